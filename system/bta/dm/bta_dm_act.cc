@@ -1572,8 +1572,9 @@ void bta_dm_ble_update_conn_params(const RawAddress& bd_addr, uint16_t min_int,
   stack::l2cap::get_interface().L2CA_AdjustConnectionIntervals(&min_int, &max_int,
                                                                BTM_BLE_CONN_INT_MIN);
 
-  if (!stack::l2cap::get_interface().L2CA_UpdateBleConnParams(bd_addr, min_int, max_int, latency,
-                                                              timeout, min_ce_len, max_ce_len)) {
+  if (!stack::l2cap::get_interface().L2CA_SetBleConnDemand(bd_addr, L2CAP_BLE_CONN_DEMAND_GATT,
+                                                           min_int, max_int, latency, timeout,
+                                                           min_ce_len, max_ce_len)) {
     log::error("Update connection parameters failed!");
   }
 }
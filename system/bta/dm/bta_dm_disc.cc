@@ -23,6 +23,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -34,11 +35,14 @@
 #include "btif/include/btif_storage.h"
 #include "common/circular_buffer.h"
 #include "common/strings.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "internal_include/bt_target.h"
 #include "main/shim/dumpsys.h"
 #include "os/logging/log_adapter.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
+#include "stack/include/acl_api.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/include/bt_name.h"
 #include "stack/include/bt_uuid16.h"
@@ -62,6 +66,8 @@ static void btm_dm_start_gatt_discovery(const RawAddress& bd_addr);
 
 namespace {
 constexpr char kBtmLogTag[] = "SDP";
+constexpr char kPropertyMaxConcurrentDiscoveries[] =
+        "bluetooth.bta_dm.max_concurrent_discoveries";
 
 tBTA_DM_SERVICE_DISCOVERY_CB bta_dm_discovery_cb;
 base::RepeatingCallback<void(tBTA_DM_SDP_STATE*)> default_sdp_performer =
@@ -83,20 +89,38 @@ static bool is_same_device(const RawAddress& a, const RawAddress& b) {
 
   return false;
 }
-}  // namespace
 
-static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event, std::unique_ptr<tBTA_DM_MSG> msg);
-static void post_disc_evt(tBTA_DM_DISC_EVT event, std::unique_ptr<tBTA_DM_MSG> msg) {
-  if (do_in_main_thread(base::BindOnce(&bta_dm_disc_sm_execute, event, std::move(msg))) !=
-      BT_STATUS_SUCCESS) {
-    log::error("post_disc_evt failed");
+tBTA_DM_DISC_SESSION* bta_dm_disc_find_session(const RawAddress& bd_addr) {
+  for (auto& [addr, session] : bta_dm_discovery_cb.sessions) {
+    if (is_same_device(addr, bd_addr)) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+tBTA_DM_DISC_SESSION* bta_dm_disc_find_session_by_conn_id(tCONN_ID conn_id) {
+  if (conn_id == GATT_INVALID_CONN_ID) {
+    return nullptr;
   }
+  for (auto& [addr, session] : bta_dm_discovery_cb.sessions) {
+    if (session.conn_id == conn_id) {
+      return &session;
+    }
+  }
+  return nullptr;
 }
+}  // namespace
 
-static void bta_dm_gatt_disc_complete(tCONN_ID conn_id, tGATT_STATUS status);
+static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event, std::unique_ptr<tBTA_DM_MSG> msg);
+
+static void bta_dm_gatt_disc_complete(const RawAddress& bd_addr, tCONN_ID conn_id,
+                                      tGATT_STATUS status);
 static void bta_dm_gattc_callback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data);
+static void bta_dm_disc_start_session(tBTA_DM_API_DISCOVER& discover);
+static void bta_dm_disc_finish_session(const RawAddress& bd_addr);
 static void bta_dm_execute_queued_discovery_request();
-static void bta_dm_close_gatt_conn();
+static void bta_dm_close_expired_gatt_conns();
 
 namespace {
 
@@ -163,10 +187,20 @@ void bta_dm_disc_gatt_refresh(const RawAddress& bd_addr) {
 }
 
 void bta_dm_disc_remove_device(const RawAddress& bd_addr) {
-  if (bta_dm_discovery_cb.service_discovery_state == BTA_DM_DISCOVER_ACTIVE &&
-      bta_dm_discovery_cb.peer_bdaddr == bd_addr) {
+  auto& queue = bta_dm_discovery_cb.pending_discovery_queue;
+  auto queued = std::remove_if(queue.begin(), queue.end(), [&bd_addr](const auto& discovery) {
+    return is_same_device(discovery.bd_addr, bd_addr);
+  });
+  if (queued != queue.end()) {
+    log::info("Device removed, dropping {} queued service discovery request(s) to {}",
+              std::distance(queued, queue.end()), bd_addr);
+    queue.erase(queued, queue.end());
+  }
+
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(bd_addr);
+  if (session != nullptr) {
     log::info("Device removed while service discovery was pending, conclude the service discovery");
-    bta_dm_gatt_disc_complete(GATT_INVALID_CONN_ID, (tGATT_STATUS)GATT_ERROR);
+    bta_dm_gatt_disc_complete(bd_addr, GATT_INVALID_CONN_ID, (tGATT_STATUS)GATT_ERROR);
   }
 }
 
@@ -177,8 +211,13 @@ static tBTA_DM_SERVICE_DISCOVERY_STATE bta_dm_discovery_get_state() {
   return bta_dm_discovery_cb.service_discovery_state;
 }
 
-// TODO. Currently we did nothing
-static void bta_dm_discovery_cancel() {}
+/* Drops queued requests, running sessions are concluded by the stack shutdown */
+static void bta_dm_discovery_cancel() {
+  log::info("Dropping {} queued service discovery request(s), {} running",
+            bta_dm_discovery_cb.pending_discovery_queue.size(),
+            bta_dm_discovery_cb.sessions.size());
+  bta_dm_discovery_cb.pending_discovery_queue.clear();
+}
 
 /*******************************************************************************
  *
@@ -212,38 +251,60 @@ void bta_dm_sdp_finished(RawAddress bda, tBTA_STATUS result, std::vector<bluetoo
 }
 
 /* Callback from sdp with discovery status */
-void bta_dm_sdp_callback(const RawAddress& /* bd_addr */, tSDP_STATUS sdp_status) {
-  bool sdp_pending = bta_dm_discovery_cb.transports & BT_TRANSPORT_BR_EDR;
-  log::info("{}, sdp_pending: {}", bta_dm_state_text(bta_dm_discovery_get_state()), sdp_pending);
+void bta_dm_sdp_callback(const RawAddress& bd_addr, tSDP_STATUS sdp_status) {
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(bd_addr);
+  bool sdp_pending = session != nullptr && (session->transports & BT_TRANSPORT_BR_EDR);
+  log::info("{}, peer:{} sdp_pending: {}", bta_dm_state_text(bta_dm_discovery_get_state()),
+            bd_addr, sdp_pending);
 
-  if (bta_dm_discovery_get_state() == BTA_DM_DISCOVER_IDLE || !sdp_pending ||
-      !bta_dm_discovery_cb.sdp_state) {
+  if (!sdp_pending || !session->sdp_state) {
     return;
   }
 
-  do_in_main_thread(
-          base::BindOnce(&bta_dm_sdp_result, sdp_status, bta_dm_discovery_cb.sdp_state.get()));
+  /* The session may be concluded before the result is processed, look it up
+   * again on the main thread */
+  do_in_main_thread(base::BindOnce(
+          [](RawAddress bd_addr, tSDP_STATUS sdp_status) {
+            tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(bd_addr);
+            if (session == nullptr || !session->sdp_state) {
+              log::warn("SDP result for {} without pending discovery", bd_addr);
+              return;
+            }
+            bta_dm_sdp_result(sdp_status, session->sdp_state.get());
+          },
+          bd_addr, sdp_status));
 }
 
 /** Callback of peer's DIS reply. This is only called for floss */
 #if TARGET_FLOSS
 void bta_dm_sdp_received_di(const RawAddress& bd_addr, tSDP_DI_GET_RECORD& di_record) {
-  bta_dm_discovery_cb.service_search_cbacks.on_did_received(
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(bd_addr);
+  if (session == nullptr) {
+    log::warn("DI record received for {} without pending discovery", bd_addr);
+    return;
+  }
+  session->service_search_cbacks.on_did_received(
           bd_addr, di_record.rec.vendor_id_source, di_record.rec.vendor, di_record.rec.product,
           di_record.rec.version);
 }
 
 static void bta_dm_read_dis_cmpl(const RawAddress& addr, tDIS_VALUE* p_dis_value) {
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(addr);
+  if (session == nullptr) {
+    log::warn("DIS read completed for {} without pending discovery", addr);
+    return;
+  }
+
   if (!p_dis_value) {
     log::warn("read DIS failed");
   } else {
-    bta_dm_discovery_cb.service_search_cbacks.on_did_received(
+    session->service_search_cbacks.on_did_received(
             addr, p_dis_value->pnp_id.vendor_id_src, p_dis_value->pnp_id.vendor_id,
             p_dis_value->pnp_id.product_id, p_dis_value->pnp_id.product_version);
   }
 
-  if (!bta_dm_discovery_cb.transports) {
-    bta_dm_execute_queued_discovery_request();
+  if (!session->transports) {
+    bta_dm_disc_finish_session(session->peer_bdaddr);
   }
 }
 #endif
@@ -261,51 +322,53 @@ static void bta_dm_read_dis_cmpl(const RawAddress& addr, tDIS_VALUE* p_dis_value
 static void bta_dm_disc_result(tBTA_DM_SVC_RES& disc_result) {
   log::verbose("");
 
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(disc_result.bd_addr);
+  if (session == nullptr) {
+    log::warn("Service discovery result for {} without pending discovery", disc_result.bd_addr);
+    return;
+  }
+
   /* if any BR/EDR service discovery has been done, report the event */
   if (!disc_result.is_gatt_over_ble) {
-    bta_dm_discovery_cb.transports &= ~BT_TRANSPORT_BR_EDR;
+    session->transports &= ~BT_TRANSPORT_BR_EDR;
 
     auto& r = disc_result;
     if (!r.gatt_uuids.empty()) {
       log::info("Sending GATT services discovered using SDP");
       // send GATT result back to app, if any
-      bta_dm_discovery_cb.service_search_cbacks.on_gatt_results(r.bd_addr, r.gatt_uuids,
-                                                                /* transport_le */ false);
+      session->service_search_cbacks.on_gatt_results(r.bd_addr, r.gatt_uuids,
+                                                     /* transport_le */ false);
     }
-    bta_dm_discovery_cb.service_search_cbacks.on_service_discovery_results(r.bd_addr, r.uuids,
-                                                                           r.result);
+    session->service_search_cbacks.on_service_discovery_results(r.bd_addr, r.uuids, r.result);
   } else {
     char remote_name[BD_NAME_LEN] = "";
-    bta_dm_discovery_cb.transports &= ~BT_TRANSPORT_LE;
-    if (btif_storage_get_stored_remote_name(bta_dm_discovery_cb.peer_bdaddr, remote_name) &&
+    session->transports &= ~BT_TRANSPORT_LE;
+    if (btif_storage_get_stored_remote_name(session->peer_bdaddr, remote_name) &&
         interop_match_name(INTEROP_DISABLE_LE_CONN_PREFERRED_PARAMS, remote_name)) {
       // Some devices provide PPCP values that are incompatible with the device-side firmware.
       log::info("disable PPCP read: interop matched name {} address {}", remote_name,
-                bta_dm_discovery_cb.peer_bdaddr);
+                session->peer_bdaddr);
     } else {
       log::info("reading PPCP");
-      GAP_BleReadPeerPrefConnParams(bta_dm_discovery_cb.peer_bdaddr);
+      GAP_BleReadPeerPrefConnParams(session->peer_bdaddr);
     }
 
-    bta_dm_discovery_cb.service_search_cbacks.on_gatt_results(bta_dm_discovery_cb.peer_bdaddr,
-                                                              disc_result.gatt_uuids,
-                                                              /* transport_le */ true);
+    session->service_search_cbacks.on_gatt_results(session->peer_bdaddr, disc_result.gatt_uuids,
+                                                   /* transport_le */ true);
   }
 
-  if (!bta_dm_discovery_cb.transports) {
-    bta_dm_discovery_set_state(BTA_DM_DISCOVER_IDLE);
+  if (session->transports) {
+    return;
   }
 
 #if TARGET_FLOSS
-  if (bta_dm_discovery_cb.conn_id != GATT_INVALID_CONN_ID &&
-      DIS_ReadDISInfo(bta_dm_discovery_cb.peer_bdaddr, bta_dm_read_dis_cmpl, DIS_ATTR_PNP_ID_BIT)) {
+  if (session->conn_id != GATT_INVALID_CONN_ID &&
+      DIS_ReadDISInfo(session->peer_bdaddr, bta_dm_read_dis_cmpl, DIS_ATTR_PNP_ID_BIT)) {
     return;
   }
 #endif
 
-  if (!bta_dm_discovery_cb.transports) {
-    bta_dm_execute_queued_discovery_request();
-  }
+  bta_dm_disc_finish_session(session->peer_bdaddr);
 }
 
 /*******************************************************************************
@@ -320,22 +383,122 @@ static void bta_dm_disc_result(tBTA_DM_SVC_RES& disc_result) {
 static void bta_dm_queue_disc(tBTA_DM_API_DISCOVER& discovery) {
   log::info("bta_dm_discovery: queuing service discovery to {} [{}]", discovery.bd_addr,
             bt_transport_text(discovery.transport));
-  bta_dm_discovery_cb.pending_discovery_queue.push(discovery);
+  bta_dm_discovery_cb.pending_discovery_queue.push_back(discovery);
 }
 
-static void bta_dm_execute_queued_discovery_request() {
-  if (bta_dm_discovery_cb.pending_discovery_queue.empty()) {
-    bta_dm_discovery_cb.sdp_state.reset();
+/*******************************************************************************
+ *
+ * Function         bta_dm_disc_has_capacity
+ *
+ * Description      Checks whether a new discovery session towards bd_addr can
+ *                  be started without exceeding the concurrency limit, nor the
+ *                  number of links the stack can hold.
+ *
+ * Returns          bool
+ *
+ ******************************************************************************/
+static bool bta_dm_disc_has_capacity(const RawAddress& bd_addr) {
+  const auto& sessions = bta_dm_discovery_cb.sessions;
+  if (sessions.empty()) {
+    return true;
+  }
+  if (sessions.size() >= bta_dm_discovery_cb.max_concurrent_discoveries) {
+    return false;
+  }
+
+  auto is_connected = [](const RawAddress& addr) {
+    return get_btm_client_interface().peer.BTM_IsAclConnectionUp(addr, BT_TRANSPORT_BR_EDR) ||
+           get_btm_client_interface().peer.BTM_IsAclConnectionUp(addr, BT_TRANSPORT_LE);
+  };
+  if (is_connected(bd_addr)) {
+    return true;
+  }
+
+  /* Sessions still waiting for their link will consume an ACL as well */
+  size_t links = BTM_GetNumAclLinks();
+  for (const auto& [addr, session] : sessions) {
+    if (!is_connected(addr)) {
+      links++;
+    }
+  }
+  return links < MAX_L2CAP_LINKS;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_disc_start_queued_discoveries
+ *
+ * Description      Starts queued discovery requests, in order, as long as
+ *                  there is capacity. Requests for a device that already has a
+ *                  session, or that would need a link the stack cannot hold,
+ *                  stay queued without blocking the ones behind them.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_disc_start_queued_discoveries() {
+  auto& queue = bta_dm_discovery_cb.pending_discovery_queue;
+  if (queue.empty()) {
     log::info("No more service discovery queued");
     return;
   }
 
-  tBTA_DM_API_DISCOVER pending_discovery = bta_dm_discovery_cb.pending_discovery_queue.front();
-  bta_dm_discovery_cb.pending_discovery_queue.pop();
-  log::info("Start pending discovery {} [{}]", pending_discovery.bd_addr,
-            pending_discovery.transport);
-  post_disc_evt(BTA_DM_API_DISCOVER_EVT,
-                std::make_unique<tBTA_DM_MSG>(tBTA_DM_API_DISCOVER{pending_discovery}));
+  for (auto it = queue.begin(); it != queue.end();) {
+    /* A device that is already connected may fit even when a new link would
+     * not, so keep looking further down the queue */
+    if (bta_dm_disc_find_session(it->bd_addr) != nullptr ||
+        !bta_dm_disc_has_capacity(it->bd_addr)) {
+      ++it;
+      continue;
+    }
+
+    tBTA_DM_API_DISCOVER pending_discovery = *it;
+    queue.erase(it);
+    log::info("Start pending discovery {} [{}]", pending_discovery.bd_addr,
+              pending_discovery.transport);
+    bta_dm_disc_start_session(pending_discovery);
+    /* Starting a session may finish one synchronously and touch the queue */
+    it = queue.begin();
+  }
+
+  log::info("{} service discovery running, {} queued", bta_dm_discovery_cb.sessions.size(),
+            queue.size());
+}
+
+static void bta_dm_execute_queued_discovery_request() {
+  if (do_in_main_thread(base::BindOnce(&bta_dm_disc_start_queued_discoveries)) !=
+      BT_STATUS_SUCCESS) {
+    log::error("Unable to schedule queued service discovery");
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_disc_finish_session
+ *
+ * Description      Concludes the discovery session of a device and gives its
+ *                  slot to the next queued request.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_disc_finish_session(const RawAddress& bd_addr) {
+  auto it = bta_dm_discovery_cb.sessions.find(bd_addr);
+  if (it == bta_dm_discovery_cb.sessions.end()) {
+    return;
+  }
+
+  log::info("Service discovery to {} finished in {}ms", bd_addr,
+            bluetooth::common::time_get_os_boottime_ms() - it->second.start_time_ms);
+  if (it->second.sdp_state) {
+    bta_dm_sdp_release_db(it->second.sdp_state.get());
+  }
+  bta_dm_discovery_cb.sessions.erase(it);
+  if (bta_dm_discovery_cb.sessions.empty()) {
+    bta_dm_discovery_set_state(BTA_DM_DISCOVER_IDLE);
+  }
+
+  bta_dm_execute_queued_discovery_request();
 }
 
 /*******************************************************************************
@@ -367,7 +530,8 @@ static tBT_TRANSPORT bta_dm_determine_discovery_transport(const RawAddress& remo
 }
 
 /* Discovers services on a remote device */
-static void bta_dm_discover_services(tBTA_DM_API_DISCOVER& discover) {
+static void bta_dm_discover_services(tBTA_DM_DISC_SESSION& session,
+                                     tBTA_DM_API_DISCOVER& discover) {
   bta_dm_disc_gattc_register();
 
   RawAddress bd_addr = discover.bd_addr;
@@ -378,9 +542,7 @@ static void bta_dm_discover_services(tBTA_DM_API_DISCOVER& discover) {
   log::info("starting service discovery to: {}, transport: {}", bd_addr,
             bt_transport_text(transport));
 
-  bta_dm_discovery_cb.service_search_cbacks = discover.cbacks;
-
-  bta_dm_discovery_cb.peer_bdaddr = bd_addr;
+  session.service_search_cbacks = discover.cbacks;
 
   /* Classic mouses with this attribute should not start SDP here, because the
     SDP has been done during bonding. SDP request here will interleave with
@@ -399,33 +561,47 @@ static void bta_dm_discover_services(tBTA_DM_API_DISCOVER& discover) {
                  base::StringPrintf("Transport:%s", bt_transport_text(transport).c_str()));
 
   if (transport == BT_TRANSPORT_LE) {
-    if (bta_dm_discovery_cb.transports & BT_TRANSPORT_LE) {
+    if (session.transports & BT_TRANSPORT_LE) {
       log::info("won't start GATT discovery - already started {}", bd_addr);
       return;
     } else {
       log::info("starting GATT discovery on {}", bd_addr);
       /* start GATT for service discovery */
-      bta_dm_discovery_cb.transports |= BT_TRANSPORT_LE;
+      session.transports |= BT_TRANSPORT_LE;
       gatt_performer.Run(bd_addr);
       return;
     }
   }
 
   // transport == BT_TRANSPORT_BR_EDR
-  if (bta_dm_discovery_cb.transports & BT_TRANSPORT_BR_EDR) {
+  if (session.transports & BT_TRANSPORT_BR_EDR) {
     log::info("won't start SDP - already started {}", bd_addr);
   } else {
     log::info("starting SDP discovery on {}", bd_addr);
-    bta_dm_discovery_cb.transports |= BT_TRANSPORT_BR_EDR;
+    session.transports |= BT_TRANSPORT_BR_EDR;
 
-    bta_dm_discovery_cb.sdp_state = std::make_unique<tBTA_DM_SDP_STATE>(tBTA_DM_SDP_STATE{
+    session.sdp_state = std::make_unique<tBTA_DM_SDP_STATE>(tBTA_DM_SDP_STATE{
             .bd_addr = bd_addr,
             .services_to_search = BTA_ALL_SERVICE_MASK,
             .services_found = 0,
             .service_index = 0,
     });
-    sdp_performer.Run(bta_dm_discovery_cb.sdp_state.get());
+    sdp_performer.Run(session.sdp_state.get());
+  }
+}
+
+/* Opens a new discovery session for the device and starts discovery */
+static void bta_dm_disc_start_session(tBTA_DM_API_DISCOVER& discover) {
+  auto [it, inserted] = bta_dm_discovery_cb.sessions.try_emplace(discover.bd_addr);
+  tBTA_DM_DISC_SESSION& session = it->second;
+  if (inserted) {
+    session.peer_bdaddr = discover.bd_addr;
+    session.conn_id = GATT_INVALID_CONN_ID;
+    session.start_time_ms = bluetooth::common::time_get_os_boottime_ms();
   }
+  bta_dm_discovery_set_state(BTA_DM_DISCOVER_ACTIVE);
+
+  bta_dm_discover_services(session, discover);
 }
 
 void bta_dm_disc_override_sdp_performer_for_testing(
@@ -504,12 +680,19 @@ void bta_dm_gatt_finished(RawAddress bda, tBTA_STATUS result,
  * Parameters:
  *
  ******************************************************************************/
-static void bta_dm_gatt_disc_complete(tCONN_ID conn_id, tGATT_STATUS status) {
-  bool sdp_pending = bta_dm_discovery_cb.transports & BT_TRANSPORT_BR_EDR;
-  bool le_pending = bta_dm_discovery_cb.transports & BT_TRANSPORT_LE;
+static void bta_dm_gatt_disc_complete(const RawAddress& bd_addr, tCONN_ID conn_id,
+                                      tGATT_STATUS status) {
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(bd_addr);
+  if (session == nullptr) {
+    log::warn("GATT discovery complete for {} without pending discovery", bd_addr);
+    return;
+  }
 
-  log::verbose("conn_id = {}, status = {}, sdp_pending = {}, le_pending = {}", conn_id, status,
-               sdp_pending, le_pending);
+  bool sdp_pending = session->transports & BT_TRANSPORT_BR_EDR;
+  bool le_pending = session->transports & BT_TRANSPORT_LE;
+
+  log::verbose("peer = {}, conn_id = {}, status = {}, sdp_pending = {}, le_pending = {}",
+               session->peer_bdaddr, conn_id, status, sdp_pending, le_pending);
 
   if (com::android::bluetooth::flags::bta_dm_discover_both() && sdp_pending && !le_pending) {
     /* LE Service discovery finished, and services were reported, but SDP is not
@@ -518,6 +701,10 @@ static void bta_dm_gatt_disc_complete(tCONN_ID conn_id, tGATT_STATUS status) {
     return;
   }
 
+  /* The session may be concluded while reporting the result */
+  const RawAddress peer_bdaddr = session->peer_bdaddr;
+  const tCONN_ID session_conn_id = session->conn_id;
+
   std::vector<Uuid> gatt_services;
 
   if (conn_id != GATT_INVALID_CONN_ID && status == GATT_SUCCESS) {
@@ -537,57 +724,88 @@ static void bta_dm_gatt_disc_complete(tCONN_ID conn_id, tGATT_STATUS status) {
   }
 
   /* no more services to be discovered */
-  bta_dm_gatt_finished(bta_dm_discovery_cb.peer_bdaddr,
-                       (status == GATT_SUCCESS) ? BTA_SUCCESS : BTA_FAILURE,
+  bta_dm_gatt_finished(peer_bdaddr, (status == GATT_SUCCESS) ? BTA_SUCCESS : BTA_FAILURE,
                        std::move(gatt_services));
 
   if (conn_id != GATT_INVALID_CONN_ID) {
-    bta_dm_discovery_cb.pending_close_bda = bta_dm_discovery_cb.peer_bdaddr;
+    session = bta_dm_disc_find_session(peer_bdaddr);
+    if (session != nullptr) {
+      session->conn_id = GATT_INVALID_CONN_ID;
+    }
     // Gatt will be close immediately if bluetooth.gatt.delay_close.enabled is
     // set to false. If property is true / unset there will be a delay
+    uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
     if (bta_dm_discovery_cb.gatt_close_timer != nullptr) {
-      /* start a GATT channel close delay timer */
-      alarm_set_on_mloop(bta_dm_discovery_cb.gatt_close_timer, BTA_DM_GATT_CLOSE_DELAY_TOUT,
-                         gatt_close_timer_cb, 0);
+      bta_dm_discovery_cb.pending_close[peer_bdaddr] = {
+              .conn_id = conn_id,
+              .close_time_ms = now_ms + BTA_DM_GATT_CLOSE_DELAY_TOUT,
+      };
+      /* start a GATT channel close delay timer, unless one is already running
+       * for an earlier connection */
+      if (!alarm_is_scheduled(bta_dm_discovery_cb.gatt_close_timer)) {
+        alarm_set_on_mloop(bta_dm_discovery_cb.gatt_close_timer, BTA_DM_GATT_CLOSE_DELAY_TOUT,
+                           gatt_close_timer_cb, 0);
+      }
     } else {
+      bta_dm_discovery_cb.pending_close[peer_bdaddr] = {
+              .conn_id = conn_id,
+              .close_time_ms = now_ms,
+      };
       bta_dm_disc_sm_execute(BTA_DM_DISC_CLOSE_TOUT_EVT, nullptr);
     }
   } else {
     log::info("Discovery complete for invalid conn ID. Will pick up next job");
 
+    session = bta_dm_disc_find_session(peer_bdaddr);
     if (com::android::bluetooth::flags::cancel_open_discovery_client()) {
-      bta_dm_close_gatt_conn();
-    } else {
-      bta_dm_discovery_cb.conn_id = GATT_INVALID_CONN_ID;
+      if (session_conn_id != GATT_INVALID_CONN_ID) {
+        BTA_GATTC_Close(session_conn_id);
+      }
+      bta_dm_discovery_cb.pending_close.erase(peer_bdaddr);
+    }
+    if (session != nullptr) {
+      session->conn_id = GATT_INVALID_CONN_ID;
     }
     if (com::android::bluetooth::flags::fix_le_evt_cancelling_sdp_discovery() &&
-        (bta_dm_discovery_cb.transports & BT_TRANSPORT_BR_EDR)) {
-      log::info("classic discovery still pending {}", bta_dm_discovery_cb.peer_bdaddr);
+        session != nullptr && (session->transports & BT_TRANSPORT_BR_EDR)) {
+      log::info("classic discovery still pending {}", peer_bdaddr);
       return;
-    } else {
-      bta_dm_discovery_set_state(BTA_DM_DISCOVER_IDLE);
     }
-    bta_dm_execute_queued_discovery_request();
+    bta_dm_disc_finish_session(peer_bdaddr);
   }
 }
 
 /*******************************************************************************
  *
- * Function         bta_dm_close_gatt_conn
+ * Function         bta_dm_close_expired_gatt_conns
  *
- * Description      This function close the GATT connection after delay
- *timeout.
+ * Description      This function closes the GATT connections whose close delay
+ *                  expired, and rearms the timer for the remaining ones.
  *
  * Parameters:
  *
  ******************************************************************************/
-static void bta_dm_close_gatt_conn() {
-  if (bta_dm_discovery_cb.conn_id != GATT_INVALID_CONN_ID) {
-    BTA_GATTC_Close(bta_dm_discovery_cb.conn_id);
+static void bta_dm_close_expired_gatt_conns() {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint64_t next_close_time_ms = UINT64_MAX;
+
+  auto& pending_close = bta_dm_discovery_cb.pending_close;
+  for (auto it = pending_close.begin(); it != pending_close.end();) {
+    if (it->second.close_time_ms > now_ms) {
+      next_close_time_ms = std::min(next_close_time_ms, it->second.close_time_ms);
+      ++it;
+      continue;
+    }
+    if (it->second.conn_id != GATT_INVALID_CONN_ID) {
+      BTA_GATTC_Close(it->second.conn_id);
+    }
+    it = pending_close.erase(it);
   }
 
-  bta_dm_discovery_cb.pending_close_bda = RawAddress::kEmpty;
-  bta_dm_discovery_cb.conn_id = GATT_INVALID_CONN_ID;
+  if (next_close_time_ms != UINT64_MAX && bta_dm_discovery_cb.gatt_close_timer != nullptr) {
+    alarm_set_on_mloop(bta_dm_discovery_cb.gatt_close_timer, next_close_time_ms - now_ms,
+                       gatt_close_timer_cb, 0);
+  }
 }
 /*******************************************************************************
  *
@@ -603,11 +821,13 @@ static void btm_dm_start_gatt_discovery(const RawAddress& bd_addr) {
   constexpr bool kUseOpportunistic = true;
 
   /* connection is already open */
-  if (bta_dm_discovery_cb.pending_close_bda == bd_addr &&
-      bta_dm_discovery_cb.conn_id != GATT_INVALID_CONN_ID) {
-    bta_dm_discovery_cb.pending_close_bda = RawAddress::kEmpty;
-    alarm_cancel(bta_dm_discovery_cb.gatt_close_timer);
-    get_gatt_interface().BTA_GATTC_ServiceSearchRequest(bta_dm_discovery_cb.conn_id, nullptr);
+  auto pending = bta_dm_discovery_cb.pending_close.find(bd_addr);
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(bd_addr);
+  if (pending != bta_dm_discovery_cb.pending_close.end() && session != nullptr &&
+      pending->second.conn_id != GATT_INVALID_CONN_ID) {
+    session->conn_id = pending->second.conn_id;
+    bta_dm_discovery_cb.pending_close.erase(pending);
+    get_gatt_interface().BTA_GATTC_ServiceSearchRequest(session->conn_id, nullptr);
   } else {
     if (get_btm_client_interface().peer.BTM_IsAclConnectionUp(bd_addr, BT_TRANSPORT_LE)) {
       log::debug(
@@ -637,18 +857,31 @@ static void btm_dm_start_gatt_discovery(const RawAddress& bd_addr) {
  *
  ******************************************************************************/
 static void bta_dm_proc_open_evt(tBTA_GATTC_OPEN* p_data) {
-  log::verbose("DM Search state= {} bta_dm_discovery_cb.peer_dbaddr:{} connected_bda={}",
-               bta_dm_discovery_get_state(), bta_dm_discovery_cb.peer_bdaddr, p_data->remote_bda);
+  log::verbose("DM Search state= {} connected_bda={}", bta_dm_discovery_get_state(),
+               p_data->remote_bda);
 
   log::debug("BTA_GATTC_OPEN_EVT conn_id = {} client_if={} status = {}", p_data->conn_id,
              p_data->client_if, p_data->status);
 
-  bta_dm_discovery_cb.conn_id = p_data->conn_id;
+  tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(p_data->remote_bda);
+  if (session == nullptr || !(session->transports & BT_TRANSPORT_LE)) {
+    log::info("No GATT discovery pending for {}", p_data->remote_bda);
+    if (p_data->status == GATT_SUCCESS) {
+      bta_dm_discovery_cb.pending_close[p_data->remote_bda] = {
+              .conn_id = p_data->conn_id,
+              .close_time_ms = 0,
+      };
+      bta_dm_close_expired_gatt_conns();
+    }
+    return;
+  }
+
+  session->conn_id = p_data->conn_id;
 
   if (p_data->status == GATT_SUCCESS) {
     get_gatt_interface().BTA_GATTC_ServiceSearchRequest(p_data->conn_id, nullptr);
   } else {
-    bta_dm_gatt_disc_complete(GATT_INVALID_CONN_ID, p_data->status);
+    bta_dm_gatt_disc_complete(session->peer_bdaddr, GATT_INVALID_CONN_ID, p_data->status);
   }
 }
 
@@ -669,26 +902,32 @@ static void bta_dm_gattc_callback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
       bta_dm_proc_open_evt(&p_data->open);
       break;
 
-    case BTA_GATTC_SEARCH_CMPL_EVT:
-      if (bta_dm_discovery_get_state() == BTA_DM_DISCOVER_ACTIVE) {
-        bta_dm_gatt_disc_complete(p_data->search_cmpl.conn_id, p_data->search_cmpl.status);
+    case BTA_GATTC_SEARCH_CMPL_EVT: {
+      tBTA_DM_DISC_SESSION* session =
+              bta_dm_disc_find_session_by_conn_id(p_data->search_cmpl.conn_id);
+      if (session != nullptr) {
+        bta_dm_gatt_disc_complete(session->peer_bdaddr, p_data->search_cmpl.conn_id,
+                                  p_data->search_cmpl.status);
       }
-      break;
+    } break;
 
-    case BTA_GATTC_CLOSE_EVT:
+    case BTA_GATTC_CLOSE_EVT: {
       log::info("BTA_GATTC_CLOSE_EVT reason = {}", p_data->close.reason);
 
-      if (p_data->close.remote_bda == bta_dm_discovery_cb.peer_bdaddr) {
-        bta_dm_discovery_cb.conn_id = GATT_INVALID_CONN_ID;
+      auto pending = bta_dm_discovery_cb.pending_close.find(p_data->close.remote_bda);
+      if (pending != bta_dm_discovery_cb.pending_close.end() &&
+          pending->second.conn_id == p_data->close.conn_id) {
+        bta_dm_discovery_cb.pending_close.erase(pending);
       }
 
-      if (bta_dm_discovery_get_state() == BTA_DM_DISCOVER_ACTIVE) {
+      tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(p_data->close.remote_bda);
+      if (session != nullptr) {
+        session->conn_id = GATT_INVALID_CONN_ID;
         /* in case of disconnect before search is completed */
-        if (p_data->close.remote_bda == bta_dm_discovery_cb.peer_bdaddr) {
-          bta_dm_gatt_disc_complete(GATT_INVALID_CONN_ID, (tGATT_STATUS)GATT_ERROR);
-        }
+        bta_dm_gatt_disc_complete(session->peer_bdaddr, GATT_INVALID_CONN_ID,
+                                  (tGATT_STATUS)GATT_ERROR);
       }
-      break;
+    } break;
 
     case BTA_GATTC_CANCEL_OPEN_EVT:
     case BTA_GATTC_CFG_MTU_EVT:
@@ -762,14 +1001,14 @@ static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event, std::unique_ptr<tBTA_
     case BTA_DM_DISCOVER_IDLE:
       switch (event) {
         case BTA_DM_API_DISCOVER_EVT:
-          bta_dm_discovery_set_state(BTA_DM_DISCOVER_ACTIVE);
           log::assert_that(std::holds_alternative<tBTA_DM_API_DISCOVER>(*msg),
                            "bad message type: {}", msg->index());
 
-          bta_dm_discover_services(std::get<tBTA_DM_API_DISCOVER>(*msg));
+          bta_dm_queue_disc(std::get<tBTA_DM_API_DISCOVER>(*msg));
+          bta_dm_disc_start_queued_discoveries();
           break;
         case BTA_DM_DISC_CLOSE_TOUT_EVT:
-          bta_dm_close_gatt_conn();
+          bta_dm_close_expired_gatt_conns();
           break;
         default:
           log::info("Received unexpected event {}[0x{:x}] in state {}", bta_dm_event_text(event),
@@ -789,16 +1028,21 @@ static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event, std::unique_ptr<tBTA_
           log::assert_that(std::holds_alternative<tBTA_DM_API_DISCOVER>(*msg),
                            "bad message type: {}", msg->index());
 
-          auto req = std::get<tBTA_DM_API_DISCOVER>(*msg);
-          if (com::android::bluetooth::flags::bta_dm_discover_both() &&
-              is_same_device(req.bd_addr, bta_dm_discovery_cb.peer_bdaddr)) {
-            bta_dm_discover_services(std::get<tBTA_DM_API_DISCOVER>(*msg));
+          auto& req = std::get<tBTA_DM_API_DISCOVER>(*msg);
+          tBTA_DM_DISC_SESSION* session = bta_dm_disc_find_session(req.bd_addr);
+          if (session != nullptr) {
+            if (com::android::bluetooth::flags::bta_dm_discover_both()) {
+              bta_dm_discover_services(*session, req);
+            } else {
+              bta_dm_queue_disc(req);
+            }
           } else {
-            bta_dm_queue_disc(std::get<tBTA_DM_API_DISCOVER>(*msg));
+            bta_dm_queue_disc(req);
+            bta_dm_disc_start_queued_discoveries();
           }
         } break;
         case BTA_DM_DISC_CLOSE_TOUT_EVT:
-          bta_dm_close_gatt_conn();
+          bta_dm_close_expired_gatt_conns();
           break;
         default:
           log::info("Received unexpected event {}[0x{:x}] in state {}", bta_dm_event_text(event),
@@ -811,11 +1055,19 @@ static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event, std::unique_ptr<tBTA_
 static void bta_dm_disc_init_discovery_cb(tBTA_DM_SERVICE_DISCOVERY_CB& bta_dm_discovery_cb) {
   bta_dm_discovery_cb = {};
   bta_dm_discovery_cb.service_discovery_state = BTA_DM_DISCOVER_IDLE;
-  bta_dm_discovery_cb.conn_id = GATT_INVALID_CONN_ID;
+  bta_dm_discovery_cb.max_concurrent_discoveries = BTA_DM_MAX_CONCURRENT_DISCOVERIES;
 }
 
 static void bta_dm_disc_reset() {
   alarm_free(bta_dm_discovery_cb.gatt_close_timer);
+  for (auto& [addr, session] : bta_dm_discovery_cb.sessions) {
+    if (session.sdp_state) {
+      /* The session and its database are gone once reset, so stop a search
+       * still in flight before releasing the chunks it grew */
+      bta_dm_sdp_cancel(session.sdp_state.get());
+      bta_dm_sdp_release_db(session.sdp_state.get());
+    }
+  }
   bta_dm_disc_init_discovery_cb(::bta_dm_discovery_cb);
 }
 
@@ -824,6 +1076,9 @@ void bta_dm_disc_start(bool delay_close_gatt) {
   bta_dm_discovery_cb.gatt_close_timer =
           delay_close_gatt ? alarm_new("bta_dm_search.gatt_close_timer") : nullptr;
   bta_dm_discovery_cb.pending_discovery_queue = {};
+  bta_dm_discovery_cb.max_concurrent_discoveries = std::max(
+          1, osi_property_get_int32(kPropertyMaxConcurrentDiscoveries,
+                                    BTA_DM_MAX_CONCURRENT_DISCOVERIES));
 }
 
 void bta_dm_disc_stop() { bta_dm_disc_reset(); }
@@ -845,6 +1100,15 @@ void DumpsysBtaDmDisc(int fd) {
   }
   LOG_DUMPSYS(fd, " current bta_dm_discovery_state:%s",
               bta_dm_state_text(bta_dm_discovery_get_state()).c_str());
+  LOG_DUMPSYS(fd, " running discoveries:%zu max:%zu queued:%zu",
+              bta_dm_discovery_cb.sessions.size(), bta_dm_discovery_cb.max_concurrent_discoveries,
+              bta_dm_discovery_cb.pending_discovery_queue.size());
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  for (const auto& [addr, session] : bta_dm_discovery_cb.sessions) {
+    LOG_DUMPSYS(fd, "   peer:%s transports:0x%02x conn_id:0x%04x running:%llums",
+                ADDRESS_TO_LOGGABLE_CSTR(addr), session.transports, session.conn_id,
+                static_cast<unsigned long long>(now_ms - session.start_time_ms));
+  }
 }
 #undef DUMPSYS_TAG
 
@@ -19,7 +19,9 @@
 #include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 
-#include <queue>
+#include <deque>
+#include <map>
+#include <memory>
 #include <string>
 
 #include "bta/include/bta_api.h"
@@ -92,23 +94,43 @@ typedef struct {
   alignas(tSDP_DISCOVERY_DB) uint8_t sdp_db_buffer[BTA_DM_SDP_DB_SIZE];
 } tBTA_DM_SDP_STATE;
 
+/* Per device service discovery session. A session covers the SDP and/or GATT
+ * discovery towards a single peer and lives until all of its transports are
+ * done. */
 typedef struct {
+  RawAddress peer_bdaddr;
   service_discovery_callbacks service_search_cbacks;
+  uint8_t transports;
+  std::unique_ptr<tBTA_DM_SDP_STATE> sdp_state;
+  tCONN_ID conn_id;
+  uint64_t start_time_ms;
+} tBTA_DM_DISC_SESSION;
+
+/* GATT connection kept open for a while after discovery completed, so that a
+ * follow up discovery can reuse it */
+typedef struct {
+  tCONN_ID conn_id;
+  uint64_t close_time_ms;
+} tBTA_DM_GATT_PENDING_CLOSE;
+
+typedef struct {
   tGATT_IF client_if;
-  std::queue<tBTA_DM_API_DISCOVER> pending_discovery_queue;
+  std::deque<tBTA_DM_API_DISCOVER> pending_discovery_queue;
+
+  /* Service discovery sessions currently running, keyed by peer address */
+  std::map<RawAddress, tBTA_DM_DISC_SESSION> sessions;
+  /* Upper bound on the number of sessions running at the same time */
+  size_t max_concurrent_discoveries;
 
-  RawAddress peer_bdaddr;
-  uint8_t transports;
   /* This covers service discovery state - callers of BTA_DmDiscover. That is
    * initial service discovery after bonding and
    * BluetoothDevice.fetchUuidsWithSdp(). Responsible for LE GATT Service
-   * Discovery and SDP */
+   * Discovery and SDP. Active as long as at least one session is running. */
   tBTA_DM_SERVICE_DISCOVERY_STATE service_discovery_state;
-  std::unique_ptr<tBTA_DM_SDP_STATE> sdp_state;
 
-  tCONN_ID conn_id;
-  alarm_t* gatt_close_timer;    /* GATT channel close delay timer */
-  RawAddress pending_close_bda; /* pending GATT channel remote device address */
+  alarm_t* gatt_close_timer; /* GATT channel close delay timer */
+  /* GATT channels pending close, keyed by remote device address */
+  std::map<RawAddress, tBTA_DM_GATT_PENDING_CLOSE> pending_close;
 } tBTA_DM_SERVICE_DISCOVERY_CB;
 
 extern const uint32_t bta_service_id_to_btm_srv_id_lkup_tbl[];
@@ -120,6 +142,8 @@ void bta_dm_disc_override_gatt_performer_for_testing(
         base::RepeatingCallback<void(const RawAddress&)> test_gatt_performer);
 void bta_dm_sdp_find_services(tBTA_DM_SDP_STATE* sdp_state);
 void bta_dm_sdp_result(tSDP_STATUS sdp_result, tBTA_DM_SDP_STATE* sdp_state);
+void bta_dm_sdp_release_db(tBTA_DM_SDP_STATE* sdp_state);
+void bta_dm_sdp_cancel(tBTA_DM_SDP_STATE* sdp_state);
 void bta_dm_sdp_finished(RawAddress bda, tBTA_STATUS result,
                          std::vector<bluetooth::Uuid> uuids = {},
                          std::vector<bluetooth::Uuid> gatt_uuids = {});
@@ -290,6 +290,22 @@ void bta_dm_sdp_result(tSDP_STATUS sdp_result, tBTA_DM_SDP_STATE* sdp_state) {
   }
 }
 
+/* Release the memory the discovery database grew by. The database content is
+ * no longer valid afterwards. */
+void bta_dm_sdp_release_db(tBTA_DM_SDP_STATE* sdp_state) {
+  get_legacy_stack_sdp_api()->service.SDP_FreeDiscoveryDb(
+          (tSDP_DISCOVERY_DB*)sdp_state->sdp_db_buffer);
+}
+
+/* Stop a search that may still be filling the discovery database, so that no
+ * chunk is chained to it once it is released. */
+void bta_dm_sdp_cancel(tBTA_DM_SDP_STATE* sdp_state) {
+  if (get_legacy_stack_sdp_api()->service.SDP_CancelServiceSearch(
+              (tSDP_DISCOVERY_DB*)sdp_state->sdp_db_buffer)) {
+    log::info("Cancelled SDP search to {}", sdp_state->bd_addr);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_dm_sdp_find_services
@@ -329,10 +345,12 @@ void bta_dm_sdp_find_services(tBTA_DM_SDP_STATE* sdp_state) {
   tSDP_DISCOVERY_DB* p_sdp_db = (tSDP_DISCOVERY_DB*)sdp_state->sdp_db_buffer;
 
   log::info("search UUID = {}", uuid.ToString());
+  bta_dm_sdp_release_db(sdp_state);
   if (!get_legacy_stack_sdp_api()->service.SDP_InitDiscoveryDb(p_sdp_db, BTA_DM_SDP_DB_SIZE, 1,
                                                                &uuid, 0, NULL)) {
     log::warn("Unable to initialize SDP service discovery db peer:{}", sdp_state->bd_addr);
   }
+  p_sdp_db->chunk_size = BTA_DM_SDP_DB_CHUNK_SIZE;
 
   sdp_state->g_disc_raw_data_buf = {};
   p_sdp_db->raw_data = sdp_state->g_disc_raw_data_buf.data();
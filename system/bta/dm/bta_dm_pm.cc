@@ -44,6 +44,7 @@
 #include "stack/include/acl_api.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack/include/btm_status.h"
+#include "stack/include/l2cap_interface.h"
 #include "stack/include/main_thread.h"
 #include "types/raw_address.h"
 
@@ -729,8 +730,11 @@ static void bta_dm_pm_set_mode(const RawAddress& peer_addr, tBTA_DM_PM_ACTION pm
     bta_dm_pm_park(peer_addr);
     log::warn("DEPRECATED Setting link to park mode peer:{}", peer_addr);
   } else if (pm_action & BTA_DM_PM_SNIFF) {
-    /* dont initiate SNIFF, if link_policy has it disabled */
-    if (BTM_is_sniff_allowed_for(peer_addr)) {
+    /* dont initiate SNIFF, if link_policy has it disabled or audio or HID
+     * keep the LE link to the same peer busy */
+    if (stack::l2cap::get_interface().L2CA_IsBleConnLatencySensitive(peer_addr)) {
+      log::debug("LE link demand is latency sensitive, ignore request peer:{}", peer_addr);
+    } else if (BTM_is_sniff_allowed_for(peer_addr)) {
       log::verbose("Link policy allows sniff mode so setting mode peer:{}", peer_addr);
       p_peer_device->pm_mode_attempted = BTA_DM_PM_SNIFF;
       bta_dm_pm_sniff(p_peer_device, (uint8_t)(pm_action & 0x0F));
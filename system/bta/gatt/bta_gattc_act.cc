@@ -1429,6 +1429,7 @@ static void bta_gattc_deregister_cmpl(tBTA_GATTC_RCB* p_clreg) {
   memset(&cb_data, 0, sizeof(tBTA_GATTC));
 
   GATT_Deregister(p_clreg->client_if);
+  bta_gattc_cb.notif_index.erase(p_clreg->client_if);
   if (com::android::bluetooth::flags::gatt_client_dynamic_allocation()) {
     if (bta_gattc_cb.cl_rcb_map.erase(p_clreg->client_if) == 0) {
       log::warn("deregistered unknown rcb client_if={}", p_clreg->client_if);
@@ -648,15 +648,10 @@ tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if, const RawAdd
 
   p_clreg = bta_gattc_cl_get_regcb(client_if);
   if (p_clreg != NULL) {
-    for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-      if (p_clreg->notif_reg[i].in_use && p_clreg->notif_reg[i].remote_bda == bda &&
-          p_clreg->notif_reg[i].handle == handle) {
-        log::warn("notification already registered");
-        status = GATT_SUCCESS;
-        break;
-      }
-    }
-    if (status != GATT_SUCCESS) {
+    if (bta_gattc_find_notif_reg(p_clreg, bda, handle) != NULL) {
+      log::warn("notification already registered");
+      status = GATT_SUCCESS;
+    } else {
       for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
         if (!p_clreg->notif_reg[i].in_use) {
           memset((void*)&p_clreg->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
@@ -665,6 +660,7 @@ tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if, const RawAdd
           p_clreg->notif_reg[i].remote_bda = bda;
 
           p_clreg->notif_reg[i].handle = handle;
+          bta_gattc_index_notif_reg(p_clreg, i);
           status = GATT_SUCCESS;
           break;
         }
@@ -708,17 +704,16 @@ tGATT_STATUS BTA_GATTC_DeregisterForNotifications(tGATT_IF client_if, const RawA
     return GATT_ILLEGAL_PARAMETER;
   }
 
-  for (int i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-    if (p_clreg->notif_reg[i].in_use && p_clreg->notif_reg[i].remote_bda == bda &&
-        p_clreg->notif_reg[i].handle == handle) {
-      log::verbose("deregistered bd_addr={}", bda);
-      memset(&p_clreg->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
-      return GATT_SUCCESS;
-    }
+  tBTA_GATTC_NOTIF_REG* p_reg = bta_gattc_find_notif_reg(p_clreg, bda, handle);
+  if (p_reg == NULL) {
+    log::error("registration not found bd_addr={}", bda);
+    return GATT_ERROR;
   }
 
-  log::error("registration not found bd_addr={}", bda);
-  return GATT_ERROR;
+  log::verbose("deregistered bd_addr={}", bda);
+  bta_gattc_unindex_notif_reg(p_clreg, p_reg - p_clreg->notif_reg);
+  memset(p_reg, 0, sizeof(tBTA_GATTC_NOTIF_REG));
+  return GATT_SUCCESS;
 }
 
 /*******************************************************************************
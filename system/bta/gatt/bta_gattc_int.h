@@ -272,6 +272,10 @@ typedef struct {
   uint16_t handle;
 } tBTA_GATTC_NOTIF_REG;
 
+/* index of the notif_reg entries of a client, by server address and handle */
+typedef std::unordered_map<RawAddress, std::unordered_map<uint16_t, uint8_t>>
+        tBTA_GATTC_NOTIF_INDEX;
+
 typedef struct {
   tBTA_GATTC_CBACK* p_cback;
   bool in_use;
@@ -351,6 +355,11 @@ typedef struct {
   tBTA_GATTC_CLCB clcb[BTA_GATTC_CLCB_MAX];
   std::unordered_set<std::unique_ptr<tBTA_GATTC_CLCB>> clcb_set;
   tBTA_GATTC_SERV known_server[BTA_GATTC_KNOWN_SR_MAX];
+
+  /* lookups used on every notification, so that dispatching does not scan
+   * all CLCBs and registrations */
+  std::unordered_map<tCONN_ID, tBTA_GATTC_CLCB*> clcb_by_conn_id;
+  std::unordered_map<tGATT_IF, tBTA_GATTC_NOTIF_INDEX> notif_index;
 } tBTA_GATTC_CB;
 
 /*****************************************************************************
@@ -446,6 +455,10 @@ void bta_gattc_cmpl_sendmsg(tCONN_ID conn_id, tGATTC_OPTYPE op, tGATT_STATUS sta
 
 bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg, tBTA_GATTC_SERV* p_srcb,
                                     tBTA_GATTC_NOTIFY* p_notify);
+tBTA_GATTC_NOTIF_REG* bta_gattc_find_notif_reg(tBTA_GATTC_RCB* p_clreg,
+                                               const RawAddress& remote_bda, uint16_t handle);
+void bta_gattc_index_notif_reg(tBTA_GATTC_RCB* p_clreg, uint8_t index);
+void bta_gattc_unindex_notif_reg(tBTA_GATTC_RCB* p_clreg, uint8_t index);
 bool bta_gattc_mark_bg_conn(tGATT_IF client_if, const RawAddress& remote_bda, bool add);
 bool bta_gattc_check_bg_conn(tGATT_IF client_if, const RawAddress& remote_bda, uint8_t role);
 uint8_t bta_gattc_num_reg_app(void);
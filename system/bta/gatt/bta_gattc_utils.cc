@@ -140,10 +140,22 @@ tBTA_GATTC_CLCB* bta_gattc_find_clcb_by_cif(uint8_t client_if, const RawAddress&
  *
  ******************************************************************************/
 tBTA_GATTC_CLCB* bta_gattc_find_clcb_by_conn_id(tCONN_ID conn_id) {
+  /* conn_id is assigned in several places, so the lookup is checked before use
+   * and only acts as a cache of the scan below */
+  auto it = bta_gattc_cb.clcb_by_conn_id.find(conn_id);
+  if (it != bta_gattc_cb.clcb_by_conn_id.end()) {
+    if (it->second->in_use && it->second->bta_conn_id == conn_id) {
+      return it->second;
+    }
+    bta_gattc_cb.clcb_by_conn_id.erase(it);
+  }
+
+  tBTA_GATTC_CLCB* p_found = NULL;
   if (com::android::bluetooth::flags::gatt_client_dynamic_allocation()) {
     for (auto& p_clcb : bta_gattc_cb.clcb_set) {
       if (p_clcb->bta_conn_id == conn_id) {
-        return p_clcb.get();
+        p_found = p_clcb.get();
+        break;
       }
     }
   } else {
@@ -151,11 +163,16 @@ tBTA_GATTC_CLCB* bta_gattc_find_clcb_by_conn_id(tCONN_ID conn_id) {
 
     for (size_t i = 0; i < BTA_GATTC_CLCB_MAX; i++, p_clcb++) {
       if (p_clcb->in_use && p_clcb->bta_conn_id == conn_id) {
-        return p_clcb;
+        p_found = p_clcb;
+        break;
       }
     }
   }
-  return NULL;
+
+  if (p_found != NULL && p_found->in_use) {
+    bta_gattc_cb.clcb_by_conn_id[conn_id] = p_found;
+  }
+  return p_found;
 }
 
 /*******************************************************************************
@@ -314,6 +331,14 @@ void bta_gattc_clcb_dealloc(tBTA_GATTC_CLCB* p_clcb) {
     osi_free_and_reset((void**)&p_clcb->p_q_cmd);
   }
 
+  for (auto it = bta_gattc_cb.clcb_by_conn_id.begin(); it != bta_gattc_cb.clcb_by_conn_id.end();) {
+    if (it->second == p_clcb) {
+      it = bta_gattc_cb.clcb_by_conn_id.erase(it);
+    } else {
+      it++;
+    }
+  }
+
   /* Clear p_clcb. Some of the fields are already reset e.g. p_q_cmd_queue and
    * p_q_cmd. */
   if (com::android::bluetooth::flags::gatt_client_dynamic_allocation()) {
@@ -549,18 +574,90 @@ BtaEnqueuedResult_t bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_
  ******************************************************************************/
 bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg, tBTA_GATTC_SERV* p_srcb,
                                     tBTA_GATTC_NOTIFY* p_notify) {
-  uint8_t i;
-
-  for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-    if (p_clreg->notif_reg[i].in_use && p_clreg->notif_reg[i].remote_bda == p_srcb->server_bda &&
-        p_clreg->notif_reg[i].handle == p_notify->handle &&
-        !p_clreg->notif_reg[i].app_disconnected) {
-      log::verbose("Notification registered!");
-      return true;
-    }
+  tBTA_GATTC_NOTIF_REG* p_reg =
+          bta_gattc_find_notif_reg(p_clreg, p_srcb->server_bda, p_notify->handle);
+  if (p_reg != NULL && !p_reg->app_disconnected) {
+    log::verbose("Notification registered!");
+    return true;
   }
   return false;
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_find_notif_reg
+ *
+ * Description      find the notification registration of a client for a
+ *                  server attribute, through the client notification index.
+ *
+ * Returns          pointer to the registration, NULL if not registered.
+ *
+ ******************************************************************************/
+tBTA_GATTC_NOTIF_REG* bta_gattc_find_notif_reg(tBTA_GATTC_RCB* p_clreg,
+                                               const RawAddress& remote_bda, uint16_t handle) {
+  auto client = bta_gattc_cb.notif_index.find(p_clreg->client_if);
+  if (client == bta_gattc_cb.notif_index.end()) {
+    return NULL;
+  }
+  auto server = client->second.find(remote_bda);
+  if (server == client->second.end()) {
+    return NULL;
+  }
+  auto entry = server->second.find(handle);
+  if (entry == server->second.end()) {
+    return NULL;
+  }
+
+  tBTA_GATTC_NOTIF_REG* p_reg = &p_clreg->notif_reg[entry->second];
+  if (!p_reg->in_use || p_reg->remote_bda != remote_bda || p_reg->handle != handle) {
+    return NULL;
+  }
+  return p_reg;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_index_notif_reg
+ *
+ * Description      add a newly used notif_reg entry to the client
+ *                  notification index.
+ *
+ * Returns          None.
+ *
+ ******************************************************************************/
+void bta_gattc_index_notif_reg(tBTA_GATTC_RCB* p_clreg, uint8_t index) {
+  const tBTA_GATTC_NOTIF_REG& reg = p_clreg->notif_reg[index];
+  bta_gattc_cb.notif_index[p_clreg->client_if][reg.remote_bda][reg.handle] = index;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_unindex_notif_reg
+ *
+ * Description      remove a notif_reg entry from the client notification
+ *                  index, before the entry is cleared.
+ *
+ * Returns          None.
+ *
+ ******************************************************************************/
+void bta_gattc_unindex_notif_reg(tBTA_GATTC_RCB* p_clreg, uint8_t index) {
+  const tBTA_GATTC_NOTIF_REG& reg = p_clreg->notif_reg[index];
+  auto client = bta_gattc_cb.notif_index.find(p_clreg->client_if);
+  if (client == bta_gattc_cb.notif_index.end()) {
+    return;
+  }
+  auto server = client->second.find(reg.remote_bda);
+  if (server == client->second.end()) {
+    return;
+  }
+  server->second.erase(reg.handle);
+  if (server->second.empty()) {
+    client->second.erase(server);
+  }
+  if (client->second.empty()) {
+    bta_gattc_cb.notif_index.erase(client);
+  }
+}
 /*******************************************************************************
  *
  * Function         bta_gattc_clear_notif_registration
@@ -593,6 +690,7 @@ void bta_gattc_clear_notif_registration(tBTA_GATTC_SERV* p_srcb, tCONN_ID conn_i
            */
           handle = p_clrcb->notif_reg[i].handle;
           if (handle >= start_handle && handle <= end_handle) {
+            bta_gattc_unindex_notif_reg(p_clrcb, i);
             memset(&p_clrcb->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
           }
         }
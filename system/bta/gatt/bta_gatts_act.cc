@@ -26,6 +26,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "bta/gatt/bta_gatts_int.h"
@@ -395,6 +396,70 @@ void bta_gatts_indicate_handle(tBTA_GATTS_CB* p_cb, tBTA_GATTS_DATA* p_msg) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_gatts_multi_notify_impl
+ *
+ * Description      GATTS sends a burst of notifications to a client. Values
+ *                  held back by congestion are not reported to the application.
+ *
+ * Returns          none.
+ *
+ ******************************************************************************/
+void bta_gatts_multi_notify_impl(tCONN_ID conn_id, std::vector<tGATT_VALUE> values,
+                                 BTA_GATTS_MultipleValueNotificationCb cb) {
+  tGATT_IF gatt_if;
+  RawAddress remote_bda;
+  tBT_TRANSPORT transport;
+  tBTA_GATTS_RCB* p_rcb = NULL;
+  tGATT_STATUS status = GATT_ILLEGAL_PARAMETER;
+  uint16_t num_sent = 0;
+
+  if (GATT_GetConnectionInfor(conn_id, &gatt_if, remote_bda, &transport)) {
+    p_rcb = bta_gatts_find_app_rcb_by_app_if(gatt_if);
+
+    /* Every value must belong to a service registered by the sending application */
+    auto not_owned = std::find_if(values.begin(), values.end(), [p_rcb](const tGATT_VALUE& value) {
+      tBTA_GATTS_SRVC_CB* p_srvc_cb =
+              bta_gatts_find_srvc_cb_by_attr_id(&bta_gatts_cb, value.handle);
+      return p_rcb == NULL || p_srvc_cb == NULL ||
+             &bta_gatts_cb.rcb[p_srvc_cb->rcb_idx] != p_rcb;
+    });
+    if (not_owned != values.end()) {
+      log::error("Not a service attribute ID of gatt_if:{}: 0x{:x}", gatt_if, not_owned->handle);
+    } else {
+      status = GATTS_HandleMultipleValueNotification(conn_id, values, &num_sent);
+
+      /* if over BR_EDR, inform PM for mode change */
+      if (transport == BT_TRANSPORT_BR_EDR) {
+        bta_sys_busy(BTA_ID_GATTS, BTA_ALL_APP_ID, remote_bda);
+        bta_sys_idle(BTA_ID_GATTS, BTA_ALL_APP_ID, remote_bda);
+      }
+    }
+  } else {
+    log::error("Unknown connection_id=0x{:x} fail sending notifications", conn_id);
+  }
+
+  uint16_t num_completed =
+          status == GATT_CONGESTED ? num_sent : static_cast<uint16_t>(values.size());
+  if (p_rcb && p_rcb->p_cback) {
+    for (uint16_t i = 0; i < num_completed; i++) {
+      tBTA_GATTS cb_data;
+      cb_data.req_data.conn_id = conn_id;
+      if (i + 1 < num_sent) {
+        cb_data.req_data.status = GATT_SUCCESS;
+      } else if (i + 1 == num_sent) {
+        /* The last value sent carries the congestion */
+        cb_data.req_data.status = status == GATT_CONGESTED ? GATT_CONGESTED : GATT_SUCCESS;
+      } else {
+        cb_data.req_data.status = status;
+      }
+      (*p_rcb->p_cback)(BTA_GATTS_CONF_EVT, &cb_data);
+    }
+  }
+  std::move(cb).Run(conn_id, num_completed);
+}
+
 /*******************************************************************************
  *
  * Function         bta_gatts_open
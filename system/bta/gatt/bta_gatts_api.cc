@@ -256,6 +256,26 @@ void BTA_GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_id, std::ve
   bta_sys_sendmsg(p_buf);
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function is called to send several notifications to a
+ *                  client at once.
+ *
+ * Parameters       conn_id - connection identifier.
+ *                  values - attribute IDs and values to notify, in order.
+ *                  cb - called with the number of values reported.
+ *
+ * Returns          None
+ *
+ ******************************************************************************/
+void BTA_GATTS_HandleMultipleValueNotification(tCONN_ID conn_id, std::vector<tGATT_VALUE> values,
+                                               BTA_GATTS_MultipleValueNotificationCb cb) {
+  do_in_main_thread(base::BindOnce(&bta_gatts_multi_notify_impl, conn_id, std::move(values),
+                                   std::move(cb)));
+}
+
 /*******************************************************************************
  *
  * Function         BTA_GATTS_SendRsp
@@ -25,6 +25,7 @@
 #define BTA_GATTS_INT_H
 
 #include <cstdint>
+#include <vector>
 
 #include "bta/include/bta_gatt_api.h"
 #include "bta/sys/bta_sys.h"
@@ -181,6 +182,8 @@ void bta_gatts_stop_service(tBTA_GATTS_SRVC_CB* p_srvc_cb, tBTA_GATTS_DATA* p_ms
 
 void bta_gatts_send_rsp(tBTA_GATTS_CB* p_cb, tBTA_GATTS_DATA* p_msg);
 void bta_gatts_indicate_handle(tBTA_GATTS_CB* p_cb, tBTA_GATTS_DATA* p_msg);
+void bta_gatts_multi_notify_impl(tCONN_ID conn_id, std::vector<tGATT_VALUE> values,
+                                 BTA_GATTS_MultipleValueNotificationCb cb);
 
 void bta_gatts_open(tBTA_GATTS_CB* p_cb, tBTA_GATTS_DATA* p_msg);
 void bta_gatts_cancel_open(tBTA_GATTS_CB* p_cb, tBTA_GATTS_DATA* p_msg);
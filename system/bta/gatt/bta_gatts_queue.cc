@@ -16,11 +16,14 @@
 
 #define LOG_TAG "gatt"
 
+#include <base/functional/bind.h>
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <iterator>
 #include <list>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "bta_gatt_server_queue.h"
 #include "os/log.h"
@@ -31,8 +34,14 @@ using namespace bluetooth;
 
 constexpr uint8_t GATT_NOTIFY = 1;
 
+// Consecutive notifications sent together, packed in Multiple Handle Value
+// Notifications when the client supports them
+constexpr size_t kMaxNotificationBurst = 16;
+// Operations queued per connection beyond which producers get no more credits
+constexpr size_t kMaxQueuedOperations = 64;
+
 std::unordered_map<tCONN_ID, std::list<gatts_operation>> BtaGattServerQueue::gatts_op_queue;
-std::unordered_set<tCONN_ID> BtaGattServerQueue::gatts_op_queue_executing;
+std::unordered_map<tCONN_ID, size_t> BtaGattServerQueue::gatts_op_queue_executing;
 std::unordered_map<tCONN_ID, bool> BtaGattServerQueue::congestion_queue;
 
 void BtaGattServerQueue::mark_as_not_executing(tCONN_ID conn_id) {
@@ -78,9 +87,32 @@ void BtaGattServerQueue::gatts_execute_next_op(tCONN_ID conn_id) {
   gatts_operation op = map_ptr->second.front();
   log::verbose("op.type={}, attr_id={}", op.type, op.attr_id);
 
+  if (op.type == GATT_NOTIFY && !op.need_confirm) {
+    std::vector<tGATT_VALUE> values;
+    for (const auto& next_op : map_ptr->second) {
+      if (values.size() == kMaxNotificationBurst || next_op.type != GATT_NOTIFY ||
+          next_op.need_confirm || next_op.value.size() > GATT_MAX_ATTR_LEN) {
+        break;
+      }
+      tGATT_VALUE value = {.conn_id = conn_id,
+                           .handle = next_op.attr_id,
+                           .len = static_cast<uint16_t>(next_op.value.size())};
+      std::copy(next_op.value.begin(), next_op.value.end(), value.value);
+      values.push_back(value);
+    }
+
+    if (values.size() > 1) {
+      log::verbose("sending {} notifications at once", values.size());
+      gatts_op_queue_executing[conn_id] = values.size();
+      BTA_GATTS_HandleMultipleValueNotification(
+              conn_id, std::move(values), base::BindOnce(&BtaGattServerQueue::burst_completed));
+      return;
+    }
+  }
+
   if (op.type == GATT_NOTIFY) {
     BTA_GATTS_HandleValueIndication(conn_id, op.attr_id, op.value, op.need_confirm);
-    gatts_op_queue_executing.insert(conn_id);
+    gatts_op_queue_executing[conn_id] = 1;
   }
 }
 
@@ -89,6 +121,7 @@ void BtaGattServerQueue::Clean(tCONN_ID conn_id) {
 
   gatts_op_queue.erase(conn_id);
   gatts_op_queue_executing.erase(conn_id);
+  congestion_queue.erase(conn_id);
 }
 
 void BtaGattServerQueue::SendNotification(tCONN_ID conn_id, uint16_t handle,
@@ -105,12 +138,38 @@ void BtaGattServerQueue::NotificationCallback(tCONN_ID conn_id) {
     return;
   }
 
-  gatts_operation op = map_ptr->second.front();
+  // The values of a burst are accounted for by burst_completed()
+  auto executing = gatts_op_queue_executing.find(conn_id);
+  if (executing != gatts_op_queue_executing.end() && executing->second > 1) {
+    return;
+  }
+
   map_ptr->second.pop_front();
   mark_as_not_executing(conn_id);
   gatts_execute_next_op(conn_id);
 }
 
+void BtaGattServerQueue::burst_completed(tCONN_ID conn_id, uint16_t num_completed) {
+  if (!gatts_op_queue_executing.count(conn_id)) {
+    log::verbose("conn_id {} was cleaned up", conn_id);
+    return;
+  }
+
+  // Notifications held back by congestion stay at the front of the queue until
+  // the channel drains
+  if (num_completed < gatts_op_queue_executing[conn_id]) {
+    congestion_queue[conn_id] = true;
+  }
+
+  auto map_ptr = gatts_op_queue.find(conn_id);
+  if (map_ptr != gatts_op_queue.end()) {
+    auto& ops = map_ptr->second;
+    ops.erase(ops.begin(), std::next(ops.begin(), std::min<size_t>(num_completed, ops.size())));
+  }
+  mark_as_not_executing(conn_id);
+  gatts_execute_next_op(conn_id);
+}
+
 void BtaGattServerQueue::CongestionCallback(tCONN_ID conn_id, bool congested) {
   log::verbose("conn_id: {}, congested: {}", conn_id, congested);
 
@@ -119,3 +178,14 @@ void BtaGattServerQueue::CongestionCallback(tCONN_ID conn_id, bool congested) {
     gatts_execute_next_op(conn_id);
   }
 }
+
+size_t BtaGattServerQueue::GetNotificationCredits(tCONN_ID conn_id) {
+  auto congestion = congestion_queue.find(conn_id);
+  if (congestion != congestion_queue.end() && congestion->second) {
+    return 0;
+  }
+
+  auto map_ptr = gatts_op_queue.find(conn_id);
+  size_t num_queued = map_ptr == gatts_op_queue.end() ? 0 : map_ptr->second.size();
+  return num_queued < kMaxQueuedOperations ? kMaxQueuedOperations - num_queued : 0;
+}
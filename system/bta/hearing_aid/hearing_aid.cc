@@ -416,11 +416,11 @@ public:
       max_ce_len = overwrite_max_ce_len;
     }
 
-    log::info("L2CA_UpdateBleConnParams for device {} min_ce_len:{} max_ce_len:{}", address,
+    log::info("L2CA_SetBleConnDemand for device {} min_ce_len:{} max_ce_len:{}", address,
               min_ce_len, max_ce_len);
-    if (!stack::l2cap::get_interface().L2CA_UpdateBleConnParams(
-                address, connection_interval, connection_interval, 0x000A, 0x0064 /*1s*/,
-                min_ce_len, max_ce_len)) {
+    if (!stack::l2cap::get_interface().L2CA_SetBleConnDemand(
+                address, L2CAP_BLE_CONN_DEMAND_AUDIO, connection_interval, connection_interval,
+                0x000A, 0x0064 /*1s*/, min_ce_len, max_ce_len)) {
       log::warn("Unable to update L2CAP ble connection parameters peer:{}", address);
     }
     return connection_interval;
@@ -1831,6 +1831,8 @@ public:
     }
     hearingDevice->connection_update_status = NONE;
     hearingDevice->gap_opened = false;
+    stack::l2cap::get_interface().L2CA_ClearBleConnDemand(hearingDevice->address,
+                                                          L2CAP_BLE_CONN_DEMAND_AUDIO);
 
     if (hearingDevice->conn_id != INVALID_CONN_ID) {
       BtaGattQueue::Clean(hearingDevice->conn_id);
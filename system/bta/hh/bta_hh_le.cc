@@ -1402,8 +1402,9 @@ static void read_pref_conn_params_cb(tCONN_ID conn_id, tGATT_STATUS status, uint
 
   get_btm_client_interface().ble.BTM_BleSetPrefConnParams(
           p_dev_cb->link_spec.addrt.bda, min_interval, max_interval, latency, timeout);
-  if (!stack::l2cap::get_interface().L2CA_UpdateBleConnParams(
-              p_dev_cb->link_spec.addrt.bda, min_interval, max_interval, latency, timeout, 0, 0)) {
+  if (!stack::l2cap::get_interface().L2CA_SetBleConnDemand(p_dev_cb->link_spec.addrt.bda,
+                                                           L2CAP_BLE_CONN_DEMAND_HID, min_interval,
+                                                           max_interval, latency, timeout, 0, 0)) {
     log::warn("Unable to update L2CAP ble connection params peer:{}",
               p_dev_cb->link_spec.addrt.bda);
   }
@@ -1779,6 +1780,8 @@ void bta_hh_le_api_disc_act(tBTA_HH_DEV_CB* p_cb) {
   }
 
   BtaGattQueue::Clean(p_cb->conn_id);
+  stack::l2cap::get_interface().L2CA_ClearBleConnDemand(p_cb->link_spec.addrt.bda,
+                                                        L2CAP_BLE_CONN_DEMAND_HID);
   BTA_GATTC_Close(p_cb->conn_id);
   /* remove device from background connection if intended to disconnect,
      do not allow reconnection */
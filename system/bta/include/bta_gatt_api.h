@@ -977,6 +977,29 @@ void BTA_GATTS_StopService(uint16_t service_id);
 void BTA_GATTS_HandleValueIndication(tCONN_ID conn_id, uint16_t attr_id, std::vector<uint8_t> value,
                                      bool need_confirm);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function is called to send several notifications to a
+ *                  client at once. Each value sent or failed is reported by its
+ *                  own BTA_GATTS_CONF_EVT. Values held back because the channel
+ *                  got congested are not reported, and are left to the caller.
+ *
+ * Parameters       conn_id - connection identifier.
+ *                  values - attribute IDs and values to notify, in order.
+ *                  cb - called with the number of values reported, the first
+ *                  ones of |values|.
+ *
+ * Returns          None
+ *
+ ******************************************************************************/
+typedef base::OnceCallback<void(tCONN_ID conn_id, uint16_t num_completed)>
+        BTA_GATTS_MultipleValueNotificationCb;
+
+void BTA_GATTS_HandleMultipleValueNotification(tCONN_ID conn_id, std::vector<tGATT_VALUE> values,
+                                               BTA_GATTS_MultipleValueNotificationCb cb);
+
 /*******************************************************************************
  *
  * Function         BTA_GATTS_SendRsp
@@ -16,7 +16,6 @@
 
 #include <list>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "bta_gatt_api.h"
@@ -26,9 +25,14 @@ public:
   static void Clean(tCONN_ID conn_id);
   static void SendNotification(tCONN_ID conn_id, uint16_t handle, std::vector<uint8_t> value,
                                bool need_confirm);
+  /* To be called on each BTA_GATTS_CONF_EVT of conn_id */
   static void NotificationCallback(tCONN_ID conn_id);
   static void CongestionCallback(tCONN_ID conn_id, bool congested);
 
+  /* Number of notifications a producer can still queue for conn_id before they
+   * only add latency, zero while the connection is congested */
+  static size_t GetNotificationCredits(tCONN_ID conn_id);
+
   /* Holds pending GATT operations */
   struct gatts_operation {
     uint8_t type;
@@ -41,6 +45,7 @@ private:
   static bool is_congested;
   static void mark_as_not_executing(tCONN_ID conn_id);
   static void gatts_execute_next_op(tCONN_ID conn_id);
+  static void burst_completed(tCONN_ID conn_id, uint16_t num_completed);
 
   // maps connection id to operations waiting for execution
   static std::unordered_map<tCONN_ID, std::list<gatts_operation>> gatts_op_queue;
@@ -48,6 +53,7 @@ private:
   // maps connection id to congestion status of each device
   static std::unordered_map<tCONN_ID, bool> congestion_queue;
 
-  // contain connection ids that currently execute operations
-  static std::unordered_set<tCONN_ID> gatts_op_queue_executing;
+  // maps connection ids that currently execute operations to the number of
+  // operations sent at once
+  static std::unordered_map<tCONN_ID, size_t> gatts_op_queue_executing;
 };
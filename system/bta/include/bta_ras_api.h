@@ -37,6 +37,7 @@ public:
   virtual void OnVendorSpecificReply(
           const RawAddress& address,
           const std::vector<VendorSpecificCharacteristic>& vendor_specific_reply) = 0;
+  virtual void OnRasServerDisconnected(const RawAddress& address) = 0;
 };
 
 class RasServer {
@@ -49,6 +50,7 @@ public:
   virtual void HandleVendorSpecificReplyComplete(RawAddress address, bool success) = 0;
   virtual void PushProcedureData(RawAddress address, uint16_t procedure_count, bool is_last,
                                  std::vector<uint8_t> data) = 0;
+  virtual void DebugDump(int fd) = 0;
 };
 
 RasServer* GetRasServer();
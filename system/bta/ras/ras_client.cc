@@ -17,9 +17,12 @@
 #include <base/functional/bind.h>
 #include <base/functional/callback.h>
 
+#include <algorithm>
+
 #include "bta/include/bta_gatt_api.h"
 #include "bta/include/bta_ras_api.h"
 #include "bta/ras/ras_types.h"
+#include "common/time_util.h"
 #include "os/logging/log_adapter.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/btm_ble_addr.h"
@@ -70,6 +73,14 @@ public:
     std::vector<VendorSpecificCharacteristic> vendor_specific_characteristics_;
     uint8_t writeReplyCounter_ = 0;
     uint8_t writeReplySuccessCounter_ = 0;
+    // Ranging data reception statistics
+    uint8_t next_segment_counter_ = 0;
+    uint64_t first_segment_time_ms_ = 0;
+    uint32_t segments_received_ = 0;
+    uint32_t segments_lost_ = 0;
+    uint32_t procedures_received_ = 0;
+    uint64_t total_transfer_time_ms_ = 0;
+    uint64_t max_transfer_time_ms_ = 0;
 
     const gatt::Characteristic* FindCharacteristicByUuid(Uuid uuid) {
       for (auto& characteristic : service_->characteristics) {
@@ -219,6 +230,12 @@ public:
       BTA_GATTC_Close(evt.conn_id);
       return;
     }
+    log::info("segments received:{}, lost:{}, procedures:{}, avg transfer {}ms, max {}ms",
+              tracker->segments_received_, tracker->segments_lost_, tracker->procedures_received_,
+              tracker->procedures_received_ == 0
+                      ? 0
+                      : tracker->total_transfer_time_ms_ / tracker->procedures_received_,
+              tracker->max_transfer_time_ms_);
     callbacks_->OnDisconnected(tracker->address_for_cs_);
     trackers_.remove(tracker);
   }
@@ -348,12 +365,41 @@ public:
   }
 
   void OnRemoteData(const tBTA_GATTC_NOTIFY& evt, std::shared_ptr<RasTracker> tracker) {
-    std::vector<uint8_t> data;
-    data.resize(evt.len);
-    std::copy(evt.value, evt.value + evt.len, data.begin());
+    if (evt.len < kSegmentationHeaderSize) {
+      log::warn("Invalid segment, len {}", evt.len);
+      return;
+    }
+    UpdateSegmentStatistics(evt.value[0], tracker);
+    std::vector<uint8_t> data(evt.value, evt.value + evt.len);
     callbacks_->OnRemoteData(tracker->address_for_cs_, data);
   }
 
+  // Counts lost segments from gaps in the rolling segment counter, and the time
+  // between the first and the last segment of each procedure
+  void UpdateSegmentStatistics(uint8_t segmentation_header, std::shared_ptr<RasTracker> tracker) {
+    uint8_t counter = segmentation_header >> kRollingSegmentCounterShift;
+    uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+    tracker->segments_received_++;
+    if (segmentation_header & kFirstSegmentMask) {
+      tracker->first_segment_time_ms_ = now_ms;
+    } else if (counter != tracker->next_segment_counter_) {
+      uint8_t lost = (counter + kRollingSegmentCounterModulo - tracker->next_segment_counter_) %
+                     kRollingSegmentCounterModulo;
+      log::warn("Lost {} segments, expected counter {}, got {}", lost,
+                tracker->next_segment_counter_, counter);
+      tracker->segments_lost_ += lost;
+    }
+    tracker->next_segment_counter_ = (counter + 1) % kRollingSegmentCounterModulo;
+
+    if (segmentation_header & kLastSegmentMask) {
+      uint64_t transfer_time_ms = now_ms - tracker->first_segment_time_ms_;
+      tracker->procedures_received_++;
+      tracker->total_transfer_time_ms_ += transfer_time_ms;
+      tracker->max_transfer_time_ms_ = std::max(tracker->max_transfer_time_ms_, transfer_time_ms);
+      log::verbose("Procedure received in {}ms", transfer_time_ms);
+    }
+  }
+
   void OnControlPointEvent(const tBTA_GATTC_NOTIFY& evt, std::shared_ptr<RasTracker> tracker) {
     switch (evt.value[0]) {
       case (uint8_t)EventCode::COMPLETE_RANGING_DATA_RESPONSE: {
@@ -16,18 +16,30 @@
 
 #include <base/functional/bind.h>
 #include <base/functional/callback.h>
+#include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "bta/include/bta_gatt_api.h"
+#include "bta/include/bta_gatt_server_queue.h"
 #include "bta/include/bta_ras_api.h"
 #include "bta/ras/ras_types.h"
 #include "gd/hci/uuid.h"
 #include "gd/os/rand.h"
+#include "common/time_util.h"
 #include "os/logging/log_adapter.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/btm_ble_addr.h"
+#include "stack/include/gatt_api.h"
+#include "stack/include/main_thread.h"
 
 using namespace bluetooth;
 using namespace ::ras;
@@ -41,6 +53,7 @@ RasServerImpl* instance;
 
 static constexpr uint32_t kSupportedFeatures = feature::kRealTimeRangingData;
 static constexpr uint16_t kBufferSize = 3;
+static constexpr std::chrono::seconds kDumpTimeout = std::chrono::seconds(1);
 
 class RasServerImpl : public bluetooth::ras::RasServer {
 public:
@@ -52,9 +65,10 @@ public:
 
   // Struct to save data of specific ranging counter
   struct DataBuffer {
-    DataBuffer(uint16_t ranging_counter) : ranging_counter_(ranging_counter), segments_() {}
+    DataBuffer(uint16_t ranging_counter) : ranging_counter_(ranging_counter), data_() {}
     uint16_t ranging_counter_;
-    std::vector<std::vector<uint8_t>> segments_;
+    // Ranging data without segmentation headers, segmented to the MTU when sent
+    std::vector<uint8_t> data_;
   };
 
   struct PendingWriteResponse {
@@ -63,7 +77,27 @@ public:
     uint16_t write_req_handle_;
   };
 
+  // Loss and latency of the values sent to a client
+  struct Statistics {
+    uint32_t segments_sent_ = 0;
+    uint32_t failed_indications_ = 0;
+    uint32_t dropped_procedures_ = 0;
+    uint32_t confirmed_ = 0;
+    uint64_t total_confirm_latency_ms_ = 0;
+    uint64_t max_confirm_latency_ms_ = 0;
+
+    void Add(const Statistics& other) {
+      segments_sent_ += other.segments_sent_;
+      failed_indications_ += other.failed_indications_;
+      dropped_procedures_ += other.dropped_procedures_;
+      confirmed_ += other.confirmed_;
+      total_confirm_latency_ms_ += other.total_confirm_latency_ms_;
+      max_confirm_latency_ms_ = std::max(max_confirm_latency_ms_, other.max_confirm_latency_ms_);
+    }
+  };
+
   struct ClientTracker {
+    RawAddress address_;
     tCONN_ID conn_id_;
     std::unordered_map<Uuid, uint16_t> ccc_values_;
     std::vector<DataBuffer> buffers_;
@@ -72,6 +106,14 @@ public:
     PendingWriteResponse pending_write_response_;
     uint16_t last_ready_procedure_ = 0;
     uint16_t last_overwritten_procedure_ = 0;
+    // Real-time streaming
+    uint16_t real_time_counter_ = 0;
+    uint8_t real_time_segment_counter_ = 0;
+    bool real_time_skipping_ = true;
+    bool congested_ = false;
+    // When each value still waiting for BTA_GATTS_CONF_EVT was sent, oldest first
+    std::deque<uint64_t> pending_since_ms_;
+    Statistics statistics_;
   };
 
   void Initialize() {
@@ -122,17 +164,22 @@ public:
       log::warn("Can't find tracker for {}", ble_bd_addr.bda);
       return;
     }
+    if (data.size() < kSegmentationHeaderSize) {
+      log::warn("Invalid segment, size {}", data.size());
+      return;
+    }
     ClientTracker& tracker = trackers_[ble_bd_addr.bda];
     uint16_t ccc_real_time = tracker.ccc_values_[kRasRealTimeRangingDataCharacteristic];
     uint16_t ccc_data_ready = tracker.ccc_values_[kRasRangingDataReadyCharacteristic];
     uint16_t ccc_data_over_written = tracker.ccc_values_[kRasRangingDataOverWrittenCharacteristic];
 
+    // The segments are cut again to the MTU of the link, only the payload is kept
+    bool is_first = data[0] & kFirstSegmentMask;
+    const uint8_t* payload = data.data() + kSegmentationHeaderSize;
+    size_t payload_size = data.size() - kSegmentationHeaderSize;
+
     if (ccc_real_time != GATT_CLT_CONFIG_NONE) {
-      bool need_confirm = ccc_real_time & GATT_CLT_CONFIG_INDICATION;
-      uint16_t attr_id =
-              GetCharacteristic(kRasRealTimeRangingDataCharacteristic)->attribute_handle_;
-      log::debug("Send Real-time Ranging Data is_last {}", is_last);
-      BTA_GATTS_HandleValueIndication(tracker.conn_id_, attr_id, data, need_confirm);
+      PushRealTimeData(tracker, procedure_counter, is_first, is_last, payload, payload_size);
     }
 
     if (ccc_data_ready == GATT_CLT_CONFIG_NONE && ccc_data_over_written == GATT_CLT_CONFIG_NONE) {
@@ -140,7 +187,7 @@ public:
     }
     std::lock_guard<std::mutex> lock(on_demand_ranging_mutex_);
     DataBuffer& data_buffer = InitDataBuffer(ble_bd_addr.bda, procedure_counter);
-    data_buffer.segments_.push_back(data);
+    data_buffer.data_.insert(data_buffer.data_.end(), payload, payload + payload_size);
     tracker.last_ready_procedure_ = procedure_counter;
 
     // Send data ready
@@ -149,13 +196,13 @@ public:
         log::debug("Skip Ranging Data Ready");
       } else {
         bool need_confirm = ccc_data_ready & GATT_CLT_CONFIG_INDICATION;
-        log::debug("Send data ready, ranging_counter {}, total fragment {}", procedure_counter,
-                   data_buffer.segments_.size());
+        log::debug("Send data ready, ranging_counter {}, total size {}", procedure_counter,
+                   data_buffer.data_.size());
         uint16_t attr_id = GetCharacteristic(kRasRangingDataReadyCharacteristic)->attribute_handle_;
         std::vector<uint8_t> value(kRingingCounterSize);
         value[0] = (procedure_counter & 0xFF);
         value[1] = (procedure_counter >> 8) & 0xFF;
-        BTA_GATTS_HandleValueIndication(tracker.conn_id_, attr_id, value, need_confirm);
+        SendIndication(tracker, attr_id, std::move(value), need_confirm);
       }
     }
 
@@ -175,11 +222,91 @@ public:
       std::vector<uint8_t> value(kRingingCounterSize);
       value[0] = (begin->ranging_counter_ & 0xFF);
       value[1] = (begin->ranging_counter_ >> 8) & 0xFF;
-      BTA_GATTS_HandleValueIndication(tracker.conn_id_, attr_id, value, need_confirm);
+      SendIndication(tracker, attr_id, std::move(value), need_confirm);
       tracker.buffers_.erase(begin);
     }
   }
 
+  void PushRealTimeData(ClientTracker& tracker, uint16_t procedure_counter, bool is_first,
+                        bool is_last, const uint8_t* payload, size_t payload_size) {
+    if (is_first) {
+      tracker.real_time_counter_ = procedure_counter;
+      tracker.real_time_segment_counter_ = 0;
+      tracker.real_time_skipping_ = false;
+    } else if (procedure_counter != tracker.real_time_counter_) {
+      log::warn("Unexpected real-time data for counter {}, current {}", procedure_counter,
+                tracker.real_time_counter_);
+      return;
+    }
+    if (tracker.real_time_skipping_) {
+      return;
+    }
+
+    // Drop procedures while the client is behind, so that the ones it gets are
+    // recent. The size of a procedure is only known once its last fragment
+    // arrives, so every fragment is checked; the client discards a procedure
+    // that stops before its last segment.
+    size_t credits = BtaGattServerQueue::GetNotificationCredits(tracker.conn_id_);
+    if (credits < GetNumSegments(tracker, payload_size)) {
+      tracker.real_time_skipping_ = true;
+      tracker.statistics_.dropped_procedures_++;
+      log::warn("Drop real-time procedure {}, first fragment:{}, congested:{}, credits:{}",
+                procedure_counter, is_first, tracker.congested_, credits);
+      return;
+    }
+
+    uint16_t ccc_real_time = tracker.ccc_values_[kRasRealTimeRangingDataCharacteristic];
+    bool need_confirm = ccc_real_time & GATT_CLT_CONFIG_INDICATION;
+    uint16_t attr_id = GetCharacteristic(kRasRealTimeRangingDataCharacteristic)->attribute_handle_;
+    log::debug("Send Real-time Ranging Data is_last {}", is_last);
+    SendSegments(tracker, attr_id, need_confirm, payload, payload_size, is_first, is_last,
+                 tracker.real_time_segment_counter_);
+  }
+
+  // Sends |len| bytes of ranging data as RAS segments that each fit in a single
+  // notification on the link
+  void SendSegments(ClientTracker& tracker, uint16_t attr_id, bool need_confirm,
+                    const uint8_t* data, size_t len, bool first, bool last,
+                    uint8_t& rolling_segment_counter) {
+    size_t max_payload_size = GetMaxSegmentSize(tracker) - kSegmentationHeaderSize;
+    size_t offset = 0;
+    do {
+      size_t payload_size = std::min(max_payload_size, len - offset);
+      bool is_first = first && offset == 0;
+      bool is_last = last && offset + payload_size == len;
+      std::vector<uint8_t> segment(kSegmentationHeaderSize + payload_size);
+      segment[0] = (is_first ? kFirstSegmentMask : 0) | (is_last ? kLastSegmentMask : 0) |
+                   (rolling_segment_counter << kRollingSegmentCounterShift);
+      std::copy(data + offset, data + offset + payload_size,
+                segment.begin() + kSegmentationHeaderSize);
+      SendIndication(tracker, attr_id, std::move(segment), need_confirm);
+      tracker.statistics_.segments_sent_++;
+      rolling_segment_counter = (rolling_segment_counter + 1) % kRollingSegmentCounterModulo;
+      offset += payload_size;
+    } while (offset < len);
+  }
+
+  // The MTU is read from the bearer when a segment is built, an exchange may
+  // complete without this server being told
+  uint16_t GetMaxSegmentSize(const ClientTracker& tracker) {
+    return std::max<uint16_t>(GATT_GetPayloadSize(tracker.conn_id_), GATT_DEF_BLE_MTU_SIZE) -
+           kAttNotificationHeaderSize;
+  }
+
+  size_t GetNumSegments(const ClientTracker& tracker, size_t len) {
+    size_t max_payload_size = GetMaxSegmentSize(tracker) - kSegmentationHeaderSize;
+    return std::max<size_t>(1, (len + max_payload_size - 1) / max_payload_size);
+  }
+
+  // Every value sent is answered by BTA_GATTS_CONF_EVT, notifications included.
+  // The server queue packs consecutive notifications into bursts.
+  void SendIndication(ClientTracker& tracker, uint16_t attr_id, std::vector<uint8_t> value,
+                      bool need_confirm) {
+    tracker.pending_since_ms_.push_back(common::time_get_os_boottime_ms());
+    BtaGattServerQueue::SendNotification(tracker.conn_id_, attr_id, std::move(value),
+                                         need_confirm);
+  }
+
   void GattsCallback(tBTA_GATTS_EVT event, tBTA_GATTS* p_data) {
     log::info("event: {}", gatt_server_event_text(event));
     switch (event) {
@@ -204,6 +331,15 @@ public:
       case BTA_GATTS_WRITE_DESCRIPTOR_EVT: {
         OnWriteDescriptor(p_data);
       } break;
+      case BTA_GATTS_CONF_EVT: {
+        OnConfirmation(p_data);
+      } break;
+      case BTA_GATTS_CONGEST_EVT: {
+        OnCongestion(p_data);
+      } break;
+      case BTA_GATTS_MTU_EVT: {
+        log::debug("conn_id:{}", p_data->req_data.conn_id);
+      } break;
       default:
         log::warn("Unhandled event {}", event);
     }
@@ -220,6 +356,7 @@ public:
     if (trackers_.find(address) == trackers_.end()) {
       log::warn("Create new tracker");
     }
+    trackers_[address].address_ = address;
     trackers_[address].conn_id_ = p_data->conn.conn_id;
   }
 
@@ -227,8 +364,90 @@ public:
     auto address = p_data->conn.remote_bda;
     log::info("Address: {}, conn_id:{}", address, p_data->conn.conn_id);
     if (trackers_.find(address) != trackers_.end()) {
+      const Statistics& statistics = trackers_[address].statistics_;
+      log::info("segments sent:{}, failed:{}, dropped real-time procedures:{}",
+                statistics.segments_sent_, statistics.failed_indications_,
+                statistics.dropped_procedures_);
+      disconnected_statistics_.Add(statistics);
+      BtaGattServerQueue::Clean(trackers_[address].conn_id_);
       trackers_.erase(address);
+      callbacks_->OnRasServerDisconnected(address);
+    }
+  }
+
+  void OnConfirmation(tBTA_GATTS* p_data) {
+    ClientTracker* tracker = FindTrackerByConnId(p_data->req_data.conn_id);
+    if (tracker == nullptr) {
+      return;
+    }
+    if (!tracker->pending_since_ms_.empty()) {
+      Statistics& statistics = tracker->statistics_;
+      uint64_t latency_ms = common::time_get_os_boottime_ms() - tracker->pending_since_ms_.front();
+      tracker->pending_since_ms_.pop_front();
+      statistics.confirmed_++;
+      statistics.total_confirm_latency_ms_ += latency_ms;
+      statistics.max_confirm_latency_ms_ = std::max(statistics.max_confirm_latency_ms_, latency_ms);
+    }
+    // A congested channel still took the value
+    if (p_data->req_data.status != GATT_SUCCESS && p_data->req_data.status != GATT_CONGESTED) {
+      tracker->statistics_.failed_indications_++;
+      log::warn("Failed to send value, status {}", gatt_status_text(p_data->req_data.status));
     }
+    BtaGattServerQueue::NotificationCallback(tracker->conn_id_);
+  }
+
+  void OnCongestion(tBTA_GATTS* p_data) {
+    ClientTracker* tracker = FindTrackerByConnId(p_data->congest.conn_id);
+    if (tracker == nullptr) {
+      return;
+    }
+    log::debug("conn_id:{}, congested:{}", p_data->congest.conn_id, p_data->congest.congested);
+    tracker->congested_ = p_data->congest.congested;
+    BtaGattServerQueue::CongestionCallback(tracker->conn_id_, tracker->congested_);
+  }
+
+  void DebugDump(int fd) {
+    // The trackers are owned by the main thread, dumpsys runs on its own
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+    bt_status_t status = do_in_main_thread(base::BindOnce(
+            [](std::shared_ptr<std::promise<std::string>> promise) {
+              promise->set_value(instance ? instance->Dump() : std::string());
+            },
+            promise));
+    if (status != BT_STATUS_SUCCESS || future.wait_for(kDumpTimeout) != std::future_status::ready) {
+      dprintf(fd, "RAS server: main thread busy, not dumped\n");
+      return;
+    }
+    dprintf(fd, "%s", future.get().c_str());
+  }
+
+  std::string Dump() {
+    std::string dump = "RAS server\n";
+    for (const auto& [address, tracker] : trackers_) {
+      dump += base::StringPrintf("  %s conn_id:%d mtu:%d pending:%zu congested:%d credits:%zu\n",
+                                 ADDRESS_TO_LOGGABLE_CSTR(address), tracker.conn_id_,
+                                 GATT_GetPayloadSize(tracker.conn_id_),
+                                 tracker.pending_since_ms_.size(), tracker.congested_,
+                                 BtaGattServerQueue::GetNotificationCredits(tracker.conn_id_));
+      dump += DumpStatistics(tracker.statistics_);
+    }
+    dump += "  Disconnected clients\n";
+    dump += DumpStatistics(disconnected_statistics_);
+    return dump;
+  }
+
+  static std::string DumpStatistics(const Statistics& statistics) {
+    uint64_t average_latency_ms =
+            statistics.confirmed_ ? statistics.total_confirm_latency_ms_ / statistics.confirmed_
+                                  : 0;
+    return base::StringPrintf(
+            "    segments sent:%u failed:%u dropped real-time procedures:%u confirmed:%u "
+            "latency avg:%llums max:%llums\n",
+            statistics.segments_sent_, statistics.failed_indications_,
+            statistics.dropped_procedures_, statistics.confirmed_,
+            static_cast<unsigned long long>(average_latency_ms),
+            static_cast<unsigned long long>(statistics.max_confirm_latency_ms_));
   }
 
   void OnGattServerRegister(tBTA_GATTS* p_data) {
@@ -604,22 +823,21 @@ public:
                              return buffer.ranging_counter_ == ranging_counter;
                            });
     if (it != tracker->buffers_.end()) {
-      for (uint16_t i = 0; i < it->segments_.size(); i++) {
-        if (ccc_value == GATT_CLT_CONFIG_NONE) {
-          log::warn("On Demand Data is not subscribed, Skip");
-          break;
-        }
-        log::info("Send On Demand Ranging Data, segment {}", i);
-        BTA_GATTS_HandleValueIndication(tracker->conn_id_, attr_id, it->segments_[i], need_confirm);
+      if (ccc_value == GATT_CLT_CONFIG_NONE) {
+        log::warn("On Demand Data is not subscribed, Skip");
+      } else {
+        log::info("Send On Demand Ranging Data, size {}", it->data_.size());
+        uint8_t rolling_segment_counter = 0;
+        SendSegments(*tracker, attr_id, need_confirm, it->data_.data(), it->data_.size(), true,
+                     true, rolling_segment_counter);
       }
       log::info("Send COMPLETE_RANGING_DATA_RESPONSE, ranging_counter:{}", ranging_counter);
       std::vector<uint8_t> response(3, 0);
       response[0] = (uint8_t)EventCode::COMPLETE_RANGING_DATA_RESPONSE;
       response[1] = (ranging_counter & 0xFF);
       response[2] = (ranging_counter >> 8) & 0xFF;
-      BTA_GATTS_HandleValueIndication(
-              tracker->conn_id_,
-              GetCharacteristic(kRasControlPointCharacteristic)->attribute_handle_, response, true);
+      SendIndication(*tracker, GetCharacteristic(kRasControlPointCharacteristic)->attribute_handle_,
+                     std::move(response), true);
       tracker->handling_control_point_command_ = false;
       return;
     } else {
@@ -656,9 +874,8 @@ public:
     std::vector<uint8_t> response(2, 0);
     response[0] = (uint8_t)EventCode::RESPONSE_CODE;
     response[1] = (uint8_t)response_code_value;
-    BTA_GATTS_HandleValueIndication(
-            tracker->conn_id_, GetCharacteristic(kRasControlPointCharacteristic)->attribute_handle_,
-            response, true);
+    SendIndication(*tracker, GetCharacteristic(kRasControlPointCharacteristic)->attribute_handle_,
+                   std::move(response), true);
     tracker->handling_control_point_command_ = false;
   }
 
@@ -694,6 +911,15 @@ public:
     return nullptr;
   }
 
+  ClientTracker* FindTrackerByConnId(tCONN_ID conn_id) {
+    for (auto& [address, tracker] : trackers_) {
+      if (tracker.conn_id_ == conn_id) {
+        return &tracker;
+      }
+    }
+    return nullptr;
+  }
+
   RasCharacteristic* GetCharacteristicByCccHandle(uint16_t descriptor_handle) {
     for (auto& [attribute_handle, characteristic] : characteristics_) {
       if (characteristic.attribute_handle_ccc_ == descriptor_handle) {
@@ -739,6 +965,8 @@ private:
   std::unordered_map<uint16_t, RasCharacteristic> characteristics_;
   // A map to client trackers with address
   std::unordered_map<RawAddress, ClientTracker> trackers_;
+  // Statistics of the clients that have disconnected since the server started
+  Statistics disconnected_statistics_;
   bluetooth::ras::RasServerCallbacks* callbacks_;
   std::mutex on_demand_ranging_mutex_;
   std::vector<VendorSpecificCharacteristic> vendor_specific_characteristics_;
@@ -23,6 +23,17 @@ static const uint16_t kFeatureSize = 0x04;
 static const uint16_t kRingingCounterSize = 0x02;
 static const uint16_t kCccValueSize = 0x02;
 
+// RAS segments are carried in one notification each, after the ATT opcode and
+// attribute handle
+static const uint16_t kAttNotificationHeaderSize = 0x03;
+static const uint16_t kSegmentationHeaderSize = 0x01;
+
+// Segmentation header fields
+static const uint8_t kFirstSegmentMask = 0x01;
+static const uint8_t kLastSegmentMask = 0x02;
+static const uint8_t kRollingSegmentCounterShift = 2;
+static const uint8_t kRollingSegmentCounterModulo = 64;
+
 namespace uuid {
 static const uint16_t kRangingService16Bit = 0x7F7D;
 static const uint16_t kRasFeaturesCharacteristic16bit = 0x7F7C;
@@ -32,6 +32,7 @@
 #include "bta/test/bta_test_fixtures.h"
 #include "bta_api_data_types.h"
 #include "stack/btm/neighbor_inquiry.h"
+#include "test/mock/mock_osi_properties.h"
 #include "types/bt_transport.h"
 
 #define TEST_BT com::android::bluetooth::flags
@@ -43,6 +44,7 @@ using ::testing::Return;
 
 namespace {
 const RawAddress kRawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kRawAddress2({0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc});
 }
 
 // Test hooks
@@ -53,6 +55,7 @@ namespace testing {
 void bta_dm_disc_init_search_cb(tBTA_DM_SEARCH_CB& bta_dm_search_cb);
 bool bta_dm_read_remote_device_name(const RawAddress& bd_addr, tBT_TRANSPORT transport);
 tBTA_DM_SEARCH_CB& bta_dm_disc_search_cb();
+tBTA_DM_SERVICE_DISCOVERY_CB& bta_dm_discovery_cb();
 void bta_dm_discover_next_device();
 void bta_dm_sdp_find_services(tBTA_DM_SDP_STATE* state);
 void bta_dm_inq_cmpl();
@@ -207,6 +210,41 @@ TEST_F(BtaInitializedTest, bta_dm_disc_start_service_discovery__BT_TRANSPORT_BR_
   bta_dm_disc_override_sdp_performer_for_testing({});
 }
 
+// must be global, as capturing lambda can't be treated as function
+int concurrent_service_cb_call_cnt = 0;
+
+TEST_F(BtaInitializedTest, bta_dm_disc_start_service_discovery__concurrent_devices) {
+  test::mock::osi_properties::osi_property_get_int32.body =
+          [](const char* /* key */, int32_t default_value) { return default_value; };
+  bta_dm_disc_start(true);
+  std::vector<RawAddress> sdp_started;
+  base::RepeatingCallback<void(tBTA_DM_SDP_STATE*)> sdp_performer = base::BindLambdaForTesting(
+          [&](tBTA_DM_SDP_STATE* sdp_state) { sdp_started.push_back(sdp_state->bd_addr); });
+  bta_dm_disc_override_sdp_performer_for_testing(sdp_performer);
+  concurrent_service_cb_call_cnt = 0;
+
+  service_discovery_callbacks cbacks = {
+          nullptr, nullptr, [](RawAddress addr, const std::vector<bluetooth::Uuid>&, tBTA_STATUS) {
+            concurrent_service_cb_call_cnt++;
+          }};
+  bta_dm_disc_start_service_discovery(cbacks, kRawAddress, BT_TRANSPORT_BR_EDR);
+  bta_dm_disc_start_service_discovery(cbacks, kRawAddress2, BT_TRANSPORT_BR_EDR);
+
+  // Discovery towards the second device does not wait for the first one
+  ASSERT_EQ(sdp_started.size(), 2u);
+  EXPECT_EQ(sdp_started[0], kRawAddress);
+  EXPECT_EQ(sdp_started[1], kRawAddress2);
+  EXPECT_EQ(bluetooth::legacy::testing::bta_dm_discovery_cb().sessions.size(), 2u);
+
+  bta_dm_sdp_finished(kRawAddress2, BTA_SUCCESS, {}, {});
+  bta_dm_sdp_finished(kRawAddress, BTA_SUCCESS, {}, {});
+  EXPECT_EQ(concurrent_service_cb_call_cnt, 2);
+  EXPECT_TRUE(bluetooth::legacy::testing::bta_dm_discovery_cb().sessions.empty());
+
+  bta_dm_disc_override_sdp_performer_for_testing({});
+  test::mock::osi_properties::osi_property_get_int32 = {};
+}
+
 // must be global, as capturing lambda can't be treated as function
 int gatt_service_cb_call_cnt = 0;
 
@@ -292,3 +292,34 @@ TEST_F(BtaGattTest, bta_gattc_op_cmpl_read_interrupted) {
   bta_gattc_op_cmpl(&client_channel_control_block, &data);
   ASSERT_EQ(GATT_ERROR, param::bta_gatt_read_complete_callback.status);
 }
+
+TEST_F(BtaGattTest, bta_gattc_notif_registry_index) {
+  const RawAddress server_bda({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+  bta_gattc_cb = tBTA_GATTC_CB();
+  app_control_block.client_if = 3;
+  app_control_block.notif_reg[5] = {
+          .in_use = true,
+          .remote_bda = server_bda,
+          .handle = 0x20,
+  };
+  bta_gattc_index_notif_reg(&app_control_block, 5);
+
+  service_control_block.server_bda = server_bda;
+  tBTA_GATTC_NOTIFY notify = {};
+  notify.handle = 0x20;
+  ASSERT_TRUE(bta_gattc_check_notif_registry(&app_control_block, &service_control_block, &notify));
+  ASSERT_EQ(&app_control_block.notif_reg[5],
+            bta_gattc_find_notif_reg(&app_control_block, server_bda, 0x20));
+
+  notify.handle = 0x21;
+  ASSERT_FALSE(bta_gattc_check_notif_registry(&app_control_block, &service_control_block, &notify));
+
+  notify.handle = 0x20;
+  app_control_block.notif_reg[5].app_disconnected = true;
+  ASSERT_FALSE(bta_gattc_check_notif_registry(&app_control_block, &service_control_block, &notify));
+
+  bta_gattc_unindex_notif_reg(&app_control_block, 5);
+  app_control_block.notif_reg[5] = {};
+  ASSERT_EQ(nullptr, bta_gattc_find_notif_reg(&app_control_block, server_bda, 0x20));
+  ASSERT_TRUE(bta_gattc_cb.notif_index.empty());
+}
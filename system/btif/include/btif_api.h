@@ -32,6 +32,9 @@
 
 #include <hardware/bluetooth.h>
 
+#include <utility>
+#include <vector>
+
 #include "btif_common.h"
 #include "btif_dm.h"
 #include "types/raw_address.h"
@@ -250,6 +253,18 @@ void btif_dm_create_bond_le(const RawAddress bd_addr, uint8_t addr_type);
 void btif_dm_create_bond_out_of_band(const RawAddress bd_addr, tBT_TRANSPORT transport,
                                      const bt_oob_data_t p192_data, const bt_oob_data_t p256_data);
 
+/*******************************************************************************
+ *
+ * Function         btif_dm_create_bond_batch
+ *
+ * Description      Bond with a list of devices one after the other, e.g. when
+ *                  provisioning devices on a production line. Bonding keys
+ *                  are committed to storage once, after the last device, and
+ *                  the time taken by each bond is logged.
+ *
+ ******************************************************************************/
+void btif_dm_create_bond_batch(std::vector<std::pair<RawAddress, tBT_TRANSPORT>> targets);
+
 /*******************************************************************************
  *
  * Function         btif_dm_cancel_bond
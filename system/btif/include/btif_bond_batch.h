@@ -0,0 +1,90 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <base/functional/callback.h>
+#include <hardware/bluetooth.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "types/bt_transport.h"
+#include "types/raw_address.h"
+
+namespace bluetooth {
+namespace btif {
+
+// Bonds with a list of devices one after the other. The next device is started once the previous
+// one has reported its final bond state and the btif pairing control block is free again, or once
+// it has failed to do so within kTargetTimeout. Config writes to disk are held back for the whole
+// batch.
+class BondBatch {
+public:
+  static constexpr std::chrono::milliseconds kTargetTimeout{60000};
+
+  class Interface {
+  public:
+    virtual ~Interface() = default;
+    virtual void CreateBond(const RawAddress& bd_addr, tBT_TRANSPORT transport) = 0;
+    virtual void CancelBond(const RawAddress& bd_addr) = 0;
+    virtual bool IsPairingBusy() = 0;
+    virtual void BeginBatchedSave() = 0;
+    virtual void EndBatchedSave() = 0;
+    // Records the outcome and duration of the bond of one device of the batch
+    virtual void LogBondResult(const RawAddress& bd_addr, bt_bond_state_t state,
+                               uint64_t duration_ms) = 0;
+    virtual void PostDelayed(base::OnceClosure closure, std::chrono::milliseconds delay) = 0;
+  };
+
+  explicit BondBatch(Interface* interface) : interface_(interface) {}
+
+  void Add(std::vector<std::pair<RawAddress, tBT_TRANSPORT>> targets);
+  void OnBondStateChanged(const RawAddress& bd_addr, bt_bond_state_t state);
+  void OnPairingIdle();
+
+  // Drops the remaining targets and ends the batched save, if a batch is running
+  void Reset();
+
+  bool IsActive() const { return active_; }
+  size_t NumPending() const { return pending_.size(); }
+  size_t NumBonded() const { return num_bonded_; }
+  size_t NumFailed() const { return num_failed_; }
+
+private:
+  void StartNext();
+  void ArmTimeout();
+  void OnTimeout(uint64_t timeout_id);
+  void Finish();
+
+  Interface* interface_;
+  std::deque<std::pair<RawAddress, tBT_TRANSPORT>> pending_;
+  bool active_{false};
+  bool in_progress_{false};
+  bool bond_done_{false};
+  RawAddress current_{};
+  uint64_t batch_start_ms_{0};
+  uint64_t bond_start_ms_{0};
+  uint64_t timeout_id_{0};
+  size_t num_bonded_{0};
+  size_t num_failed_{0};
+};
+
+}  // namespace btif
+}  // namespace bluetooth
@@ -18,9 +18,13 @@
 
 #include <bluetooth/log.h>
 
+#include <cstdint>
+#include <functional>
+
 #include "common/postable_context.h"
 #include "include/hardware/bt_bqr.h"
 #include "osi/include/osi.h"
+#include "types/bt_transport.h"
 #include "types/raw_address.h"
 
 namespace bluetooth {
@@ -138,6 +142,9 @@ static constexpr int8_t kCriWarnRssi = -80;
 static constexpr uint8_t kCriWarnUnusedCh = 55;
 // The queue size of recording the BQR events.
 static constexpr uint8_t kBqrEventQueueSize = 25;
+// The number of latest Link Quality related events the link statistics are
+// computed over.
+static constexpr uint8_t kLinkQualityStatsWindow = 8;
 // The Property of BQR event mask configuration.
 static constexpr const char* kpPropertyEventMask = "persist.bluetooth.bqr.event_mask";
 // The Property of BQR Vendor Quality configuration.
@@ -382,6 +389,72 @@ public:
   std::tm tm_timestamp_ = {};
 };
 
+// Fields of a Link Quality related BQR event that the link statistics are
+// computed from.
+typedef struct {
+  // Boot time when the event was received, in milliseconds.
+  uint64_t timestamp_ms;
+  int8_t rssi;
+  uint8_t snr;
+  uint32_t retransmission_count;
+  uint32_t buffer_overflow_bytes;
+  uint32_t tx_total_packets;
+  uint32_t tx_flushed_packets;
+} BqrLinkQualityRecord;
+
+// Rolling statistics of a connection, over its latest kLinkQualityStatsWindow
+// Link Quality related events.
+typedef struct {
+  // Connection handle of the connection.
+  uint16_t connection_handle;
+  // Remote device address, empty if unknown.
+  RawAddress bdaddr;
+  // Quality report ID of the latest event.
+  uint8_t quality_report_id;
+  // The count of events since the statistics of the link were started.
+  uint32_t report_count;
+  // The latest event.
+  BqrLinkQualityRecord last_record;
+  // Average and minimum RSSI over the window.
+  int8_t rssi_average;
+  int8_t rssi_min;
+  // Average SNR over the window.
+  uint8_t snr_average;
+  // Counts summed over the window.
+  uint32_t retransmission_count;
+  uint32_t buffer_overflow_bytes;
+  uint32_t tx_total_packets;
+  uint32_t tx_flushed_packets;
+  // Time covered by the window, in milliseconds.
+  uint64_t window_duration_ms;
+} BqrLinkQualityStats;
+
+// Called on the main thread each time the statistics of a link are updated.
+using LinkQualityStatsCallback = std::function<void(const BqrLinkQualityStats& stats)>;
+
+// Subscribe to the statistics updates of all links, e.g. for the encoders to
+// adapt their bitrate to the link quality. Must be called on the main thread.
+//
+// @return an identifier for UnregisterLinkQualityStatsCallback.
+int RegisterLinkQualityStatsCallback(LinkQualityStatsCallback callback);
+
+// Unsubscribe from the statistics updates. Must be called on the main thread.
+void UnregisterLinkQualityStatsCallback(int callback_id);
+
+// Get the current statistics of a link. Must be called on the main thread.
+//
+// @param connection_handle Connection handle of the link.
+// @param p_stats Filled with the statistics if the link has any.
+// @return true if the link has statistics.
+bool GetLinkQualityStats(uint16_t connection_handle, BqrLinkQualityStats* p_stats);
+
+// Drop the statistics of the links of a device that went down. Must be called
+// on the main thread.
+//
+// @param bd_addr The remote device address.
+// @param transport The transport of the link that went down.
+void OnLinkDown(const RawAddress& bd_addr, tBT_TRANSPORT transport);
+
 BluetoothQualityReportInterface* getBluetoothQualityReportInterface();
 
 // Enable Bluetooth Quality Report mechanism.
@@ -53,5 +53,12 @@ size_t btif_config_get_bin_length(const std::string& section, const std::string&
 std::vector<RawAddress> btif_config_get_paired_devices();
 
 bool btif_config_clear(void);
+
+// Defer writing the config to disk until the matching
+// btif_config_end_batched_save(), then write everything changed in between at
+// once. Calls may nest.
+void btif_config_begin_batched_save(void);
+void btif_config_end_batched_save(void);
+
 bool btif_get_device_clockoffset(const RawAddress& bda, int* p_clock_offset);
 bool btif_set_device_clockoffset(const RawAddress& bda, int clock_offset);
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_btif_bond_batch"
+
+#include "btif/include/btif_bond_batch.h"
+
+#include <base/functional/bind.h>
+#include <bluetooth/log.h>
+
+#include "common/time_util.h"
+
+namespace bluetooth {
+namespace btif {
+
+void BondBatch::Add(std::vector<std::pair<RawAddress, tBT_TRANSPORT>> targets) {
+  log::info("Queueing {} devices for batch bonding", targets.size());
+
+  pending_.insert(pending_.end(), targets.begin(), targets.end());
+  if (active_) {
+    return;
+  }
+
+  active_ = true;
+  num_bonded_ = 0;
+  num_failed_ = 0;
+  batch_start_ms_ = common::time_get_os_boottime_ms();
+  interface_->BeginBatchedSave();
+  StartNext();
+}
+
+void BondBatch::OnBondStateChanged(const RawAddress& bd_addr, bt_bond_state_t state) {
+  if (!in_progress_ || bond_done_ || bd_addr != current_ || state == BT_BOND_STATE_BONDING) {
+    return;
+  }
+
+  const uint64_t elapsed_ms = common::time_get_os_boottime_ms() - bond_start_ms_;
+  if (state == BT_BOND_STATE_BONDED) {
+    num_bonded_++;
+  } else {
+    num_failed_++;
+  }
+  log::info("Batch bond {} {} in {} ms, {} left", bd_addr,
+            state == BT_BOND_STATE_BONDED ? "bonded" : "failed", elapsed_ms, pending_.size());
+  interface_->LogBondResult(bd_addr, state, elapsed_ms);
+
+  // The next bond is started from OnPairingIdle(), once service discovery is over
+  bond_done_ = true;
+}
+
+void BondBatch::OnPairingIdle() {
+  if (!active_) {
+    return;
+  }
+  if (in_progress_) {
+    if (!bond_done_) {
+      return;
+    }
+    in_progress_ = false;
+  }
+  StartNext();
+}
+
+void BondBatch::Reset() {
+  if (active_) {
+    log::warn("Dropping bond batch with {} devices left", pending_.size());
+    pending_.clear();
+    Finish();
+  }
+}
+
+void BondBatch::StartNext() {
+  if (!active_ || in_progress_) {
+    return;
+  }
+
+  if (pending_.empty()) {
+    Finish();
+    return;
+  }
+
+  // Another pairing holds the control block, wait for it to be released
+  if (interface_->IsPairingBusy()) {
+    ArmTimeout();
+    return;
+  }
+
+  auto [bd_addr, transport] = pending_.front();
+  pending_.pop_front();
+  current_ = bd_addr;
+  in_progress_ = true;
+  bond_done_ = false;
+  bond_start_ms_ = common::time_get_os_boottime_ms();
+  ArmTimeout();
+  interface_->CreateBond(bd_addr, transport);
+}
+
+void BondBatch::ArmTimeout() {
+  // Earlier timeouts still posted are recognised by their stale id and ignored
+  interface_->PostDelayed(
+          base::BindOnce(&BondBatch::OnTimeout, base::Unretained(this), ++timeout_id_),
+          kTargetTimeout);
+}
+
+void BondBatch::OnTimeout(uint64_t timeout_id) {
+  if (!active_ || timeout_id != timeout_id_) {
+    return;
+  }
+
+  if (!in_progress_) {
+    // The pairing control block was never released, give up on the rest of the batch
+    log::warn("Pairing still busy, dropping bond batch with {} devices left", pending_.size());
+    num_failed_ += pending_.size();
+    pending_.clear();
+    Finish();
+    return;
+  }
+
+  if (!bond_done_) {
+    log::warn("Batch bond {} timed out", current_);
+    num_failed_++;
+    interface_->LogBondResult(current_, BT_BOND_STATE_NONE,
+                              common::time_get_os_boottime_ms() - bond_start_ms_);
+    bond_done_ = true;
+    interface_->CancelBond(current_);
+  }
+  in_progress_ = false;
+  StartNext();
+}
+
+void BondBatch::Finish() {
+  const uint64_t elapsed_ms = common::time_get_os_boottime_ms() - batch_start_ms_;
+  log::info("Bond batch done bonded:{} failed:{} in {} ms", num_bonded_, num_failed_, elapsed_ms);
+
+  active_ = false;
+  in_progress_ = false;
+  bond_done_ = false;
+  current_ = RawAddress::kEmpty;
+  timeout_id_++;
+  interface_->EndBatchedSave();
+}
+
+}  // namespace btif
+}  // namespace bluetooth
@@ -21,8 +21,14 @@
 #endif
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "btif/include/btif_bqr.h"
 #include "btif/include/btif_common.h"
@@ -61,7 +67,22 @@ std::unique_ptr<BluetoothQualityReportInterface> bluetoothQualityReportInstance;
 
 namespace {
 common::PostableContext* to_bind_ = nullptr;
-}
+
+// The latest Link Quality records of a link in a ring buffer, and the
+// statistics computed from them.
+struct LinkQualityHistory {
+  std::array<BqrLinkQualityRecord, kLinkQualityStatsWindow> records{};
+  size_t next_record = 0;
+  size_t record_count = 0;
+  BqrLinkQualityStats stats{};
+};
+
+// Written on the main thread, read by the dumpsys thread as well.
+std::mutex link_quality_histories_mutex_;
+std::unordered_map<uint16_t, LinkQualityHistory> link_quality_histories_;
+std::map<int, LinkQualityStatsCallback> link_quality_stats_callbacks_;
+int next_link_quality_stats_callback_id_ = 0;
+}  // namespace
 
 void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length, const uint8_t* p_param_buf) {
   if (length < kLinkQualityParamTotalLen) {
@@ -382,6 +403,8 @@ void DisableBtQualityReport() {
   }
   EnableDisableBtQualityReport(false);
   to_bind_ = nullptr;
+  std::lock_guard<std::mutex> lock(link_quality_histories_mutex_);
+  link_quality_histories_.clear();
 }
 
 static void BqrVscCompleteCallback(hci::CommandCompleteView complete);
@@ -616,16 +639,129 @@ static void CategorizeBqrEvent(uint8_t length, const uint8_t* p_bqr_event) {
   }
 }
 
+// Add a Link Quality related BQR event to the statistics of its link, and
+// notify the subscribers.
+//
+// @param event The parsed Link Quality related BQR event.
+// @param bd_addr The remote device address of the link, empty if unknown.
+static void UpdateLinkQualityStats(const BqrLinkQualityEvent& event, const RawAddress& bd_addr) {
+  std::unique_lock<std::mutex> lock(link_quality_histories_mutex_);
+  LinkQualityHistory& history = link_quality_histories_[event.connection_handle];
+  if (history.record_count != 0 && !bd_addr.IsEmpty() && !history.stats.bdaddr.IsEmpty() &&
+      history.stats.bdaddr != bd_addr) {
+    // The connection handle was reused for another device
+    history = LinkQualityHistory{};
+  }
+
+  const BqrLinkQualityRecord record = {
+          .timestamp_ms = bluetooth::common::time_get_os_boottime_ms(),
+          .rssi = event.rssi,
+          .snr = event.snr,
+          .retransmission_count = event.retransmission_count,
+          .buffer_overflow_bytes = event.buffer_overflow_bytes,
+          .tx_total_packets = event.tx_total_packets,
+          .tx_flushed_packets = event.tx_flushed_packets,
+  };
+  history.records[history.next_record] = record;
+  history.next_record = (history.next_record + 1) % kLinkQualityStatsWindow;
+  history.record_count = std::min<size_t>(history.record_count + 1, kLinkQualityStatsWindow);
+
+  BqrLinkQualityStats& stats = history.stats;
+  stats.connection_handle = event.connection_handle;
+  if (!bd_addr.IsEmpty()) {
+    stats.bdaddr = bd_addr;
+  }
+  stats.quality_report_id = event.quality_report_id;
+  stats.report_count++;
+  stats.last_record = record;
+
+  int rssi_sum = 0;
+  uint32_t snr_sum = 0;
+  uint64_t oldest_timestamp_ms = record.timestamp_ms;
+  stats.rssi_min = INT8_MAX;
+  stats.retransmission_count = 0;
+  stats.buffer_overflow_bytes = 0;
+  stats.tx_total_packets = 0;
+  stats.tx_flushed_packets = 0;
+  for (size_t i = 0; i < history.record_count; i++) {
+    const BqrLinkQualityRecord& r = history.records[i];
+    rssi_sum += r.rssi;
+    snr_sum += r.snr;
+    stats.rssi_min = std::min(stats.rssi_min, r.rssi);
+    stats.retransmission_count += r.retransmission_count;
+    stats.buffer_overflow_bytes += r.buffer_overflow_bytes;
+    stats.tx_total_packets += r.tx_total_packets;
+    stats.tx_flushed_packets += r.tx_flushed_packets;
+    oldest_timestamp_ms = std::min(oldest_timestamp_ms, r.timestamp_ms);
+  }
+  stats.rssi_average = static_cast<int8_t>(rssi_sum / static_cast<int>(history.record_count));
+  stats.snr_average = static_cast<uint8_t>(snr_sum / history.record_count);
+  stats.window_duration_ms = record.timestamp_ms - oldest_timestamp_ms;
+
+  // Subscribers may query the statistics again, notify them without the lock
+  const BqrLinkQualityStats stats_copy = stats;
+  lock.unlock();
+  for (const auto& [callback_id, callback] : link_quality_stats_callbacks_) {
+    callback(stats_copy);
+  }
+}
+
+int RegisterLinkQualityStatsCallback(LinkQualityStatsCallback callback) {
+  int callback_id = next_link_quality_stats_callback_id_++;
+  link_quality_stats_callbacks_[callback_id] = std::move(callback);
+  return callback_id;
+}
+
+void UnregisterLinkQualityStatsCallback(int callback_id) {
+  link_quality_stats_callbacks_.erase(callback_id);
+}
+
+bool GetLinkQualityStats(uint16_t connection_handle, BqrLinkQualityStats* p_stats) {
+  std::lock_guard<std::mutex> lock(link_quality_histories_mutex_);
+  auto it = link_quality_histories_.find(connection_handle);
+  if (it == link_quality_histories_.end()) {
+    return false;
+  }
+  *p_stats = it->second.stats;
+  return true;
+}
+
+void OnLinkDown(const RawAddress& bd_addr, tBT_TRANSPORT transport) {
+  // The device may still be connected over the other transport
+  const tBT_TRANSPORT other_transport =
+          transport == BT_TRANSPORT_LE ? BT_TRANSPORT_BR_EDR : BT_TRANSPORT_LE;
+  const uint16_t live_handle =
+          get_btm_client_interface().peer.BTM_GetHCIConnHandle(bd_addr, other_transport);
+
+  std::lock_guard<std::mutex> lock(link_quality_histories_mutex_);
+  for (auto it = link_quality_histories_.begin(); it != link_quality_histories_.end();) {
+    if (it->second.stats.bdaddr == bd_addr && it->first != live_handle) {
+      it = link_quality_histories_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 // Record a new incoming Link Quality related BQR event in quality event queue.
 //
 // @param length Lengths of the Link Quality related BQR event.
 // @param p_link_quality_event A pointer to the Link Quality related BQR event.
 static void AddLinkQualityEventToQueue(uint8_t length, const uint8_t* p_link_quality_event) {
   std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
-  RawAddress bd_addr;
 
   p_bqr_event->ParseBqrLinkQualityEvt(length, p_link_quality_event);
 
+  RawAddress bd_addr = p_bqr_event->bqr_link_quality_event_.bdaddr;
+  if (bd_addr.IsEmpty()) {
+    tBTM_SEC_DEV_REC* dev =
+            btm_find_dev_by_handle(p_bqr_event->bqr_link_quality_event_.connection_handle);
+    if (dev != NULL) {
+      bd_addr = dev->RemoteAddress();
+    }
+  }
+  UpdateLinkQualityStats(p_bqr_event->bqr_link_quality_event_, bd_addr);
+
   GetInterfaceToProfiles()->events->invoke_link_quality_report_cb(
           bluetooth::common::time_get_os_boottime_ms(),
           p_bqr_event->bqr_link_quality_event_.quality_report_id,
@@ -663,15 +799,6 @@ static void AddLinkQualityEventToQueue(uint8_t length, const uint8_t* p_link_qua
   BluetoothQualityReportInterface* bqrItf = getBluetoothQualityReportInterface();
 
   if (bqrItf != NULL) {
-    bd_addr = p_bqr_event->bqr_link_quality_event_.bdaddr;
-    if (bd_addr.IsEmpty()) {
-      tBTM_SEC_DEV_REC* dev =
-              btm_find_dev_by_handle(p_bqr_event->bqr_link_quality_event_.connection_handle);
-      if (dev != NULL) {
-        bd_addr = dev->RemoteAddress();
-      }
-    }
-
     if (!bd_addr.IsEmpty()) {
       bqrItf->bqr_delivery_event(bd_addr, p_link_quality_event, length);
     } else {
@@ -764,11 +891,39 @@ static int OpenBtSchedulingTraceLogFile() {
   return logfile_fd;
 }
 
+// Dump the rolling statistics of the links.
+//
+// @param fd The file descriptor to use for dumping information.
+static void DumpLinkQualityStats(int fd) {
+  std::vector<BqrLinkQualityStats> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(link_quality_histories_mutex_);
+    for (const auto& [handle, history] : link_quality_histories_) {
+      snapshot.push_back(history.stats);
+    }
+  }
+  if (snapshot.empty()) {
+    return;
+  }
+
+  dprintf(fd, "BT Link Quality Statistics (last %u events): \n", kLinkQualityStatsWindow);
+  for (const BqrLinkQualityStats& stats : snapshot) {
+    dprintf(fd,
+            "   Handle: 0x%04x, Reports: %u, RSSI avg/min: %d/%d dBm, SNR avg: %u dB, "
+            "Retrans: %u, OverFlow: %u, Flushed: %u/%u, Window: %llu ms\n",
+            stats.connection_handle, stats.report_count, stats.rssi_average, stats.rssi_min, stats.snr_average,
+            stats.retransmission_count, stats.buffer_overflow_bytes, stats.tx_flushed_packets,
+            stats.tx_total_packets, static_cast<unsigned long long>(stats.window_duration_ms));
+  }
+  dprintf(fd, "\n");
+}
+
 void DebugDump(int fd) {
   dprintf(fd, "\nBT Quality Report Events: \n");
 
   if (kpBqrEventQueue.Empty()) {
     dprintf(fd, "Event queue is empty.\n");
+    DumpLinkQualityStats(fd);
     return;
   }
 
@@ -786,6 +941,7 @@ void DebugDump(int fd) {
   }
 
   dprintf(fd, "\n");
+  DumpLinkQualityStats(fd);
 }
 
 static bt_remote_version_t btif_get_remote_version(const RawAddress& bd_addr) {
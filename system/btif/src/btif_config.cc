@@ -320,3 +320,15 @@ bool btif_config_clear(void) {
   bluetooth::shim::BtifConfigInterface::Clear();
   return true;
 }
+
+void btif_config_begin_batched_save(void) {
+  log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
+                   "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bluetooth::shim::BtifConfigInterface::BeginBatchedSave();
+}
+
+void btif_config_end_batched_save(void) {
+  log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
+                   "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  bluetooth::shim::BtifConfigInterface::EndBatchedSave();
+}
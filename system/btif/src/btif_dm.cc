@@ -46,6 +46,7 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <mutex>
 #include <optional>
 
@@ -57,6 +58,7 @@
 #include "bta/include/bta_hh_api.h"
 #include "btif/include/stack_manager_t.h"
 #include "btif_api.h"
+#include "btif_bond_batch.h"
 #include "btif_bqr.h"
 #include "btif_config.h"
 #include "btif_dm.h"
@@ -273,6 +275,31 @@ static void btif_dm_save_ble_bonding_keys(RawAddress& bd_addr);
 static btif_dm_pairing_cb_t pairing_cb;
 static btif_dm_oob_cb_t oob_cb;
 static btif_dm_metadata_cb_t metadata_cb{.le_audio_cache{40}};
+static void btif_dm_bond_batch_on_pairing_idle();
+
+/* Drives btif_dm_create_bond_batch() through the regular bonding API */
+class BtifDmBondBatchInterface : public bluetooth::btif::BondBatch::Interface {
+public:
+  void CreateBond(const RawAddress& bd_addr, tBT_TRANSPORT transport) override {
+    btif_dm_create_bond(bd_addr, transport);
+  }
+  void CancelBond(const RawAddress& bd_addr) override { btif_dm_cancel_bond(bd_addr); }
+  bool IsPairingBusy() override { return btif_dm_pairing_is_busy(); }
+  void BeginBatchedSave() override { btif_config_begin_batched_save(); }
+  void EndBatchedSave() override { btif_config_end_batched_save(); }
+  void LogBondResult(const RawAddress& bd_addr, bt_bond_state_t state,
+                     uint64_t duration_ms) override {
+    BTM_LogHistory(kBtmLogTag, bd_addr, "Batch bond",
+                   base::StringPrintf("bond_state:%u duration_ms:%llu", state,
+                                      static_cast<unsigned long long>(duration_ms)));
+  }
+  void PostDelayed(base::OnceClosure closure, std::chrono::milliseconds delay) override {
+    do_in_main_thread_delayed(std::move(closure), delay);
+  }
+};
+
+static BtifDmBondBatchInterface bond_batch_interface;
+static bluetooth::btif::BondBatch bond_batch(&bond_batch_interface);
 static void btif_dm_cb_create_bond(const RawAddress bd_addr, tBT_TRANSPORT transport);
 static void btif_dm_cb_create_bond_le(const RawAddress bd_addr, tBLE_ADDR_TYPE addr_type);
 static btif_dm_local_key_cb_t ble_local_key_cb;
@@ -314,6 +341,8 @@ static bool is_bonding_or_sdp() {
 void btif_dm_init(uid_set_t* set) { uid_set = set; }
 
 void btif_dm_cleanup(void) {
+  bond_batch.Reset();
+
   if (uid_set) {
     uid_set_destroy(uid_set);
     uid_set = NULL;
@@ -597,6 +626,7 @@ static void bond_state_changed(bt_status_t status, const RawAddress& bd_addr,
                   hci_reason_code_text(to_hci_reason_code(pairing_cb.fail_reason)).c_str()));
   GetInterfaceToProfiles()->events->invoke_bond_state_changed_cb(status, bd_addr, state,
                                                                  pairing_cb.fail_reason);
+  bond_batch.OnBondStateChanged(bd_addr, state);
 
   if ((state == BT_BOND_STATE_NONE) && (pairing_cb.bd_addr != bd_addr) && is_bonding_or_sdp()) {
     log::warn("Ignoring bond state changed for unexpected device: {} pairing: {}", bd_addr,
@@ -614,6 +644,7 @@ static void bond_state_changed(bt_status_t status, const RawAddress& bd_addr,
   } else {
     log::debug("clearing btif pairing_cb");
     pairing_cb = {};
+    btif_dm_bond_batch_on_pairing_idle();
   }
 }
 
@@ -1682,6 +1713,7 @@ static void btif_on_service_discovery_results(RawAddress bd_addr,
       // it is not already cleared
       pairing_cb = {};
       log::debug("clearing btif pairing_cb");
+      btif_dm_bond_batch_on_pairing_idle();
     }
   }
 
@@ -1733,6 +1765,7 @@ void btif_on_gatt_results(RawAddress bd_addr, std::vector<bluetooth::Uuid>& serv
         // we are safe to clear the service discovery part of CB.
         log::debug("clearing pairing_cb");
         pairing_cb = {};
+        btif_dm_bond_batch_on_pairing_idle();
       }
 
       if (lea_supported) {
@@ -2220,6 +2253,7 @@ void btif_dm_acl_evt(tBTA_DM_ACL_EVT event, tBTA_DM_ACL* p_data) {
       bd_addr = p_data->link_down.bd_addr;
       btm_set_bond_type_dev(p_data->link_down.bd_addr, BOND_TYPE_UNKNOWN);
       GetInterfaceToProfiles()->onLinkDown(bd_addr, p_data->link_down.transport_link_type);
+      bluetooth::bqr::OnLinkDown(bd_addr, p_data->link_down.transport_link_type);
 
       bt_conn_direction_t direction;
       switch (btm_get_acl_disc_reason_code()) {
@@ -2379,6 +2413,33 @@ void btif_dm_create_bond_le(const RawAddress bd_addr, tBLE_ADDR_TYPE addr_type)
   btif_dm_cb_create_bond_le(bd_addr, addr_type);
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_dm_bond_batch_on_pairing_idle
+ *
+ * Description      Let a running bond batch move on to its next device now
+ *                  that the pairing control block has been cleared
+ *
+ ******************************************************************************/
+static void btif_dm_bond_batch_on_pairing_idle() {
+  if (!bond_batch.IsActive()) {
+    return;
+  }
+  do_in_main_thread(base::BindOnce([]() { bond_batch.OnPairingIdle(); }));
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_dm_create_bond_batch
+ *
+ * Description      Bond with each of the given devices in turn, committing
+ *                  the bonding keys to storage once after the last one
+ *
+ ******************************************************************************/
+void btif_dm_create_bond_batch(std::vector<std::pair<RawAddress, tBT_TRANSPORT>> targets) {
+  bond_batch.Add(std::move(targets));
+}
+
 /*******************************************************************************
  *
  * Function         btif_dm_create_bond_out_of_band
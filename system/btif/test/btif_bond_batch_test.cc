@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif/include/btif_bond_batch.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using bluetooth::btif::BondBatch;
+using ::testing::_;
+using ::testing::Return;
+
+namespace {
+const RawAddress kRawAddress1 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+const RawAddress kRawAddress2 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x77}};
+const RawAddress kRawAddress3 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x88}};
+
+class MockBondBatchInterface : public BondBatch::Interface {
+public:
+  MOCK_METHOD(void, CreateBond, (const RawAddress& bd_addr, tBT_TRANSPORT transport), (override));
+  MOCK_METHOD(void, CancelBond, (const RawAddress& bd_addr), (override));
+  MOCK_METHOD(bool, IsPairingBusy, (), (override));
+  MOCK_METHOD(void, BeginBatchedSave, (), (override));
+  MOCK_METHOD(void, EndBatchedSave, (), (override));
+  MOCK_METHOD(void, LogBondResult,
+              (const RawAddress& bd_addr, bt_bond_state_t state, uint64_t duration_ms),
+              (override));
+
+  void PostDelayed(base::OnceClosure closure, std::chrono::milliseconds /* delay */) override {
+    delayed_.push_back(std::move(closure));
+  }
+
+  // Runs every timeout posted so far, as if they had all expired
+  void ExpireTimeouts() {
+    auto delayed = std::move(delayed_);
+    delayed_.clear();
+    for (auto& closure : delayed) {
+      std::move(closure).Run();
+    }
+  }
+
+  std::vector<base::OnceClosure> delayed_;
+};
+}  // namespace
+
+class BtifBondBatchTest : public ::testing::Test {
+protected:
+  void SetUp() override { ON_CALL(interface_, IsPairingBusy).WillByDefault(Return(false)); }
+
+  // Reports the final bond state of a device and releases the pairing control block
+  void CompleteBond(const RawAddress& bd_addr, bt_bond_state_t state) {
+    bond_batch_.OnBondStateChanged(bd_addr, state);
+    bond_batch_.OnPairingIdle();
+  }
+
+  ::testing::NiceMock<MockBondBatchInterface> interface_;
+  BondBatch bond_batch_{&interface_};
+};
+
+TEST_F(BtifBondBatchTest, bonds_devices_in_turn) {
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(interface_, BeginBatchedSave());
+    EXPECT_CALL(interface_, CreateBond(kRawAddress1, BT_TRANSPORT_BR_EDR));
+    EXPECT_CALL(interface_, CreateBond(kRawAddress2, BT_TRANSPORT_LE));
+    EXPECT_CALL(interface_, EndBatchedSave());
+  }
+
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}, {kRawAddress2, BT_TRANSPORT_LE}});
+  ASSERT_TRUE(bond_batch_.IsActive());
+  ASSERT_EQ(1u, bond_batch_.NumPending());
+
+  // Neither the bonding state nor another device advance the batch
+  bond_batch_.OnBondStateChanged(kRawAddress1, BT_BOND_STATE_BONDING);
+  CompleteBond(kRawAddress3, BT_BOND_STATE_BONDED);
+  ASSERT_EQ(1u, bond_batch_.NumPending());
+
+  EXPECT_CALL(interface_, LogBondResult(kRawAddress1, BT_BOND_STATE_BONDED, _));
+  CompleteBond(kRawAddress1, BT_BOND_STATE_BONDED);
+  ASSERT_EQ(0u, bond_batch_.NumPending());
+
+  CompleteBond(kRawAddress2, BT_BOND_STATE_NONE);
+  ASSERT_FALSE(bond_batch_.IsActive());
+  ASSERT_EQ(1u, bond_batch_.NumBonded());
+  ASSERT_EQ(1u, bond_batch_.NumFailed());
+}
+
+TEST_F(BtifBondBatchTest, waits_for_service_discovery) {
+  EXPECT_CALL(interface_, CreateBond(kRawAddress1, _));
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}, {kRawAddress2, BT_TRANSPORT_BR_EDR}});
+
+  // Bonded, but service discovery still holds the pairing control block
+  EXPECT_CALL(interface_, CreateBond(kRawAddress2, _)).Times(0);
+  bond_batch_.OnBondStateChanged(kRawAddress1, BT_BOND_STATE_BONDED);
+  ::testing::Mock::VerifyAndClearExpectations(&interface_);
+
+  EXPECT_CALL(interface_, CreateBond(kRawAddress2, _));
+  bond_batch_.OnPairingIdle();
+}
+
+TEST_F(BtifBondBatchTest, waits_for_other_pairing) {
+  EXPECT_CALL(interface_, IsPairingBusy()).WillOnce(Return(true));
+  EXPECT_CALL(interface_, CreateBond(_, _)).Times(0);
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}});
+  ::testing::Mock::VerifyAndClearExpectations(&interface_);
+
+  EXPECT_CALL(interface_, CreateBond(kRawAddress1, _));
+  bond_batch_.OnPairingIdle();
+}
+
+TEST_F(BtifBondBatchTest, timeout_moves_to_next_device) {
+  EXPECT_CALL(interface_, CreateBond(kRawAddress1, _));
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}, {kRawAddress2, BT_TRANSPORT_BR_EDR}});
+
+  // The first device never reports its bond state
+  EXPECT_CALL(interface_, CancelBond(kRawAddress1));
+  EXPECT_CALL(interface_, LogBondResult(kRawAddress1, BT_BOND_STATE_NONE, _));
+  EXPECT_CALL(interface_, CreateBond(kRawAddress2, _));
+  interface_.ExpireTimeouts();
+  ASSERT_EQ(1u, bond_batch_.NumFailed());
+
+  // A late report from the first device is not counted nor logged again
+  EXPECT_CALL(interface_, LogBondResult(kRawAddress1, _, _)).Times(0);
+  CompleteBond(kRawAddress1, BT_BOND_STATE_NONE);
+  ASSERT_EQ(1u, bond_batch_.NumFailed());
+  ASSERT_TRUE(bond_batch_.IsActive());
+
+  EXPECT_CALL(interface_, EndBatchedSave());
+  CompleteBond(kRawAddress2, BT_BOND_STATE_BONDED);
+  ASSERT_FALSE(bond_batch_.IsActive());
+}
+
+TEST_F(BtifBondBatchTest, stale_timeout_is_ignored) {
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}, {kRawAddress2, BT_TRANSPORT_BR_EDR}});
+  CompleteBond(kRawAddress1, BT_BOND_STATE_BONDED);
+
+  // Only the timeout of the second device may cancel it
+  EXPECT_CALL(interface_, CancelBond(kRawAddress1)).Times(0);
+  EXPECT_CALL(interface_, CancelBond(kRawAddress2)).Times(1);
+  auto delayed = std::move(interface_.delayed_);
+  interface_.delayed_.clear();
+  std::move(delayed.front()).Run();
+  ASSERT_TRUE(bond_batch_.IsActive());
+  std::move(delayed.back()).Run();
+}
+
+TEST_F(BtifBondBatchTest, pairing_never_released_ends_batch) {
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}, {kRawAddress2, BT_TRANSPORT_BR_EDR}});
+
+  ON_CALL(interface_, IsPairingBusy).WillByDefault(Return(true));
+  CompleteBond(kRawAddress1, BT_BOND_STATE_BONDED);
+  ASSERT_TRUE(bond_batch_.IsActive());
+
+  EXPECT_CALL(interface_, EndBatchedSave());
+  interface_.ExpireTimeouts();
+  ASSERT_FALSE(bond_batch_.IsActive());
+  ASSERT_EQ(1u, bond_batch_.NumBonded());
+  ASSERT_EQ(1u, bond_batch_.NumFailed());
+}
+
+TEST_F(BtifBondBatchTest, reset_ends_batched_save) {
+  bond_batch_.Add({{kRawAddress1, BT_TRANSPORT_BR_EDR}, {kRawAddress2, BT_TRANSPORT_BR_EDR}});
+
+  EXPECT_CALL(interface_, EndBatchedSave());
+  bond_batch_.Reset();
+  ASSERT_FALSE(bond_batch_.IsActive());
+  ASSERT_EQ(0u, bond_batch_.NumPending());
+
+  // Timeouts of the dropped batch do nothing
+  EXPECT_CALL(interface_, CancelBond(_)).Times(0);
+  interface_.ExpireTimeouts();
+}
+
+TEST_F(BtifBondBatchTest, reset_without_batch_does_nothing) {
+  EXPECT_CALL(interface_, EndBatchedSave()).Times(0);
+  bond_batch_.Reset();
+}
@@ -875,6 +875,41 @@ TEST_F(BtifCoreWithVendorSupportTest, send_a2dp_audio_choppy) {
   ASSERT_EQ(std::future_status::ready, event_reported.wait_for(std::chrono::seconds(1)));
 }
 
+TEST_F(BtifCoreWithVendorSupportTest, link_quality_stats) {
+  static std::promise<bluetooth::bqr::BqrLinkQualityStats> stats_promise;
+  stats_promise = std::promise<bluetooth::bqr::BqrLinkQualityStats>();
+  auto stats_reported = stats_promise.get_future();
+  static int callback_id;
+  do_in_main_thread(BindOnce([]() {
+    callback_id = bluetooth::bqr::RegisterLinkQualityStatsCallback(
+            [](const bluetooth::bqr::BqrLinkQualityStats& stats) {
+              stats_promise.set_value(stats);
+            });
+  }));
+
+  auto view = VendorSpecificEventView::Create(
+          EventView::Create(BuilderToView(BqrLinkQualityEventBuilder::Create(
+                  QualityReportId::MONITOR_MODE, BqrPacketType::TYPE_3DH3, 0x123, Role::CENTRAL,
+                  1, 0xc4 /* rssi -60 */, 30 /* snr */, 4, 5, 6, 7, 8 /* retransmission_count */, 9,
+                  10, 11, 12, 13, 14 /* buffer_overflow_bytes */, 15,
+                  std::make_unique<RawBuilder>()))));
+  EXPECT_TRUE(view.IsValid());
+  vse_callback_(view);
+  ASSERT_EQ(std::future_status::ready, stats_reported.wait_for(std::chrono::seconds(1)));
+
+  auto stats = stats_reported.get();
+  ASSERT_EQ(0x123, stats.connection_handle);
+  ASSERT_EQ(1u, stats.report_count);
+  ASSERT_EQ(-60, stats.rssi_average);
+  ASSERT_EQ(-60, stats.rssi_min);
+  ASSERT_EQ(30, stats.snr_average);
+  ASSERT_EQ(8u, stats.retransmission_count);
+  ASSERT_EQ(14u, stats.buffer_overflow_bytes);
+
+  do_in_main_thread(
+          BindOnce([]() { bluetooth::bqr::UnregisterLinkQualityStatsCallback(callback_id); }));
+}
+
 TEST_F(BtifCoreWithVendorSupportTest, send_lmp_ll_trace) {
   auto payload = std::make_unique<RawBuilder>();
   payload->AddOctets({'d', 'a', 't', 'a'});
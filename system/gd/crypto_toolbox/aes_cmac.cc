@@ -63,23 +63,33 @@ static void xor_128(Octet16* a, const Octet16& b) {
 }
 }  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
+/** Expand the AES-128 key schedule of |key|, given in little endian order */
+static void aes_128_set_key(const Octet16& key, aes_context* ctx) {
   Octet16 key_reversed;
+
+  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+  aes_set_key(key_reversed.data(), key_reversed.size(), ctx);
+}
+
+/** Encrypt |message| with an expanded key schedule, little endian order */
+static Octet16 aes_128_encrypt(const aes_context& ctx, const Octet16& message) {
   Octet16 message_reversed;
   Octet16 output;
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
   std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
-
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
   aes_encrypt(message_reversed.data(), output.data(), &ctx);
 
   std::reverse(output.begin(), output.end());
   return output;
 }
 
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+  return aes_128_encrypt(ctx, message);
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * kOctet16Length memory space; where include length bytes valid data. */
@@ -104,7 +114,7 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
 }
 
 /** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+static Octet16 cmac_aes_k_calculate(const aes_context& ctx) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -113,7 +123,7 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
     /* Mi' := Mi (+) X  */
     xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length], x);
 
-    output = aes_128(key, *(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length]);
+    output = aes_128_encrypt(ctx, *(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length]);
     x = output;
     i++;
   }
@@ -144,39 +154,36 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 /** This is the function to generate the two subkeys.
  * |key| is CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
-  Octet16 zero{};
-  Octet16 p = aes_128(key, zero);
+AesCmacKey::AesCmacKey(const Octet16& key) {
+  aes_128_set_key(key, &ctx_);
 
-  Octet16 k1, k2;
+  Octet16 zero{};
+  Octet16 p = aes_128_encrypt(ctx_, zero);
   uint8_t* pp = p.data();
 
   /* If MSB(L) = 0, then K1 = L << 1 */
   if ((pp[kOctet16Length - 1] & 0x80) != 0) {
     /* Else K1 = ( L << 1 ) (+) Rb */
-    leftshift_onebit(pp, k1.data());
-    xor_128(&k1, const_Rb);
+    leftshift_onebit(pp, k1_.data());
+    xor_128(&k1_, const_Rb);
   } else {
-    leftshift_onebit(pp, k1.data());
+    leftshift_onebit(pp, k1_.data());
   }
 
-  if ((k1[kOctet16Length - 1] & 0x80) != 0) {
+  if ((k1_[kOctet16Length - 1] & 0x80) != 0) {
     /* K2 =  (K1 << 1) (+) Rb */
-    leftshift_onebit(k1.data(), k2.data());
-    xor_128(&k2, const_Rb);
+    leftshift_onebit(k1_.data(), k2_.data());
+    xor_128(&k2_, const_Rb);
   } else {
     /* If MSB(K1) = 0, then K2 = K1 << 1 */
-    leftshift_onebit(k1.data(), k2.data());
+    leftshift_onebit(k1_.data(), k2_.data());
   }
-
-  cmac_prepare_last_block(k1, k2);
 }
 
-/** key - CMAC key in little endian order
- *  input - text to be signed in little endian byte order.
+/** input - text to be signed in little endian byte order.
  *  length - length of the input in byte.
  */
-Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
+Octet16 AesCmacKey::Sign(const uint8_t* input, uint16_t length) const {
   uint32_t len;
   uint16_t diff;
   /* n is number of rounds */
@@ -201,10 +208,10 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
     cmac_cb.len = 0;
   }
 
-  /* prepare calculation for subkey s and last block of data */
-  cmac_generate_subkey(key);
+  /* prepare the last block of data with the precomputed subkeys */
+  cmac_prepare_last_block(k1_, k2_);
   /* start calculation */
-  Octet16 signature = cmac_aes_k_calculate(key);
+  Octet16 signature = cmac_aes_k_calculate(ctx_);
 
   /* clean up */
   memset(&cmac_cb, 0, sizeof(tCMAC_CB));
@@ -213,4 +220,12 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
   return signature;
 }
 
+/** key - CMAC key in little endian order
+ *  input - text to be signed in little endian byte order.
+ *  length - length of the input in byte.
+ */
+Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
+  return AesCmacKey(key).Sign(input, length);
+}
+
 }  // namespace crypto_toolbox
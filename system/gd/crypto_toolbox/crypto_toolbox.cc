@@ -29,6 +29,32 @@ using bluetooth::hci::Octet16;
 
 namespace crypto_toolbox {
 
+namespace {
+
+/* The f5 and h7 salts are constant, so are their CMAC key schedules and
+ * subkeys */
+const AesCmacKey& f5_salt_key() {
+  static const AesCmacKey key(Octet16{0xBE, 0x83, 0x60, 0x5A, 0xDB, 0x0B, 0x37, 0x60, 0x38, 0xA5,
+                                      0xF5, 0xAA, 0x91, 0x83, 0x88, 0x6C});
+  return key;
+}
+
+/* "tmp1" mapping to extended ASCII, little endian */
+const AesCmacKey& tmp1_salt_key() {
+  static const AesCmacKey key(Octet16{0x31, 0x70, 0x6D, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                      0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+  return key;
+}
+
+/* "tmp2" mapping to extended ASCII, little endian */
+const AesCmacKey& tmp2_salt_key() {
+  static const AesCmacKey key(Octet16{0x32, 0x70, 0x6D, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                      0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+  return key;
+}
+
+}  // namespace
+
 Octet16 h6(const Octet16& w, std::array<uint8_t, 4> keyid) {
   return aes_cmac(w, keyid.data(), keyid.size());
 }
@@ -53,7 +79,7 @@ Octet16 f4(const uint8_t* u, const uint8_t* v, const Octet16& x, uint8_t z) {
 }
 
 /** helper for f5 */
-static Octet16 calculate_mac_key_or_ltk(const Octet16& t, uint8_t counter, uint8_t* key_id,
+static Octet16 calculate_mac_key_or_ltk(const AesCmacKey& t, uint8_t counter, uint8_t* key_id,
                                         const Octet16& n1, const Octet16& n2, uint8_t* a1,
                                         uint8_t* a2, uint8_t* length) {
   constexpr size_t msg_len = 1 /* Counter size */ + 4 /* keyID size */ +
@@ -70,7 +96,7 @@ static Octet16 calculate_mac_key_or_ltk(const Octet16& t, uint8_t counter, uint8
   it = std::copy(key_id, key_id + 4, it);
   it = std::copy(&counter, &counter + 1, it);
 
-  return aes_cmac(t, msg.data(), msg.size());
+  return t.Sign(msg.data(), msg.size());
 }
 
 void f5(const uint8_t* w, const Octet16& n1, const Octet16& n2, uint8_t* a1, uint8_t* a2,
@@ -81,20 +107,21 @@ void f5(const uint8_t* w, const Octet16& n1, const Octet16& n2, uint8_t* a1, uin
               HexEncode(a1, 7), HexEncode(a2, 7));
 #endif
 
-  const Octet16 salt{0xBE, 0x83, 0x60, 0x5A, 0xDB, 0x0B, 0x37, 0x60,
-                     0x38, 0xA5, 0xF5, 0xAA, 0x91, 0x83, 0x88, 0x6C};
-  Octet16 t = aes_cmac(salt, w, kOctet32Length);
+  Octet16 t = f5_salt_key().Sign(w, kOctet32Length);
 
 #if 0
   log::verbose("T={}", HexEncode(t.data(), t.size()));
 #endif
 
+  /* T keys both the MacKey and the LTK, set it up once */
+  const AesCmacKey t_key(t);
+
   uint8_t key_id[4] = {0x65, 0x6c, 0x74, 0x62}; /* 0x62746c65 */
   uint8_t length[2] = {0x00, 0x01};             /* 0x0100 */
 
-  *mac_key = calculate_mac_key_or_ltk(t, 0, key_id, n1, n2, a1, a2, length);
+  *mac_key = calculate_mac_key_or_ltk(t_key, 0, key_id, n1, n2, a1, a2, length);
 
-  *ltk = calculate_mac_key_or_ltk(t, 1, key_id, n1, n2, a1, a2, length);
+  *ltk = calculate_mac_key_or_ltk(t_key, 1, key_id, n1, n2, a1, a2, length);
 
 #if 0
   log::verbose("mac_key={}", HexEncode(mac_key->data(), mac_key->size()));
@@ -150,9 +177,7 @@ uint32_t g2(const uint8_t* u, const uint8_t* v, const Octet16& x, const Octet16&
 Octet16 ltk_to_link_key(const Octet16& ltk, bool use_h7) {
   Octet16 ilk; /* intermidiate link key */
   if (use_h7) {
-    constexpr Octet16 salt{0x31, 0x70, 0x6D, 0x74, 0x00, 0x00, 0x00, 0x00,
-                           0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-    ilk = h7(salt, ltk);
+    ilk = tmp1_salt_key().Sign(ltk);
   } else {
     /* "tmp1" mapping to extended ASCII, little endian*/
     constexpr std::array<uint8_t, 4> keyID_tmp1 = {0x31, 0x70, 0x6D, 0x74};
@@ -167,9 +192,7 @@ Octet16 ltk_to_link_key(const Octet16& ltk, bool use_h7) {
 Octet16 link_key_to_ltk(const Octet16& link_key, bool use_h7) {
   Octet16 iltk; /* intermidiate long term key */
   if (use_h7) {
-    constexpr Octet16 salt{0x32, 0x70, 0x6D, 0x74, 0x00, 0x00, 0x00, 0x00,
-                           0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-    iltk = h7(salt, link_key);
+    iltk = tmp2_salt_key().Sign(link_key);
   } else {
     /* "tmp2" mapping to extended ASCII, little endian */
     constexpr std::array<uint8_t, 4> keyID_tmp2 = {0x32, 0x70, 0x6D, 0x74};
@@ -20,10 +20,28 @@
 #include <cstdint>
 #include <cstring>
 
+#include "crypto_toolbox/aes.h"
 #include "hci/octets.h"
 
 namespace crypto_toolbox {
 
+// AES-CMAC key with its AES key schedule and CMAC subkeys computed once, for
+// keys that sign more than one message. All values are in little endian order.
+class AesCmacKey {
+public:
+  explicit AesCmacKey(const bluetooth::hci::Octet16& key);
+
+  bluetooth::hci::Octet16 Sign(const uint8_t* message, uint16_t length) const;
+  bluetooth::hci::Octet16 Sign(const bluetooth::hci::Octet16& message) const {
+    return Sign(message.data(), message.size());
+  }
+
+private:
+  aes_context ctx_;
+  bluetooth::hci::Octet16 k1_;
+  bluetooth::hci::Octet16 k2_;
+};
+
 bluetooth::hci::Octet16 c1(const bluetooth::hci::Octet16& k, const bluetooth::hci::Octet16& r,
                            const uint8_t* pres, const uint8_t* preq, const uint8_t iat,
                            const uint8_t* ia, const uint8_t rat, const uint8_t* ra);
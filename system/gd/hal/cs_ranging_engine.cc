@@ -0,0 +1,283 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/cs_ranging_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+constexpr double kSpeedOfLight = 299792458.0;        // m/s
+constexpr double kChannelSpacingHz = 1e6;            // CS channels are 1 MHz apart
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kMaxUnambiguousDistance = kSpeedOfLight / (2 * kChannelSpacingHz);
+
+// Tone quality indicator values, from the LE CS Subevent Result event
+constexpr uint8_t kToneQualityMask = 0x03;
+constexpr uint8_t kToneQualityMedium = 0x01;
+
+// Minimum amount of data for an estimate to be meaningful
+constexpr size_t kMinChannels = 10;
+constexpr size_t kMinChannelPairs = 8;
+
+// Zero padded IFFT size, gives ~0.3 m between impulse response taps
+constexpr size_t kIfftSize = 512;
+// First path is the earliest peak within 8 dB of the strongest one, well
+// above the sidelobes of the channel grid
+constexpr double kFirstPathPowerRatio = 0.15;
+
+// The phase slope estimate is used when it agrees with the first path
+constexpr double kMaxEstimatorDisagreementMeters = 1.5;
+
+static_assert((kIfftSize & (kIfftSize - 1)) == 0, "IFFT size must be a power of two");
+static_assert(kIfftSize >= CsProcedureSoa::kNumChannels, "IFFT size must cover all channels");
+
+bool IsGoodTone(const std::vector<std::vector<uint8_t>>& tone_quality, size_t path, size_t step) {
+  if (path >= tone_quality.size() || step >= tone_quality[path].size()) {
+    return true;
+  }
+  return (tone_quality[path][step] & kToneQualityMask) <= kToneQualityMedium;
+}
+
+struct TwiddleTable {
+  std::array<double, kIfftSize / 2> cos_;
+  std::array<double, kIfftSize / 2> sin_;
+
+  TwiddleTable() {
+    for (size_t k = 0; k < kIfftSize / 2; k++) {
+      cos_[k] = std::cos(2 * kPi * k / kIfftSize);
+      sin_[k] = std::sin(2 * kPi * k / kIfftSize);
+    }
+  }
+};
+
+// In place radix-2 inverse FFT, without the 1/N scaling
+void InverseFft(std::array<double, kIfftSize>& real, std::array<double, kIfftSize>& imag) {
+  static const TwiddleTable twiddles;
+
+  for (size_t i = 1, j = 0; i < kIfftSize; i++) {
+    size_t bit = kIfftSize >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      std::swap(real[i], real[j]);
+      std::swap(imag[i], imag[j]);
+    }
+  }
+
+  for (size_t len = 2; len <= kIfftSize; len <<= 1) {
+    size_t half = len / 2;
+    size_t stride = kIfftSize / len;
+    for (size_t i = 0; i < kIfftSize; i += len) {
+      for (size_t k = 0; k < half; k++) {
+        double w_real = twiddles.cos_[k * stride];
+        double w_imag = twiddles.sin_[k * stride];
+        double v_real = real[i + k + half] * w_real - imag[i + k + half] * w_imag;
+        double v_imag = real[i + k + half] * w_imag + imag[i + k + half] * w_real;
+        real[i + k + half] = real[i + k] - v_real;
+        imag[i + k + half] = imag[i + k] - v_imag;
+        real[i + k] += v_real;
+        imag[i + k] += v_imag;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void CsProcedureSoa::Clear() {
+  real_.fill(0);
+  imag_.fill(0);
+  count_.fill(0);
+}
+
+size_t CsProcedureSoa::Load(const ChannelSoundingRawData& raw_data) {
+  size_t num_tones = 0;
+  // The slot after the last antenna path holds the tone extension
+  size_t num_paths = std::min<size_t>({raw_data.num_antenna_paths_,
+                                       raw_data.tone_pct_initiator_.size(),
+                                       raw_data.tone_pct_reflector_.size()});
+  for (size_t path = 0; path < num_paths; path++) {
+    const auto& initiator = raw_data.tone_pct_initiator_[path];
+    const auto& reflector = raw_data.tone_pct_reflector_[path];
+    size_t num_steps =
+            std::min({raw_data.step_channel_.size(), initiator.size(), reflector.size()});
+    for (size_t step = 0; step < num_steps; step++) {
+      uint8_t channel = raw_data.step_channel_[step];
+      if (channel >= kNumChannels || count_[channel] == UINT8_MAX) {
+        continue;
+      }
+      if (!IsGoodTone(raw_data.tone_quality_indicator_initiator_, path, step) ||
+          !IsGoodTone(raw_data.tone_quality_indicator_reflector_, path, step)) {
+        continue;
+      }
+      std::complex<double> round_trip = initiator[step] * reflector[step];
+      real_[channel] += round_trip.real();
+      imag_[channel] += round_trip.imag();
+      count_[channel]++;
+      num_tones++;
+    }
+  }
+  return num_tones;
+}
+
+size_t CsProcedureSoa::NumChannels() const {
+  return std::count_if(count_.begin(), count_.end(), [](uint8_t count) { return count != 0; });
+}
+
+double EstimateDistancePhaseSlope(const CsProcedureSoa& procedure) {
+  const auto& real = procedure.real_;
+  const auto& imag = procedure.imag_;
+
+  // Sum of z[k + 1] * conj(z[k]). Channels without tones are zero and add
+  // nothing, which keeps the loop free of branches.
+  double acc_real = 0;
+  double acc_imag = 0;
+  for (size_t k = 0; k + 1 < CsProcedureSoa::kNumChannels; k++) {
+    acc_real += real[k + 1] * real[k] + imag[k + 1] * imag[k];
+    acc_imag += imag[k + 1] * real[k] - real[k + 1] * imag[k];
+  }
+
+  size_t num_pairs = 0;
+  for (size_t k = 0; k + 1 < CsProcedureSoa::kNumChannels; k++) {
+    num_pairs += (procedure.count_[k] != 0 && procedure.count_[k + 1] != 0);
+  }
+  if (num_pairs < kMinChannelPairs || (acc_real == 0 && acc_imag == 0)) {
+    return -1;
+  }
+
+  // Round trip phase rotates by -4 * pi * spacing * d / c per channel
+  double slope = std::atan2(acc_imag, acc_real);
+  double distance = -slope * kSpeedOfLight / (4 * kPi * kChannelSpacingHz);
+  if (distance < 0) {
+    distance += kMaxUnambiguousDistance;
+  }
+  return distance;
+}
+
+double EstimateDistanceIfft(const CsProcedureSoa& procedure) {
+  if (procedure.NumChannels() < kMinChannels) {
+    return -1;
+  }
+
+  std::array<double, kIfftSize> real{};
+  std::array<double, kIfftSize> imag{};
+  std::copy(procedure.real_.begin(), procedure.real_.end(), real.begin());
+  std::copy(procedure.imag_.begin(), procedure.imag_.end(), imag.begin());
+  InverseFft(real, imag);
+
+  std::array<double, kIfftSize> power;
+  for (size_t n = 0; n < kIfftSize; n++) {
+    power[n] = real[n] * real[n] + imag[n] * imag[n];
+  }
+  double max_power = *std::max_element(power.begin(), power.end());
+  if (max_power == 0) {
+    return -1;
+  }
+
+  // Earliest local maximum close to the strongest tap, so that a stronger
+  // reflection does not hide the direct path
+  size_t peak = 0;
+  for (size_t n = 0; n < kIfftSize; n++) {
+    double prev = power[(n + kIfftSize - 1) % kIfftSize];
+    double next = power[(n + 1) % kIfftSize];
+    if (power[n] >= kFirstPathPowerRatio * max_power && power[n] >= prev && power[n] >= next) {
+      peak = n;
+      break;
+    }
+  }
+
+  // Parabolic interpolation between taps
+  double a = std::sqrt(power[(peak + kIfftSize - 1) % kIfftSize]);
+  double b = std::sqrt(power[peak]);
+  double c = std::sqrt(power[(peak + 1) % kIfftSize]);
+  double offset = 0;
+  double denominator = a - 2 * b + c;
+  if (denominator != 0) {
+    offset = std::clamp(0.5 * (a - c) / denominator, -0.5, 0.5);
+  }
+  double position = peak + offset;
+  if (position < 0) {
+    position += kIfftSize;
+  }
+
+  return position * kMaxUnambiguousDistance / kIfftSize;
+}
+
+double CsDistanceFilter::Update(double distance_meters) {
+  window_.push_back(distance_meters);
+  if (window_.size() > kMedianWindow) {
+    window_.pop_front();
+  }
+
+  std::array<double, kMedianWindow> sorted;
+  std::copy(window_.begin(), window_.end(), sorted.begin());
+  auto middle = sorted.begin() + window_.size() / 2;
+  std::nth_element(sorted.begin(), middle, sorted.begin() + window_.size());
+
+  if (smoothed_ < 0) {
+    smoothed_ = *middle;
+  } else {
+    smoothed_ += kSmoothingFactor * (*middle - smoothed_);
+  }
+  return smoothed_;
+}
+
+void CsDistanceFilter::Reset() {
+  window_.clear();
+  smoothed_ = -1;
+}
+
+bool CsRangingEngine::Process(const ChannelSoundingRawData& raw_data, RangingResult* result) {
+  procedure_.Clear();
+  if (procedure_.Load(raw_data) == 0) {
+    return false;
+  }
+
+  double first_path = EstimateDistanceIfft(procedure_);
+  double phase_slope = EstimateDistancePhaseSlope(procedure_);
+  double distance;
+  if (first_path < 0) {
+    distance = phase_slope;
+  } else if (phase_slope >= 0 &&
+             std::abs(phase_slope - first_path) < kMaxEstimatorDisagreementMeters) {
+    // The phase slope is more precise, but is pulled by multipath
+    distance = phase_slope;
+  } else {
+    distance = first_path;
+  }
+  if (distance < 0) {
+    return false;
+  }
+
+  result->result_meters_ = filter_.Update(distance);
+  return true;
+}
+
+void CsRangingEngine::Reset() {
+  procedure_.Clear();
+  filter_.Reset();
+}
+
+}  // namespace hal
+}  // namespace bluetooth
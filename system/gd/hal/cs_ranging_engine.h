@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "hal/ranging_hal.h"
+
+namespace bluetooth {
+namespace hal {
+
+// Channel Sounding procedure data as a structure of arrays. The round trip
+// phasor (initiator PCT times reflector PCT) of every usable tone is summed into
+// the bin of its CS channel, so the estimators work on contiguous arrays over a
+// uniform 1 MHz frequency grid.
+struct CsProcedureSoa {
+  static constexpr size_t kNumChannels = 79;
+
+  std::array<double, kNumChannels> real_{};
+  std::array<double, kNumChannels> imag_{};
+  std::array<uint8_t, kNumChannels> count_{};
+
+  void Clear();
+
+  // Adds the mode 2 tones of |raw_data|, skipping tone extension slots and
+  // tones of low quality. Returns the number of tones used.
+  size_t Load(const ChannelSoundingRawData& raw_data);
+
+  // Number of channels with at least one tone
+  size_t NumChannels() const;
+};
+
+// Distance estimators for a single procedure. They return the distance in
+// meters, or a negative value if the procedure does not carry enough tones.
+// Both are unambiguous up to 150 m because of the 1 MHz channel spacing.
+
+// Slope of the round trip phase over frequency, averaged over adjacent channels
+double EstimateDistancePhaseSlope(const CsProcedureSoa& procedure);
+
+// First path of the channel impulse response, from a zero padded IFFT
+double EstimateDistanceIfft(const CsProcedureSoa& procedure);
+
+// Combines estimates of consecutive procedures: a sliding median rejects
+// outliers, then an exponential average smooths the result.
+class CsDistanceFilter {
+public:
+  double Update(double distance_meters);
+  void Reset();
+
+private:
+  static constexpr size_t kMedianWindow = 5;
+  static constexpr double kSmoothingFactor = 0.5;
+
+  std::deque<double> window_;
+  double smoothed_ = -1;
+};
+
+// Host side replacement for the ranging HAL algorithm, one instance per
+// connection.
+class CsRangingEngine {
+public:
+  // Returns false if no distance could be estimated from |raw_data|
+  bool Process(const ChannelSoundingRawData& raw_data, RangingResult* result);
+  void Reset();
+
+private:
+  CsProcedureSoa procedure_;
+  CsDistanceFilter filter_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
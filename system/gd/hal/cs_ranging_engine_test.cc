@@ -0,0 +1,170 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/cs_ranging_engine.h"
+
+#include <bluetooth/log.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr double kSpeedOfLight = 299792458.0;
+constexpr double kPi = 3.14159265358979323846;
+
+struct Path {
+  double distance_meters;
+  double amplitude;
+};
+
+// Builds mode 2 data as both sides would report it for the given propagation
+// paths, on CS channels 2..76 minus the advertising channel gap.
+ChannelSoundingRawData GenerateRawData(const std::vector<Path>& paths, double noise,
+                                       uint32_t seed, uint8_t num_antenna_paths = 1) {
+  std::mt19937 generator(seed);
+  std::normal_distribution<double> gaussian(0, noise);
+  std::uniform_real_distribution<double> uniform_phase(-kPi, kPi);
+
+  ChannelSoundingRawData raw_data;
+  raw_data.num_antenna_paths_ = num_antenna_paths;
+  raw_data.tone_pct_initiator_.resize(num_antenna_paths + 1);
+  raw_data.tone_pct_reflector_.resize(num_antenna_paths + 1);
+  raw_data.tone_quality_indicator_initiator_.resize(num_antenna_paths + 1);
+  raw_data.tone_quality_indicator_reflector_.resize(num_antenna_paths + 1);
+
+  for (uint8_t channel = 2; channel <= 76; channel++) {
+    if (channel >= 23 && channel <= 25) {
+      continue;
+    }
+    raw_data.step_channel_.push_back(channel);
+    double frequency = (2402 + channel) * 1e6;
+    for (uint8_t path = 0; path <= num_antenna_paths; path++) {
+      std::complex<double> one_way = 0;
+      for (const auto& p : paths) {
+        one_way += std::polar(p.amplitude, -2 * kPi * frequency * p.distance_meters / kSpeedOfLight);
+      }
+      // Each side only sees half of the round trip, with a local oscillator
+      // phase that cancels out in the product
+      double lo_phase = uniform_phase(generator);
+      std::complex<double> initiator = one_way * std::polar(1.0, lo_phase);
+      std::complex<double> reflector = one_way * std::polar(1.0, -lo_phase);
+      initiator += std::complex<double>(gaussian(generator), gaussian(generator));
+      reflector += std::complex<double>(gaussian(generator), gaussian(generator));
+      raw_data.tone_pct_initiator_[path].push_back(initiator);
+      raw_data.tone_pct_reflector_[path].push_back(reflector);
+      raw_data.tone_quality_indicator_initiator_[path].push_back(0);
+      raw_data.tone_quality_indicator_reflector_[path].push_back(0);
+    }
+  }
+  return raw_data;
+}
+
+TEST(CsRangingEngineTest, load_skips_tone_extension_and_bad_tones) {
+  auto raw_data = GenerateRawData({{5.0, 1.0}}, 0, 1);
+  raw_data.tone_quality_indicator_initiator_[0][0] = 0x02;
+
+  CsProcedureSoa procedure;
+  size_t num_steps = raw_data.step_channel_.size();
+  ASSERT_EQ(num_steps - 1, procedure.Load(raw_data));
+  ASSERT_EQ(num_steps - 1, procedure.NumChannels());
+  ASSERT_EQ(0, procedure.count_[raw_data.step_channel_[0]]);
+
+  procedure.Clear();
+  ASSERT_EQ(0u, procedure.NumChannels());
+}
+
+TEST(CsRangingEngineTest, estimators_on_clean_data) {
+  for (double distance : {0.5, 1.0, 2.5, 7.3, 15.0, 42.0, 100.0}) {
+    CsProcedureSoa procedure;
+    procedure.Load(GenerateRawData({{distance, 1.0}}, 0, 1));
+    EXPECT_NEAR(distance, EstimateDistancePhaseSlope(procedure), 0.01);
+    EXPECT_NEAR(distance, EstimateDistanceIfft(procedure), 0.3);
+  }
+}
+
+TEST(CsRangingEngineTest, estimators_on_noisy_data) {
+  for (double distance : {1.0, 4.0, 12.0}) {
+    CsProcedureSoa procedure;
+    procedure.Load(GenerateRawData({{distance, 1.0}}, 0.1, 7, 2));
+    EXPECT_NEAR(distance, EstimateDistancePhaseSlope(procedure), 0.3);
+    EXPECT_NEAR(distance, EstimateDistanceIfft(procedure), 0.5);
+  }
+}
+
+TEST(CsRangingEngineTest, ifft_finds_first_path_under_multipath) {
+  CsProcedureSoa procedure;
+  procedure.Load(GenerateRawData({{3.0, 1.0}, {9.0, 0.8}}, 0, 1));
+  EXPECT_NEAR(3.0, EstimateDistanceIfft(procedure), 0.5);
+}
+
+TEST(CsRangingEngineTest, not_enough_data) {
+  ChannelSoundingRawData raw_data = GenerateRawData({{5.0, 1.0}}, 0, 1);
+  raw_data.step_channel_.resize(4);
+
+  CsProcedureSoa procedure;
+  procedure.Load(raw_data);
+  EXPECT_LT(EstimateDistancePhaseSlope(procedure), 0);
+  EXPECT_LT(EstimateDistanceIfft(procedure), 0);
+
+  CsRangingEngine engine;
+  RangingResult result;
+  EXPECT_FALSE(engine.Process(ChannelSoundingRawData{}, &result));
+  EXPECT_FALSE(engine.Process(raw_data, &result));
+}
+
+TEST(CsRangingEngineTest, filter_rejects_outliers) {
+  CsDistanceFilter filter;
+  for (int i = 0; i < 5; i++) {
+    filter.Update(2.0);
+  }
+  EXPECT_NEAR(2.0, filter.Update(30.0), 0.01);
+  EXPECT_NEAR(2.0, filter.Update(2.0), 0.01);
+
+  filter.Reset();
+  EXPECT_NEAR(8.0, filter.Update(8.0), 0.01);
+}
+
+TEST(CsRangingEngineTest, engine_tracks_distance_over_procedures) {
+  CsRangingEngine engine;
+  RangingResult result;
+  for (uint32_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(engine.Process(GenerateRawData({{6.0, 1.0}}, 0.1, i), &result));
+  }
+  EXPECT_NEAR(6.0, result.result_meters_, 0.2);
+}
+
+TEST(CsRangingEngineTest, estimates_per_second) {
+  constexpr int kNumProcedures = 1000;
+  auto raw_data = GenerateRawData({{6.0, 1.0}}, 0.1, 3, 4);
+  CsRangingEngine engine;
+  RangingResult result;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kNumProcedures; i++) {
+    ASSERT_TRUE(engine.Process(raw_data, &result));
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  log::info("{} estimates per second", kNumProcedures / elapsed.count());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
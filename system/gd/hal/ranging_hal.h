@@ -66,6 +66,8 @@ public:
           uint16_t connection_handle,
           const std::vector<hal::VendorSpecificCharacteristic>& vendor_specific_reply) = 0;
   virtual void WriteRawData(uint16_t connection_handle, const ChannelSoundingRawData& raw_data) = 0;
+  // Releases the session of the connection, once RAS or the link is gone
+  virtual void CloseSession(uint16_t connection_handle) = 0;
 };
 
 }  // namespace hal
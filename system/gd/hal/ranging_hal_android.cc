@@ -218,6 +218,12 @@ public:
     session_trackers_[connection_handle]->GetSession()->writeRawData(hal_raw_data);
   }
 
+  void CloseSession(uint16_t connection_handle) override {
+    if (session_trackers_.erase(connection_handle) != 0) {
+      log::info("connection_handle 0x{:04x}", connection_handle);
+    }
+  }
+
   void CopyVendorSpecificData(const std::vector<hal::VendorSpecificCharacteristic>& source,
                               std::optional<std::vector<std::optional<VendorSpecificData>>>& dist) {
     dist = std::make_optional<std::vector<std::optional<VendorSpecificData>>>();
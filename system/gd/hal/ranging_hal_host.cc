@@ -19,39 +19,81 @@
 #undef LOG_INFO
 #undef LOG_WARNING
 
+#include <bluetooth/log.h>
+
+#include <unordered_map>
+
+#include "hal/cs_ranging_engine.h"
 #include "ranging_hal.h"
 
 namespace bluetooth {
 namespace hal {
 
+// Runs the distance estimation on the host, with one engine per connection
 class RangingHalHost : public RangingHal {
 public:
-  bool IsBound() override { return false; }
-  void RegisterCallback(RangingHalCallback* /* callback */) override {}
+  bool IsBound() override { return true; }
+  void RegisterCallback(RangingHalCallback* callback) override { ranging_hal_callback_ = callback; }
   std::vector<VendorSpecificCharacteristic> GetVendorSpecificCharacteristics() override {
     std::vector<VendorSpecificCharacteristic> vendor_specific_characteristics = {};
     return vendor_specific_characteristics;
   }
-  void OpenSession(uint16_t /* connection_handle */, uint16_t /* att_handle */,
+  void OpenSession(uint16_t connection_handle, uint16_t /* att_handle */,
                    const std::vector<hal::VendorSpecificCharacteristic>& /* vendor_specific_data */)
-          override {}
+          override {
+    log::info("connection_handle 0x{:04x}", connection_handle);
+    engines_[connection_handle].Reset();
+    if (ranging_hal_callback_ != nullptr) {
+      ranging_hal_callback_->OnOpened(connection_handle, {});
+    }
+  }
 
   void HandleVendorSpecificReply(
-          uint16_t /* connection_handle */,
+          uint16_t connection_handle,
           const std::vector<hal::VendorSpecificCharacteristic>& /* vendor_specific_reply */)
-          override {}
+          override {
+    log::info("connection_handle 0x{:04x}", connection_handle);
+    engines_[connection_handle].Reset();
+    if (ranging_hal_callback_ != nullptr) {
+      ranging_hal_callback_->OnHandleVendorSpecificReplyComplete(connection_handle, true);
+    }
+  }
 
-  void WriteRawData(uint16_t /* connection_handle */,
-                    const ChannelSoundingRawData& /* raw_data */) override {}
+  void WriteRawData(uint16_t connection_handle, const ChannelSoundingRawData& raw_data) override {
+    auto it = engines_.find(connection_handle);
+    if (it == engines_.end()) {
+      log::error("Can't find session for connection_handle:0x{:04x}", connection_handle);
+      return;
+    }
+
+    RangingResult ranging_result;
+    if (!it->second.Process(raw_data, &ranging_result)) {
+      log::debug("Not enough tones for connection_handle:0x{:04x}", connection_handle);
+      return;
+    }
+    if (ranging_hal_callback_ != nullptr) {
+      ranging_hal_callback_->OnResult(connection_handle, ranging_result);
+    }
+  }
+
+  void CloseSession(uint16_t connection_handle) override {
+    if (engines_.erase(connection_handle) != 0) {
+      log::info("connection_handle 0x{:04x}", connection_handle);
+    }
+  }
 
 protected:
   void ListDependencies(ModuleList* /*list*/) const {}
 
   void Start() override {}
 
-  void Stop() override {}
+  void Stop() override { engines_.clear(); }
 
   std::string ToString() const override { return std::string("RangingHalHost"); }
+
+private:
+  RangingHalCallback* ranging_hal_callback_ = nullptr;
+  std::unordered_map<uint16_t, CsRangingEngine> engines_;
 };
 
 const ModuleFactory RangingHal::Factory = ModuleFactory([]() { return new RangingHalHost(); });
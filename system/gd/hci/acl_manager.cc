@@ -253,6 +253,10 @@ void AclManager::CreateConnection(Address address) {
   CallOn(pimpl_->classic_impl_, &classic_impl::create_connection, address);
 }
 
+void AclManager::CreateConnection(Address address, acl_manager::PagingHint paging_hint) {
+  CallOn(pimpl_->classic_impl_, &classic_impl::create_connection_with_hint, address, paging_hint);
+}
+
 void AclManager::CreateLeConnection(AddressWithType address_with_type, bool is_direct) {
   if (!is_direct) {
     CallOn(pimpl_->le_impl_, &le_impl::add_device_to_background_connection_list, address_with_type);
@@ -331,6 +335,11 @@ void AclManager::RemoveDeviceFromResolvingList(AddressWithType address_with_type
   CallOn(pimpl_->le_impl_, &le_impl::remove_device_from_resolving_list, address_with_type);
 }
 
+void AclManager::UpdateResolvingList(
+        std::vector<LeAddressManager::ResolvingListEntry> resolving_list) {
+  CallOn(pimpl_->le_impl_, &le_impl::update_resolving_list, std::move(resolving_list));
+}
+
 void AclManager::ClearResolvingList() { CallOn(pimpl_->le_impl_, &le_impl::clear_resolving_list); }
 
 void AclManager::CentralLinkKey(KeyFlag key_flag) {
@@ -424,6 +433,17 @@ void AclManager::impl::Dump(std::promise<flatbuffers::Offset<AclManagerData>> pr
           (le_impl_ != nullptr)
                   ? static_cast<int>(le_impl_->create_connection_timeout_alarms_.size())
                   : 0;
+  const auto le_connect_stats =
+          (le_impl_ != nullptr) ? le_impl_->connect_stats_ : le_impl::ConnectStats{};
+  const uint32_t le_connected_count = le_connect_stats.num_connected_;
+  const int64_t le_average_queue_wait_ms =
+          (le_connected_count != 0)
+                  ? le_connect_stats.total_queue_wait_.count() / le_connected_count
+                  : 0;
+  const int64_t le_average_connect_latency_ms =
+          (le_connected_count != 0)
+                  ? le_connect_stats.total_connect_latency_.count() / le_connected_count
+                  : 0;
 
   auto title = fb_builder->CreateString("----- Acl Manager Dumpsys -----");
   auto le_connectability_state = fb_builder->CreateString(le_connectability_state_text);
@@ -442,6 +462,11 @@ void AclManager::impl::Dump(std::promise<flatbuffers::Offset<AclManagerData>> pr
   builder.add_le_filter_accept_list(vecofstrings);
   builder.add_le_connectability_state(le_connectability_state);
   builder.add_le_create_connection_timeout_alarms_count(le_create_connection_timeout_alarms_count);
+  builder.add_le_connected_count(le_connected_count);
+  builder.add_le_average_queue_wait_ms(le_average_queue_wait_ms);
+  builder.add_le_max_queue_wait_ms(le_connect_stats.max_queue_wait_.count());
+  builder.add_le_average_connect_latency_ms(le_average_connect_latency_ms);
+  builder.add_le_max_connect_latency_ms(le_connect_stats.max_connect_latency_.count());
 
   flatbuffers::Offset<AclManagerData> dumpsys_data = builder.Finish();
   promise.set_value(dumpsys_data);
@@ -19,10 +19,12 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
+#include "hci/acl_manager/paging_hint.h"
 #include "hci/address.h"
 #include "hci/address_with_type.h"
 #include "hci/distance_measurement_manager.h"
@@ -81,6 +83,9 @@ public:
   // Generates OnConnectSuccess if connected, or OnConnectFail otherwise
   virtual void CreateConnection(Address address);
 
+  // Same as above, scheduling the page with what is known about the presence of the device
+  virtual void CreateConnection(Address address, acl_manager::PagingHint paging_hint);
+
   // Generates OnLeConnectSuccess if connected, or OnLeConnectFail otherwise
   virtual void CreateLeConnection(AddressWithType address_with_type, bool is_direct);
 
@@ -116,6 +121,9 @@ public:
                                         const std::array<uint8_t, 16>& peer_irk,
                                         const std::array<uint8_t, 16>& local_irk);
   virtual void RemoveDeviceFromResolvingList(AddressWithType address_with_type);
+  // Replaces the resolving list content, with a single pause of scanning and advertising
+  virtual void UpdateResolvingList(
+          std::vector<LeAddressManager::ResolvingListEntry> resolving_list);
   virtual void ClearResolvingList();
 
   virtual void CentralLinkKey(KeyFlag key_flag);
@@ -19,6 +19,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <deque>
 #include <optional>
 #include <unordered_set>
@@ -33,6 +34,7 @@ namespace acl_manager {
 struct AclCreateConnectionQueueEntry {
   Address address;
   common::ContextualOnceCallback<void()> callback;
+  bool likely_present;
 };
 
 struct RemoteNameRequestQueueEntry {
@@ -43,11 +45,28 @@ struct RemoteNameRequestQueueEntry {
 
 using QueueEntry = std::variant<AclCreateConnectionQueueEntry, RemoteNameRequestQueueEntry>;
 
+// Outgoing connections are given the next page ahead of queued remote name requests, so that a
+// burst of name requests during discovery does not delay connections the user is waiting for. To
+// keep names flowing, a queued name request is overtaken by at most this many connections in a row.
+constexpr size_t kMaxConnectionsAheadOfRemoteNameRequest = 2;
+
 struct AclScheduler::impl {
   void EnqueueOutgoingAclConnection(Address address,
-                                    common::ContextualOnceCallback<void()> start_connection) {
-    pending_outgoing_operations_.push_back(
-            AclCreateConnectionQueueEntry{address, std::move(start_connection)});
+                                    common::ContextualOnceCallback<void()> start_connection,
+                                    bool likely_present) {
+    auto position = pending_outgoing_operations_.end();
+    if (likely_present) {
+      // Keep request order among likely present devices
+      position = std::find_if(
+              pending_outgoing_operations_.begin(), pending_outgoing_operations_.end(),
+              [](const QueueEntry& entry) {
+                auto connection = std::get_if<AclCreateConnectionQueueEntry>(&entry);
+                return connection != nullptr && !connection->likely_present;
+              });
+    }
+    pending_outgoing_operations_.insert(
+            position,
+            AclCreateConnectionQueueEntry{address, std::move(start_connection), likely_present});
     try_dequeue_next_operation();
   }
 
@@ -163,16 +182,25 @@ struct AclScheduler::impl {
   void Stop() { stopped_ = true; }
 
 private:
-  bool ready_to_send_next_operation() const {
-    if (stopped_) {
-      return false;
-    }
-    if (pending_outgoing_operations_.empty()) {
-      return false;
+  // Pick the queued operation that should get the next page: the oldest one, unless it is a
+  // remote name request that an outgoing connection may still overtake.
+  std::deque<QueueEntry>::iterator next_operation() {
+    auto front = pending_outgoing_operations_.begin();
+    if (!std::holds_alternative<RemoteNameRequestQueueEntry>(*front) ||
+        connections_ahead_of_remote_name_request_ >= kMaxConnectionsAheadOfRemoteNameRequest) {
+      return front;
     }
+    auto connection =
+            std::find_if(front, pending_outgoing_operations_.end(), [](const QueueEntry& entry) {
+              return std::holds_alternative<AclCreateConnectionQueueEntry>(entry);
+            });
+    return connection != pending_outgoing_operations_.end() ? connection : front;
+  }
+
+  bool ready_to_send_operation(const QueueEntry& entry) const {
     if (com::android::bluetooth::flags::progress_acl_scheduler_upon_incoming_connection()) {
       if (const RemoteNameRequestQueueEntry* peek =
-                  std::get_if<RemoteNameRequestQueueEntry>(&pending_outgoing_operations_.front())) {
+                  std::get_if<RemoteNameRequestQueueEntry>(&entry)) {
         if (incoming_connecting_address_set_.contains(peek->address)) {
           log::info("Pending incoming connection and outgoing RNR to same peer:{}", peek->address);
           return true;
@@ -183,13 +211,30 @@ private:
   }
 
   void try_dequeue_next_operation() {
-    if (ready_to_send_next_operation()) {
-      log::info("Pending connections is not empty; so sending next connection");
-      auto entry = std::move(pending_outgoing_operations_.front());
-      pending_outgoing_operations_.pop_front();
-      std::visit([](auto&& variant) { variant.callback(); }, entry);
-      outgoing_entry_ = std::move(entry);
+    if (stopped_ || pending_outgoing_operations_.empty()) {
+      return;
     }
+
+    auto it = next_operation();
+    if (!ready_to_send_operation(*it)) {
+      // A remote name request that was overtaken may still be allowed to go ahead
+      it = pending_outgoing_operations_.begin();
+      if (!ready_to_send_operation(*it)) {
+        return;
+      }
+    }
+
+    if (std::holds_alternative<RemoteNameRequestQueueEntry>(*it)) {
+      connections_ahead_of_remote_name_request_ = 0;
+    } else if (it != pending_outgoing_operations_.begin()) {
+      connections_ahead_of_remote_name_request_++;
+    }
+
+    log::info("Pending connections is not empty; so sending next connection");
+    auto entry = std::move(*it);
+    pending_outgoing_operations_.erase(it);
+    std::visit([](auto&& variant) { variant.callback(); }, entry);
+    outgoing_entry_ = std::move(entry);
   }
 
   template <typename T, typename U, typename V>
@@ -223,6 +268,7 @@ private:
   std::optional<QueueEntry> outgoing_entry_;
   std::deque<QueueEntry> pending_outgoing_operations_;
   std::unordered_set<Address> incoming_connecting_address_set_;
+  size_t connections_ahead_of_remote_name_request_ = 0;
   bool stopped_ = false;
 };
 
@@ -232,9 +278,10 @@ AclScheduler::AclScheduler() : pimpl_(std::make_unique<impl>()) {}
 AclScheduler::~AclScheduler() = default;
 
 void AclScheduler::EnqueueOutgoingAclConnection(
-        Address address, common::ContextualOnceCallback<void()> start_connection) {
+        Address address, common::ContextualOnceCallback<void()> start_connection,
+        bool likely_present) {
   GetHandler()->Call(&impl::EnqueueOutgoingAclConnection, common::Unretained(pimpl_.get()), address,
-                     std::move(start_connection));
+                     std::move(start_connection), likely_present);
 }
 
 void AclScheduler::RegisterPendingIncomingConnection(Address address) {
@@ -37,9 +37,12 @@ namespace acl_manager {
 // executes them at the appropriate time.
 class AclScheduler : public bluetooth::Module {
 public:
-  // Schedule an ACL Create Connection request
-  void EnqueueOutgoingAclConnection(Address address,
-                                    common::ContextualOnceCallback<void()> start_connection);
+  // Schedule an ACL Create Connection request. Connections to devices that are likely present are
+  // queued ahead of the other queued connections, so they are not stuck behind pages to absent
+  // devices.
+  virtual void EnqueueOutgoingAclConnection(Address address,
+                                            common::ContextualOnceCallback<void()> start_connection,
+                                            bool likely_present = false);
 
   // Inform the scheduler that we are handling an incoming connection. This will block all future
   // outgoing ACL connection events until the incoming connection is deregistered.
@@ -53,7 +56,7 @@ public:
           common::ContextualOnceCallback<void(std::string)> handle_unknown_connection);
 
   // Same as above, but for the outgoing ACL connection in particular (and no callbacks)
-  void ReportOutgoingAclConnectionFailure();
+  virtual void ReportOutgoingAclConnectionFailure();
 
   // Cancel an ACL connection. If the request is already outgoing, we will invoke cancel_connection,
   // without clearing the outgoing request. Otherwise, we will remove the request from the queue,
@@ -38,6 +38,8 @@ namespace {
 const auto address1 = Address::FromString("A1:A2:A3:A4:A5:A6").value();
 const auto address2 = Address::FromString("B1:B2:B3:B4:B5:B6").value();
 const auto address3 = Address::FromString("C1:C2:C3:C4:C5:C6").value();
+const auto address4 = Address::FromString("D1:D2:D3:D4:D5:D6").value();
+const auto address5 = Address::FromString("E1:E2:E3:E4:E5:E6").value();
 
 const auto timeout = std::chrono::milliseconds(100);
 
@@ -526,6 +528,74 @@ TEST_F(AclSchedulerTest, RemoteNameRequestCancellationShouldDequeueNext) {
   EXPECT_THAT(future, IsSet());
 }
 
+TEST_F(AclSchedulerTest, OutgoingConnectionsOvertakeQueuedRemoteNameRequest) {
+  auto rnr_promise = std::promise<void>{};
+  auto rnr_future = rnr_promise.get_future();
+  auto promise1 = std::promise<void>{};
+  auto future1 = promise1.get_future();
+  auto promise2 = std::promise<void>{};
+  auto future2 = promise2.get_future();
+  auto promise3 = std::promise<void>{};
+  auto future3 = promise3.get_future();
+
+  // start an outgoing request
+  acl_scheduler_->EnqueueRemoteNameRequest(address1, emptyCallback(), impossibleCallback());
+  // queue a second request, then three connections
+  acl_scheduler_->EnqueueRemoteNameRequest(address2, promiseCallback(std::move(rnr_promise)),
+                                           impossibleCallback());
+  acl_scheduler_->EnqueueOutgoingAclConnection(address3, promiseCallback(std::move(promise1)));
+  acl_scheduler_->EnqueueOutgoingAclConnection(address4, promiseCallback(std::move(promise2)));
+  acl_scheduler_->EnqueueOutgoingAclConnection(address5, promiseCallback(std::move(promise3)));
+
+  // the first request completes, the first connection goes ahead of the queued request
+  acl_scheduler_->ReportRemoteNameRequestCompletion(address1);
+  EXPECT_THAT(future1, IsSet());
+  EXPECT_THAT(rnr_future.wait_for(timeout), std::future_status::timeout);
+
+  // so does the second connection
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future2, IsSet());
+  EXPECT_THAT(rnr_future.wait_for(timeout), std::future_status::timeout);
+
+  // but then the queued request gets its turn before the third connection
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(rnr_future, IsSet());
+  EXPECT_THAT(future3.wait_for(timeout), std::future_status::timeout);
+
+  acl_scheduler_->ReportRemoteNameRequestCompletion(address2);
+  EXPECT_THAT(future3, IsSet());
+}
+
+TEST_F(AclSchedulerTest, LikelyPresentConnectionsGoAheadOfSpeculativeOnes) {
+  auto promise1 = std::promise<void>{};
+  auto future1 = promise1.get_future();
+  auto promise2 = std::promise<void>{};
+  auto future2 = promise2.get_future();
+  auto promise3 = std::promise<void>{};
+  auto future3 = promise3.get_future();
+
+  // start a speculative connection, which immediately runs
+  acl_scheduler_->EnqueueOutgoingAclConnection(address1, emptyCallback());
+  // queue a speculative connection, then two connections to likely present devices
+  acl_scheduler_->EnqueueOutgoingAclConnection(address2, promiseCallback(std::move(promise3)));
+  acl_scheduler_->EnqueueOutgoingAclConnection(address3, promiseCallback(std::move(promise1)),
+                                               true /* likely_present */);
+  acl_scheduler_->EnqueueOutgoingAclConnection(address4, promiseCallback(std::move(promise2)),
+                                               true /* likely_present */);
+
+  // the likely present devices are paged first, in request order
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future1, IsSet());
+  EXPECT_THAT(future2.wait_for(timeout), std::future_status::timeout);
+
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future2, IsSet());
+  EXPECT_THAT(future3.wait_for(timeout), std::future_status::timeout);
+
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future3, IsSet());
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
@@ -18,13 +18,17 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <unordered_map>
 
 #include "common/bind.h"
 #include "hci/acl_manager/acl_scheduler.h"
 #include "hci/acl_manager/assembler.h"
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/connection_management_callbacks.h"
+#include "hci/acl_manager/paging_hint.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/class_of_device.h"
 #include "hci/controller.h"
@@ -33,11 +37,20 @@
 #include "hci/remote_name_request.h"
 #include "metrics/bluetooth_event.h"
 #include "os/metrics.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+constexpr uint16_t kDefaultPageTimeout = 0x2000;  // 5.12 s
+constexpr char kPropertyPageTimeout[] = "bluetooth.core.classic.page_timeout";
+// Devices that answered an inquiry this recently are paged first, with the full page timeout
+constexpr std::chrono::milliseconds kRecentlySeen = std::chrono::minutes(2);
+// Speculative pages cover two page scan intervals of the page scan repetition mode
+constexpr uint16_t kSpeculativePageTimeoutR0 = 0x0800;  // 1.28 s
+constexpr uint16_t kSpeculativePageTimeoutR1 = 0x1000;  // 2.56 s
+
 struct acl_connection {
   acl_connection(AddressWithType address_with_type, AclConnection::QueueDownEnd* queue_down_end,
                  os::Handler* handler)
@@ -62,6 +75,10 @@ struct classic_impl {
     controller_ = controller;
     handler_ = handler;
     connections.crash_on_unknown_handle_ = crash_on_unknown_handle;
+    // The same property is applied to the controller when the stack starts
+    default_page_timeout_ = static_cast<uint16_t>(
+            os::GetSystemPropertyUint32(kPropertyPageTimeout, kDefaultPageTimeout));
+    page_timeout_ = default_page_timeout_;
     should_accept_connection_ = common::Bind([](Address, ClassOfDevice) { return true; });
     acl_connection_interface_ = hci_layer_->GetAclConnectionInterface(
             handler_->BindOn(this, &classic_impl::on_classic_event),
@@ -279,29 +296,87 @@ public:
   }
 
   void create_connection(Address address) {
+    enqueue_page(address, PagingHint{}, default_page_timeout_, false /* likely_present */);
+  }
+
+  void create_connection_with_hint(Address address, PagingHint paging_hint) {
+    bool likely_present =
+            paging_hint.last_seen.has_value() && *paging_hint.last_seen < kRecentlySeen;
+    uint16_t page_timeout = default_page_timeout_;
+    if (!likely_present) {
+      switch (paging_hint.page_scan_repetition_mode) {
+        case PageScanRepetitionMode::R0:
+          page_timeout = std::min(page_timeout, kSpeculativePageTimeoutR0);
+          break;
+        case PageScanRepetitionMode::R1:
+          page_timeout = std::min(page_timeout, kSpeculativePageTimeoutR1);
+          break;
+        default:
+          break;
+      }
+    }
+    if (page_timeout < default_page_timeout_) {
+      speculative_pages_[address] = paging_hint;
+    }
+    enqueue_page(address, paging_hint, page_timeout, likely_present);
+  }
+
+  void enqueue_page(Address address, PagingHint paging_hint, uint16_t page_timeout,
+                    bool likely_present) {
     // TODO: Configure default connection parameters?
     uint16_t packet_type = 0x4408 /* DM 1,3,5 */ | 0x8810 /*DH 1,3,5 */;
-    PageScanRepetitionMode page_scan_repetition_mode = PageScanRepetitionMode::R1;
-    uint16_t clock_offset = 0;
-    ClockOffsetValid clock_offset_valid = ClockOffsetValid::INVALID;
+    uint16_t clock_offset = paging_hint.clock_offset.value_or(0);
+    ClockOffsetValid clock_offset_valid = paging_hint.clock_offset.has_value()
+                                                  ? ClockOffsetValid::VALID
+                                                  : ClockOffsetValid::INVALID;
     CreateConnectionRoleSwitch allow_role_switch = CreateConnectionRoleSwitch::ALLOW_ROLE_SWITCH;
     log::assert_that(client_callbacks_ != nullptr, "assert failed: client_callbacks_ != nullptr");
-    std::unique_ptr<CreateConnectionBuilder> packet =
-            CreateConnectionBuilder::Create(address, packet_type, page_scan_repetition_mode,
-                                            clock_offset, clock_offset_valid, allow_role_switch);
+    std::unique_ptr<CreateConnectionBuilder> packet = CreateConnectionBuilder::Create(
+            address, packet_type, paging_hint.page_scan_repetition_mode, clock_offset,
+            clock_offset_valid, allow_role_switch);
 
     acl_scheduler_->EnqueueOutgoingAclConnection(
-            address, handler_->BindOnceOn(this, &classic_impl::actually_create_connection, address,
-                                          std::move(packet)));
+            address,
+            handler_->BindOnceOn(this, &classic_impl::actually_create_connection, address,
+                                 std::move(packet), page_timeout),
+            likely_present);
+  }
+
+  // A speculative page that timed out is queued again with the full page timeout, behind the
+  // pages that were waiting for it. Returns true if the page was queued again.
+  bool retry_speculative_page(Address address, ErrorCode status) {
+    auto it = speculative_pages_.find(address);
+    if (it == speculative_pages_.end()) {
+      return false;
+    }
+    PagingHint paging_hint = it->second;
+    speculative_pages_.erase(it);
+    if (status != ErrorCode::PAGE_TIMEOUT) {
+      return false;
+    }
+    log::info("Speculative page to {} timed out, retrying with the full page timeout", address);
+    enqueue_page(address, paging_hint, default_page_timeout_, false /* likely_present */);
+    return true;
+  }
+
+  void set_page_timeout(uint16_t page_timeout) {
+    if (page_timeout == page_timeout_) {
+      return;
+    }
+    page_timeout_ = page_timeout;
+    hci_layer_->EnqueueCommand(WritePageTimeoutBuilder::Create(page_timeout),
+                               handler_->BindOnce(check_complete<WritePageTimeoutCompleteView>));
   }
 
-  void actually_create_connection(Address address,
-                                  std::unique_ptr<CreateConnectionBuilder> packet) {
+  void actually_create_connection(Address address, std::unique_ptr<CreateConnectionBuilder> packet,
+                                  uint16_t page_timeout) {
     if (is_classic_link_already_connected(address)) {
       log::warn("already connected: {}", address);
+      speculative_pages_.erase(address);
       acl_scheduler_->ReportOutgoingAclConnectionFailure();
       return;
     }
+    set_page_timeout(page_timeout);
     acl_connection_interface_->EnqueueCommand(
             std::move(packet),
             handler_->BindOnceOn(this, &classic_impl::on_create_connection_status, address));
@@ -314,6 +389,8 @@ public:
     if (status.GetStatus() != hci::ErrorCode::SUCCESS /* = pending */) {
       // something went wrong, but unblock queue and report to caller
       log::error("Failed to create connection, reporting failure and continuing");
+      speculative_pages_.erase(address);
+      set_page_timeout(default_page_timeout_);
       log::assert_that(client_callbacks_ != nullptr, "assert failed: client_callbacks_ != nullptr");
       client_handler_->Post(common::BindOnce(&ConnectionCallbacks::OnConnectFail,
                                              common::Unretained(client_callbacks_), address,
@@ -338,6 +415,13 @@ public:
       log::warn("No client callbacks registered for connection");
       return;
     }
+    if (initiator == Initiator::LOCALLY_INITIATED) {
+      // Remote name requests and other pages must not inherit the page timeout of this page
+      set_page_timeout(default_page_timeout_);
+      if (retry_speculative_page(address, status)) {
+        return;
+      }
+    }
     if (status != ErrorCode::SUCCESS) {
       client_handler_->Post(common::BindOnce(&ConnectionCallbacks::OnConnectFail,
                                              common::Unretained(client_callbacks_), address, status,
@@ -397,6 +481,7 @@ public:
   }
 
   void cancel_connect(Address address) {
+    speculative_pages_.erase(address);
     acl_scheduler_->CancelAclConnection(
             address, handler_->BindOnceOn(this, &classic_impl::actually_cancel_connect, address),
             client_handler_->BindOnceOn(client_callbacks_, &ConnectionCallbacks::OnConnectFail,
@@ -746,6 +831,12 @@ public:
 
   common::Callback<bool(Address, ClassOfDevice)> should_accept_connection_;
   std::unique_ptr<RoleChangeView> delayed_role_change_ = nullptr;
+
+  // Page timeout configured for the stack, and the one currently written to the controller
+  uint16_t default_page_timeout_ = kDefaultPageTimeout;
+  uint16_t page_timeout_ = kDefaultPageTimeout;
+  // Outgoing speculative pages, that get a second attempt after a page timeout
+  std::unordered_map<Address, PagingHint> speculative_pages_;
 };
 
 }  // namespace acl_manager
@@ -123,6 +123,15 @@ namespace acl_manager {
 
 class MockAclScheduler : public AclScheduler {
 public:
+  // Outgoing connections are started right away
+  void EnqueueOutgoingAclConnection(Address /* address */,
+                                    common::ContextualOnceCallback<void()> start_connection,
+                                    bool /* likely_present */) override {
+    start_connection();
+  }
+
+  void ReportOutgoingAclConnectionFailure() override {}
+
   virtual void ReportAclConnectionCompletion(
           Address /* address */, common::ContextualOnceCallback<void()> handle_outgoing_connection,
           common::ContextualOnceCallback<void()> handle_incoming_connection,
@@ -257,6 +266,93 @@ TEST_F(ClassicImplTest, on_classic_event_CONNECTION_COMPLETE__SUCCESS) {
   classic_impl_->on_classic_event(view);
 }
 
+class ClassicImplPagingTest : public ClassicImplTest {
+protected:
+  void SetUp() override {
+    ClassicImplTest::SetUp();
+    handle_outgoing_connection_ = true;
+  }
+
+  void ExpectPageTimeout(uint16_t page_timeout) {
+    auto command = hci_layer_->GetCommand(OpCode::WRITE_PAGE_TIMEOUT);
+    auto view = WritePageTimeoutView::Create(DiscoveryCommandView::Create(command));
+    ASSERT_TRUE(view.IsValid());
+    ASSERT_EQ(page_timeout, view.GetPageTimeout());
+    hci_layer_->IncomingEvent(WritePageTimeoutCompleteBuilder::Create(1, ErrorCode::SUCCESS));
+  }
+
+  void ExpectCreateConnection(ErrorCode status = ErrorCode::SUCCESS) {
+    auto command = hci_layer_->GetCommand(OpCode::CREATE_CONNECTION);
+    auto view = CreateConnectionView::Create(
+            ConnectionManagementCommandView::Create(AclCommandView::Create(command)));
+    ASSERT_TRUE(view.IsValid());
+    ASSERT_EQ(kRemoteAddress, view.GetBdAddr());
+    hci_layer_->IncomingEvent(CreateConnectionStatusBuilder::Create(status, 1));
+  }
+
+  void ConnectionComplete(ErrorCode status) {
+    hci_layer_->IncomingEvent(ConnectionCompleteBuilder::Create(
+            status, kHciHandle, kRemoteAddress, LinkType::ACL, bluetooth::hci::Enable::DISABLED));
+    sync_handler();
+  }
+};
+
+TEST_F(ClassicImplPagingTest, speculative_page_restores_page_timeout_on_connection) {
+  EXPECT_CALL(mock_connection_callback_, OnConnectSuccess);
+
+  // Never seen, and in page scan repetition mode R0
+  PagingHint paging_hint{.page_scan_repetition_mode = PageScanRepetitionMode::R0};
+  classic_impl_->create_connection_with_hint(kRemoteAddress, paging_hint);
+  ExpectPageTimeout(kSpeculativePageTimeoutR0);
+  ExpectCreateConnection();
+
+  ConnectionComplete(ErrorCode::SUCCESS);
+  ExpectPageTimeout(kDefaultPageTimeout);
+}
+
+TEST_F(ClassicImplPagingTest, speculative_page_is_retried_with_full_page_timeout) {
+  PagingHint paging_hint{.page_scan_repetition_mode = PageScanRepetitionMode::R1};
+  classic_impl_->create_connection_with_hint(kRemoteAddress, paging_hint);
+  ExpectPageTimeout(kSpeculativePageTimeoutR1);
+  ExpectCreateConnection();
+
+  // The first page timeout is not reported
+  EXPECT_CALL(mock_connection_callback_, OnConnectFail).Times(0);
+  ConnectionComplete(ErrorCode::PAGE_TIMEOUT);
+  ExpectPageTimeout(kDefaultPageTimeout);
+  ExpectCreateConnection();
+  Mock::VerifyAndClearExpectations(&mock_connection_callback_);
+
+  // The retry is not retried again
+  EXPECT_CALL(mock_connection_callback_,
+              OnConnectFail(kRemoteAddress, ErrorCode::PAGE_TIMEOUT, true));
+  ConnectionComplete(ErrorCode::PAGE_TIMEOUT);
+  hci_layer_->AssertNoQueuedCommand();
+}
+
+TEST_F(ClassicImplPagingTest, recently_seen_device_is_paged_with_full_page_timeout) {
+  PagingHint paging_hint{.last_seen = std::chrono::seconds(30),
+                         .page_scan_repetition_mode = PageScanRepetitionMode::R0};
+  classic_impl_->create_connection_with_hint(kRemoteAddress, paging_hint);
+  ExpectCreateConnection();
+
+  EXPECT_CALL(mock_connection_callback_,
+              OnConnectFail(kRemoteAddress, ErrorCode::PAGE_TIMEOUT, true));
+  ConnectionComplete(ErrorCode::PAGE_TIMEOUT);
+  hci_layer_->AssertNoQueuedCommand();
+}
+
+TEST_F(ClassicImplPagingTest, speculative_page_restores_page_timeout_on_command_failure) {
+  EXPECT_CALL(mock_connection_callback_,
+              OnConnectFail(kRemoteAddress, ErrorCode::COMMAND_DISALLOWED, true));
+
+  PagingHint paging_hint{.page_scan_repetition_mode = PageScanRepetitionMode::R0};
+  classic_impl_->create_connection_with_hint(kRemoteAddress, paging_hint);
+  ExpectPageTimeout(kSpeculativePageTimeoutR0);
+  ExpectCreateConnection(ErrorCode::COMMAND_DISALLOWED);
+  ExpectPageTimeout(kDefaultPageTimeout);
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
@@ -20,9 +20,13 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -61,6 +65,7 @@ constexpr uint16_t kScanWindowSlow = 0x0030;            /* 30 ms = 48 *0.625 */
 constexpr uint16_t kScanIntervalSystemSuspend = 0x0400; /* 640 ms = 1024 * 0.625 */
 constexpr uint16_t kScanWindowSystemSuspend = 0x0012;   /* 11.25ms = 18 * 0.625 */
 constexpr uint32_t kCreateConnectionTimeoutMs = 30 * 1000;
+constexpr uint32_t kAcceptListSlotTimeMs = 5 * 1000;
 constexpr uint8_t PHY_LE_NO_PACKET = 0x00;
 constexpr uint8_t PHY_LE_1M = 0x01;
 constexpr uint8_t PHY_LE_2M = 0x02;
@@ -74,6 +79,7 @@ static const std::string kPropertyConnLatency = "bluetooth.core.le.connection_la
 static const std::string kPropertyConnSupervisionTimeout =
         "bluetooth.core.le.connection_supervision_timeout";
 static const std::string kPropertyDirectConnTimeout = "bluetooth.core.le.direct_connection_timeout";
+static const std::string kPropertyAcceptListSlotTime = "bluetooth.core.le.accept_list_slot_time";
 static const std::string kPropertyConnScanIntervalFast =
         "bluetooth.core.le.connection_scan_interval_fast";
 static const std::string kPropertyConnScanWindowFast =
@@ -142,6 +148,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
             common::Bind(&le_impl::enqueue_command, common::Unretained(this)), handler_,
             controller->GetMacAddress(), controller->GetLeFilterAcceptListSize(),
             controller->GetLeResolvingListSize());
+    accept_list_rotation_alarm_ = std::make_unique<os::Alarm>(handler_);
   }
 
   ~le_impl() {
@@ -423,6 +430,9 @@ public:
 
       arm_on_resume_ = false;
       ready_to_unregister = true;
+      if (status == ErrorCode::SUCCESS) {
+        record_connect_timing(remote_address);
+      }
       remove_device_from_accept_list(remote_address);
 
       if (!accept_list.empty()) {
@@ -703,9 +713,9 @@ public:
 
     log::debug("Adding device to accept list {}", address_with_type);
     accept_list.insert(address_with_type);
+    connect_targets_[address_with_type] = {std::chrono::steady_clock::now(), std::nullopt};
     register_with_address_manager();
-    le_address_manager_->AddDeviceToFilterAcceptList(
-            address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    schedule_accept_list_sync();
   }
 
   bool is_device_in_accept_list(AddressWithType address_with_type) {
@@ -719,17 +729,109 @@ public:
     }
     accept_list.erase(address_with_type);
     connecting_le_.erase(address_with_type);
+    connect_targets_.erase(address_with_type);
     register_with_address_manager();
-    le_address_manager_->RemoveDeviceFromFilterAcceptList(
-            address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    schedule_accept_list_sync();
+  }
+
+  // The accept list changes made while the handler is busy, like the background connections
+  // of all bonded devices at startup, reach the controller in one update and one pause.
+  void schedule_accept_list_sync() {
+    if (accept_list_sync_scheduled_) {
+      return;
+    }
+    accept_list_sync_scheduled_ = true;
+    handler_->CallOn(this, &le_impl::sync_accept_list);
+  }
+
+  void sync_accept_list() {
+    accept_list_sync_scheduled_ = false;
+    // Direct targets come first, so that they get the controller room
+    std::vector<std::pair<FilterAcceptListAddressType, Address>> entries;
+    for (const auto& address_with_type : direct_connections_) {
+      if (accept_list.find(address_with_type) != accept_list.end()) {
+        entries.emplace_back(address_with_type.ToFilterAcceptListAddressType(),
+                             address_with_type.GetAddress());
+      }
+    }
+    for (const auto& address_with_type : accept_list) {
+      if (direct_connections_.find(address_with_type) == direct_connections_.end()) {
+        entries.emplace_back(address_with_type.ToFilterAcceptListAddressType(),
+                             address_with_type.GetAddress());
+      }
+    }
+    le_address_manager_->UpdateFilterAcceptList(std::move(entries), direct_connections_);
+    schedule_accept_list_rotation();
   }
 
   void clear_filter_accept_list() {
     accept_list.clear();
+    connect_targets_.clear();
     register_with_address_manager();
     le_address_manager_->ClearFilterAcceptList();
   }
 
+  void schedule_accept_list_rotation() {
+    if (accept_list_rotation_scheduled_ ||
+        !le_address_manager_->HasWaitingFilterAcceptListEntries()) {
+      return;
+    }
+    accept_list_rotation_scheduled_ = true;
+    uint32_t slot_time_ms =
+            os::GetSystemPropertyUint32(kPropertyAcceptListSlotTime, kAcceptListSlotTimeMs);
+    accept_list_rotation_alarm_->Schedule(
+            common::BindOnce(&le_impl::on_accept_list_rotation, common::Unretained(this)),
+            std::chrono::milliseconds(slot_time_ms));
+  }
+
+  // When there are more targets than the controller accept list can hold, the background
+  // targets take turns. A target out of range then holds its entry for one slot time,
+  // instead of until it connects. Direct targets keep their entry until they connect or
+  // time out.
+  void on_accept_list_rotation() {
+    accept_list_rotation_scheduled_ = false;
+    if (!le_address_manager_->HasWaitingFilterAcceptListEntries()) {
+      return;
+    }
+    le_address_manager_->RotateFilterAcceptList(le_address_manager_->GetFilterAcceptListSize(),
+                                                direct_connections_);
+    schedule_accept_list_rotation();
+  }
+
+  // Start of the initiator for the targets that just made it to the controller accept list
+  void mark_initiating_targets() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& [address_with_type, target] : connect_targets_) {
+      if (!target.initiating_.has_value() &&
+          le_address_manager_->IsDeviceInControllerFilterAcceptList(
+                  address_with_type.ToFilterAcceptListAddressType(),
+                  address_with_type.GetAddress())) {
+        target.initiating_ = now;
+      }
+    }
+  }
+
+  void record_connect_timing(AddressWithType address_with_type) {
+    auto it = connect_targets_.find(address_with_type);
+    if (it == connect_targets_.end()) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto requested = it->second.requested_;
+    auto initiating = it->second.initiating_.value_or(requested);
+    auto queue_wait = std::chrono::duration_cast<std::chrono::milliseconds>(initiating - requested);
+    auto connect_latency = std::chrono::duration_cast<std::chrono::milliseconds>(now - initiating);
+    log::info("{} connected, queue wait {}ms, connect latency {}ms", address_with_type,
+              queue_wait.count(), connect_latency.count());
+
+    connect_stats_.num_connected_++;
+    connect_stats_.total_queue_wait_ += queue_wait;
+    connect_stats_.max_queue_wait_ = std::max(connect_stats_.max_queue_wait_, queue_wait);
+    connect_stats_.total_connect_latency_ += connect_latency;
+    connect_stats_.max_connect_latency_ =
+            std::max(connect_stats_.max_connect_latency_, connect_latency);
+  }
+
   void add_device_to_resolving_list(AddressWithType address_with_type,
                                     const std::array<uint8_t, 16>& peer_irk,
                                     const std::array<uint8_t, 16>& local_irk) {
@@ -742,6 +844,14 @@ public:
     }
   }
 
+  void update_resolving_list(std::vector<LeAddressManager::ResolvingListEntry> resolving_list) {
+    register_with_address_manager();
+    le_address_manager_->UpdateResolvingList(std::move(resolving_list));
+    if (le_acceptlist_callbacks_ != nullptr) {
+      le_acceptlist_callbacks_->OnResolvingListChange();
+    }
+  }
+
   void remove_device_from_resolving_list(AddressWithType address_with_type) {
     register_with_address_manager();
     le_address_manager_->RemoveDeviceFromResolvingList(address_with_type.ToPeerAddressType(),
@@ -765,6 +875,9 @@ public:
         }
         set_connectability_state((status == ErrorCode::SUCCESS) ? ConnectabilityState::ARMED
                                                                 : ConnectabilityState::DISARMED);
+        if (status == ErrorCode::SUCCESS) {
+          mark_initiating_targets();
+        }
         log::info("Le connection state machine armed state:{} status:{}",
                   connectability_state_machine_text(connectability_state_), ErrorCodeText(status));
         if (disarmed_while_arming_) {
@@ -1238,6 +1351,24 @@ public:
   bool system_suspend_ = false;
   ConnectabilityState connectability_state_{ConnectabilityState::DISARMED};
   std::map<AddressWithType, os::Alarm> create_connection_timeout_alarms_{};
+
+  // Connection setup timing of the devices in the accept list
+  struct ConnectTarget {
+    std::chrono::steady_clock::time_point requested_;
+    std::optional<std::chrono::steady_clock::time_point> initiating_;
+  };
+  struct ConnectStats {
+    uint32_t num_connected_ = 0;
+    std::chrono::milliseconds total_queue_wait_{0};
+    std::chrono::milliseconds max_queue_wait_{0};
+    std::chrono::milliseconds total_connect_latency_{0};
+    std::chrono::milliseconds max_connect_latency_{0};
+  };
+  std::unordered_map<AddressWithType, ConnectTarget> connect_targets_{};
+  ConnectStats connect_stats_{};
+  std::unique_ptr<os::Alarm> accept_list_rotation_alarm_;
+  bool accept_list_rotation_scheduled_ = false;
+  bool accept_list_sync_scheduled_ = false;
 };
 
 }  // namespace acl_manager
@@ -713,6 +713,10 @@ TEST_F(LeImplTest, connection_complete_with_central_role) {
 
   // Check state is DISARMED
   ASSERT_EQ(ConnectabilityState::DISARMED, le_impl_->connectability_state_);
+
+  // Connection setup timing was recorded for the target
+  ASSERT_EQ(1u, le_impl_->connect_stats_.num_connected_);
+  ASSERT_TRUE(le_impl_->connect_targets_.empty());
 }
 
 TEST_F(LeImplTest, enhanced_connection_complete_with_central_role) {
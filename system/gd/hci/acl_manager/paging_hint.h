@@ -0,0 +1,42 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "hci/hci_packets.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// What recent inquiry results tell about a device we are about to page. Devices seen recently are
+// paged first, with their page scan mode and clock offset. Others are paged speculatively, with a
+// shorter page timeout, and retried with the full page timeout once the rest of the queue had a
+// chance.
+struct PagingHint {
+  // Time since the device last answered an inquiry, if it ever did
+  std::optional<std::chrono::milliseconds> last_seen;
+  PageScanRepetitionMode page_scan_repetition_mode = PageScanRepetitionMode::R1;
+  std::optional<uint16_t> clock_offset;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
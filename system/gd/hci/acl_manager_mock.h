@@ -72,6 +72,8 @@ public:
   MOCK_METHOD(void, RegisterLeCallbacks, (LeConnectionCallbacks * callbacks, os::Handler* handler),
               (override));
   MOCK_METHOD(void, CreateConnection, (Address address), (override));
+  MOCK_METHOD(void, CreateConnection, (Address address, acl_manager::PagingHint paging_hint),
+              (override));
   MOCK_METHOD(void, CreateLeConnection, (AddressWithType address_with_type, bool is_direct),
               (override));
   MOCK_METHOD(void, CancelConnect, (Address address), (override));
@@ -71,19 +71,33 @@ static constexpr uint16_t kRangingCounterMask = 0x0FFF;
 struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   struct CsProcedureData {
     CsProcedureData(uint16_t procedure_counter, uint8_t num_antenna_paths, uint8_t configuration_id,
-                    uint8_t selected_tx_power)
-        : counter(procedure_counter), num_antenna_paths(num_antenna_paths) {
+                    uint8_t selected_tx_power) {
+      Reset(procedure_counter, num_antenna_paths, configuration_id, selected_tx_power);
+    }
+
+    // Prepares the object for a new procedure. Buffers are cleared but keep their
+    // capacity, so that a recycled object does not allocate again.
+    void Reset(uint16_t procedure_counter, uint8_t num_antenna_paths, uint8_t configuration_id,
+               uint8_t selected_tx_power) {
+      counter = procedure_counter;
+      this->num_antenna_paths = num_antenna_paths;
       local_status = CsProcedureDoneStatus::PARTIAL_RESULTS;
       remote_status = CsProcedureDoneStatus::PARTIAL_RESULTS;
+      aborted = false;
+      frequency_compensation.clear();
+      step_channel.clear();
+      measured_freq_offset.clear();
       // In ascending order of antenna position with tone extension data at the end
       uint16_t num_tone_data = num_antenna_paths + 1;
+      tone_pct_initiator.resize(num_tone_data);
+      tone_pct_reflector.resize(num_tone_data);
+      tone_quality_indicator_initiator.resize(num_tone_data);
+      tone_quality_indicator_reflector.resize(num_tone_data);
       for (uint8_t i = 0; i < num_tone_data; i++) {
-        std::vector<std::complex<double>> empty_complex_vector;
-        tone_pct_initiator.push_back(empty_complex_vector);
-        tone_pct_reflector.push_back(empty_complex_vector);
-        std::vector<uint8_t> empty_vector;
-        tone_quality_indicator_initiator.push_back(empty_vector);
-        tone_quality_indicator_reflector.push_back(empty_vector);
+        tone_pct_initiator[i].clear();
+        tone_pct_reflector[i].clear();
+        tone_quality_indicator_initiator[i].clear();
+        tone_quality_indicator_reflector[i].clear();
       }
       // RAS data
       segmentation_header_.first_segment_ = 1;
@@ -97,6 +111,11 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         ranging_header_.antenna_paths_mask_ |= (1 << i);
       }
       ranging_header_.pct_format_ = PctFormat::IQ;
+      ras_raw_data_.clear();
+      ras_raw_data_index_ = 0;
+      ras_subevent_header_ = {};
+      ras_subevent_data_.clear();
+      ras_subevent_counter_ = 0;
     }
     // Procedure counter
     uint16_t counter;
@@ -156,6 +175,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     uint8_t config_id = 0;
     uint8_t selected_tx_power = 0;
     std::vector<CsProcedureData> procedure_data_list;
+    // Procedure data of completed procedures, reused for the next ones
+    std::vector<CsProcedureData> procedure_data_pool;
     uint16_t interval_ms;
     bool waiting_for_start_callback = false;
     std::unique_ptr<os::RepeatingAlarm> repeating_alarm;
@@ -410,6 +431,9 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         }
         distance_measurement_callbacks_->OnDistanceMeasurementStopped(
                 address, REASON_NO_LE_CONNECTION, METHOD_CS);
+        if (ranging_hal_->IsBound()) {
+          ranging_hal_->CloseSession(it->first);
+        }
         it = cs_trackers_.erase(it);  // erase and get the next iterator
       } else {
         ++it;
@@ -417,6 +441,20 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     }
   }
 
+  // The reflector session is opened by the vendor specific reply, and lives until the remote
+  // RAS client, or the link, goes away
+  void handle_ras_server_disconnected_event(const Address address) {
+    log::info("address:{}", address);
+    if (!ranging_hal_->IsBound()) {
+      return;
+    }
+    for (const auto& [connection_handle, tracker] : cs_trackers_) {
+      if (tracker.address == address) {
+        ranging_hal_->CloseSession(connection_handle);
+      }
+    }
+  }
+
   void handle_vendor_specific_reply(
           const Address address, uint16_t connection_handle,
           const std::vector<hal::VendorSpecificCharacteristic> vendor_specific_reply) {
@@ -935,7 +973,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   }
 
   void handle_remote_data(const Address address, uint16_t connection_handle,
-                          const std::vector<uint8_t> raw_data) {
+                          std::vector<uint8_t> raw_data) {
     log::debug("address:{}, connection_handle 0x{:04x}, size:{}", address.ToString(),
                connection_handle, raw_data.size());
 
@@ -945,8 +983,10 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     }
     auto& tracker = cs_trackers_[connection_handle];
 
+    // Both views below share this single copy of the segment
+    auto segment_bytes = std::make_shared<std::vector<uint8_t>>(std::move(raw_data));
     SegmentationHeader segmentation_header;
-    PacketView<kLittleEndian> packet_bytes_view(std::make_shared<std::vector<uint8_t>>(raw_data));
+    PacketView<kLittleEndian> packet_bytes_view(segment_bytes);
     auto after = SegmentationHeader::Parse(&segmentation_header, packet_bytes_view.begin());
     if (after == packet_bytes_view.begin()) {
       log::warn("Invalid segment data");
@@ -954,9 +994,9 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     }
 
     log::debug("Receive segment for segment counter {}, size {}",
-               segmentation_header.rolling_segment_counter_, raw_data.size());
+               segmentation_header.rolling_segment_counter_, segment_bytes->size());
 
-    PacketView<kLittleEndian> segment_data(std::make_shared<std::vector<uint8_t>>(raw_data));
+    PacketView<kLittleEndian> segment_data(segment_bytes);
     if (segmentation_header.first_segment_) {
       auto segment = FirstRangingDataSegmentView::Create(segment_data);
       if (!segment.IsValid()) {
@@ -1065,22 +1105,22 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
                       num_tone_data, remaining_data_size);
               return;
             }
-            std::vector<uint8_t> vector_for_num_tone_data = {num_tone_data};
-            PacketView<kLittleEndian> packet_view_for_num_tone_data(
-                    std::make_shared<std::vector<uint8_t>>(vector_for_num_tone_data));
-            PacketViewForRecombination packet_bytes_view =
-                    PacketViewForRecombination(packet_view_for_num_tone_data);
-            auto subview_begin = std::distance(segment_data.begin(), parse_index);
-            packet_bytes_view.AppendPacketView(
-                    segment_data.GetLittleEndianSubview(subview_begin, subview_begin + data_len));
+            // The number of tones is not part of the RAS step data, prefix it in
+            // the reused step buffer
+            std::vector<uint8_t>& step_bytes = *step_data_buffer_;
+            step_bytes.clear();
+            step_bytes.push_back(num_tone_data);
+            for (uint8_t j = 0; j < data_len; j++, ++parse_index) {
+              step_bytes.push_back(*parse_index);
+            }
+            Iterator<packet::kLittleEndian> step_begin(step_data_buffer_);
             LeCsMode2Data tone_data;
-            after = LeCsMode2Data::Parse(&tone_data, packet_bytes_view.begin());
-            if (after == packet_bytes_view.begin()) {
+            after = LeCsMode2Data::Parse(&tone_data, step_begin);
+            if (after == step_begin) {
               log::warn("Error invalid mode {} data, role:{}", step_mode.mode_type_,
                         CsRoleText(role));
               return;
             }
-            parse_index += data_len;
             uint8_t permutation_index = tone_data.antenna_permutation_index_;
 
             // Parse in ascending order of antenna position with tone extension data at the end
@@ -1134,27 +1174,46 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       }
     }
     log::info("Create data for procedure_counter: {}", procedure_counter);
-    data_list.emplace_back(procedure_counter, num_antenna_paths,
-                           cs_trackers_[connection_handle].config_id,
-                           cs_trackers_[connection_handle].selected_tx_power);
+    auto& tracker = cs_trackers_[connection_handle];
+    if (data_list.capacity() < kProcedureDataBufferSize + 1) {
+      data_list.reserve(kProcedureDataBufferSize + 1);
+    }
+    if (tracker.procedure_data_pool.empty()) {
+      data_list.emplace_back(procedure_counter, num_antenna_paths, tracker.config_id,
+                             tracker.selected_tx_power);
+    } else {
+      data_list.push_back(std::move(tracker.procedure_data_pool.back()));
+      tracker.procedure_data_pool.pop_back();
+      data_list.back().Reset(procedure_counter, num_antenna_paths, tracker.config_id,
+                             tracker.selected_tx_power);
+    }
 
-    // Append ranging header raw data
-    std::vector<uint8_t> ranging_header_raw = {};
-    BitInserter bi(ranging_header_raw);
+    // Ranging header raw data goes first, ras_raw_data_ is empty at this point
+    BitInserter bi(data_list.back().ras_raw_data_);
     data_list.back().ranging_header_.Serialize(bi);
-    append_vector(data_list.back().ras_raw_data_, ranging_header_raw);
 
     if (data_list.size() > kProcedureDataBufferSize) {
       log::warn("buffer full, drop procedure data with counter: {}", data_list.front().counter);
-      data_list.erase(data_list.begin());
+      recycle_oldest_procedure_data(tracker);
     }
     return &data_list.back();
   }
 
+  // Removes the oldest procedure data of |tracker| and keeps it, with its
+  // buffers, for a later procedure
+  void recycle_oldest_procedure_data(CsTracker& tracker) {
+    std::vector<CsProcedureData>& data_list = tracker.procedure_data_list;
+    if (tracker.procedure_data_pool.capacity() < kProcedureDataBufferSize + 1) {
+      tracker.procedure_data_pool.reserve(kProcedureDataBufferSize + 1);
+    }
+    tracker.procedure_data_pool.push_back(std::move(data_list.front()));
+    data_list.erase(data_list.begin());
+  }
+
   void cs_delete_obsolete_data(uint16_t connection_handle) {
-    std::vector<CsProcedureData>& data_list = cs_trackers_[connection_handle].procedure_data_list;
-    while (!data_list.empty()) {
-      data_list.erase(data_list.begin());
+    auto& tracker = cs_trackers_[connection_handle];
+    while (!tracker.procedure_data_list.empty()) {
+      recycle_oldest_procedure_data(tracker);
     }
   }
 
@@ -1219,20 +1278,21 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     // If the procedure is completed or aborted, delete all previous data
     if (procedure_data->local_status != CsProcedureDoneStatus::PARTIAL_RESULTS &&
         procedure_data->remote_status != CsProcedureDoneStatus::PARTIAL_RESULTS) {
-      std::vector<CsProcedureData>& data_list = cs_trackers_[connection_handle].procedure_data_list;
+      auto& tracker = cs_trackers_[connection_handle];
+      std::vector<CsProcedureData>& data_list = tracker.procedure_data_list;
       uint16_t counter = procedure_data->counter;  // Get value from pointer first.
       while (data_list.begin()->counter < counter) {
         log::debug("Delete obsolete procedure data, counter:{}", data_list.begin()->counter);
-        data_list.erase(data_list.begin());
+        recycle_oldest_procedure_data(tracker);
       }
     }
   }
 
-  void parse_cs_result_data(std::vector<LeCsResultDataStructure> result_data_structures,
+  void parse_cs_result_data(const std::vector<LeCsResultDataStructure>& result_data_structures,
                             CsProcedureData& procedure_data, CsRole role) {
     uint8_t num_antenna_paths = procedure_data.num_antenna_paths;
     auto& ras_data = procedure_data.ras_subevent_data_;
-    for (auto result_data_structure : result_data_structures) {
+    for (const auto& result_data_structure : result_data_structures) {
       uint16_t mode = result_data_structure.step_mode_;
       uint16_t step_channel = result_data_structure.step_channel_;
       uint16_t data_length = result_data_structure.step_data_.size();
@@ -1245,16 +1305,16 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       }
       append_vector(ras_data, result_data_structure.step_data_);
 
-      // Parse data into structs from an iterator
-      auto bytes = std::make_shared<std::vector<uint8_t>>();
+      // Parse data into structs from an iterator over the reused step buffer
+      std::vector<uint8_t>& bytes = *step_data_buffer_;
+      bytes.clear();
       if (mode == 0x02 || mode == 0x03) {
         // Add one byte for the length of Tone_PCT[k], Tone_Quality_Indicator[k]
-        bytes->emplace_back(num_antenna_paths + 1);
+        bytes.emplace_back(num_antenna_paths + 1);
       }
-      bytes->reserve(bytes->size() + result_data_structure.step_data_.size());
-      bytes->insert(bytes->end(), result_data_structure.step_data_.begin(),
-                    result_data_structure.step_data_.end());
-      Iterator<packet::kLittleEndian> iterator(bytes);
+      bytes.insert(bytes.end(), result_data_structure.step_data_.begin(),
+                   result_data_structure.step_data_.end());
+      Iterator<packet::kLittleEndian> iterator(step_data_buffer_);
       switch (mode) {
         case 0: {
           if (role == CsRole::INITIATOR) {
@@ -1498,6 +1558,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   hci::DistanceMeasurementInterface* distance_measurement_interface_;
   std::unordered_map<Address, RSSITracker> rssi_trackers;
   std::unordered_map<uint16_t, CsTracker> cs_trackers_;
+  // Scratch buffer for parsing a single CS step, reused across steps
+  std::shared_ptr<std::vector<uint8_t>> step_data_buffer_ = std::make_shared<std::vector<uint8_t>>();
   DistanceMeasurementCallbacks* distance_measurement_callbacks_;
   CsOptionalSubfeaturesSupported cs_subfeature_supported_;
   // Antenna path permutations. See Channel Sounding CR_PR for the details.
@@ -1557,6 +1619,10 @@ void DistanceMeasurementManager::HandleRasDisconnectedEvent(const Address& addre
   CallOn(pimpl_.get(), &impl::handle_ras_disconnected_event, address);
 }
 
+void DistanceMeasurementManager::HandleRasServerDisconnectedEvent(const Address& address) {
+  CallOn(pimpl_.get(), &impl::handle_ras_server_disconnected_event, address);
+}
+
 void DistanceMeasurementManager::HandleVendorSpecificReply(
         const Address& address, uint16_t connection_handle,
         const std::vector<hal::VendorSpecificCharacteristic>& vendor_specific_reply) {
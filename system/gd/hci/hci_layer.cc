@@ -146,25 +146,22 @@ struct HciLayer::impl {
 
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
+    std::vector<uint8_t> bytes(packet->size());
+    bytes.resize(packet->SerializeInto(bytes.data(), bytes.size()));
     hal_->sendAclData(bytes);
   }
 
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
+    std::vector<uint8_t> bytes(packet->size());
+    bytes.resize(packet->SerializeInto(bytes.data(), bytes.size()));
     hal_->sendScoData(bytes);
   }
 
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
+    std::vector<uint8_t> bytes(packet->size());
+    bytes.resize(packet->SerializeInto(bytes.data(), bytes.size()));
     hal_->sendIsoData(bytes);
   }
 
@@ -312,9 +309,9 @@ struct HciLayer::impl {
     if (command_queue_.size() == 0) {
       return;
     }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
+    auto& command = command_queue_.front().command;
+    auto bytes = std::make_shared<std::vector<uint8_t>>(command->size());
+    bytes->resize(command->SerializeInto(bytes->data(), bytes->size()));
     hal_->sendHciCommand(*bytes);
 
     auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+using ::bluetooth::packet::kLittleEndian;
+using ::bluetooth::packet::PacketView;
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+constexpr size_t kEventPayloadSize = 32;
+
+PacketView<kLittleEndian> MakeView(std::vector<uint8_t> bytes) {
+  return PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::move(bytes)));
+}
+
+// One event of every event code, and one LE meta event of every subevent code, the way the HCI
+// layer receives them before dispatching on the codes
+std::vector<PacketView<kLittleEndian>> MakeAllEvents() {
+  std::vector<PacketView<kLittleEndian>> events;
+  for (int event_code = 0; event_code <= 0xff; event_code++) {
+    if (event_code == static_cast<int>(EventCode::LE_META_EVENT)) {
+      continue;
+    }
+    std::vector<uint8_t> bytes(kEventPayloadSize + 2, 0);
+    bytes[0] = event_code;
+    bytes[1] = kEventPayloadSize;
+    events.push_back(MakeView(std::move(bytes)));
+  }
+  for (int subevent_code = 0; subevent_code <= 0xff; subevent_code++) {
+    std::vector<uint8_t> bytes(kEventPayloadSize + 2, 0);
+    bytes[0] = static_cast<uint8_t>(EventCode::LE_META_EVENT);
+    bytes[1] = kEventPayloadSize;
+    bytes[2] = subevent_code;
+    events.push_back(MakeView(std::move(bytes)));
+  }
+  return events;
+}
+
+template <class View, class Parent>
+bool Specialize(Parent parent) {
+  return View::Create(parent).IsValid();
+}
+
+using EventSpecializer = bool (*)(EventView);
+using LeMetaEventSpecializer = bool (*)(LeMetaEventView);
+
+// The view of every event and LE subevent code with a packet definition, the way the HCI layer
+// handlers specialize them
+constexpr std::pair<EventCode, EventSpecializer> kEventSpecializers[] = {
+        {EventCode::COMMAND_COMPLETE, &Specialize<CommandCompleteView, EventView>},
+        {EventCode::COMMAND_STATUS, &Specialize<CommandStatusView, EventView>},
+        {EventCode::INQUIRY_COMPLETE, &Specialize<InquiryCompleteView, EventView>},
+        {EventCode::INQUIRY_RESULT, &Specialize<InquiryResultView, EventView>},
+        {EventCode::CONNECTION_COMPLETE, &Specialize<ConnectionCompleteView, EventView>},
+        {EventCode::CONNECTION_REQUEST, &Specialize<ConnectionRequestView, EventView>},
+        {EventCode::DISCONNECTION_COMPLETE, &Specialize<DisconnectionCompleteView, EventView>},
+        {EventCode::AUTHENTICATION_COMPLETE, &Specialize<AuthenticationCompleteView, EventView>},
+        {EventCode::REMOTE_NAME_REQUEST_COMPLETE,
+         &Specialize<RemoteNameRequestCompleteView, EventView>},
+        {EventCode::ENCRYPTION_CHANGE, &Specialize<EncryptionChangeView, EventView>},
+        {EventCode::CHANGE_CONNECTION_LINK_KEY_COMPLETE,
+         &Specialize<ChangeConnectionLinkKeyCompleteView, EventView>},
+        {EventCode::CENTRAL_LINK_KEY_COMPLETE, &Specialize<CentralLinkKeyCompleteView, EventView>},
+        {EventCode::READ_REMOTE_SUPPORTED_FEATURES_COMPLETE,
+         &Specialize<ReadRemoteSupportedFeaturesCompleteView, EventView>},
+        {EventCode::READ_REMOTE_VERSION_INFORMATION_COMPLETE,
+         &Specialize<ReadRemoteVersionInformationCompleteView, EventView>},
+        {EventCode::QOS_SETUP_COMPLETE, &Specialize<QosSetupCompleteView, EventView>},
+        {EventCode::HARDWARE_ERROR, &Specialize<HardwareErrorView, EventView>},
+        {EventCode::FLUSH_OCCURRED, &Specialize<FlushOccurredView, EventView>},
+        {EventCode::ROLE_CHANGE, &Specialize<RoleChangeView, EventView>},
+        {EventCode::NUMBER_OF_COMPLETED_PACKETS,
+         &Specialize<NumberOfCompletedPacketsView, EventView>},
+        {EventCode::MODE_CHANGE, &Specialize<ModeChangeView, EventView>},
+        {EventCode::RETURN_LINK_KEYS, &Specialize<ReturnLinkKeysView, EventView>},
+        {EventCode::PIN_CODE_REQUEST, &Specialize<PinCodeRequestView, EventView>},
+        {EventCode::LINK_KEY_REQUEST, &Specialize<LinkKeyRequestView, EventView>},
+        {EventCode::LINK_KEY_NOTIFICATION, &Specialize<LinkKeyNotificationView, EventView>},
+        {EventCode::LOOPBACK_COMMAND, &Specialize<LoopbackCommandView, EventView>},
+        {EventCode::DATA_BUFFER_OVERFLOW, &Specialize<DataBufferOverflowView, EventView>},
+        {EventCode::MAX_SLOTS_CHANGE, &Specialize<MaxSlotsChangeView, EventView>},
+        {EventCode::READ_CLOCK_OFFSET_COMPLETE,
+         &Specialize<ReadClockOffsetCompleteView, EventView>},
+        {EventCode::CONNECTION_PACKET_TYPE_CHANGED,
+         &Specialize<ConnectionPacketTypeChangedView, EventView>},
+        {EventCode::QOS_VIOLATION, &Specialize<QosViolationView, EventView>},
+        {EventCode::PAGE_SCAN_REPETITION_MODE_CHANGE,
+         &Specialize<PageScanRepetitionModeChangeView, EventView>},
+        {EventCode::FLOW_SPECIFICATION_COMPLETE,
+         &Specialize<FlowSpecificationCompleteView, EventView>},
+        {EventCode::INQUIRY_RESULT_WITH_RSSI, &Specialize<InquiryResultWithRssiView, EventView>},
+        {EventCode::READ_REMOTE_EXTENDED_FEATURES_COMPLETE,
+         &Specialize<ReadRemoteExtendedFeaturesCompleteView, EventView>},
+        {EventCode::SYNCHRONOUS_CONNECTION_COMPLETE,
+         &Specialize<SynchronousConnectionCompleteView, EventView>},
+        {EventCode::SYNCHRONOUS_CONNECTION_CHANGED,
+         &Specialize<SynchronousConnectionChangedView, EventView>},
+        {EventCode::SNIFF_SUBRATING, &Specialize<SniffSubratingEventView, EventView>},
+        {EventCode::EXTENDED_INQUIRY_RESULT, &Specialize<ExtendedInquiryResultView, EventView>},
+        {EventCode::ENCRYPTION_KEY_REFRESH_COMPLETE,
+         &Specialize<EncryptionKeyRefreshCompleteView, EventView>},
+        {EventCode::IO_CAPABILITY_REQUEST, &Specialize<IoCapabilityRequestView, EventView>},
+        {EventCode::IO_CAPABILITY_RESPONSE, &Specialize<IoCapabilityResponseView, EventView>},
+        {EventCode::USER_CONFIRMATION_REQUEST, &Specialize<UserConfirmationRequestView, EventView>},
+        {EventCode::USER_PASSKEY_REQUEST, &Specialize<UserPasskeyRequestView, EventView>},
+        {EventCode::REMOTE_OOB_DATA_REQUEST, &Specialize<RemoteOobDataRequestView, EventView>},
+        {EventCode::SIMPLE_PAIRING_COMPLETE, &Specialize<SimplePairingCompleteView, EventView>},
+        {EventCode::LINK_SUPERVISION_TIMEOUT_CHANGED,
+         &Specialize<LinkSupervisionTimeoutChangedView, EventView>},
+        {EventCode::ENHANCED_FLUSH_COMPLETE, &Specialize<EnhancedFlushCompleteView, EventView>},
+        {EventCode::USER_PASSKEY_NOTIFICATION, &Specialize<UserPasskeyNotificationView, EventView>},
+        {EventCode::KEYPRESS_NOTIFICATION, &Specialize<KeypressNotificationView, EventView>},
+        {EventCode::REMOTE_HOST_SUPPORTED_FEATURES_NOTIFICATION,
+         &Specialize<RemoteHostSupportedFeaturesNotificationView, EventView>},
+        {EventCode::NUMBER_OF_COMPLETED_DATA_BLOCKS,
+         &Specialize<NumberOfCompletedDataBlocksView, EventView>},
+        {EventCode::AUTHENTICATED_PAYLOAD_TIMEOUT_EXPIRED,
+         &Specialize<AuthenticatedPayloadTimeoutExpiredView, EventView>},
+        {EventCode::ENCRYPTION_CHANGE_V2, &Specialize<EncryptionChangeV2View, EventView>},
+        {EventCode::VENDOR_SPECIFIC, &Specialize<VendorSpecificEventView, EventView>},
+};
+
+constexpr std::pair<SubeventCode, LeMetaEventSpecializer> kLeMetaEventSpecializers[] = {
+        {SubeventCode::CONNECTION_COMPLETE, &Specialize<LeConnectionCompleteView, LeMetaEventView>},
+        {SubeventCode::ADVERTISING_REPORT,
+         &Specialize<LeAdvertisingReportRawView, LeMetaEventView>},
+        {SubeventCode::CONNECTION_UPDATE_COMPLETE,
+         &Specialize<LeConnectionUpdateCompleteView, LeMetaEventView>},
+        {SubeventCode::READ_REMOTE_FEATURES_COMPLETE,
+         &Specialize<LeReadRemoteFeaturesCompleteView, LeMetaEventView>},
+        {SubeventCode::LONG_TERM_KEY_REQUEST,
+         &Specialize<LeLongTermKeyRequestView, LeMetaEventView>},
+        {SubeventCode::REMOTE_CONNECTION_PARAMETER_REQUEST,
+         &Specialize<LeRemoteConnectionParameterRequestView, LeMetaEventView>},
+        {SubeventCode::DATA_LENGTH_CHANGE, &Specialize<LeDataLengthChangeView, LeMetaEventView>},
+        {SubeventCode::READ_LOCAL_P256_PUBLIC_KEY_COMPLETE,
+         &Specialize<ReadLocalP256PublicKeyCompleteView, LeMetaEventView>},
+        {SubeventCode::GENERATE_DHKEY_COMPLETE,
+         &Specialize<GenerateDhKeyCompleteView, LeMetaEventView>},
+        {SubeventCode::ENHANCED_CONNECTION_COMPLETE,
+         &Specialize<LeEnhancedConnectionCompleteView, LeMetaEventView>},
+        {SubeventCode::DIRECTED_ADVERTISING_REPORT,
+         &Specialize<LeDirectedAdvertisingReportView, LeMetaEventView>},
+        {SubeventCode::PHY_UPDATE_COMPLETE, &Specialize<LePhyUpdateCompleteView, LeMetaEventView>},
+        {SubeventCode::EXTENDED_ADVERTISING_REPORT,
+         &Specialize<LeExtendedAdvertisingReportRawView, LeMetaEventView>},
+        {SubeventCode::PERIODIC_ADVERTISING_SYNC_ESTABLISHED,
+         &Specialize<LePeriodicAdvertisingSyncEstablishedView, LeMetaEventView>},
+        {SubeventCode::PERIODIC_ADVERTISING_REPORT,
+         &Specialize<LePeriodicAdvertisingReportView, LeMetaEventView>},
+        {SubeventCode::PERIODIC_ADVERTISING_SYNC_LOST,
+         &Specialize<LePeriodicAdvertisingSyncLostView, LeMetaEventView>},
+        {SubeventCode::SCAN_TIMEOUT, &Specialize<LeScanTimeoutView, LeMetaEventView>},
+        {SubeventCode::ADVERTISING_SET_TERMINATED,
+         &Specialize<LeAdvertisingSetTerminatedView, LeMetaEventView>},
+        {SubeventCode::SCAN_REQUEST_RECEIVED,
+         &Specialize<LeScanRequestReceivedView, LeMetaEventView>},
+        {SubeventCode::CHANNEL_SELECTION_ALGORITHM,
+         &Specialize<LeChannelSelectionAlgorithmView, LeMetaEventView>},
+        {SubeventCode::CONNECTIONLESS_IQ_REPORT,
+         &Specialize<LeConnectionlessIqReportView, LeMetaEventView>},
+        {SubeventCode::CONNECTION_IQ_REPORT,
+         &Specialize<LeConnectionIqReportView, LeMetaEventView>},
+        {SubeventCode::CTE_REQUEST_FAILED, &Specialize<LeCteRequestFailedView, LeMetaEventView>},
+        {SubeventCode::PERIODIC_ADVERTISING_SYNC_TRANSFER_RECEIVED,
+         &Specialize<LePeriodicAdvertisingSyncTransferReceivedView, LeMetaEventView>},
+        {SubeventCode::CIS_ESTABLISHED, &Specialize<LeCisEstablishedView, LeMetaEventView>},
+        {SubeventCode::CIS_REQUEST, &Specialize<LeCisRequestView, LeMetaEventView>},
+        {SubeventCode::CREATE_BIG_COMPLETE, &Specialize<LeCreateBigCompleteView, LeMetaEventView>},
+        {SubeventCode::TERMINATE_BIG_COMPLETE,
+         &Specialize<LeTerminateBigCompleteView, LeMetaEventView>},
+        {SubeventCode::BIG_SYNC_ESTABLISHED,
+         &Specialize<LeBigSyncEstablishedView, LeMetaEventView>},
+        {SubeventCode::BIG_SYNC_LOST, &Specialize<LeBigSyncLostView, LeMetaEventView>},
+        {SubeventCode::REQUEST_PEER_SCA_COMPLETE,
+         &Specialize<LeRequestPeerScaCompleteView, LeMetaEventView>},
+        {SubeventCode::PATH_LOSS_THRESHOLD, &Specialize<LePathLossThresholdView, LeMetaEventView>},
+        {SubeventCode::TRANSMIT_POWER_REPORTING,
+         &Specialize<LeTransmitPowerReportingView, LeMetaEventView>},
+        {SubeventCode::BIG_INFO_ADVERTISING_REPORT,
+         &Specialize<LeBigInfoAdvertisingReportView, LeMetaEventView>},
+        {SubeventCode::LE_SUBRATE_CHANGE, &Specialize<LeSubrateChangeView, LeMetaEventView>},
+        {SubeventCode::LE_CS_READ_REMOTE_SUPPORTED_CAPABILITIES_COMPLETE,
+         &Specialize<LeCsReadRemoteSupportedCapabilitiesCompleteView, LeMetaEventView>},
+        {SubeventCode::LE_CS_READ_REMOTE_FAE_TABLE_COMPLETE,
+         &Specialize<LeCsReadRemoteFaeTableCompleteView, LeMetaEventView>},
+        {SubeventCode::LE_CS_SECURITY_ENABLE_COMPLETE,
+         &Specialize<LeCsSecurityEnableCompleteView, LeMetaEventView>},
+        {SubeventCode::LE_CS_CONFIG_COMPLETE, &Specialize<LeCsConfigCompleteView, LeMetaEventView>},
+        {SubeventCode::LE_CS_PROCEDURE_ENABLE_COMPLETE,
+         &Specialize<LeCsProcedureEnableCompleteView, LeMetaEventView>},
+        {SubeventCode::LE_CS_SUBEVENT_RESULT, &Specialize<LeCsSubeventResultView, LeMetaEventView>},
+        {SubeventCode::LE_CS_SUBEVENT_RESULT_CONTINUE,
+         &Specialize<LeCsSubeventResultContinueView, LeMetaEventView>},
+        {SubeventCode::LE_CS_TEST_END_COMPLETE,
+         &Specialize<LeCsTestEndCompleteView, LeMetaEventView>},
+};
+
+// Indexed by code, so that the lookup does not weigh on the specialization being measured
+template <class Code, class Specializer, size_t N>
+std::array<Specializer, 256> MakeSpecializerTable(
+        const std::pair<Code, Specializer> (&entries)[N]) {
+  std::array<Specializer, 256> table{};
+  for (const auto& [code, specializer] : entries) {
+    table[static_cast<uint8_t>(code)] = specializer;
+  }
+  return table;
+}
+
+void BM_DispatchAllEventTypes(State& state) {
+  auto events = MakeAllEvents();
+  auto event_specializers = MakeSpecializerTable(kEventSpecializers);
+  auto le_meta_event_specializers = MakeSpecializerTable(kLeMetaEventSpecializers);
+  for (auto _ : state) {
+    for (const auto& packet : events) {
+      auto event = EventView::Create(packet);
+      if (!event.IsValid()) {
+        continue;
+      }
+      if (event.GetEventCode() == EventCode::LE_META_EVENT) {
+        auto meta_event = LeMetaEventView::Create(event);
+        if (!meta_event.IsValid()) {
+          continue;
+        }
+        auto specializer =
+                le_meta_event_specializers[static_cast<uint8_t>(meta_event.GetSubeventCode())];
+        if (specializer != nullptr) {
+          benchmark::DoNotOptimize(specializer(meta_event));
+        }
+      } else {
+        auto specializer = event_specializers[static_cast<uint8_t>(event.GetEventCode())];
+        if (specializer != nullptr) {
+          benchmark::DoNotOptimize(specializer(event));
+        }
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_DispatchAllEventTypes);
+
+void BM_SpecializeCommandComplete(State& state) {
+  auto packet = MakeView({0x0e, 0x0a, 0x01, 0x09, 0x10, 0x00, 0x14, 0x8e, 0x61, 0x5f, 0x36, 0x88});
+  for (auto _ : state) {
+    auto event = EventView::Create(packet);
+    if (!event.IsValid()) {
+      state.SkipWithError("Invalid event");
+      break;
+    }
+    auto command_complete = CommandCompleteView::Create(event);
+    if (!command_complete.IsValid()) {
+      state.SkipWithError("Invalid command complete");
+      break;
+    }
+    auto complete = ReadBdAddrCompleteView::Create(command_complete);
+    if (!complete.IsValid()) {
+      state.SkipWithError("Invalid read bd addr complete");
+      break;
+    }
+    benchmark::DoNotOptimize(complete.GetBdAddr());
+  }
+}
+BENCHMARK(BM_SpecializeCommandComplete);
+
+void BM_SpecializeLeAdvertisingReport(State& state) {
+  std::vector<uint8_t> bytes = {0x3e, 0x00, 0x02, 0x00};
+  uint8_t num_responses = state.range(0);
+  for (uint8_t i = 0; i < num_responses; i++) {
+    std::vector<uint8_t> response = {0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, i,
+                                     0x03, 0x02, 0x01, 0x06, 0xc4};
+    bytes.insert(bytes.end(), response.begin(), response.end());
+  }
+  bytes[1] = bytes.size() - 2;
+  bytes[3] = num_responses;
+  auto packet = MakeView(std::move(bytes));
+
+  for (auto _ : state) {
+    auto event = EventView::Create(packet);
+    if (!event.IsValid()) {
+      state.SkipWithError("Invalid event");
+      break;
+    }
+    auto meta_event = LeMetaEventView::Create(event);
+    if (!meta_event.IsValid()) {
+      state.SkipWithError("Invalid LE meta event");
+      break;
+    }
+    auto report = LeAdvertisingReportRawView::Create(meta_event);
+    if (!report.IsValid()) {
+      state.SkipWithError("Invalid advertising report");
+      break;
+    }
+    benchmark::DoNotOptimize(report.GetResponses());
+  }
+  state.SetItemsProcessed(state.iterations() * num_responses);
+}
+BENCHMARK(BM_SpecializeLeAdvertisingReport)->Arg(1)->Arg(4)->Arg(16);
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -19,6 +19,9 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
+#include <set>
+
 #include "hci/octets.h"
 #include "include/macros.h"
 #include "os/rand.h"
@@ -317,6 +320,23 @@ void LeAddressManager::push_command(Command command) {
   cached_commands_.push(std::move(command));
 }
 
+void LeAddressManager::push_commands(std::vector<Command> commands) {
+  if (commands.empty()) {
+    return;
+  }
+  bool idle = cached_commands_.empty();
+  for (auto& command : commands) {
+    cached_commands_.push(std::move(command));
+  }
+  // A single pause covers the whole batch, check_cached_commands() keeps the
+  // clients paused until the queue is drained.
+  if (!registered_clients_.empty()) {
+    pause_registered_clients();
+  } else if (idle) {
+    handle_next_command();
+  }
+}
+
 void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
   if (registered_clients_.find(callback) == registered_clients_.end()) {
     log::info("No clients registered to ack pause");
@@ -572,6 +592,18 @@ void LeAddressManager::handle_next_command() {
 
 void LeAddressManager::AddDeviceToFilterAcceptList(
         FilterAcceptListAddressType accept_list_address_type, bluetooth::hci::Address address) {
+  AcceptListKey key = {accept_list_address_type, address};
+  if (controller_accept_list_.count(key) == 0 &&
+      controller_accept_list_.size() >= accept_list_size_) {
+    // The controller would reject it, wait for an entry to be removed or rotated out
+    if (std::find(host_accept_list_.begin(), host_accept_list_.end(), key) ==
+        host_accept_list_.end()) {
+      log::info("Accept list is full, {} waits on the host", address);
+      host_accept_list_.push_back(key);
+    }
+    return;
+  }
+  controller_accept_list_[key] = accept_list_sequence_++;
   auto packet_builder =
           hci::LeAddDeviceToFilterAcceptListBuilder::Create(accept_list_address_type, address);
   Command command = {CommandType::ADD_DEVICE_TO_ACCEPT_LIST, HCICommand{std::move(packet_builder)}};
@@ -592,6 +624,8 @@ void LeAddressManager::AddDeviceToResolvingList(PeerAddressType peer_identity_ad
                      HCICommand{std::move(disable_builder)}};
   cached_commands_.push(std::move(disable));
 
+  controller_resolving_list_[{peer_identity_address_type, peer_identity_address}] = {
+          peer_identity_address_type, peer_identity_address, peer_irk, local_irk};
   auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
           peer_identity_address_type, peer_identity_address, peer_irk, local_irk);
   Command command = {CommandType::ADD_DEVICE_TO_RESOLVING_LIST,
@@ -620,11 +654,25 @@ void LeAddressManager::AddDeviceToResolvingList(PeerAddressType peer_identity_ad
 
 void LeAddressManager::RemoveDeviceFromFilterAcceptList(
         FilterAcceptListAddressType accept_list_address_type, bluetooth::hci::Address address) {
+  AcceptListKey key = {accept_list_address_type, address};
+  auto host_entry = std::find(host_accept_list_.begin(), host_accept_list_.end(), key);
+  if (host_entry != host_accept_list_.end()) {
+    // Never made it to the controller
+    host_accept_list_.erase(host_entry);
+    return;
+  }
+  controller_accept_list_.erase(key);
+
   auto packet_builder =
           hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(accept_list_address_type, address);
   Command command = {CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST,
                      HCICommand{std::move(packet_builder)}};
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command))();
+
+  std::vector<Command> promoted;
+  if (promote_host_accept_list_entry(&promoted)) {
+    handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(promoted.front()))();
+  }
 }
 
 void LeAddressManager::RemoveDeviceFromResolvingList(PeerAddressType peer_identity_address_type,
@@ -633,6 +681,13 @@ void LeAddressManager::RemoveDeviceFromResolvingList(PeerAddressType peer_identi
     return;
   }
 
+  ResolvingListKey key = {peer_identity_address_type, peer_identity_address};
+  if (host_resolving_list_.erase(key) != 0) {
+    // Never made it to the controller
+    return;
+  }
+  controller_resolving_list_.erase(key);
+
   // Disable Address resolution
   auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
   Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE,
@@ -645,6 +700,12 @@ void LeAddressManager::RemoveDeviceFromResolvingList(PeerAddressType peer_identi
                      HCICommand{std::move(packet_builder)}};
   cached_commands_.push(std::move(command));
 
+  std::vector<Command> promoted;
+  promote_host_resolving_list_entry(&promoted);
+  for (auto& promoted_command : promoted) {
+    cached_commands_.push(std::move(promoted_command));
+  }
+
   // Enable Address resolution
   auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
   Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE,
@@ -659,6 +720,9 @@ void LeAddressManager::RemoveDeviceFromResolvingList(PeerAddressType peer_identi
 }
 
 void LeAddressManager::ClearFilterAcceptList() {
+  controller_accept_list_.clear();
+  host_accept_list_.clear();
+  pinned_accept_list_.clear();
   auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
   Command command = {CommandType::CLEAR_ACCEPT_LIST, HCICommand{std::move(packet_builder)}};
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command))();
@@ -669,6 +733,9 @@ void LeAddressManager::ClearResolvingList() {
     return;
   }
 
+  controller_resolving_list_.clear();
+  host_resolving_list_.clear();
+
   // Disable Address resolution
   auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
   Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE,
@@ -688,6 +755,241 @@ void LeAddressManager::ClearResolvingList() {
   handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients)();
 }
 
+void LeAddressManager::add_resolving_list_entry_commands(const ResolvingListEntry& entry,
+                                                         std::vector<Command>* commands) {
+  auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
+          entry.peer_identity_address_type, entry.peer_identity_address, entry.peer_irk,
+          entry.local_irk);
+  commands->push_back(
+          {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+
+  auto privacy_mode_builder = hci::LeSetPrivacyModeBuilder::Create(
+          entry.peer_identity_address_type, entry.peer_identity_address, PrivacyMode::DEVICE);
+  commands->push_back(
+          {CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(privacy_mode_builder)}});
+}
+
+bool LeAddressManager::promote_host_accept_list_entry(std::vector<Command>* commands) {
+  if (host_accept_list_.empty() || controller_accept_list_.size() >= accept_list_size_) {
+    return false;
+  }
+  // Pinned entries get the room first, the others in the order they started waiting
+  auto waiting = std::find_if(host_accept_list_.begin(), host_accept_list_.end(),
+                              [this](const AcceptListKey& key) {
+                                return pinned_accept_list_.count(key) != 0;
+                              });
+  if (waiting == host_accept_list_.end()) {
+    waiting = host_accept_list_.begin();
+  }
+  auto entry = *waiting;
+  host_accept_list_.erase(waiting);
+  controller_accept_list_[entry] = accept_list_sequence_++;
+  log::info("Moving {} from the host to the controller accept list", entry.second);
+
+  auto packet_builder =
+          hci::LeAddDeviceToFilterAcceptListBuilder::Create(entry.first, entry.second);
+  commands->push_back(
+          {CommandType::ADD_DEVICE_TO_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+  return true;
+}
+
+bool LeAddressManager::promote_host_resolving_list_entry(std::vector<Command>* commands) {
+  if (host_resolving_list_.empty() || controller_resolving_list_.size() >= resolving_list_size_) {
+    return false;
+  }
+  auto node = host_resolving_list_.extract(host_resolving_list_.begin());
+  log::info("Moving {} from the host to the controller resolving list",
+            node.mapped().peer_identity_address);
+  add_resolving_list_entry_commands(node.mapped(), commands);
+  controller_resolving_list_.insert(std::move(node));
+  return true;
+}
+
+void LeAddressManager::set_pinned_accept_list(
+        const std::unordered_set<AddressWithType>& pinned) {
+  pinned_accept_list_.clear();
+  for (const auto& address_with_type : pinned) {
+    pinned_accept_list_.insert(
+            {address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress()});
+  }
+}
+
+bool LeAddressManager::demote_controller_accept_list_entry(uint64_t before_sequence,
+                                                           std::vector<Command>* commands) {
+  auto oldest = controller_accept_list_.end();
+  for (auto it = controller_accept_list_.begin(); it != controller_accept_list_.end(); it++) {
+    if (it->second >= before_sequence || pinned_accept_list_.count(it->first) != 0) {
+      continue;
+    }
+    if (oldest == controller_accept_list_.end() || it->second < oldest->second) {
+      oldest = it;
+    }
+  }
+  if (oldest == controller_accept_list_.end()) {
+    return false;
+  }
+  AcceptListKey key = oldest->first;
+  controller_accept_list_.erase(oldest);
+  log::info("Moving {} from the controller to the host accept list", key.second);
+  auto packet_builder =
+          hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(key.first, key.second);
+  commands->push_back(
+          {CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+  promote_host_accept_list_entry(commands);
+  host_accept_list_.push_back(key);
+  return true;
+}
+
+void LeAddressManager::RotateFilterAcceptList(size_t count,
+                                              const std::unordered_set<AddressWithType>& pinned) {
+  set_pinned_accept_list(pinned);
+
+  // Entries promoted by this rotation are not moved out again
+  uint64_t rotation_start = accept_list_sequence_;
+  std::vector<Command> commands;
+  for (size_t i = 0; i < count && !host_accept_list_.empty(); i++) {
+    if (!demote_controller_accept_list_entry(rotation_start, &commands)) {
+      break;
+    }
+  }
+  if (commands.empty()) {
+    return;
+  }
+  handler_->BindOnceOn(this, &LeAddressManager::push_commands, std::move(commands))();
+}
+
+bool LeAddressManager::IsDeviceInControllerFilterAcceptList(
+        FilterAcceptListAddressType accept_list_address_type, Address address) const {
+  return controller_accept_list_.count({accept_list_address_type, address}) != 0;
+}
+
+void LeAddressManager::UpdateFilterAcceptList(
+        std::vector<std::pair<FilterAcceptListAddressType, Address>> accept_list,
+        const std::unordered_set<AddressWithType>& pinned) {
+  std::set<AcceptListKey> wanted(accept_list.begin(), accept_list.end());
+  set_pinned_accept_list(pinned);
+  std::vector<Command> commands;
+
+  // Remove first, so that the room is available for the new entries
+  for (auto it = controller_accept_list_.begin(); it != controller_accept_list_.end();) {
+    if (wanted.count(it->first) != 0) {
+      it++;
+      continue;
+    }
+    auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(
+            it->first.first, it->first.second);
+    commands.push_back({CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST,
+                        HCICommand{std::move(packet_builder)}});
+    it = controller_accept_list_.erase(it);
+  }
+
+  // Entries already waiting keep their place, and get the room before the new ones
+  host_accept_list_.erase(std::remove_if(host_accept_list_.begin(), host_accept_list_.end(),
+                                         [&wanted](const AcceptListKey& key) {
+                                           return wanted.count(key) == 0;
+                                         }),
+                          host_accept_list_.end());
+  while (promote_host_accept_list_entry(&commands)) {
+  }
+
+  for (const auto& entry : accept_list) {
+    if (controller_accept_list_.count(entry) != 0 ||
+        std::find(host_accept_list_.begin(), host_accept_list_.end(), entry) !=
+                host_accept_list_.end()) {
+      continue;
+    }
+    if (controller_accept_list_.size() >= accept_list_size_) {
+      host_accept_list_.push_back(entry);
+      continue;
+    }
+    auto packet_builder =
+            hci::LeAddDeviceToFilterAcceptListBuilder::Create(entry.first, entry.second);
+    commands.push_back(
+            {CommandType::ADD_DEVICE_TO_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+    controller_accept_list_[entry] = accept_list_sequence_++;
+  }
+
+  // A pinned entry does not wait for the next rotation, the oldest background entry makes
+  // room for it right away
+  while (std::any_of(host_accept_list_.begin(), host_accept_list_.end(),
+                     [this](const AcceptListKey& key) {
+                       return pinned_accept_list_.count(key) != 0;
+                     })) {
+    if (!demote_controller_accept_list_entry(accept_list_sequence_, &commands)) {
+      break;
+    }
+  }
+
+  if (!host_accept_list_.empty()) {
+    log::warn("Accept list is full, {} entries kept on the host", host_accept_list_.size());
+  }
+  if (commands.empty()) {
+    return;
+  }
+  log::info("Updating accept list with {} commands", commands.size());
+  handler_->BindOnceOn(this, &LeAddressManager::push_commands, std::move(commands))();
+}
+
+void LeAddressManager::UpdateResolvingList(std::vector<ResolvingListEntry> resolving_list) {
+  if (!supports_ble_privacy_) {
+    return;
+  }
+
+  std::map<ResolvingListKey, ResolvingListEntry> wanted;
+  for (const auto& entry : resolving_list) {
+    wanted[{entry.peer_identity_address_type, entry.peer_identity_address}] = entry;
+  }
+  std::vector<Command> commands;
+
+  // Entries whose keys changed are removed and programmed again
+  for (auto it = controller_resolving_list_.begin(); it != controller_resolving_list_.end();) {
+    auto wanted_entry = wanted.find(it->first);
+    if (wanted_entry != wanted.end() &&
+        wanted_entry->second.peer_irk == it->second.peer_irk &&
+        wanted_entry->second.local_irk == it->second.local_irk) {
+      wanted.erase(wanted_entry);
+      it++;
+      continue;
+    }
+    auto packet_builder = hci::LeRemoveDeviceFromResolvingListBuilder::Create(it->first.first,
+                                                                              it->first.second);
+    commands.push_back({CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST,
+                        HCICommand{std::move(packet_builder)}});
+    it = controller_resolving_list_.erase(it);
+  }
+
+  host_resolving_list_.clear();
+  for (auto& [key, entry] : wanted) {
+    if (controller_resolving_list_.size() >= resolving_list_size_) {
+      host_resolving_list_.emplace(key, entry);
+      continue;
+    }
+    add_resolving_list_entry_commands(entry, &commands);
+    controller_resolving_list_.emplace(key, entry);
+  }
+
+  if (!host_resolving_list_.empty()) {
+    log::warn("Resolving list is full, {} entries kept on the host", host_resolving_list_.size());
+  }
+  if (commands.empty()) {
+    return;
+  }
+  log::info("Updating resolving list with {} commands", commands.size());
+
+  // Address resolution is only disabled once around the whole update
+  std::vector<Command> batch;
+  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
+  batch.push_back(
+          {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}});
+  for (auto& command : commands) {
+    batch.push_back(std::move(command));
+  }
+  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
+  batch.push_back(
+          {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}});
+  handler_->BindOnceOn(this, &LeAddressManager::push_commands, std::move(batch))();
+}
+
 template <class View>
 void LeAddressManager::on_command_complete(CommandCompleteView view) {
   auto op_code = view.GetCommandOpCode();
@@ -17,8 +17,13 @@
 
 #include <bluetooth/log.h>
 
+#include <array>
 #include <map>
+#include <set>
+#include <unordered_set>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -96,12 +101,43 @@ public:
                                      Address peer_identity_address);
   void ClearFilterAcceptList();
   void ClearResolvingList();
+
+  struct ResolvingListEntry {
+    PeerAddressType peer_identity_address_type;
+    Address peer_identity_address;
+    std::array<uint8_t, 16> peer_irk;
+    std::array<uint8_t, 16> local_irk;
+  };
+
+  // Make the controller accept list match the given one. Only the difference with what is
+  // programmed is sent, and all the commands go out inside a single pause of the clients.
+  // Entries that do not fit in the controller wait on the host, in the given order after
+  // the ones already waiting. A waiting |pinned| entry takes the room of the oldest entry
+  // that is not pinned right away, and gets the room first whenever an entry is removed.
+  void UpdateFilterAcceptList(
+          std::vector<std::pair<FilterAcceptListAddressType, Address>> accept_list,
+          const std::unordered_set<AddressWithType>& pinned = {});
+  // Make the controller resolving list match the given one. Only the difference with what is
+  // programmed is sent, and all the commands go out inside a single pause of the clients.
+  // Entries that do not fit in the controller are kept on the host, and programmed as soon
+  // as an entry is removed from the controller list.
+  void UpdateResolvingList(std::vector<ResolvingListEntry> resolving_list);
+  // Moves up to |count| entries out of the controller accept list, the ones programmed
+  // first, to make room for the entries waiting on the host. The moved entries are put
+  // back at the end of the host queue. |pinned| entries are never moved out, and get the
+  // room first when they are waiting.
+  void RotateFilterAcceptList(size_t count, const std::unordered_set<AddressWithType>& pinned = {});
+  bool HasWaitingFilterAcceptListEntries() const { return !host_accept_list_.empty(); }
+  bool IsDeviceInControllerFilterAcceptList(FilterAcceptListAddressType accept_list_address_type,
+                                            Address address) const;
   void OnCommandComplete(CommandCompleteView view);
   std::chrono::milliseconds GetNextPrivateAddressIntervalMs();
   PrivateAddressIntervalRange GetNextPrivateAddressIntervalRange();
 
   // Unsynchronized check for testing purposes
   size_t NumberCachedCommands() const { return cached_commands_.size(); }
+  size_t NumberHostAcceptListEntries() const { return host_accept_list_.size(); }
+  size_t NumberHostResolvingListEntries() const { return host_resolving_list_.size(); }
 
 protected:
   AddressPolicy address_policy_ = AddressPolicy::POLICY_NOT_SET;
@@ -143,8 +179,19 @@ private:
     std::variant<RotateRandomAddressCommand, UpdateIRKCommand, HCICommand> contents;
   };
 
+  using AcceptListKey = std::pair<FilterAcceptListAddressType, Address>;
+  using ResolvingListKey = std::pair<PeerAddressType, Address>;
+
   void pause_registered_clients();
   void push_command(Command command);
+  void push_commands(std::vector<Command> commands);
+  void add_resolving_list_entry_commands(const ResolvingListEntry& entry,
+                                         std::vector<Command>* commands);
+  bool promote_host_accept_list_entry(std::vector<Command>* commands);
+  bool demote_controller_accept_list_entry(uint64_t before_sequence,
+                                           std::vector<Command>* commands);
+  void set_pinned_accept_list(const std::unordered_set<AddressWithType>& pinned);
+  bool promote_host_resolving_list_entry(std::vector<Command>* commands);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
   void ack_resume(LeAddressManagerCallback* callback);
@@ -177,6 +224,15 @@ private:
   uint8_t resolving_list_size_;
   std::queue<Command> cached_commands_;
   bool supports_ble_privacy_{false};
+
+  // What is expected to be programmed in the controller, and what did not fit. Controller
+  // entries map to the order in which they were programmed.
+  std::map<AcceptListKey, uint64_t> controller_accept_list_;
+  uint64_t accept_list_sequence_{0};
+  std::vector<AcceptListKey> host_accept_list_;
+  std::set<AcceptListKey> pinned_accept_list_;
+  std::map<ResolvingListKey, ResolvingListEntry> controller_resolving_list_;
+  std::map<ResolvingListKey, ResolvingListEntry> host_resolving_list_;
 };
 
 }  // namespace hci
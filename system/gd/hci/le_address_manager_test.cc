@@ -18,6 +18,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
 #include "hci/hci_layer_fake.h"
 #include "hci/octets.h"
 #include "packet/raw_builder.h"
@@ -41,6 +46,7 @@ public:
 
   void OnPause() {
     paused = true;
+    pause_count++;
     le_address_manager_->AckPause(this);
   }
 
@@ -64,6 +70,7 @@ public:
   }
 
   bool paused{false};
+  size_t pause_count{0};
   LeAddressManager* le_address_manager_;
   size_t id_;
   std::unique_ptr<std::promise<void>> resume_promise_;
@@ -197,7 +204,7 @@ public:
     le_address_manager_ = new LeAddressManager(
             common::Bind(&LeAddressManagerWithSingleClientTest::enqueue_command,
                          common::Unretained(this)),
-            handler_, address, 0x3F, 0x3F);
+            handler_, address, accept_list_size_, resolving_list_size_);
     AllocateClients(1);
 
     Octet16 irk = {0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05,
@@ -206,8 +213,8 @@ public:
     auto maximum_rotation_time = std::chrono::milliseconds(3000);
     AddressWithType remote_address(Address::kEmpty, AddressType::RANDOM_DEVICE_ADDRESS);
     le_address_manager_->SetPrivacyPolicyForInitiatorAddress(
-            LeAddressManager::AddressPolicy::USE_RESOLVABLE_ADDRESS, remote_address, irk, false,
-            minimum_rotation_time, maximum_rotation_time);
+            LeAddressManager::AddressPolicy::USE_RESOLVABLE_ADDRESS, remote_address, irk,
+            supports_ble_privacy_, minimum_rotation_time, maximum_rotation_time);
 
     le_address_manager_->Register(clients[0].get());
     sync_handler(handler_);
@@ -230,6 +237,11 @@ public:
     delete handler_;
     delete thread_;
   }
+
+protected:
+  uint8_t accept_list_size_ = 0x3F;
+  uint8_t resolving_list_size_ = 0x3F;
+  bool supports_ble_privacy_ = false;
 };
 
 TEST_F(LeAddressManagerWithSingleClientTest, add_device_to_accept_list) {
@@ -452,6 +464,338 @@ TEST_F(LeAddressManagerWithSingleClientTest, register_during_command_complete) {
   clients[1].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, rotate_filter_accept_list) {
+  // Fill the controller accept list, two more entries wait on the host
+  uint8_t accept_list_size = le_address_manager_->GetFilterAcceptListSize();
+  std::vector<Address> addresses;
+  for (uint8_t i = 0; i < accept_list_size + 2; i++) {
+    addresses.push_back(Address({0x01, 0x02, 0x03, 0x04, 0x05, i}));
+    le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM,
+                                                     addresses.back());
+  }
+  for (uint8_t i = 0; i < accept_list_size; i++) {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+    auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+            LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(addresses[i], packet_view.GetAddress());
+    hci_layer_->IncomingEvent(
+            LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(2u, le_address_manager_->NumberHostAcceptListEntries());
+  ASSERT_TRUE(le_address_manager_->HasWaitingFilterAcceptListEntries());
+
+  // The two oldest entries make room for the waiting ones
+  le_address_manager_->RotateFilterAcceptList(2);
+  for (uint8_t i = 0; i < 2; i++) {
+    auto remove = hci_layer_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST);
+    auto remove_view = LeRemoveDeviceFromFilterAcceptListView::Create(
+            LeConnectionManagementCommandView::Create(AclCommandView::Create(remove)));
+    ASSERT_TRUE(remove_view.IsValid());
+    ASSERT_EQ(addresses[i], remove_view.GetAddress());
+    hci_layer_->IncomingEvent(
+            LeRemoveDeviceFromFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+
+    auto add = hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+    auto add_view = LeAddDeviceToFilterAcceptListView::Create(
+            LeConnectionManagementCommandView::Create(AclCommandView::Create(add)));
+    ASSERT_TRUE(add_view.IsValid());
+    ASSERT_EQ(addresses[accept_list_size + i], add_view.GetAddress());
+    hci_layer_->IncomingEvent(
+            LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(2u, le_address_manager_->NumberHostAcceptListEntries());
+  ASSERT_FALSE(le_address_manager_->IsDeviceInControllerFilterAcceptList(
+          FilterAcceptListAddressType::RANDOM, addresses[0]));
+  ASSERT_TRUE(le_address_manager_->IsDeviceInControllerFilterAcceptList(
+          FilterAcceptListAddressType::RANDOM, addresses[accept_list_size]));
+}
+
+TEST_F(LeAddressManagerWithSingleClientTest, update_filter_accept_list_in_single_pause) {
+  Address address1, address2, address3;
+  Address::FromString("01:02:03:04:05:06", address1);
+  Address::FromString("01:02:03:04:05:07", address2);
+  Address::FromString("01:02:03:04:05:08", address3);
+  size_t pause_count = clients[0]->pause_count;
+
+  le_address_manager_->UpdateFilterAcceptList({{FilterAcceptListAddressType::RANDOM, address1},
+                                               {FilterAcceptListAddressType::RANDOM, address2}});
+  for (auto address : {address1, address2}) {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+    auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+            LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(address, packet_view.GetAddress());
+    hci_layer_->IncomingEvent(
+            LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(pause_count + 1, clients[0]->pause_count);
+
+  // Only the difference is sent
+  le_address_manager_->UpdateFilterAcceptList({{FilterAcceptListAddressType::RANDOM, address2},
+                                               {FilterAcceptListAddressType::RANDOM, address3}});
+  {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST);
+    auto packet_view = LeRemoveDeviceFromFilterAcceptListView::Create(
+            LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(address1, packet_view.GetAddress());
+    hci_layer_->IncomingEvent(
+            LeRemoveDeviceFromFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+    auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+            LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(address3, packet_view.GetAddress());
+    hci_layer_->IncomingEvent(
+            LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(pause_count + 2, clients[0]->pause_count);
+  ASSERT_EQ(0u, le_address_manager_->NumberHostAcceptListEntries());
+}
+
+class LeAddressManagerWithSmallAcceptListTest : public LeAddressManagerWithSingleClientTest {
+public:
+  LeAddressManagerWithSmallAcceptListTest() { accept_list_size_ = 8; }
+
+  Address ExpectAcceptListCommand(OpCode op_code) {
+    auto packet = hci_layer_->GetCommand(op_code);
+    Address address;
+    if (op_code == OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST) {
+      auto view = LeAddDeviceToFilterAcceptListView::Create(
+              LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+      EXPECT_TRUE(view.IsValid());
+      address = view.GetAddress();
+      hci_layer_->IncomingEvent(
+              LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+    } else {
+      auto view = LeRemoveDeviceFromFilterAcceptListView::Create(
+              LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+      EXPECT_TRUE(view.IsValid());
+      address = view.GetAddress();
+      hci_layer_->IncomingEvent(LeRemoveDeviceFromFilterAcceptListCompleteBuilder::Create(
+              0x01, ErrorCode::SUCCESS));
+    }
+    return address;
+  }
+};
+
+TEST_F(LeAddressManagerWithSmallAcceptListTest, rotate_filter_accept_list_storm) {
+  // Two direct targets are added first, a third one after 50 background targets
+  constexpr size_t kNumBackground = 50;
+  std::vector<Address> addresses;
+  std::unordered_set<AddressWithType> pinned;
+  std::set<Address> background;
+  for (size_t i = 0; i < kNumBackground + 3; i++) {
+    Address address({0x01, 0x02, 0x03, 0x04, static_cast<uint8_t>(i >> 8),
+                     static_cast<uint8_t>(i)});
+    addresses.push_back(address);
+    if (i < 2 || i == kNumBackground + 2) {
+      pinned.insert(AddressWithType(address, AddressType::RANDOM_DEVICE_ADDRESS));
+    } else {
+      background.insert(address);
+    }
+    le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM,
+                                                     address);
+  }
+  std::set<Address> seen;
+  for (size_t i = 0; i < accept_list_size_; i++) {
+    seen.insert(ExpectAcceptListCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST));
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(addresses.size() - accept_list_size_,
+            le_address_manager_->NumberHostAcceptListEntries());
+
+  // Each rotation moves out the background targets programmed before it, in a single pause
+  size_t rotations = 0;
+  while (!std::includes(seen.begin(), seen.end(), background.begin(), background.end())) {
+    ASSERT_LT(rotations++, kNumBackground);
+    size_t num_pinned = 0;
+    for (const auto& address_with_type : pinned) {
+      if (le_address_manager_->IsDeviceInControllerFilterAcceptList(
+                  FilterAcceptListAddressType::RANDOM, address_with_type.GetAddress())) {
+        num_pinned++;
+      }
+    }
+    size_t pause_count = clients[0]->pause_count;
+    le_address_manager_->RotateFilterAcceptList(accept_list_size_, pinned);
+    for (size_t i = 0; i < accept_list_size_ - num_pinned; i++) {
+      Address removed = ExpectAcceptListCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST);
+      ASSERT_EQ(0u, pinned.count(AddressWithType(removed, AddressType::RANDOM_DEVICE_ADDRESS)));
+      seen.insert(ExpectAcceptListCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST));
+    }
+    clients[0].get()->WaitForResume();
+    ASSERT_EQ(pause_count + 1, clients[0]->pause_count);
+
+    // The waiting direct target got its entry in the first rotation, and kept it
+    for (const auto& address_with_type : pinned) {
+      ASSERT_TRUE(le_address_manager_->IsDeviceInControllerFilterAcceptList(
+              FilterAcceptListAddressType::RANDOM, address_with_type.GetAddress()));
+    }
+  }
+
+  // Five background targets take turns in each rotation
+  ASSERT_EQ(9u, rotations);
+  ASSERT_EQ(addresses.size() - accept_list_size_,
+            le_address_manager_->NumberHostAcceptListEntries());
+}
+
+TEST_F(LeAddressManagerWithSmallAcceptListTest, update_filter_accept_list_evicts_for_pinned) {
+  std::vector<std::pair<FilterAcceptListAddressType, Address>> entries;
+  for (uint8_t i = 0; i < accept_list_size_ + 1; i++) {
+    entries.emplace_back(FilterAcceptListAddressType::RANDOM,
+                         Address({0x01, 0x02, 0x03, 0x04, 0x05, i}));
+  }
+  le_address_manager_->UpdateFilterAcceptList(entries);
+  for (size_t i = 0; i < accept_list_size_; i++) {
+    ExpectAcceptListCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(1u, le_address_manager_->NumberHostAcceptListEntries());
+
+  // A new direct target takes the entry of the oldest background target, without a rotation
+  Address direct({0x01, 0x02, 0x03, 0x04, 0x06, 0x00});
+  entries.emplace_back(FilterAcceptListAddressType::RANDOM, direct);
+  std::unordered_set<AddressWithType> pinned = {
+          AddressWithType(direct, AddressType::RANDOM_DEVICE_ADDRESS)};
+  size_t pause_count = clients[0]->pause_count;
+  le_address_manager_->UpdateFilterAcceptList(entries, pinned);
+  ASSERT_EQ(entries[0].second,
+            ExpectAcceptListCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST));
+  ASSERT_EQ(direct, ExpectAcceptListCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST));
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(pause_count + 1, clients[0]->pause_count);
+  ASSERT_TRUE(le_address_manager_->IsDeviceInControllerFilterAcceptList(
+          FilterAcceptListAddressType::RANDOM, direct));
+  ASSERT_EQ(2u, le_address_manager_->NumberHostAcceptListEntries());
+
+  // The direct target waits behind the background ones, but gets the room first
+  Address second_direct({0x01, 0x02, 0x03, 0x04, 0x06, 0x01});
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM,
+                                                   second_direct);
+  pinned.insert(AddressWithType(second_direct, AddressType::RANDOM_DEVICE_ADDRESS));
+  le_address_manager_->RotateFilterAcceptList(0, pinned);
+  le_address_manager_->RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::RANDOM,
+                                                        entries[1].second);
+  ASSERT_EQ(entries[1].second,
+            ExpectAcceptListCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST));
+  ASSERT_EQ(second_direct, ExpectAcceptListCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST));
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(2u, le_address_manager_->NumberHostAcceptListEntries());
+}
+
+class LeAddressManagerWithPrivacyTest : public LeAddressManagerWithSingleClientTest {
+public:
+  LeAddressManagerWithPrivacyTest() {
+    resolving_list_size_ = 2;
+    supports_ble_privacy_ = true;
+  }
+
+  static LeAddressManager::ResolvingListEntry MakeEntry(uint8_t id) {
+    return {PeerAddressType::RANDOM_DEVICE_OR_IDENTITY_ADDRESS,
+            Address({0x01, 0x02, 0x03, 0x04, 0x05, id}),
+            {id},
+            {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+             0x0f, 0x10}};
+  }
+
+  void ExpectAddressResolutionEnable(Enable enable) {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE);
+    auto packet_view =
+            LeSetAddressResolutionEnableView::Create(LeSecurityCommandView::Create(packet));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(enable, packet_view.GetAddressResolutionEnable());
+    hci_layer_->IncomingEvent(
+            LeSetAddressResolutionEnableCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+
+  void ExpectAddToResolvingList(const LeAddressManager::ResolvingListEntry& entry) {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_RESOLVING_LIST);
+    auto packet_view =
+            LeAddDeviceToResolvingListView::Create(LeSecurityCommandView::Create(packet));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(entry.peer_identity_address, packet_view.GetPeerIdentityAddress());
+    ASSERT_EQ(entry.peer_irk, packet_view.GetPeerIrk());
+    hci_layer_->IncomingEvent(
+            LeAddDeviceToResolvingListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+
+    hci_layer_->GetCommand(OpCode::LE_SET_PRIVACY_MODE);
+    hci_layer_->IncomingEvent(LeSetPrivacyModeCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+
+  void ExpectRemoveFromResolvingList(const LeAddressManager::ResolvingListEntry& entry) {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_RESOLVING_LIST);
+    auto packet_view =
+            LeRemoveDeviceFromResolvingListView::Create(LeSecurityCommandView::Create(packet));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(entry.peer_identity_address, packet_view.GetPeerIdentityAddress());
+    hci_layer_->IncomingEvent(
+            LeRemoveDeviceFromResolvingListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+};
+
+TEST_F(LeAddressManagerWithPrivacyTest, update_resolving_list_overflows_to_host) {
+  auto entry1 = MakeEntry(1);
+  auto entry2 = MakeEntry(2);
+  auto entry3 = MakeEntry(3);
+  size_t pause_count = clients[0]->pause_count;
+
+  // The controller holds two entries, the third one is kept on the host
+  le_address_manager_->UpdateResolvingList({entry1, entry2, entry3});
+  ExpectAddressResolutionEnable(Enable::DISABLED);
+  ExpectAddToResolvingList(entry1);
+  ExpectAddToResolvingList(entry2);
+  ExpectAddressResolutionEnable(Enable::ENABLED);
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(pause_count + 1, clients[0]->pause_count);
+  ASSERT_EQ(1u, le_address_manager_->NumberHostResolvingListEntries());
+
+  // The host entry takes the room freed in the controller
+  le_address_manager_->RemoveDeviceFromResolvingList(entry1.peer_identity_address_type,
+                                                     entry1.peer_identity_address);
+  ExpectAddressResolutionEnable(Enable::DISABLED);
+  ExpectRemoveFromResolvingList(entry1);
+  ExpectAddToResolvingList(entry3);
+  ExpectAddressResolutionEnable(Enable::ENABLED);
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(0u, le_address_manager_->NumberHostResolvingListEntries());
+}
+
+TEST_F(LeAddressManagerWithPrivacyTest, update_resolving_list_sends_difference) {
+  auto entry1 = MakeEntry(1);
+  auto entry2 = MakeEntry(2);
+  auto entry3 = MakeEntry(3);
+
+  le_address_manager_->UpdateResolvingList({entry1, entry2});
+  ExpectAddressResolutionEnable(Enable::DISABLED);
+  ExpectAddToResolvingList(entry1);
+  ExpectAddToResolvingList(entry2);
+  ExpectAddressResolutionEnable(Enable::ENABLED);
+  clients[0].get()->WaitForResume();
+  size_t pause_count = clients[0]->pause_count;
+
+  // Only the entry that left is removed, and only the new one is added
+  le_address_manager_->UpdateResolvingList({entry2, entry3});
+  ExpectAddressResolutionEnable(Enable::DISABLED);
+  ExpectRemoveFromResolvingList(entry1);
+  ExpectAddToResolvingList(entry3);
+  ExpectAddressResolutionEnable(Enable::ENABLED);
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(pause_count + 1, clients[0]->pause_count);
+
+  // Nothing changed, nothing is sent
+  le_address_manager_->UpdateResolvingList({entry3, entry2});
+  sync_handler(handler_);
+  ASSERT_EQ(pause_count + 1, clients[0]->pause_count);
+  ASSERT_EQ(0u, le_address_manager_->NumberCachedCommands());
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
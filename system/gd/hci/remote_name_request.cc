@@ -19,6 +19,8 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <chrono>
+
 #include "hci/acl_manager/acl_scheduler.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
@@ -70,7 +72,7 @@ public:
             handler_->BindOnceOn(this, &impl::actually_start_remote_name_request, address,
                                  std::move(request), std::move(on_completion),
                                  std::move(on_remote_host_supported_features_notification),
-                                 on_remote_name_complete_ptr),
+                                 on_remote_name_complete_ptr, std::chrono::steady_clock::now()),
             handler_->BindOnce(
                     [&](Address address,
                         std::shared_ptr<RemoteNameCallback> on_remote_name_complete_ptr) {
@@ -96,6 +98,7 @@ public:
               "from {}",
               address.ToRedactedStringForLogging());
       pending_ = false;
+      record_time_to_name(address, ErrorCode::UNKNOWN_CONNECTION);
       on_remote_name_complete_(ErrorCode::UNKNOWN_CONNECTION, {});
       acl_scheduler_->ReportRemoteNameRequestCompletion(address);
     } else {
@@ -110,10 +113,13 @@ private:
           Address address, std::unique_ptr<RemoteNameRequestBuilder> request,
           CompletionCallback on_completion,
           RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification,
-          std::shared_ptr<RemoteNameCallback> on_remote_name_complete_ptr) {
+          std::shared_ptr<RemoteNameCallback> on_remote_name_complete_ptr,
+          std::chrono::steady_clock::time_point enqueue_time) {
     log::info("Starting remote name request to {}", address.ToRedactedStringForLogging());
     log::assert_that(pending_ == false, "assert failed: pending_ == false");
     pending_ = true;
+    enqueue_time_ = enqueue_time;
+    start_time_ = std::chrono::steady_clock::now();
     on_remote_host_supported_features_notification_ =
             std::move(on_remote_host_supported_features_notification);
     on_remote_name_complete_ = std::move(*on_remote_name_complete_ptr.get());
@@ -142,6 +148,7 @@ private:
     on_completion(status.GetStatus());
     if (status.GetStatus() != ErrorCode::SUCCESS /* pending */) {
       pending_ = false;
+      record_time_to_name(address, status.GetStatus());
       acl_scheduler_->ReportRemoteNameRequestCompletion(address);
     }
   }
@@ -182,6 +189,7 @@ private:
       log::info("Received REMOTE_NAME_REQUEST_COMPLETE from {} with status {}",
                 address.ToRedactedStringForLogging(), ErrorCodeText(status));
       pending_ = false;
+      record_time_to_name(address, status);
       on_remote_name_complete_(status, name);
       acl_scheduler_->ReportRemoteNameRequestCompletion(address);
     } else {
@@ -190,6 +198,28 @@ private:
     }
   }
 
+  // Time to name covers the time spent in the scheduler queue behind other pages as well as the
+  // page and name exchange itself.
+  void record_time_to_name(Address address, ErrorCode status) {
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+
+    const auto queued = duration_cast<milliseconds>(start_time_ - enqueue_time_);
+    const auto time_to_name =
+            duration_cast<milliseconds>(std::chrono::steady_clock::now() - enqueue_time_);
+    if (status == ErrorCode::SUCCESS) {
+      num_names_received_++;
+      total_time_to_name_ += time_to_name;
+    }
+    log::info(
+            "Remote name request to {} status:{} time_to_name:{}ms queued:{}ms, average "
+            "time_to_name:{}ms over {} names",
+            address.ToRedactedStringForLogging(), ErrorCodeText(status), time_to_name.count(),
+            queued.count(),
+            num_names_received_ ? total_time_to_name_.count() / num_names_received_ : int64_t{0},
+            num_names_received_);
+  }
+
   void on_remote_name_request_complete(EventView view) {
     auto packet = RemoteNameRequestCompleteView::Create(view);
     log::assert_that(packet.IsValid(), "Invalid packet");
@@ -214,6 +244,10 @@ private:
   os::Handler* handler_;
 
   bool pending_ = false;
+  std::chrono::steady_clock::time_point enqueue_time_;
+  std::chrono::steady_clock::time_point start_time_;
+  int64_t num_names_received_ = 0;
+  std::chrono::milliseconds total_time_to_name_{0};
   RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification_;
   RemoteNameCallback on_remote_name_complete_;
 };
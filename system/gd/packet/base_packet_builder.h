@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "packet/bit_inserter.h"
+#include "packet/span_inserter.h"
 
 namespace bluetooth {
 namespace packet {
@@ -38,6 +39,14 @@ public:
   // Write to the vector with the given iterator.
   virtual void Serialize(BitInserter& it) const = 0;
 
+  // Write to a preallocated buffer of at least size() bytes, e.g. a transmit buffer, without
+  // growing a vector byte by byte. Returns the number of bytes written.
+  size_t SerializeInto(uint8_t* buffer, size_t buffer_size) const {
+    SpanInserter it(buffer, buffer + buffer_size);
+    Serialize(it);
+    return it.size();
+  }
+
   void SetFlushable(bool is_flushable) { is_flushable_ = is_flushable; }
   bool IsFlushable() const { return is_flushable_; }
 
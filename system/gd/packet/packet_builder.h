@@ -43,9 +43,8 @@ public:
 
   // Serialize the packet to a byte vector.
   std::vector<uint8_t> SerializeToBytes() const {
-    std::vector<uint8_t> output;
-    BitInserter it(output);
-    Serialize(it);
+    std::vector<uint8_t> output(size());
+    output.resize(SerializeInto(output.data(), output.size()));
     return output;
   }
 };
@@ -91,7 +91,11 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing,
   // Constructor from a View
   if (parent_ != nullptr) {
     s << "explicit " << name_ << "View(" << parent_->name_ << "View parent)";
-    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false; }";
+    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false;";
+    // Only the parents of this class can be known to be valid.
+    size_t parent_depth = GetAncestors().size();
+    s << "if (validated_depth_ > " << parent_depth << ") { validated_depth_ = " << parent_depth
+      << "; }}";
   } else {
     s << "explicit " << name_ << "View(PacketView<" << (is_little_endian_ ? "" : "!")
       << "kLittleEndian> packet) ";
@@ -195,6 +199,9 @@ void PacketDef::GenValidator(std::ostream& s) const {
     }
   }
 
+  // Depth of this packet in its hierarchy, counting the top most class as 1.
+  size_t depth = GetAncestors().size() + 1;
+
   // Generate the public validator IsValid().
   // The method only needs to be generated for the top most class.
   if (parent_ == nullptr) {
@@ -215,7 +222,9 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "virtual bool Validate() const {" << std::endl;
   } else {
     s << "bool Validate() const override {" << std::endl;
-    s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
+    // A view specialized from an already validated parent only checks its own fields.
+    s << "  if (validated_depth_ < " << depth - 1 << " && !" << parent_->name_
+      << "View::Validate()) {" << std::endl;
     s << "    return false;" << std::endl;
     s << "  }" << std::endl;
   }
@@ -343,10 +352,14 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "\n";
   }
 
+  s << "validated_depth_ = " << depth << ";";
   s << "return true;";
   s << "}\n";
   if (parent_ == nullptr) {
     s << "bool was_validated_{false};\n";
+    // Number of classes of the hierarchy, from the top most one, that validated the packet.
+    // Copied along when a view is specialized, so that the parents are not validated again.
+    s << "mutable size_t validated_depth_{0};\n";
   }
 }
 
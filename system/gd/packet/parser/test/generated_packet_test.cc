@@ -99,6 +99,27 @@ TEST(GeneratedPacketTest, testChildTwoTwoThree) {
   ASSERT_TRUE(grandchild_view.IsValid());
 }
 
+TEST(GeneratedPacketTest, testSpecializeValidatedView) {
+  auto packet = ChildTwoTwoThreeBuilder::Create();
+  std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*packet_bytes);
+  packet->Serialize(it);
+
+  PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
+  ChildTwoTwoView child_view = ChildTwoTwoView::Create(ParentTwoView::Create(packet_bytes_view));
+  ASSERT_TRUE(child_view.IsValid());
+
+  // A sibling of a validated view still checks its own constraints and fields
+  ChildTwoThreeView sibling_view = ChildTwoThreeView::Create(child_view);
+  ASSERT_FALSE(sibling_view.IsValid());
+
+  // Only the parent of the invalid sibling is known to be valid
+  ChildTwoTwoThreeView grandchild_view =
+          ChildTwoTwoThreeView::Create(ChildTwoTwoView::Create(sibling_view));
+  ASSERT_TRUE(grandchild_view.IsValid());
+  ASSERT_EQ(FourBits::THREE, grandchild_view.GetMoreBits());
+}
+
 TEST(GeneratedPacketTest, testChild) {
   uint16_t field_name = 0xa2a1;
   uint8_t footer = 0xb1;
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/span_inserter.h"
+
+#undef NDEBUG
+#include <cassert>
+
+namespace bluetooth {
+namespace packet {
+
+SpanInserter::SpanInserter(uint8_t* begin, uint8_t* end)
+    : BitInserter(to_construct_bit_inserter_), begin_(begin), cursor_(begin), end_(end) {}
+
+void SpanInserter::insert_bits(uint8_t byte, size_t num_bits) {
+  size_t total_bits = num_bits + num_saved_bits_;
+  uint16_t new_value =
+          static_cast<uint8_t>(saved_bits_) | (static_cast<uint16_t>(byte) << num_saved_bits_);
+  if (total_bits >= 8) {
+    uint8_t new_byte = static_cast<uint8_t>(new_value);
+    assert(cursor_ < end_);
+    on_byte(new_byte);
+    *cursor_++ = new_byte;
+    total_bits -= 8;
+    new_value = new_value >> 8;
+  }
+  num_saved_bits_ = total_bits;
+  uint8_t mask = static_cast<uint8_t>(0xff) >> (8 - num_saved_bits_);
+  saved_bits_ = static_cast<uint8_t>(new_value) & mask;
+}
+
+void SpanInserter::insert_byte(uint8_t byte) {
+  // Most fields are byte aligned, skip the bit shuffling for them
+  if (num_saved_bits_ != 0) {
+    insert_bits(byte, 8);
+    return;
+  }
+  assert(cursor_ < end_);
+  on_byte(byte);
+  *cursor_++ = byte;
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+
+namespace bluetooth {
+namespace packet {
+
+// Writes into a caller supplied buffer, sized up front with BasePacketBuilder::size(), instead of
+// appending to a vector.
+class SpanInserter : public BitInserter {
+public:
+  SpanInserter(uint8_t* begin, uint8_t* end);
+
+  void insert_bits(uint8_t byte, size_t num_bits) override;
+
+  void insert_byte(uint8_t byte) override;
+
+  // Number of bytes written so far
+  size_t size() const { return static_cast<size_t>(cursor_ - begin_); }
+
+protected:
+  std::vector<uint8_t> to_construct_bit_inserter_;
+  uint8_t* begin_;
+  uint8_t* cursor_;
+  uint8_t* end_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/span_inserter.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+#include "packet/raw_builder.h"
+
+using bluetooth::packet::SpanInserter;
+using std::vector;
+
+namespace bluetooth {
+namespace packet {
+
+TEST(SpanInserterTest, addMoreBits) {
+  std::vector<uint8_t> result = {0b00011101 /* 3 2 1 */, 0b00010101 /* 5 4 */, 0b11100011 /* 7 6 */,
+                                 0b10000000 /* 8 */, 0b10100000 /* filled with 1010 */};
+  std::array<uint8_t, 8> buffer{};
+
+  SpanInserter it(buffer.data(), buffer.data() + buffer.size());
+
+  for (size_t i = 0; i < 9; i++) {
+    it.insert_bits(static_cast<uint8_t>(i), i);
+  }
+  it.insert_bits(static_cast<uint8_t>(0b1010), 4);
+
+  ASSERT_EQ(result.size(), it.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    ASSERT_EQ(result[i], buffer[i]);
+  }
+}
+
+TEST(SpanInserterTest, observerTest) {
+  std::vector<uint8_t> result = {0x01, 0x02, 0b00100011 /* 3 then 2 */, 0x04};
+  std::array<uint8_t, 4> buffer{};
+
+  SpanInserter it(buffer.data(), buffer.data() + buffer.size());
+
+  std::vector<uint8_t> copy;
+  uint64_t checksum = 0x0123456789abcdef;
+  it.RegisterObserver(ByteObserver([&copy](uint8_t byte) { copy.push_back(byte); },
+                                   [checksum]() { return checksum; }));
+
+  it.insert_byte(0x01);
+  it.insert_byte(0x02);
+  it.insert_bits(0x03, 4);
+  it.insert_bits(0x02, 4);
+  it.insert_byte(0x04);
+
+  ASSERT_EQ(checksum, it.UnregisterObserver().GetValue());
+  ASSERT_EQ(result.size(), it.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    ASSERT_EQ(result[i], buffer[i]);
+    ASSERT_EQ(result[i], copy[i]);
+  }
+}
+
+TEST(SpanInserterTest, serializeBuilderIntoBuffer) {
+  RawBuilder builder;
+  builder.AddOctets2(0x0201);
+  builder.AddOctets4(0x06050403);
+  builder.AddOctets1(0x07);
+
+  // Leave room for a header in front of the packet
+  std::array<uint8_t, 16> buffer{};
+  size_t written = builder.SerializeInto(buffer.data() + 1, buffer.size() - 1);
+
+  ASSERT_EQ(builder.size(), written);
+  for (size_t i = 0; i < written; i++) {
+    ASSERT_EQ(i + 1, buffer[i + 1]);
+  }
+  ASSERT_EQ(0, buffer[0]);
+  ASSERT_EQ(0, buffer[written + 1]);
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -97,6 +97,8 @@ struct StorageModule::impl {
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
   bool has_pending_config_save_ = false;
+  int batched_save_depth_ = 0;
+  bool has_batched_config_change_ = false;
 };
 
 Mutation StorageModule::Modify() {
@@ -106,6 +108,10 @@ Mutation StorageModule::Modify() {
 
 void StorageModule::SaveDelayed() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (pimpl_->batched_save_depth_ > 0) {
+    pimpl_->has_batched_config_change_ = true;
+    return;
+  }
   if (pimpl_->has_pending_config_save_) {
     return;
   }
@@ -121,6 +127,7 @@ void StorageModule::SaveImmediately() {
     pimpl_->config_save_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
+  pimpl_->has_batched_config_change_ = false;
 #ifndef TARGET_FLOSS
   log::assert_that(
           LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_),
@@ -138,6 +145,23 @@ void StorageModule::SaveImmediately() {
   }
 }
 
+void StorageModule::BeginBatchedSave() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  pimpl_->batched_save_depth_++;
+}
+
+void StorageModule::EndBatchedSave() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (pimpl_->batched_save_depth_ == 0) {
+    log::warn("No batched save in progress");
+    return;
+  }
+  pimpl_->batched_save_depth_--;
+  if (pimpl_->batched_save_depth_ == 0 && pimpl_->has_batched_config_change_) {
+    SaveImmediately();
+  }
+}
+
 void StorageModule::Clear() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   pimpl_->cache_.Clear();
@@ -193,7 +217,7 @@ void StorageModule::Start() {
 
 void StorageModule::Stop() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  if (pimpl_->has_pending_config_save_) {
+  if (pimpl_->has_pending_config_save_ || pimpl_->has_batched_config_change_) {
     // Save pending changes before stopping the module.
     SaveImmediately();
   }
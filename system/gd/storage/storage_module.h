@@ -137,6 +137,11 @@ protected:
   // In some cases, one may want to save the config immediately to disk. Call this method with
   // caution as it runs immediately on the calling thread
   void SaveImmediately();
+  // Hold back the delayed saving until the matching EndBatchedSave(), so that a long series of
+  // changes, e.g. keys from many back-to-back pairings, is written to disk once. Calls may nest;
+  // the config is saved immediately when the outermost batch ends and anything changed during it
+  void BeginBatchedSave();
+  void EndBatchedSave();
   // remove all content in this config cache, restore it to the state after the explicit constructor
   void Clear();
 
@@ -88,6 +88,9 @@ public:
   }
 
   void RemoveSectionPublic(const std::string& section) { return RemoveSection(section); }
+
+  void BeginBatchedSavePublic() { return BeginBatchedSave(); }
+  void EndBatchedSavePublic() { return EndBatchedSave(); }
 };
 
 class StorageModuleTest : public Test {
@@ -300,6 +303,38 @@ TEST_F(StorageModuleTest, changed_config_causes_a_write) {
   ASSERT_TRUE(std::filesystem::exists(temp_config_));
 }
 
+TEST_F(StorageModuleTest, batched_changes_cause_a_single_write_at_the_end) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  // Remove the file after it was read, so we can check if it was written with exists()
+  DeleteConfigFiles();
+
+  storage->BeginBatchedSavePublic();
+  storage->BeginBatchedSavePublic();
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "foo");
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "bar");
+
+  // The delayed save must not fire while a batch is open
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay * 2));
+  ASSERT_FALSE(std::filesystem::exists(temp_config_));
+
+  // Ending the inner batch does not save either
+  storage->EndBatchedSavePublic();
+  ASSERT_FALSE(std::filesystem::exists(temp_config_));
+
+  storage->EndBatchedSavePublic();
+  ASSERT_TRUE(std::filesystem::exists(temp_config_));
+  ASSERT_EQ(*storage->GetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME), "bar");
+
+  // Tear down
+  test_registry_.StopAll();
+}
+
 TEST_F(StorageModuleTest, no_config_causes_a_write) {
   // Set up
   auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
@@ -67,7 +67,20 @@
 #endif
 
 #ifndef BTA_DM_SDP_DB_SIZE
-#define BTA_DM_SDP_DB_SIZE 20000
+#define BTA_DM_SDP_DB_SIZE 4000
+#endif
+
+/* Growth step of the BTA DM discovery database once BTA_DM_SDP_DB_SIZE is
+ * exhausted. */
+#ifndef BTA_DM_SDP_DB_CHUNK_SIZE
+#define BTA_DM_SDP_DB_CHUNK_SIZE 4000
+#endif
+
+// Maximum number of service discoveries (SDP and/or GATT) run concurrently
+// towards different peers. Can be overridden with the
+// bluetooth.bta_dm.max_concurrent_discoveries property.
+#ifndef BTA_DM_MAX_CONCURRENT_DISCOVERIES
+#define BTA_DM_MAX_CONCURRENT_DISCOVERIES 4
 #endif
 
 #ifndef AG_VOICE_SETTINGS
@@ -457,6 +470,12 @@
 #define SDP_MAX_LIST_BYTE_COUNT 4096
 #endif
 
+/* The maximum number of bytes a growable discovery database may allocate on
+ * top of its initial memory pool. */
+#ifndef SDP_MAX_DISC_DB_GROWTH
+#define SDP_MAX_DISC_DB_GROWTH (64 * 1024)
+#endif
+
 /* The maximum number of parameters in an SDP protocol element. */
 #ifndef SDP_MAX_PROTOCOL_PARAMS
 #define SDP_MAX_PROTOCOL_PARAMS 2
@@ -40,12 +40,14 @@
 #include "common/interfaces/ILoggable.h"
 #include "common/strings.h"
 #include "common/sync_map_count.h"
+#include "common/time_util.h"
 #include "hci/acl_manager.h"
 #include "hci/acl_manager/acl_connection.h"
 #include "hci/acl_manager/classic_acl_connection.h"
 #include "hci/acl_manager/connection_management_callbacks.h"
 #include "hci/acl_manager/le_acl_connection.h"
 #include "hci/acl_manager/le_connection_management_callbacks.h"
+#include "hci/acl_manager/paging_hint.h"
 #include "hci/address.h"
 #include "hci/address_with_type.h"
 #include "hci/class_of_device.h"
@@ -60,6 +62,7 @@
 #include "osi/include/allocator.h"
 #include "stack/acl/acl.h"
 #include "stack/btm/btm_int_types.h"
+#include "stack/btm/neighbor_inquiry.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_log_history.h"
 #include "stack/include/main_thread.h"
@@ -351,6 +354,29 @@ void ValidateAclInterface(const shim::acl_interface_t& acl_interface) {
                    "Must provide to respond when active le connection disconnects");
 }
 
+// Builds the paging hint of a device from its latest inquiry response, if any
+hci::acl_manager::PagingHint GetPagingHint(const hci::Address& address) {
+  constexpr uint16_t kClockOffsetValid = 0x8000;
+  constexpr uint16_t kClockOffsetMask = 0x7fff;
+
+  hci::acl_manager::PagingHint paging_hint;
+  const tINQ_DB_ENT* p_inq = btm_inq_db_find(ToRawAddress(address));
+  if (p_inq == nullptr || !(p_inq->inq_info.results.inq_result_type & BT_DEVICE_TYPE_BREDR)) {
+    return paging_hint;
+  }
+  const tBTM_INQ_RESULTS& results = p_inq->inq_info.results;
+  paging_hint.last_seen = std::chrono::milliseconds(
+          bluetooth::common::time_get_os_boottime_ms() - p_inq->time_of_resp);
+  if (results.page_scan_rep_mode <= static_cast<uint8_t>(hci::PageScanRepetitionMode::R2)) {
+    paging_hint.page_scan_repetition_mode =
+            static_cast<hci::PageScanRepetitionMode>(results.page_scan_rep_mode);
+  }
+  if (results.clock_offset & kClockOffsetValid) {
+    paging_hint.clock_offset = results.clock_offset & kClockOffsetMask;
+  }
+  return paging_hint;
+}
+
 }  // namespace
 
 #define TRY_POSTING_ON_MAIN(cb, ...)                        \
@@ -1086,6 +1112,21 @@ struct shim::Acl::impl {
     GetAclManager()->RemoveDeviceFromResolvingList(address_with_type);
   }
 
+  void UpdateAddressResolution(
+          std::vector<std::pair<hci::AddressWithType, std::array<uint8_t, 16>>> peers,
+          const std::array<uint8_t, 16>& local_irk) {
+    std::vector<hci::LeAddressManager::ResolvingListEntry> resolving_list;
+    shadow_address_resolution_list_.Clear();
+    for (const auto& [address_with_type, peer_irk] : peers) {
+      if (!shadow_address_resolution_list_.Add(address_with_type)) {
+        break;
+      }
+      resolving_list.push_back({address_with_type.ToPeerAddressType(),
+                                address_with_type.GetAddress(), peer_irk, local_irk});
+    }
+    GetAclManager()->UpdateResolvingList(std::move(resolving_list));
+  }
+
   void ClearResolvingList() {
     GetAclManager()->ClearResolvingList();
     // TODO This should really be cleared after successful clear status
@@ -1320,7 +1361,7 @@ void shim::Acl::Flush(HciHandle handle) {
 }
 
 void shim::Acl::CreateClassicConnection(const hci::Address& address) {
-  GetAclManager()->CreateConnection(address);
+  GetAclManager()->CreateConnection(address, GetPagingHint(address));
   log::debug("Connection initiated for classic to remote:{}", address);
   BTM_LogHistory(kBtmLogTag, ToRawAddress(address), "Initiated connection", "classic");
 }
@@ -1678,6 +1719,13 @@ void shim::Acl::RemoveFromAddressResolution(const hci::AddressWithType& address_
   handler_->CallOn(pimpl_.get(), &Acl::impl::RemoveFromAddressResolution, address_with_type);
 }
 
+void shim::Acl::UpdateAddressResolution(
+        std::vector<std::pair<hci::AddressWithType, std::array<uint8_t, 16>>> peers,
+        const std::array<uint8_t, 16>& local_irk) {
+  handler_->CallOn(pimpl_.get(), &Acl::impl::UpdateAddressResolution, std::move(peers),
+                   local_irk);
+}
+
 void shim::Acl::ClearAddressResolution() {
   handler_->CallOn(pimpl_.get(), &Acl::impl::ClearResolvingList);
 }
@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include <array>
 #include <future>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
@@ -78,6 +81,9 @@ public:
                               const std::array<uint8_t, 16>& peer_irk,
                               const std::array<uint8_t, 16>& local_irk);
   void RemoveFromAddressResolution(const hci::AddressWithType& address_with_type);
+  void UpdateAddressResolution(
+          std::vector<std::pair<hci::AddressWithType, std::array<uint8_t, 16>>> peers,
+          const std::array<uint8_t, 16>& local_irk);
   void ClearAddressResolution();
 
   void LeSetDefaultSubrate(uint16_t subrate_min, uint16_t subrate_max, uint16_t max_latency,
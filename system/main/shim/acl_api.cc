@@ -165,6 +165,17 @@ void bluetooth::shim::ACL_RemoveFromAddressResolution(
           ToAddressWithType(legacy_address_with_type.bda, legacy_address_with_type.type));
 }
 
+void bluetooth::shim::ACL_UpdateAddressResolution(
+        const std::vector<std::pair<tBLE_BD_ADDR, Octet16>>& peers, const Octet16& local_irk) {
+  std::vector<std::pair<hci::AddressWithType, std::array<uint8_t, 16>>> gd_peers;
+  for (const auto& [legacy_address_with_type, peer_irk] : peers) {
+    gd_peers.push_back(
+            {ToAddressWithType(legacy_address_with_type.bda, legacy_address_with_type.type),
+             peer_irk});
+  }
+  Stack::GetInstance()->GetAcl()->UpdateAddressResolution(std::move(gd_peers), local_irk);
+}
+
 void bluetooth::shim::ACL_ClearAddressResolution() {
   Stack::GetInstance()->GetAcl()->ClearAddressResolution();
 }
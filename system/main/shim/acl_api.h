@@ -17,6 +17,8 @@
 #pragma once
 
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_octets.h"
@@ -50,6 +52,8 @@ std::optional<uint8_t> ACL_GetAdvertisingSetConnectedTo(const RawAddress& addr);
 void ACL_AddToAddressResolution(const tBLE_BD_ADDR& legacy_address_with_type,
                                 const Octet16& peer_irk, const Octet16& local_irk);
 void ACL_RemoveFromAddressResolution(const tBLE_BD_ADDR& legacy_address_with_type);
+void ACL_UpdateAddressResolution(const std::vector<std::pair<tBLE_BD_ADDR, Octet16>>& peers,
+                                 const Octet16& local_irk);
 void ACL_ClearAddressResolution();
 void ACL_ClearFilterAcceptList();
 void ACL_LeSetDefaultSubrate(uint16_t subrate_min, uint16_t subrate_max, uint16_t max_latency,
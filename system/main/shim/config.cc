@@ -147,5 +147,9 @@ void BtifConfigInterface::ConvertEncryptOrDecryptKeyIfNeeded() {
 
 void BtifConfigInterface::Clear() { GetStorage()->Clear(); }
 
+void BtifConfigInterface::BeginBatchedSave() { GetStorage()->BeginBatchedSave(); }
+
+void BtifConfigInterface::EndBatchedSave() { GetStorage()->EndBatchedSave(); }
+
 }  // namespace shim
 }  // namespace bluetooth
@@ -47,6 +47,8 @@ public:
   static std::vector<std::string> GetPersistentDevices();
   static void ConvertEncryptOrDecryptKeyIfNeeded();
   static void Clear();
+  static void BeginBatchedSave();
+  static void EndBatchedSave();
 };
 
 }  // namespace shim
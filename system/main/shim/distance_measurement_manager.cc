@@ -127,10 +127,13 @@ public:
                                     error_altitude_angle, static_cast<uint8_t>(method)));
   }
 
+  // The RAS server keeps its client state and sends through GATT on the main thread
   void OnRasFragmentReady(bluetooth::hci::Address address, uint16_t procedure_counter, bool is_last,
                           std::vector<uint8_t> raw_data) {
-    bluetooth::ras::GetRasServer()->PushProcedureData(bluetooth::ToRawAddress(address),
-                                                      procedure_counter, is_last, raw_data);
+    do_in_main_thread(base::BindOnce(&bluetooth::ras::RasServer::PushProcedureData,
+                                     base::Unretained(bluetooth::ras::GetRasServer()),
+                                     bluetooth::ToRawAddress(address), procedure_counter, is_last,
+                                     std::move(raw_data)));
   }
 
   void OnVendorSpecificCharacteristics(std::vector<bluetooth::hal::VendorSpecificCharacteristic>
@@ -143,8 +146,9 @@ public:
       vendor_specific_characteristic.value_ = characteristic.value_;
       ras_vendor_specific_characteristics.emplace_back(vendor_specific_characteristic);
     }
-    bluetooth::ras::GetRasServer()->SetVendorSpecificCharacteristic(
-            ras_vendor_specific_characteristics);
+    do_in_main_thread(base::BindOnce(&bluetooth::ras::RasServer::SetVendorSpecificCharacteristic,
+                                     base::Unretained(bluetooth::ras::GetRasServer()),
+                                     std::move(ras_vendor_specific_characteristics)));
   }
 
   void OnVendorSpecificReply(bluetooth::hci::Address address,
@@ -163,8 +167,9 @@ public:
   }
 
   void OnHandleVendorSpecificReplyComplete(bluetooth::hci::Address address, bool success) {
-    bluetooth::ras::GetRasServer()->HandleVendorSpecificReplyComplete(
-            bluetooth::ToRawAddress(address), success);
+    do_in_main_thread(base::BindOnce(&bluetooth::ras::RasServer::HandleVendorSpecificReplyComplete,
+                                     base::Unretained(bluetooth::ras::GetRasServer()),
+                                     bluetooth::ToRawAddress(address), success));
   }
 
   // Must be called from main_thread
@@ -185,6 +190,11 @@ public:
             hal_vendor_specific_characteristics);
   }
 
+  void OnRasServerDisconnected(const RawAddress& address) override {
+    bluetooth::shim::GetDistanceMeasurementManager()->HandleRasServerDisconnectedEvent(
+            bluetooth::ToGdAddress(address));
+  }
+
   // Must be called from main_thread
   // Callbacks of bluetooth::ras::RasClientCallbacks
   void OnConnected(const RawAddress& address, uint16_t att_handle,
@@ -387,7 +387,7 @@ protected:
     acl_ = MakeAcl();
 
     // Create connection
-    EXPECT_CALL(*test::mock_acl_manager_, CreateConnection(_)).Times(1);
+    EXPECT_CALL(*test::mock_acl_manager_, CreateConnection(_, _)).Times(1);
     acl_->CreateClassicConnection(address);
 
     // Respond with a mock connection created
@@ -458,7 +458,7 @@ TEST_F(MainShimTest, connect_and_disconnect) {
   auto acl = MakeAcl();
 
   // Create connection
-  EXPECT_CALL(*test::mock_acl_manager_, CreateConnection(_)).Times(1);
+  EXPECT_CALL(*test::mock_acl_manager_, CreateConnection(_, _)).Times(1);
   acl->CreateClassicConnection(address);
 
   // Respond with a mock connection created
@@ -33,6 +33,7 @@
 #include "btm_ble_int.h"
 #include "btm_dev.h"
 #include "btm_sec_cb.h"
+#include "common/lru_cache.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/controller_interface.h"
 #include "main/shim/entry.h"
@@ -135,6 +136,42 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
   return true;
 }
 
+namespace {
+/* An RPA stays the same for several minutes and is reported over and over while
+ * scanning. Remember which record it resolved to, and which RPAs resolved to
+ * nobody, so that only the first report pays for a full pass over the bonded
+ * devices IRKs. */
+constexpr size_t kResolvedRpaCacheSize = 64;
+constexpr size_t kUnresolvedRpaCacheSize = 256;
+
+bluetooth::common::LruCache<RawAddress, RawAddress> resolved_rpa_cache(kResolvedRpaCacheSize);
+/* Value is the IRK generation the RPA failed to resolve against */
+bluetooth::common::LruCache<RawAddress, uint32_t> unresolved_rpa_cache(kUnresolvedRpaCacheSize);
+uint32_t irk_generation = 0;
+}  // namespace
+
+/** Match the random address against the devices resolved by the host, or
+ * against all the others. */
+static tBTM_SEC_DEV_REC* btm_ble_match_random_bda_in_pass(const RawAddress& random_bda,
+                                                         bool host_resolved) {
+  list_node_t* end = list_end(btm_sec_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_sec_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (btm_ble_resolving_list_is_host_resolved(p_dev_rec->bd_addr) != host_resolved) {
+      continue;
+    }
+    if (!btm_ble_match_random_bda(p_dev_rec, (void*)&random_bda)) {
+      return p_dev_rec;
+    }
+  }
+  return nullptr;
+}
+
+/** Called whenever a peer IRK is learned, so that RPAs which previously did not
+ * resolve are tried again. */
+void btm_ble_rpa_cache_irk_changed() { irk_generation++; }
+
 /** This function is called to resolve a random address.
  * Returns pointer to the security record of the device whom a random address is
  * matched to.
@@ -143,9 +180,38 @@ tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_sec_cb.sec_dev_rec == nullptr) {
     return nullptr;
   }
-  list_node_t* n =
-          list_foreach(btm_sec_cb.sec_dev_rec, btm_ble_match_random_bda, (void*)&random_bda);
-  return (n == nullptr) ? (nullptr) : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+
+  auto resolved = resolved_rpa_cache.find(random_bda);
+  if (resolved != resolved_rpa_cache.end()) {
+    /* Check again in case the record was removed or its IRK changed */
+    tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(resolved->second);
+    if (p_dev_rec != nullptr && !btm_ble_match_random_bda(p_dev_rec, (void*)&random_bda)) {
+      btm_ble_resolving_list_note_activity(p_dev_rec->bd_addr);
+      return p_dev_rec;
+    }
+    resolved_rpa_cache.extract(random_bda);
+  }
+
+  auto unresolved = unresolved_rpa_cache.find(random_bda);
+  if (unresolved != unresolved_rpa_cache.end() && unresolved->second == irk_generation) {
+    return nullptr;
+  }
+
+  /* The controller resolves the RPAs of the devices in its resolving list, so
+   * the devices that did not fit there are tried first */
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_ble_match_random_bda_in_pass(random_bda, true);
+  if (p_dev_rec == nullptr) {
+    p_dev_rec = btm_ble_match_random_bda_in_pass(random_bda, false);
+  }
+  if (p_dev_rec == nullptr) {
+    unresolved_rpa_cache.insert_or_assign(random_bda, irk_generation);
+    return nullptr;
+  }
+
+  unresolved_rpa_cache.extract(random_bda);
+  resolved_rpa_cache.insert_or_assign(random_bda, p_dev_rec->bd_addr);
+  btm_ble_resolving_list_note_activity(p_dev_rec->bd_addr);
+  return p_dev_rec;
 }
 
 /*******************************************************************************
@@ -25,19 +25,29 @@
 
 #include "stack/include/btm_ble_privacy.h"
 
+#include <base/functional/bind.h>
 #include <bluetooth/log.h>
 
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "btm_dev.h"
 #include "btm_sec_cb.h"
 #include "btm_sec_int_types.h"
+#include "common/time_util.h"
 #include "hci/controller_interface.h"
 #include "main/shim/acl_api.h"
 #include "main/shim/entry.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_int_types.h"
+#include "stack/gatt/connection_manager.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/btm_client_interface.h"
+#include "stack/include/main_thread.h"
 #include "types/raw_address.h"
 
 using namespace bluetooth;
@@ -429,7 +439,9 @@ static void btm_ble_resolving_list_vsc_op_cmpl(tBTM_VSC_CMPL* p_params) {
  *
  * Function         btm_ble_remove_resolving_list_entry
  *
- * Description      This function to remove an IRK entry from the list
+ * Description      This function to remove an IRK entry from the list of a
+ *                  controller without BLE privacy support. The others get the
+ *                  removal through btm_ble_resolving_list_sync.
  *
  * Parameters       ble_addr_type: address type
  *                  ble_addr: LE adddress
@@ -443,21 +455,17 @@ static tBTM_STATUS btm_ble_remove_resolving_list_entry(tBTM_SEC_DEV_REC* p_dev_r
     return tBTM_STATUS::BTM_WRONG_MODE;
   }
 
-  if (bluetooth::shim::GetController()->SupportsBlePrivacy()) {
-    bluetooth::shim::ACL_RemoveFromAddressResolution(p_dev_rec->ble.identity_address_with_type);
-  } else {
-    uint8_t param[20] = {0};
-    uint8_t* p = param;
+  uint8_t param[20] = {0};
+  uint8_t* p = param;
 
-    UINT8_TO_STREAM(p, BTM_BLE_META_REMOVE_IRK_ENTRY);
-    UINT8_TO_STREAM(p, p_dev_rec->ble.identity_address_with_type.type);
-    BDADDR_TO_STREAM(p, p_dev_rec->ble.identity_address_with_type.bda);
+  UINT8_TO_STREAM(p, BTM_BLE_META_REMOVE_IRK_ENTRY);
+  UINT8_TO_STREAM(p, p_dev_rec->ble.identity_address_with_type.type);
+  BDADDR_TO_STREAM(p, p_dev_rec->ble.identity_address_with_type.bda);
 
-    get_btm_client_interface().vendor.BTM_VendorSpecificCommand(HCI_VENDOR_BLE_RPA_VSC,
-                                                                BTM_BLE_META_REMOVE_IRK_LEN, param,
-                                                                btm_ble_resolving_list_vsc_op_cmpl);
-    btm_ble_enq_resolving_list_pending(p_dev_rec->bd_addr, BTM_BLE_META_REMOVE_IRK_ENTRY);
-  }
+  get_btm_client_interface().vendor.BTM_VendorSpecificCommand(HCI_VENDOR_BLE_RPA_VSC,
+                                                              BTM_BLE_META_REMOVE_IRK_LEN, param,
+                                                              btm_ble_resolving_list_vsc_op_cmpl);
+  btm_ble_enq_resolving_list_pending(p_dev_rec->bd_addr, BTM_BLE_META_REMOVE_IRK_ENTRY);
   return tBTM_STATUS::BTM_CMD_STARTED;
 }
 
@@ -542,12 +550,125 @@ static void btm_ble_ble_unsupported_resolving_list_load_dev(tBTM_SEC_DEV_REC* p_
   return;
 }
 
+/* The controller resolving list is usually much smaller than the number of
+ * bonded devices. The ones that do not fit are resolved by the host, and the
+ * controller entries go to the devices seen most recently, with background
+ * connection targets kept in place. Values are the last activity time in ms. */
+namespace {
+std::unordered_map<RawAddress, uint64_t> controller_resolving_list;
+std::unordered_map<RawAddress, uint64_t> host_resolving_list;
+
+/* A controller entry must have been idle for this long before a device that
+ * is resolved on the host can take its place */
+constexpr uint64_t kResolvingListRebalanceIdleMs = 60 * 1000;
+
+/* Host activity is acted upon at most once per this delay, and by at most this
+ * many swaps, to bound the HCI traffic in a busy scanning environment */
+constexpr std::chrono::seconds kResolvingListRebalanceDelay = std::chrono::seconds(10);
+constexpr size_t kResolvingListMaxSwaps = 2;
+bool resolving_list_rebalance_pending = false;
+
+/* Controller list changes made in one main thread task are sent together */
+bool resolving_list_sync_pending = false;
+}  // namespace
+
+static Octet16 get_local_irk() { return btm_sec_cb.devcb.id_keys.irk; }
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_sync
+ *
+ * Description      Program the controller resolving list with the devices
+ *                  currently placed there. Only the difference is sent, inside
+ *                  a single pause of scanning and advertising, so loading all
+ *                  the bonded devices at startup costs one pause.
+ *
+ ******************************************************************************/
+static void btm_ble_resolving_list_sync() {
+  resolving_list_sync_pending = false;
+
+  std::vector<std::pair<tBLE_BD_ADDR, Octet16>> peers;
+  for (const auto& [bd_addr, last_activity_ms] : controller_resolving_list) {
+    tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(bd_addr);
+    if (p_dev_rec == nullptr) {
+      continue;
+    }
+    peers.push_back({p_dev_rec->ble.identity_address_with_type, p_dev_rec->sec_rec.ble_keys.irk});
+  }
+  log::debug("Address Resolving list has {} devices", peers.size());
+  bluetooth::shim::ACL_UpdateAddressResolution(peers, get_local_irk());
+}
+
+static void btm_ble_resolving_list_schedule_sync() {
+  if (resolving_list_sync_pending) {
+    return;
+  }
+  resolving_list_sync_pending = true;
+  do_in_main_thread(base::BindOnce(&btm_ble_resolving_list_sync));
+}
+
+static void btm_ble_resolving_list_add_to_controller(tBTM_SEC_DEV_REC& dev_rec,
+                                                     uint64_t last_activity_ms) {
+  log::debug("Adding to Address Resolving list device:{}", dev_rec.ble.identity_address_with_type);
+
+  dev_rec.ble.in_controller_list |= BTM_RESOLVING_LIST_BIT;
+  host_resolving_list.erase(dev_rec.bd_addr);
+  controller_resolving_list[dev_rec.bd_addr] = last_activity_ms;
+  btm_ble_resolving_list_schedule_sync();
+}
+
+static void btm_ble_resolving_list_move_to_host(tBTM_SEC_DEV_REC* p_dev_rec) {
+  log::info("Moving device:{} to the host resolving list",
+            p_dev_rec->ble.identity_address_with_type);
+  p_dev_rec->ble.in_controller_list &= ~BTM_RESOLVING_LIST_BIT;
+  btm_ble_resolving_list_schedule_sync();
+
+  auto it = controller_resolving_list.find(p_dev_rec->bd_addr);
+  if (it != controller_resolving_list.end()) {
+    host_resolving_list[p_dev_rec->bd_addr] = it->second;
+    controller_resolving_list.erase(it);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_find_victim
+ *
+ * Description      Find the controller resolving list entry least worth keeping.
+ *                  Connected devices and background connection targets are
+ *                  never chosen.
+ *
+ * Parameters       idle_before_ms: only entries whose last activity is older
+ *                  than this are considered.
+ *
+ * Returns          device record of the entry, or nullptr if none qualifies
+ *
+ ******************************************************************************/
+static tBTM_SEC_DEV_REC* btm_ble_resolving_list_find_victim(uint64_t idle_before_ms) {
+  tBTM_SEC_DEV_REC* p_victim = nullptr;
+  uint64_t victim_activity_ms = idle_before_ms;
+
+  for (auto it = controller_resolving_list.begin(); it != controller_resolving_list.end();) {
+    tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(it->first);
+    if (p_dev_rec == nullptr) {
+      // Record is gone, the entry is stale
+      it = controller_resolving_list.erase(it);
+      continue;
+    }
+    if (it->second < victim_activity_ms && p_dev_rec->ble_hci_handle == HCI_INVALID_HANDLE &&
+        !connection_manager::is_background_connection(it->first)) {
+      p_victim = p_dev_rec;
+      victim_activity_ms = it->second;
+    }
+    it++;
+  }
+  return p_victim;
+}
+
 static bool is_peer_identity_key_valid(const tBTM_SEC_DEV_REC& dev_rec) {
   return dev_rec.sec_rec.ble_keys.key_type & BTM_LE_KEY_PID;
 }
 
-static Octet16 get_local_irk() { return btm_sec_cb.devcb.id_keys.irk; }
-
 void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
   if (btm_cb.ble_ctr_cb.privacy_mode < BTM_PRIVACY_1_2) {
     log::debug("Privacy 1.2 is not enabled");
@@ -574,9 +695,6 @@ void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
     return;
   }
 
-  const Octet16& peer_irk = dev_rec.sec_rec.ble_keys.irk;
-  const Octet16& local_irk = get_local_irk();
-
   if (dev_rec.ble.identity_address_with_type.bda.IsEmpty()) {
     dev_rec.ble.identity_address_with_type = {
             .type = dev_rec.ble.AddressType(),
@@ -590,12 +708,31 @@ void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
     return;
   }
 
-  bluetooth::shim::ACL_AddToAddressResolution(dev_rec.ble.identity_address_with_type, peer_irk,
-                                              local_irk);
+  uint64_t last_activity_ms = 0;
+  auto host_entry = host_resolving_list.find(dev_rec.bd_addr);
+  if (host_entry != host_resolving_list.end()) {
+    last_activity_ms = host_entry->second;
+  }
+  if (dev_rec.ble_hci_handle != HCI_INVALID_HANDLE) {
+    // Just bonded, or keys refreshed over a live link
+    last_activity_ms = bluetooth::common::time_get_os_boottime_ms();
+  }
 
-  log::debug("Added to Address Resolving list device:{}", dev_rec.ble.identity_address_with_type);
+  const size_t controller_size = bluetooth::shim::GetController()->GetLeResolvingListSize();
+  if (controller_resolving_list.size() >= controller_size) {
+    const bool is_background = connection_manager::is_background_connection(dev_rec.bd_addr);
+    tBTM_SEC_DEV_REC* p_victim =
+            btm_ble_resolving_list_find_victim(is_background ? UINT64_MAX : last_activity_ms);
+    if (p_victim == nullptr) {
+      log::info("Address Resolving list is full, device:{} is resolved by the host",
+                dev_rec.ble.identity_address_with_type);
+      host_resolving_list[dev_rec.bd_addr] = last_activity_ms;
+      return;
+    }
+    btm_ble_resolving_list_move_to_host(p_victim);
+  }
 
-  dev_rec.ble.in_controller_list |= BTM_RESOLVING_LIST_BIT;
+  btm_ble_resolving_list_add_to_controller(dev_rec, last_activity_ms);
 }
 
 /*******************************************************************************
@@ -615,14 +752,146 @@ void btm_ble_resolving_list_remove_dev(tBTM_SEC_DEV_REC* p_dev_rec) {
     return;
   }
 
+  host_resolving_list.erase(p_dev_rec->bd_addr);
+
   if ((p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT) &&
       !btm_ble_brcm_find_resolving_pending_entry(p_dev_rec->bd_addr,
                                                  BTM_BLE_META_REMOVE_IRK_ENTRY)) {
     btm_ble_update_resolving_list(p_dev_rec->bd_addr, false);
-    btm_ble_remove_resolving_list_entry(p_dev_rec);
+    if (bluetooth::shim::GetController()->SupportsBlePrivacy()) {
+      /* Goes out with the pending additions, so that an add and a remove of
+       * the same device reach the controller in the order they were made */
+      btm_ble_resolving_list_schedule_sync();
+    } else {
+      btm_ble_remove_resolving_list_entry(p_dev_rec);
+    }
   } else {
     log::verbose("Device not in resolving list");
+    return;
+  }
+
+  if (controller_resolving_list.erase(p_dev_rec->bd_addr) == 0) {
+    return;
+  }
+
+  /* Give the freed entry to the most recently active device on the host */
+  tBTM_SEC_DEV_REC* p_best = nullptr;
+  uint64_t best_activity_ms = 0;
+  for (auto it = host_resolving_list.begin(); it != host_resolving_list.end();) {
+    tBTM_SEC_DEV_REC* p_candidate = btm_find_dev(it->first);
+    if (p_candidate == nullptr || p_candidate == p_dev_rec) {
+      it = host_resolving_list.erase(it);
+      continue;
+    }
+    if (p_best == nullptr || it->second > best_activity_ms) {
+      p_best = p_candidate;
+      best_activity_ms = it->second;
+    }
+    it++;
+  }
+  if (p_best != nullptr) {
+    btm_ble_resolving_list_add_to_controller(*p_best, best_activity_ms);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_rebalance
+ *
+ * Description      Give the controller entries that have been idle for a while
+ *                  to the devices most recently resolved by the host. Each swap
+ *                  pauses scanning and advertising, so only a few are done per
+ *                  run.
+ *
+ ******************************************************************************/
+void btm_ble_resolving_list_rebalance() {
+  resolving_list_rebalance_pending = false;
+
+  if (!bluetooth::shim::GetController()->SupportsBlePrivacy()) {
+    return;
+  }
+  const uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (now_ms < kResolvingListRebalanceIdleMs) {
+    return;
   }
+
+  for (size_t swaps = 0; swaps < kResolvingListMaxSwaps; swaps++) {
+    tBTM_SEC_DEV_REC* p_best = nullptr;
+    uint64_t best_activity_ms = now_ms - kResolvingListRebalanceIdleMs;
+    for (auto it = host_resolving_list.begin(); it != host_resolving_list.end();) {
+      tBTM_SEC_DEV_REC* p_candidate = btm_find_dev(it->first);
+      if (p_candidate == nullptr) {
+        it = host_resolving_list.erase(it);
+        continue;
+      }
+      if (it->second > best_activity_ms) {
+        p_best = p_candidate;
+        best_activity_ms = it->second;
+      }
+      it++;
+    }
+    if (p_best == nullptr) {
+      return;
+    }
+
+    tBTM_SEC_DEV_REC* p_victim =
+            btm_ble_resolving_list_find_victim(now_ms - kResolvingListRebalanceIdleMs);
+    if (p_victim == nullptr) {
+      return;
+    }
+    btm_ble_resolving_list_move_to_host(p_victim);
+    btm_ble_resolving_list_add_to_controller(*p_best, best_activity_ms);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_note_activity
+ *
+ * Description      Record activity from a bonded device, either a connection or
+ *                  an RPA resolved by the host. This runs for every advertising
+ *                  report, so the controller list is never changed from here:
+ *                  activity on a device resolved by the host schedules a
+ *                  rebalance instead.
+ *
+ * Parameters       pseudo_addr: address of the device record
+ *
+ ******************************************************************************/
+void btm_ble_resolving_list_note_activity(const RawAddress& pseudo_addr) {
+  const uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  auto controller_entry = controller_resolving_list.find(pseudo_addr);
+  if (controller_entry != controller_resolving_list.end()) {
+    controller_entry->second = now_ms;
+    return;
+  }
+
+  auto host_entry = host_resolving_list.find(pseudo_addr);
+  if (host_entry == host_resolving_list.end()) {
+    return;
+  }
+  host_entry->second = now_ms;
+
+  if (resolving_list_rebalance_pending) {
+    return;
+  }
+  resolving_list_rebalance_pending = true;
+  do_in_main_thread_delayed(base::BindOnce(&btm_ble_resolving_list_rebalance),
+                            kResolvingListRebalanceDelay);
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_is_host_resolved
+ *
+ * Description      Check whether the RPAs of a device are resolved by the host,
+ *                  because it did not fit in the controller resolving list.
+ *
+ * Parameters       pseudo_addr: address of the device record
+ *
+ ******************************************************************************/
+bool btm_ble_resolving_list_is_host_resolved(const RawAddress& pseudo_addr) {
+  return host_resolving_list.count(pseudo_addr) != 0;
 }
 
 /*******************************************************************************
@@ -657,4 +926,8 @@ void btm_ble_resolving_list_init(uint8_t max_irk_list_sz) {
 
   btm_ble_clear_resolving_list();
   btm_cb.ble_ctr_cb.resolving_list_avail_size = max_irk_list_sz;
+  controller_resolving_list.clear();
+  host_resolving_list.clear();
+  resolving_list_rebalance_pending = false;
+  resolving_list_sync_pending = false;
 }
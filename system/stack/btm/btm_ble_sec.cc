@@ -926,6 +926,7 @@ void btm_sec_save_le_key(const RawAddress& bd_addr, tBTM_LE_KEY_TYPE key_type,
         p_rec->bd_addr = p_keys->pid_key.identity_addr;
         /* combine DUMO device security record if needed */
         btm_consolidate_dev(p_rec);
+        btm_ble_rpa_cache_irk_changed();
         break;
 
       case BTM_LE_KEY_PCSRK:
@@ -1539,6 +1540,8 @@ void btm_ble_connected(const RawAddress& bda, uint16_t handle, uint8_t /* enc_mo
     }
   }
   btm_cb.ble_ctr_cb.inq_var.directed_conn = BTM_BLE_ADV_IND_EVT;
+
+  btm_ble_resolving_list_note_activity(p_dev_rec->bd_addr);
 }
 
 /*******************************************************************************
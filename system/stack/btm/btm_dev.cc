@@ -62,6 +62,7 @@ constexpr char kBtmLogTag[] = "BOND";
 static void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->sec_rec.link_key.fill(0);
   memset(&p_dev_rec->sec_rec.ble_keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_sec_cb.ForgetDevRec(p_dev_rec);
   list_remove(btm_sec_cb.sec_dev_rec, p_dev_rec);
 }
 
@@ -221,7 +222,7 @@ void BTM_SecClearSecurityFlags(const RawAddress& bd_addr) {
 
   p_dev_rec->sec_rec.sec_flags = 0;
   p_dev_rec->sec_rec.le_link = tSECURITY_STATE::IDLE;
-  p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+  btm_sec_cb.SetClassicLinkState(p_dev_rec, tSECURITY_STATE::IDLE);
   p_dev_rec->sm4 = BTM_SM4_UNKNOWN;
 }
 
@@ -460,6 +461,8 @@ void btm_consolidate_dev(tBTM_SEC_DEV_REC* p_target_rec) {
       p_target_rec->sec_rec.new_encryption_key_is_p256 =
               temp_rec.sec_rec.new_encryption_key_is_p256;
       p_target_rec->sec_rec.bond_type = temp_rec.sec_rec.bond_type;
+      /* The classic link state was copied over with the combined record */
+      btm_sec_cb.SetClassicLinkState(p_target_rec, p_target_rec->sec_rec.classic_link);
 
       /* remove the combined record */
       wipe_secrets_and_remove(p_dev_rec);
@@ -34,6 +34,7 @@
 #include <string.h>
 
 #include <mutex>
+#include <vector>
 
 #include "btif/include/btif_acl.h"
 #include "common/time_util.h"
@@ -731,6 +732,7 @@ tBTM_STATUS BTM_StartInquiry(tBTM_INQ_RESULTS_CB* p_results_cb, tBTM_CMPL_CB* p_
   btm_cb.neighbor.classic_inquiry = {
           .start_time_ms = timestamper_in_milliseconds.GetTimestamp(),
           .results = 0,
+          .duplicates = 0,
   };
 
   log::debug("Starting device discovery inq_active:0x{:02x}", btm_cb.btm_inq_vars.inq_active);
@@ -1420,6 +1422,25 @@ static void btm_process_inq_results_rssi(EventView event) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_inq_eir_hash
+ *
+ * Description      Computes a 32 bit FNV-1a hash of the EIR data, used to
+ *                  detect repeated extended inquiry results.
+ *
+ * Returns          hash of the data
+ *
+ ******************************************************************************/
+static uint32_t btm_inq_eir_hash(const uint8_t* p_data, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= p_data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
 /*******************************************************************************
  *
  * Function         btm_process_inq_results_extended
@@ -1474,11 +1495,40 @@ static void btm_process_inq_results_extended(EventView event) {
 
     p_i = btm_inq_db_find(bda);
 
+    // Serialize the EIR data once, padded with 0, so that it can be compared
+    // against what was already reported for this device.
+    auto data = std::vector<uint8_t>();
+    data.reserve(HCI_EXT_INQ_RESPONSE_LEN);
+    bluetooth::packet::BitInserter bi(data);
+    for (const auto& eir : extended_view.GetExtendedInquiryResponse()) {
+      if (eir.data_type_ != static_cast<GapDataType>(0)) {
+        eir.Serialize(bi);
+      }
+    }
+    while (data.size() < HCI_EXT_INQ_RESPONSE_LEN) {
+      data.push_back(0);
+    }
+    const uint32_t eir_hash = btm_inq_eir_hash(data.data(), data.size());
+
     /* Check if this address has already been processed for this inquiry */
     if (btm_inq_find_bdaddr(bda)) {
       /* By default suppose no update needed */
       i_rssi = (int8_t)rssi;
 
+      /* Controllers repeat the same response for the whole inquiry window.
+       * Drop it when neither the EIR nor a better RSSI brings anything new. */
+      if (p_i && p_i->eir_reported && p_i->inq_count == btm_cb.btm_inq_vars.inq_counter &&
+          p_i->eir_hash == eir_hash && (rssi == 0 || i_rssi <= p_i->eir_rssi)) {
+        btm_cb.neighbor.classic_inquiry.duplicates++;
+        /* Still keep the best RSSI seen, like for a reported result */
+        if (rssi != 0 &&
+            (i_rssi > p_i->inq_info.results.rssi || p_i->inq_info.results.rssi == 0)) {
+          p_i->inq_info.results.rssi = i_rssi;
+        }
+        log::verbose("Dropping duplicate inquiry result peer:{} rssi:{}", bda, i_rssi);
+        return;
+      }
+
       /* If this new RSSI is higher than the last one */
       if ((rssi != 0) && p_i &&
           (i_rssi > p_i->inq_info.results.rssi ||
@@ -1557,27 +1607,19 @@ static void btm_process_inq_results_extended(EventView event) {
     }
 
     if (is_new || update) {
-      // Create a vector of EIR data and pad it with 0
-      auto data = std::vector<uint8_t>();
-      data.reserve(HCI_EXT_INQ_RESPONSE_LEN);
-      bluetooth::packet::BitInserter bi(data);
-      for (const auto& eir : extended_view.GetExtendedInquiryResponse()) {
-        if (eir.data_type_ != static_cast<GapDataType>(0)) {
-          eir.Serialize(bi);
-        }
-      }
-      while (data.size() < HCI_EXT_INQ_RESPONSE_LEN) {
-        data.push_back(0);
-      }
-
       const uint8_t* p_eir_data = data.data();
 
-      {
+      /* Only re-parse the UUID list when the EIR actually changed */
+      if (!p_i->eir_reported || p_i->eir_hash != eir_hash) {
         memset(p_cur->eir_uuid, 0, BTM_EIR_SERVICE_ARRAY_SIZE * (BTM_EIR_ARRAY_BITS / 8));
         /* set bit map of UUID list from received EIR */
         btm_set_eir_uuid(p_eir_data, p_cur);
       }
 
+      p_i->eir_reported = true;
+      p_i->eir_hash = eir_hash;
+      p_i->eir_rssi = (int8_t)rssi;
+
       /* If a callback is registered, call it with the results */
       if (p_inq_results_cb) {
         (p_inq_results_cb)((tBTM_INQ_RESULTS*)p_cur, p_eir_data, HCI_EXT_INQ_RESPONSE_LEN);
@@ -1689,10 +1731,11 @@ void btm_process_inq_complete(tHCI_STATUS status, uint8_t mode) {
       const auto end_time_ms = timestamper_in_milliseconds.GetTimestamp();
       BTM_LogHistory(kBtmLogTag, RawAddress::kEmpty, "Classic inquiry complete",
                      base::StringPrintf(
-                             "duration_s:%6.3f results:%lu inq_active:0x%02x std:%u rssi:%u "
-                             "ext:%u status:%s",
+                             "duration_s:%6.3f results:%lu duplicates:%lu inq_active:0x%02x "
+                             "std:%u rssi:%u ext:%u status:%s",
                              (end_time_ms - btm_cb.neighbor.classic_inquiry.start_time_ms) / 1000.0,
-                             btm_cb.neighbor.classic_inquiry.results, inq_active,
+                             btm_cb.neighbor.classic_inquiry.results,
+                             btm_cb.neighbor.classic_inquiry.duplicates, inq_active,
                              btm_cb.btm_inq_vars.inq_cmpl_info.resp_type[BTM_INQ_RESULT_STANDARD],
                              btm_cb.btm_inq_vars.inq_cmpl_info.resp_type[BTM_INQ_RESULT_WITH_RSSI],
                              btm_cb.btm_inq_vars.inq_cmpl_info.resp_type[BTM_INQ_RESULT_EXTENDED],
@@ -150,6 +150,7 @@ public:
     struct {
       long long start_time_ms;
       unsigned long results;
+      unsigned long duplicates;
     } classic_inquiry, le_scan, le_inquiry, le_observe, le_legacy_scan;
     std::unique_ptr<bluetooth::common::TimestampedCircularBuffer<tBTM_INQUIRY_CMPL>>
             inquiry_history_ = std::make_unique<
@@ -31,9 +31,12 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <string>
+#include <vector>
 
 #include "btif/include/btif_storage.h"
 #include "common/metrics.h"
@@ -220,15 +223,18 @@ static bool btm_dev_16_digit_authenticated(const tBTM_SEC_DEV_REC* p_dev_rec) {
   return p_dev_rec->sec_rec.sec_flags & BTM_SEC_16_DIGIT_PIN_AUTHED;
 }
 
-static bool is_sec_state_equal(void* data, void* context) {
-  tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
-  tSECURITY_STATE* state = static_cast<tSECURITY_STATE*>(context);
-
-  if (p_dev_rec->sec_rec.classic_link == *state) {
-    return false;
-  }
-
-  return true;
+/*******************************************************************************
+ *
+ * Function         btm_sec_set_classic_link_state
+ *
+ * Description      Update the classic link security state of a device record
+ *                  and keep the index of busy records in sync
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void btm_sec_set_classic_link_state(tBTM_SEC_DEV_REC* p_dev_rec, tSECURITY_STATE state) {
+  btm_sec_cb.SetClassicLinkState(p_dev_rec, state);
 }
 
 /*******************************************************************************
@@ -242,12 +248,7 @@ static bool is_sec_state_equal(void* data, void* context) {
  *
  ******************************************************************************/
 static tBTM_SEC_DEV_REC* btm_sec_find_dev_by_sec_state(tSECURITY_STATE state) {
-  list_node_t* n = list_foreach(btm_sec_cb.sec_dev_rec, is_sec_state_equal, &state);
-  if (n) {
-    return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
-  }
-
-  return nullptr;
+  return btm_sec_cb.FindDevRecBySecState(state);
 }
 
 /*******************************************************************************
@@ -1105,7 +1106,7 @@ static tBTM_STATUS btm_sec_send_hci_disconnect(tBTM_SEC_DEV_REC* p_dev_rec, tHCI
       // Already sent classic disconnect
       return tBTM_STATUS::BTM_CMD_STARTED;
     }
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::DISCONNECTING;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::DISCONNECTING);
   } else if (conn_handle == p_dev_rec->ble_hci_handle) {
     if (p_dev_rec->sec_rec.le_link == tSECURITY_STATE::DISCONNECTING) {
       // Already sent ble disconnect
@@ -1573,7 +1574,7 @@ tBTM_STATUS btm_sec_l2cap_access_req_by_requirement(const RawAddress& bd_addr,
       */
       log::info("peer should have initiated security process by now (SM4 to SM4)");
       p_dev_rec->sec_rec.p_callback = p_callback;
-      p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::DELAY_FOR_ENC;
+      btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::DELAY_FOR_ENC);
       (*p_callback)(bd_addr, transport, p_ref_data, rc);
 
       return tBTM_STATUS::BTM_SUCCESS;
@@ -1964,29 +1965,21 @@ void btm_sec_check_pending_reqs(void) {
       l2cu_resubmit_pending_sec_req(nullptr);
     }
 
-    /* Now, re-submit anything in the mux queue */
-    fixed_queue_t* bq = btm_sec_cb.sec_pending_q;
-
-    btm_sec_cb.sec_pending_q = fixed_queue_new(SIZE_MAX);
-
-    tBTM_SEC_QUEUE_ENTRY* p_e;
-    while ((p_e = (tBTM_SEC_QUEUE_ENTRY*)fixed_queue_try_dequeue(bq)) != NULL) {
+    /* Now, re-submit anything in the mux queue, in the order it was queued */
+    for (const tBTM_SEC_QUEUE_ENTRY& e : btm_sec_cb.TakePendingRequests()) {
       /* Check that the ACL is still up before starting security procedures */
-      if (get_btm_client_interface().peer.BTM_IsAclConnectionUp(p_e->bd_addr, p_e->transport)) {
-        if (p_e->psm != 0) {
-          log::verbose("PSM:0x{:04x} Is_Orig:{}", p_e->psm, p_e->is_orig);
+      if (get_btm_client_interface().peer.BTM_IsAclConnectionUp(e.bd_addr, e.transport)) {
+        if (e.psm != 0) {
+          log::verbose("PSM:0x{:04x} Is_Orig:{}", e.psm, e.is_orig);
 
-          btm_sec_mx_access_request(p_e->bd_addr, p_e->is_orig, p_e->rfcomm_security_requirement,
-                                    p_e->p_callback, p_e->p_ref_data);
+          btm_sec_mx_access_request(e.bd_addr, e.is_orig, e.rfcomm_security_requirement,
+                                    e.p_callback, e.p_ref_data);
         } else {
-          BTM_SetEncryption(p_e->bd_addr, p_e->transport, p_e->p_callback, p_e->p_ref_data,
-                            p_e->sec_act);
+          BTM_SetEncryption(e.bd_addr, e.transport, e.p_callback, e.p_ref_data,
+                            e.sec_act);
         }
       }
-
-      osi_free(p_e);
     }
-    fixed_queue_free(bq, NULL);
   }
 }
 
@@ -2037,7 +2030,7 @@ void btm_sec_abort_access_req(const RawAddress& bd_addr) {
     return;
   }
 
-  p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+  btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
 
   log::verbose("clearing callback. p_dev_rec={}, p_callback={}", fmt::ptr(p_dev_rec),
                fmt::ptr(p_dev_rec->sec_rec.p_callback));
@@ -2235,7 +2228,7 @@ void btm_sec_rmt_name_request_complete(const RawAddress* p_bd_addr, const uint8_
   const bool is_security_state_getting_name =
           (p_dev_rec->sec_rec.classic_link == tSECURITY_STATE::GETTING_NAME);
   if (is_security_state_getting_name) {
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
   }
 
   /* If we were delaying asking UI for a PIN because name was not resolved,
@@ -2938,7 +2931,7 @@ static void btm_sec_auth_collision(uint16_t handle) {
       /* We will restart authentication after timeout */
       if (p_dev_rec->sec_rec.classic_link == tSECURITY_STATE::AUTHENTICATING ||
           p_dev_rec->sec_rec.is_security_state_bredr_encrypting()) {
-        p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+        btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
       }
 
       btm_sec_cb.p_collided_dev_rec = p_dev_rec;
@@ -2985,7 +2978,7 @@ static bool btm_sec_auth_retry(uint16_t handle, uint8_t status) {
        controller.
        If the stack may sit on top of other controller, we may need this
        BTM_DeleteStoredLinkKey (bd_addr, NULL); */
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
     btm_sec_execute_procedure(p_dev_rec);
     return true;
   }
@@ -3051,7 +3044,7 @@ void btm_sec_auth_complete(uint16_t handle, tHCI_STATUS status) {
   }
 
   if (p_dev_rec->sec_rec.classic_link == tSECURITY_STATE::AUTHENTICATING) {
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
     was_authenticating = true;
     /* There can be a race condition, when we are starting authentication
      * and the peer device is doing encryption.
@@ -3322,7 +3315,7 @@ void btm_sec_encrypt_change(uint16_t handle, tHCI_STATUS status, uint8_t encr_en
   /* If this encryption was started by peer do not need to do anything */
   if (!p_dev_rec->sec_rec.is_security_state_bredr_encrypting()) {
     if (tSECURITY_STATE::DELAY_FOR_ENC == p_dev_rec->sec_rec.classic_link) {
-      p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+      btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
       log::verbose("clearing callback. p_dev_rec={}, p_callback={}", fmt::ptr(p_dev_rec),
                    fmt::ptr(p_dev_rec->sec_rec.p_callback));
       p_dev_rec->sec_rec.p_callback = NULL;
@@ -3330,7 +3323,7 @@ void btm_sec_encrypt_change(uint16_t handle, tHCI_STATUS status, uint8_t encr_en
       return;
     } else if (!concurrentPeerAuthIsEnabled() &&
                p_dev_rec->sec_rec.classic_link == tSECURITY_STATE::AUTHENTICATING) {
-      p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+      btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
       return;
     }
     if (!handleUnexpectedEncryptionChange()) {
@@ -3338,7 +3331,7 @@ void btm_sec_encrypt_change(uint16_t handle, tHCI_STATUS status, uint8_t encr_en
     }
   }
 
-  p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+  btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
   /* If encryption setup failed, notify the waiting layer */
   if (status != HCI_SUCCESS) {
     btm_sec_dev_rec_cback_event(p_dev_rec, tBTM_STATUS::BTM_ERR_PROCESSING, false);
@@ -3877,7 +3870,7 @@ void btm_sec_disconnected(uint16_t handle, tHCI_REASON reason, std::string comme
   if (transport == BT_TRANSPORT_LE) {
     p_dev_rec->sec_rec.le_link = tSECURITY_STATE::IDLE;
   } else if (transport == BT_TRANSPORT_BR_EDR) {
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
   }
 
   if (p_dev_rec->sec_rec.classic_link == tSECURITY_STATE::DISCONNECTING ||
@@ -3907,7 +3900,7 @@ void btm_sec_disconnected(uint16_t handle, tHCI_REASON reason, std::string comme
     }
   }
 
-  p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::IDLE;
+  btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::IDLE);
   p_dev_rec->sec_rec.le_link = tSECURITY_STATE::IDLE;
   p_dev_rec->sec_rec.security_required = BTM_SEC_NONE;
 
@@ -4104,7 +4097,7 @@ void btm_sec_link_key_request(const RawAddress bda) {
 
   log::verbose("bda: {}", bda);
   if (!concurrentPeerAuthIsEnabled()) {
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::AUTHENTICATING;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::AUTHENTICATING);
   }
 
   if ((btm_sec_cb.pairing_state == BTM_PAIR_STATE_WAIT_PIN_REQ) &&
@@ -4517,7 +4510,7 @@ tBTM_STATUS btm_sec_execute_procedure(tBTM_SEC_DEV_REC* p_dev_rec) {
     log::verbose("Security Manager: Start encryption");
 
     btsnd_hcic_set_conn_encrypt(p_dev_rec->hci_handle, true);
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::ENCRYPTING;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::ENCRYPTING);
     return tBTM_STATUS::BTM_CMD_STARTED;
   } else {
     log::debug("Encryption not required");
@@ -4561,7 +4554,7 @@ static bool btm_sec_start_get_name(tBTM_SEC_DEV_REC* p_dev_rec) {
     return false;
   }
 
-  p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::GETTING_NAME;
+  btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::GETTING_NAME);
 
   /* 0 and NULL are as timeout and callback params because they are not used in
    * security get name case */
@@ -4619,7 +4612,7 @@ static void btm_sec_auth_timer_timeout(void* data) {
     log::info("device is in the process of authenticating");
   } else {
     log::info("starting authentication");
-    p_dev_rec->sec_rec.classic_link = tSECURITY_STATE::AUTHENTICATING;
+    btm_sec_set_classic_link_state(p_dev_rec, tSECURITY_STATE::AUTHENTICATING);
     btsnd_hcic_auth_request(p_dev_rec->hci_handle);
   }
 }
@@ -4817,21 +4810,21 @@ void btm_sec_cr_loc_oob_data_cback_event(const RawAddress& address,
 static bool btm_sec_queue_mx_request(const RawAddress& bd_addr, uint16_t psm, bool is_orig,
                                      uint16_t security_required, tBTM_SEC_CALLBACK* p_callback,
                                      void* p_ref_data) {
-  tBTM_SEC_QUEUE_ENTRY* p_e = (tBTM_SEC_QUEUE_ENTRY*)osi_malloc(sizeof(tBTM_SEC_QUEUE_ENTRY));
+  tBTM_SEC_QUEUE_ENTRY e{};
 
-  p_e->psm = psm;
-  p_e->is_orig = is_orig;
-  p_e->p_callback = p_callback;
-  p_e->p_ref_data = p_ref_data;
-  p_e->transport = BT_TRANSPORT_BR_EDR;
-  p_e->sec_act = BTM_BLE_SEC_NONE;
-  p_e->bd_addr = bd_addr;
-  p_e->rfcomm_security_requirement = security_required;
+  e.psm = psm;
+  e.is_orig = is_orig;
+  e.p_callback = p_callback;
+  e.p_ref_data = p_ref_data;
+  e.transport = BT_TRANSPORT_BR_EDR;
+  e.sec_act = BTM_BLE_SEC_NONE;
+  e.bd_addr = bd_addr;
+  e.rfcomm_security_requirement = security_required;
 
   log::verbose("PSM: 0x{:04x}  Is_Orig: {}  security_required: 0x{:x}", psm, is_orig,
                security_required);
 
-  fixed_queue_enqueue(btm_sec_cb.sec_pending_q, p_e);
+  btm_sec_cb.QueuePendingRequest(e);
 
   return true;
 }
@@ -4890,15 +4883,15 @@ static bool btm_sec_check_prefetch_pin(tBTM_SEC_DEV_REC* p_dev_rec) {
 static void btm_sec_queue_encrypt_request(const RawAddress& bd_addr, tBT_TRANSPORT transport,
                                           tBTM_SEC_CALLBACK* p_callback, void* p_ref_data,
                                           tBTM_BLE_SEC_ACT sec_act) {
-  tBTM_SEC_QUEUE_ENTRY* p_e = (tBTM_SEC_QUEUE_ENTRY*)osi_malloc(sizeof(tBTM_SEC_QUEUE_ENTRY) + 1);
-
-  p_e->psm = 0; /* if PSM 0, encryption request */
-  p_e->p_callback = p_callback;
-  p_e->p_ref_data = p_ref_data;
-  p_e->transport = transport;
-  p_e->sec_act = sec_act;
-  p_e->bd_addr = bd_addr;
-  fixed_queue_enqueue(btm_sec_cb.sec_pending_q, p_e);
+  tBTM_SEC_QUEUE_ENTRY e{};
+
+  e.psm = 0; /* if PSM 0, encryption request */
+  e.p_callback = p_callback;
+  e.p_ref_data = p_ref_data;
+  e.transport = transport;
+  e.sec_act = sec_act;
+  e.bd_addr = bd_addr;
+  btm_sec_cb.QueuePendingRequest(e);
 }
 
 /*******************************************************************************
@@ -4913,27 +4906,35 @@ static void btm_sec_queue_encrypt_request(const RawAddress& bd_addr, tBT_TRANSPO
  ******************************************************************************/
 static void btm_sec_check_pending_enc_req(tBTM_SEC_DEV_REC* p_dev_rec, tBT_TRANSPORT transport,
                                           uint8_t encr_enable) {
-  if (fixed_queue_is_empty(btm_sec_cb.sec_pending_q)) {
+  auto it = btm_sec_cb.sec_pending_q.find(p_dev_rec->bd_addr);
+  if (it == btm_sec_cb.sec_pending_q.end()) {
     return;
   }
 
+  /* Take the completed requests off the device queue before running any
+   * callback, a callback may queue new requests for this device */
+  std::vector<tBTM_SEC_QUEUE_ENTRY> completed;
+  std::deque<tBTM_SEC_QUEUE_ENTRY>& queue = it->second;
+  for (auto e = queue.begin(); e != queue.end();) {
+    if (e->psm == 0 && e->transport == transport &&
+        (encr_enable == 0 || transport == BT_TRANSPORT_BR_EDR ||
+         e->sec_act == BTM_BLE_SEC_ENCRYPT || e->sec_act == BTM_BLE_SEC_ENCRYPT_NO_MITM ||
+         (e->sec_act == BTM_BLE_SEC_ENCRYPT_MITM &&
+          p_dev_rec->sec_rec.sec_flags & BTM_SEC_LE_AUTHENTICATED))) {
+      completed.push_back(*e);
+      e = queue.erase(e);
+    } else {
+      ++e;
+    }
+  }
+  if (queue.empty()) {
+    btm_sec_cb.sec_pending_q.erase(it);
+  }
+
   const tBTM_STATUS res = encr_enable ? tBTM_STATUS::BTM_SUCCESS : tBTM_STATUS::BTM_ERR_PROCESSING;
-  list_t* list = fixed_queue_get_list(btm_sec_cb.sec_pending_q);
-  for (const list_node_t* node = list_begin(list); node != list_end(list);) {
-    tBTM_SEC_QUEUE_ENTRY* p_e = (tBTM_SEC_QUEUE_ENTRY*)list_node(node);
-    node = list_next(node);
-
-    if (p_e->bd_addr == p_dev_rec->bd_addr && p_e->psm == 0 && p_e->transport == transport) {
-      if (encr_enable == 0 || transport == BT_TRANSPORT_BR_EDR ||
-          p_e->sec_act == BTM_BLE_SEC_ENCRYPT || p_e->sec_act == BTM_BLE_SEC_ENCRYPT_NO_MITM ||
-          (p_e->sec_act == BTM_BLE_SEC_ENCRYPT_MITM &&
-           p_dev_rec->sec_rec.sec_flags & BTM_SEC_LE_AUTHENTICATED)) {
-        if (p_e->p_callback) {
-          (*p_e->p_callback)(p_dev_rec->bd_addr, transport, p_e->p_ref_data, res);
-        }
-        fixed_queue_try_remove_from_queue(btm_sec_cb.sec_pending_q, (void*)p_e);
-        osi_free(p_e);
-      }
+  for (const tBTM_SEC_QUEUE_ENTRY& e : completed) {
+    if (e.p_callback) {
+      (*e.p_callback)(p_dev_rec->bd_addr, transport, e.p_ref_data, res);
     }
   }
 }
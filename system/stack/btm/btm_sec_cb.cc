@@ -21,7 +21,9 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "internal_include/bt_trace.h"
 #include "internal_include/stack_config.h"
@@ -46,7 +48,9 @@ void tBTM_SEC_CB::Init(uint8_t initial_security_mode) {
   connecting_bda = RawAddress::kEmpty;
   connecting_dc = kDevClassEmpty;
 
-  sec_pending_q = fixed_queue_new(SIZE_MAX);
+  sec_pending_q.clear();
+  sec_pending_seq = 0;
+  sec_busy_dev_rec.clear();
   sec_collision_timer = alarm_new("btm.sec_collision_timer");
   pairing_timer = alarm_new("btm.pairing_timer");
   execution_wait_timer = alarm_new("btm.execution_wait_timer");
@@ -62,8 +66,8 @@ void tBTM_SEC_CB::Init(uint8_t initial_security_mode) {
 }
 
 void tBTM_SEC_CB::Free() {
-  fixed_queue_free(sec_pending_q, nullptr);
-  sec_pending_q = nullptr;
+  sec_pending_q.clear();
+  sec_busy_dev_rec.clear();
 
   list_free(sec_dev_rec);
   sec_dev_rec = nullptr;
@@ -355,3 +359,49 @@ uint8_t tBTM_SEC_CB::RemoveServiceByPsm(uint16_t psm) {
 
   return num_freed;
 }
+
+void tBTM_SEC_CB::QueuePendingRequest(tBTM_SEC_QUEUE_ENTRY entry) {
+  entry.seq = sec_pending_seq++;
+  sec_pending_q[entry.bd_addr].push_back(entry);
+}
+
+std::vector<tBTM_SEC_QUEUE_ENTRY> tBTM_SEC_CB::TakePendingRequests() {
+  std::vector<tBTM_SEC_QUEUE_ENTRY> entries;
+  for (const auto& [bd_addr, queue] : sec_pending_q) {
+    entries.insert(entries.end(), queue.begin(), queue.end());
+  }
+  sec_pending_q.clear();
+
+  std::sort(entries.begin(), entries.end(),
+            [](const tBTM_SEC_QUEUE_ENTRY& a, const tBTM_SEC_QUEUE_ENTRY& b) {
+              return a.seq < b.seq;
+            });
+  return entries;
+}
+
+void tBTM_SEC_CB::SetClassicLinkState(tBTM_SEC_DEV_REC* p_dev_rec, tSECURITY_STATE state) {
+  p_dev_rec->sec_rec.classic_link = state;
+
+  auto it = std::find(sec_busy_dev_rec.begin(), sec_busy_dev_rec.end(), p_dev_rec);
+  if (state == tSECURITY_STATE::IDLE) {
+    if (it != sec_busy_dev_rec.end()) {
+      sec_busy_dev_rec.erase(it);
+    }
+  } else if (it == sec_busy_dev_rec.end()) {
+    sec_busy_dev_rec.push_back(p_dev_rec);
+  }
+}
+
+void tBTM_SEC_CB::ForgetDevRec(tBTM_SEC_DEV_REC* p_dev_rec) {
+  sec_busy_dev_rec.erase(std::remove(sec_busy_dev_rec.begin(), sec_busy_dev_rec.end(), p_dev_rec),
+                         sec_busy_dev_rec.end());
+}
+
+tBTM_SEC_DEV_REC* tBTM_SEC_CB::FindDevRecBySecState(tSECURITY_STATE state) {
+  for (tBTM_SEC_DEV_REC* p_dev_rec : sec_busy_dev_rec) {
+    if (p_dev_rec->sec_rec.classic_link == state) {
+      return p_dev_rec;
+    }
+  }
+  return nullptr;
+}
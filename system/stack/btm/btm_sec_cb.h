@@ -18,6 +18,9 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
 
 #include "internal_include/bt_target.h"
 #include "osi/include/alarm.h"
@@ -72,8 +75,16 @@ public:
 
   RawAddress connecting_bda;
 
-  fixed_queue_t* sec_pending_q{nullptr}; /* pending sequrity requests in
-                                            tBTM_SEC_QUEUE_ENTRY format */
+  /* Pending security requests, queued per peer device. Entries carry an
+   * arrival sequence number so that the queues can be replayed in the order
+   * the requests were made once pairing completes. */
+  std::map<RawAddress, std::deque<tBTM_SEC_QUEUE_ENTRY>> sec_pending_q;
+  uint64_t sec_pending_seq{0};
+
+  /* Device records whose classic link is not tSECURITY_STATE::IDLE, in the
+   * order they left it. Only updated through SetClassicLinkState() and
+   * ForgetDevRec(). */
+  std::vector<tBTM_SEC_DEV_REC*> sec_busy_dev_rec;
 
   tBTM_SEC_SERV_REC sec_serv_rec[BTM_SEC_MAX_SERVICE_RECORDS];
 
@@ -100,6 +111,16 @@ public:
 
   void change_pairing_state(tBTM_PAIRING_STATE new_state);
 
+  void QueuePendingRequest(tBTM_SEC_QUEUE_ENTRY entry);
+  // Empties the pending queues, and returns their entries in the order they were queued
+  std::vector<tBTM_SEC_QUEUE_ENTRY> TakePendingRequests();
+
+  void SetClassicLinkState(tBTM_SEC_DEV_REC* p_dev_rec, tSECURITY_STATE state);
+  // Drops a device record that is about to be freed
+  void ForgetDevRec(tBTM_SEC_DEV_REC* p_dev_rec);
+  // First device record, in the order they left tSECURITY_STATE::IDLE, in the given state
+  tBTM_SEC_DEV_REC* FindDevRecBySecState(tSECURITY_STATE state);
+
   // misc static methods
   static const char* btm_pair_state_descr(tBTM_PAIRING_STATE state);
 };
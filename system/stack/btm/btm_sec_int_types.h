@@ -77,6 +77,7 @@ typedef struct {
   uint16_t rfcomm_security_requirement;
   tBT_TRANSPORT transport;
   tBTM_BLE_SEC_ACT sec_act;
+  uint64_t seq; /* arrival order across all devices */
 } tBTM_SEC_QUEUE_ENTRY;
 
 /* Define the Device Management control structure
@@ -159,6 +159,9 @@ typedef struct {
   tBTM_INQ_INFO inq_info;
   bool in_use;
   bool scan_rsp;
+  bool eir_reported;   /* Set once an EIR was parsed and reported for this entry  */
+  uint32_t eir_hash;   /* Hash of the last reported EIR, used to drop duplicates  */
+  int8_t eir_rssi;     /* RSSI reported along with the last EIR                   */
 } tINQ_DB_ENT;
 
 typedef struct /* contains the parameters passed to the inquiry functions */
@@ -19,7 +19,10 @@
 
 #include <bluetooth/log.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "stack/eatt/eatt_impl.h"
@@ -27,6 +30,7 @@
 #include "stack/include/bt_psm_types.h"
 #include "stack/include/l2cap_interface.h"
 #include "stack/include/l2cdefs.h"
+#include "stack/include/main_thread.h"
 #include "types/raw_address.h"
 
 using bluetooth::eatt::eatt_impl;
@@ -192,6 +196,30 @@ EattChannel* EattExtension::GetChannelAvailableForClientRequest(const RawAddress
   return pimpl_->eatt_impl_->get_channel_available_for_client_request(bd_addr);
 }
 
+/* Upper bound on the wait for the main thread to collect the bearer state */
+static constexpr std::chrono::seconds kDumpTimeout = std::chrono::seconds(1);
+
+void EattExtension::Dump(int fd) {
+  if (!pimpl_->IsRunning()) {
+    return;
+  }
+
+  /* The bearers are owned by the main thread, dumpsys runs on its own */
+  auto promise = std::make_shared<std::promise<std::string>>();
+  std::future<std::string> future = promise->get_future();
+  bt_status_t status = do_in_main_thread(base::BindOnce(
+          [](std::shared_ptr<std::promise<std::string>> promise) {
+            eatt_impl* impl = EattExtension::impl::GetImplInstance();
+            promise->set_value(impl ? impl->dump() : std::string());
+          },
+          promise));
+  if (status != BT_STATUS_SUCCESS || future.wait_for(kDumpTimeout) != std::future_status::ready) {
+    dprintf(fd, "EATT bearers: main thread busy, not dumped\n");
+    return;
+  }
+  dprintf(fd, "%s", future.get().c_str());
+}
+
 /* Start stop GATT indication timer per CID */
 void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr, uint16_t cid) {
   pimpl_->eatt_impl_->start_indication_confirm_timer(bd_addr, cid);
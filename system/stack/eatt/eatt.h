@@ -59,6 +59,11 @@ public:
   alarm_t* ind_confirmation_timer_;
   /* GATT client command queue */
   std::deque<tGATT_CMD_Q> cl_cmd_q_;
+  /* Number of ATT transactions assigned to this bearer */
+  uint32_t num_assigned_;
+  /* Sequence number of the last assignment, used to rotate between equally
+   * loaded bearers */
+  uint32_t last_assigned_;
 
   EattChannel(RawAddress& bda, uint16_t cid, uint16_t tx_mtu, uint16_t rx_mtu)
       : bda_(bda),
@@ -67,7 +72,9 @@ public:
         state_(EattChannelState::EATT_CHANNEL_PENDING),
         indicate_handle_(0),
         ind_ack_timer_(NULL),
-        ind_confirmation_timer_(NULL) {
+        ind_confirmation_timer_(NULL),
+        num_assigned_(0),
+        last_assigned_(0) {
     cl_cmd_q_ = std::deque<tGATT_CMD_Q>();
     EattChannelSetTxMTU(tx_mtu);
   }
@@ -236,6 +243,14 @@ public:
    */
   virtual EattChannel* GetChannelAvailableForClientRequest(const RawAddress& bd_addr);
 
+  /**
+   * Dump the EATT bearers and their load into dumpsys. The state is collected
+   * on the main thread, the caller waits for it.
+   *
+   * @param fd file descriptor to write to
+   */
+  virtual void Dump(int fd);
+
   /**
    * Start GATT indication timer per CID.
    *
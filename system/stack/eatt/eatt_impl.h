@@ -17,11 +17,15 @@
 
 #pragma once
 
+#include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <cinttypes>
 #include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -56,8 +60,16 @@ public:
 
   std::map<uint16_t, std::shared_ptr<EattChannel>> eatt_channels;
   bool collision;
+  /* Bearers asked of the peer, and the ones it refused */
+  uint32_t num_requested_bearers_;
+  uint32_t num_refused_bearers_;
   eatt_device(const RawAddress& bd_addr, uint16_t mtu, uint16_t mps)
-      : rx_mtu_(mtu), rx_mps_(mps), eatt_tcb_(nullptr), collision(false) {
+      : rx_mtu_(mtu),
+        rx_mps_(mps),
+        eatt_tcb_(nullptr),
+        collision(false),
+        num_requested_bearers_(0),
+        num_refused_bearers_(0) {
     bda_ = bd_addr;
   }
 };
@@ -68,6 +80,7 @@ struct eatt_impl {
   uint16_t default_mtu_;
   uint16_t max_mps_;
   tL2CAP_APPL_INFO reg_info_;
+  uint32_t assignment_seq_;
 
   base::WeakPtrFactory<eatt_impl> weak_factory_{this};
 
@@ -75,6 +88,7 @@ struct eatt_impl {
     default_mtu_ = EATT_DEFAULT_MTU;
     max_mps_ = EATT_MIN_MTU_MPS;
     psm_ = BT_PSM_EATT;
+    assignment_seq_ = 0;
   }
 
   ~eatt_impl() = default;
@@ -387,6 +401,7 @@ struct eatt_impl {
 
     if (result != tL2CAP_LE_RESULT_CODE::L2CAP_LE_RESULT_CONN_OK) {
       log::error("Could not connect CoC result: 0x{:x}", result);
+      eatt_dev->num_refused_bearers_++;
       remove_channel_by_cid(eatt_dev, lcid);
 
       /* If there is no channels connected, check if there was collision */
@@ -571,6 +586,7 @@ struct eatt_impl {
     }
 
     log::info("Successfully sent CoC request, number of channel: {}", connecting_cids.size());
+    eatt_dev->num_requested_bearers_ += connecting_cids.size();
 
     for (uint16_t cid : connecting_cids) {
       log::info("\t cid: 0x{:x}", cid);
@@ -632,15 +648,70 @@ struct eatt_impl {
     return iter != eatt_dev->eatt_channels.end();
   }
 
+  /* Client requests waiting for a response, and an indication waiting for its
+   * confirmation */
+  static size_t channel_outstanding(const EattChannel& channel) {
+    return channel.cl_cmd_q_.size() + (GATT_HANDLE_IS_VALID(channel.indicate_handle_) ? 1 : 0);
+  }
+
+  /* Bytes of client commands queued on the bearer and not sent yet */
+  static size_t channel_queued_bytes(const EattChannel& channel) {
+    size_t bytes = 0;
+    for (const tGATT_CMD_Q& cmd : channel.cl_cmd_q_) {
+      if (cmd.to_send && cmd.p_cmd != nullptr) {
+        bytes += cmd.p_cmd->len;
+      }
+    }
+    return bytes;
+  }
+
+  /* SDUs waiting in L2CAP for credits */
+  static uint16_t channel_l2cap_queue_depth(const EattChannel& channel) {
+    return stack::l2cap::get_interface().L2CA_GetTxQueueDepth(channel.cid_);
+  }
+
+  /* Returns the least loaded opened bearer accepted by is_candidate: fewest
+   * outstanding transactions, then fewest SDUs and bytes waiting to be sent,
+   * then largest MTU, then the one used least recently. Taking the first idle
+   * bearer instead piles all traffic on the lowest CID. */
+  template <typename Predicate>
+  EattChannel* assign_least_loaded_channel(eatt_device* eatt_dev, Predicate is_candidate) {
+    EattChannel* best = nullptr;
+    std::tuple<size_t, uint16_t, size_t, int, uint32_t> best_load;
+
+    for (const std::pair<const uint16_t, std::shared_ptr<EattChannel>>& el :
+         eatt_dev->eatt_channels) {
+      EattChannel* channel = el.second.get();
+      if (channel->state_ != EattChannelState::EATT_CHANNEL_OPENED || !is_candidate(*channel)) {
+        continue;
+      }
+
+      auto load = std::make_tuple(channel_outstanding(*channel),
+                                  channel_l2cap_queue_depth(*channel),
+                                  channel_queued_bytes(*channel), -channel->tx_mtu_,
+                                  channel->last_assigned_);
+      if (best == nullptr || load < best_load) {
+        best = channel;
+        best_load = load;
+      }
+    }
+
+    if (best != nullptr) {
+      best->num_assigned_++;
+      best->last_assigned_ = ++assignment_seq_;
+    }
+    return best;
+  }
+
   EattChannel* get_channel_available_for_indication(const RawAddress& bd_addr) {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
-    auto iter = find_if(eatt_dev->eatt_channels.begin(), eatt_dev->eatt_channels.end(),
-                        [](const std::pair<uint16_t, std::shared_ptr<EattChannel>>& el) {
-                          return el.second->state_ == EattChannelState::EATT_CHANNEL_OPENED &&
-                                 !GATT_HANDLE_IS_VALID(el.second->indicate_handle_);
-                        });
+    if (!eatt_dev) {
+      return nullptr;
+    }
 
-    return (iter == eatt_dev->eatt_channels.end()) ? nullptr : iter->second.get();
+    return assign_least_loaded_channel(eatt_dev, [](const EattChannel& channel) {
+      return !GATT_HANDLE_IS_VALID(channel.indicate_handle_);
+    });
   }
 
   EattChannel* get_channel_available_for_client_request(const RawAddress& bd_addr) {
@@ -649,13 +720,10 @@ struct eatt_impl {
       return nullptr;
     }
 
-    auto iter = find_if(eatt_dev->eatt_channels.begin(), eatt_dev->eatt_channels.end(),
-                        [](const std::pair<uint16_t, std::shared_ptr<EattChannel>>& el) {
-                          return el.second->state_ == EattChannelState::EATT_CHANNEL_OPENED &&
-                                 el.second->cl_cmd_q_.empty();
-                        });
-
-    return (iter == eatt_dev->eatt_channels.end()) ? nullptr : iter->second.get();
+    /* Only one request can be outstanding on a bearer. When all of them are
+     * busy the caller falls back to the ATT bearer. */
+    return assign_least_loaded_channel(
+            eatt_dev, [](const EattChannel& channel) { return channel.cl_cmd_q_.empty(); });
   }
 
   void free_gatt_resources(const RawAddress& bd_addr) {
@@ -1004,6 +1072,50 @@ struct eatt_impl {
     }
   }
 
+  static std::string channel_state_text(EattChannelState state) {
+    switch (state) {
+      CASE_RETURN_TEXT(EattChannelState::EATT_CHANNEL_PENDING);
+      CASE_RETURN_TEXT(EattChannelState::EATT_CHANNEL_OPENED);
+      CASE_RETURN_TEXT(EattChannelState::EATT_CHANNEL_RECONFIGURING);
+    }
+    RETURN_UNKNOWN_TYPE_STRING(EattChannelState, state);
+  }
+
+  /* Must run on the main thread, which owns the bearers */
+  std::string dump() {
+    std::string out = "EATT bearers:\n";
+    for (const eatt_device& eatt_dev : devices_) {
+      if (eatt_dev.eatt_channels.empty() && eatt_dev.num_requested_bearers_ == 0) {
+        continue;
+      }
+
+      uint64_t total_assigned = 0;
+      for (const std::pair<const uint16_t, std::shared_ptr<EattChannel>>& el :
+           eatt_dev.eatt_channels) {
+        total_assigned += el.second->num_assigned_;
+      }
+
+      out += base::StringPrintf("  %s bearers: %zu requested: %u refused: %u assigned "
+                                "transactions: %" PRIu64 "\n",
+                                ADDRESS_TO_LOGGABLE_CSTR(eatt_dev.bda_),
+                                eatt_dev.eatt_channels.size(), eatt_dev.num_requested_bearers_,
+                                eatt_dev.num_refused_bearers_, total_assigned);
+      for (const std::pair<const uint16_t, std::shared_ptr<EattChannel>>& el :
+           eatt_dev.eatt_channels) {
+        const EattChannel& channel = *el.second;
+        uint64_t share =
+                total_assigned ? 100 * uint64_t{channel.num_assigned_} / total_assigned : 0;
+        out += base::StringPrintf(
+                "    cid: 0x%04x state: %s tx_mtu: %d rx_mtu: %d outstanding: %zu queued: %d "
+                "sdus, %zu bytes assigned: %u (%d%%)\n",
+                channel.cid_, channel_state_text(channel.state_).c_str(), channel.tx_mtu_,
+                channel.rx_mtu_, channel_outstanding(channel), channel_l2cap_queue_depth(channel),
+                channel_queued_bytes(channel), channel.num_assigned_, static_cast<int>(share));
+      }
+    }
+    return out;
+  }
+
   void add_from_storage(const RawAddress& bd_addr) {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
 
@@ -20,13 +20,16 @@
 
 #include <base/functional/bind.h>
 #include <base/functional/callback.h>
-#include <base/location.h>
 #include <bluetooth/log.h>
 
-#include <map>
-#include <memory>
+#include <bitset>
+#include <limits>
 #include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
+#include "common/time_util.h"
 #include "main/shim/le_scanning_manager.h"
 #include "os/logging/log_adapter.h"
 #include "osi/include/alarm.h"
@@ -45,73 +48,121 @@ using namespace bluetooth;
 
 constexpr char kBtmLogTag[] = "TA";
 
-struct closure_data {
-  base::OnceClosure user_task;
-  base::Location posted_from;
-};
-
-static void alarm_closure_cb(void* p) {
-  closure_data* data = (closure_data*)p;
-  log::verbose("executing timer scheduled at {}", data->posted_from.ToString());
-  std::move(data->user_task).Run();
-  delete data;
-}
-
-// Periodic alarms are not supported, because we clean up data in callback
-void alarm_set_closure(const base::Location& posted_from, alarm_t* alarm, uint64_t interval_ms,
-                       base::OnceClosure user_task) {
-  closure_data* data = new closure_data;
-  data->posted_from = posted_from;
-  data->user_task = std::move(user_task);
-  log::verbose("scheduling timer {}", data->posted_from.ToString());
-  alarm_set_on_mloop(alarm, interval_ms, alarm_closure_cb, data);
-}
-
-using unique_alarm_ptr = std::unique_ptr<alarm_t, decltype(&alarm_free)>;
-
 namespace connection_manager {
 
+/* One bit per app, tAPP_ID is used as the bit index */
+using tAPP_ID_SET = std::bitset<std::numeric_limits<tAPP_ID>::max() + 1>;
+
 struct tAPPS_CONNECTING {
   // ids of clients doing background connection to given device
-  std::set<tAPP_ID> doing_bg_conn;
-  std::set<tAPP_ID> doing_targeted_announcements_conn;
-  bool is_in_accept_list;
+  tAPP_ID_SET doing_bg_conn;
+  tAPP_ID_SET doing_targeted_announcements_conn;
+  bool is_in_accept_list{false};
 
-  // Apps trying to do direct connection.
-  std::map<tAPP_ID, unique_alarm_ptr> doing_direct_conn;
+  // Apps trying to do direct connection. Their timeouts are kept in
+  // direct_connect_timeouts.
+  tAPP_ID_SET doing_direct_conn;
 };
 
 namespace {
 // Maps address to apps trying to connect to it
-std::map<RawAddress, tAPPS_CONNECTING> bgconn_dev;
+std::unordered_map<RawAddress, tAPPS_CONNECTING> bgconn_dev;
+
+// Direct connection timeouts for all the devices, ordered by deadline. A single
+// alarm is armed for the earliest one.
+std::set<std::tuple<uint64_t, RawAddress, tAPP_ID>> direct_connect_timeouts;
+alarm_t* direct_connect_timer = nullptr;
+
+tAPP_ID first_app_id(const tAPP_ID_SET& apps) {
+  for (size_t app_id = 0; app_id < apps.size(); app_id++) {
+    if (apps.test(app_id)) {
+      return static_cast<tAPP_ID>(app_id);
+    }
+  }
+  return 0;
+}
+
+std::set<tAPP_ID> to_app_id_set(const tAPP_ID_SET& apps) {
+  std::set<tAPP_ID> app_ids;
+  for (size_t app_id = 0; app_id < apps.size() && app_ids.size() < apps.count(); app_id++) {
+    if (apps.test(app_id)) {
+      app_ids.insert(static_cast<tAPP_ID>(app_id));
+    }
+  }
+  return app_ids;
+}
 
 int num_of_targeted_announcements_users(void) {
   return std::count_if(bgconn_dev.begin(), bgconn_dev.end(), [](const auto& pair) {
-    return !pair.second.is_in_accept_list && !pair.second.doing_targeted_announcements_conn.empty();
+    return !pair.second.is_in_accept_list && pair.second.doing_targeted_announcements_conn.any();
   });
 }
 
 bool is_anyone_interested_to_use_accept_list(
-        const std::map<RawAddress, tAPPS_CONNECTING>::iterator it) {
-  if (!it->second.doing_targeted_announcements_conn.empty()) {
-    return !it->second.doing_direct_conn.empty();
+        const std::unordered_map<RawAddress, tAPPS_CONNECTING>::iterator it) {
+  if (it->second.doing_targeted_announcements_conn.any()) {
+    return it->second.doing_direct_conn.any();
   }
-  return !it->second.doing_bg_conn.empty() || !it->second.doing_direct_conn.empty();
+  return it->second.doing_bg_conn.any() || it->second.doing_direct_conn.any();
 }
 
-bool is_anyone_connecting(const std::map<RawAddress, tAPPS_CONNECTING>::iterator it) {
-  return !it->second.doing_bg_conn.empty() || !it->second.doing_direct_conn.empty() ||
-         !it->second.doing_targeted_announcements_conn.empty();
+bool is_anyone_connecting(const std::unordered_map<RawAddress, tAPPS_CONNECTING>::iterator it) {
+  return it->second.doing_bg_conn.any() || it->second.doing_direct_conn.any() ||
+         it->second.doing_targeted_announcements_conn.any();
 }
 
 }  // namespace
 
+static void direct_connect_timer_cb(void* data);
+
+/* Arm the alarm for the earliest direct connection timeout, or cancel it if
+ * there is none left */
+static void direct_connect_timer_rearm() {
+  if (direct_connect_timeouts.empty()) {
+    if (direct_connect_timer != nullptr) {
+      alarm_cancel(direct_connect_timer);
+    }
+    return;
+  }
+
+  if (direct_connect_timer == nullptr) {
+    direct_connect_timer = alarm_new("wl_conn_params_30s");
+  }
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint64_t deadline_ms = std::get<0>(*direct_connect_timeouts.begin());
+  alarm_set_on_mloop(direct_connect_timer, deadline_ms > now_ms ? deadline_ms - now_ms : 0,
+                     direct_connect_timer_cb, nullptr);
+}
+
+static void direct_connect_timeout_add(tAPP_ID app_id, const RawAddress& address) {
+  bool was_empty = direct_connect_timeouts.empty();
+  direct_connect_timeouts.emplace(
+          bluetooth::common::time_get_os_boottime_ms() + DIRECT_CONNECT_TIMEOUT, address, app_id);
+  // All attempts use the same timeout, so only the first one moves the alarm
+  if (was_empty) {
+    direct_connect_timer_rearm();
+  }
+}
+
+static void direct_connect_timeout_remove(tAPP_ID app_id, const RawAddress& address) {
+  for (auto it = direct_connect_timeouts.begin(); it != direct_connect_timeouts.end(); it++) {
+    if (std::get<1>(*it) == address && std::get<2>(*it) == app_id) {
+      bool was_first = (it == direct_connect_timeouts.begin());
+      direct_connect_timeouts.erase(it);
+      if (was_first) {
+        direct_connect_timer_rearm();
+      }
+      return;
+    }
+  }
+}
+
 /** background connection device from the list. Returns pointer to the device
  * record, or nullptr if not found */
 std::set<tAPP_ID> get_apps_connecting_to(const RawAddress& address) {
   log::debug("address={}", address);
   auto it = bgconn_dev.find(address);
-  return (it != bgconn_dev.end()) ? it->second.doing_bg_conn : std::set<tAPP_ID>();
+  return (it != bgconn_dev.end()) ? to_app_id_set(it->second.doing_bg_conn) : std::set<tAPP_ID>();
 }
 
 bool IsTargetedAnnouncement(const uint8_t* p_eir, uint16_t eir_len) {
@@ -152,7 +203,7 @@ static void target_announcement_observe_results_cb(tBTM_INQ_RESULTS* p_inq, cons
                                                    uint16_t eir_len) {
   auto addr = p_inq->remote_bd_addr;
   auto it = bgconn_dev.find(addr);
-  if (it == bgconn_dev.end() || it->second.doing_targeted_announcements_conn.empty()) {
+  if (it == bgconn_dev.end() || it->second.doing_targeted_announcements_conn.none()) {
     return;
   }
 
@@ -176,7 +227,7 @@ static void target_announcement_observe_results_cb(tBTM_INQ_RESULTS* p_inq, cons
   BTM_LogHistory(kBtmLogTag, addr, "Found TA from");
 
   /* Take fist app_id and use it for direct_connect */
-  auto app_id = *(it->second.doing_targeted_announcements_conn.begin());
+  auto app_id = first_app_id(it->second.doing_targeted_announcements_conn);
 
   /* If scan is ongoing lets stop it */
   do_in_main_thread(base::BindOnce(schedule_direct_connect_add, app_id, addr));
@@ -205,20 +256,20 @@ bool background_connect_targeted_announcement_add(tAPP_ID app_id, const RawAddre
   auto it = bgconn_dev.find(address);
   if (it != bgconn_dev.end()) {
     // check if filtering already enabled
-    if (it->second.doing_targeted_announcements_conn.count(app_id)) {
+    if (it->second.doing_targeted_announcements_conn.test(app_id)) {
       log::info("app_id={}, already doing targeted announcement filtering to address={}",
                 static_cast<int>(app_id), address);
       return true;
     }
 
-    bool targeted_filtering_enabled = !it->second.doing_targeted_announcements_conn.empty();
+    bool targeted_filtering_enabled = it->second.doing_targeted_announcements_conn.any();
 
     // Check if connecting
-    if (!it->second.doing_direct_conn.empty()) {
+    if (it->second.doing_direct_conn.any()) {
       log::info("app_id={}, address={}, already in direct connection", static_cast<int>(app_id),
                 address);
 
-    } else if (!targeted_filtering_enabled && !it->second.doing_bg_conn.empty()) {
+    } else if (!targeted_filtering_enabled && it->second.doing_bg_conn.any()) {
       // device is already in the acceptlist so we would have to remove it
       log::info("already doing background connection to address={}. Need to disable it.", address);
       disable_accept_list = true;
@@ -230,8 +281,9 @@ bool background_connect_targeted_announcement_add(tAPP_ID app_id, const RawAddre
     bgconn_dev[address].is_in_accept_list = false;
   }
 
-  bgconn_dev[address].doing_targeted_announcements_conn.insert(app_id);
-  if (bgconn_dev[address].doing_targeted_announcements_conn.size() == 1) {
+  tAPPS_CONNECTING& entry = bgconn_dev[address];
+  entry.doing_targeted_announcements_conn.set(app_id);
+  if (entry.doing_targeted_announcements_conn.count() == 1) {
     BTM_LogHistory(kBtmLogTag, address, "Allow connection from");
   }
 
@@ -251,7 +303,7 @@ bool background_connect_add(uint8_t app_id, const RawAddress& address) {
   bool is_targeted_announcement_enabled = false;
   if (it != bgconn_dev.end()) {
     // device already in the acceptlist, just add interested app to the list
-    if (it->second.doing_bg_conn.count(app_id)) {
+    if (it->second.doing_bg_conn.test(app_id)) {
       log::debug("app_id={}, already doing background connection to address={}",
                  static_cast<int>(app_id), address);
       return true;
@@ -263,7 +315,7 @@ bool background_connect_add(uint8_t app_id, const RawAddress& address) {
                  address);
       in_acceptlist = true;
     } else {
-      is_targeted_announcement_enabled = !it->second.doing_targeted_announcements_conn.empty();
+      is_targeted_announcement_enabled = it->second.doing_targeted_announcements_conn.any();
     }
   }
 
@@ -283,7 +335,7 @@ bool background_connect_add(uint8_t app_id, const RawAddress& address) {
 
   // create entry for address, and insert app_id.
   // new tAPPS_CONNECTING will be default constructed if not exist
-  bgconn_dev[address].doing_bg_conn.insert(app_id);
+  bgconn_dev[address].doing_bg_conn.set(app_id);
   return true;
 }
 
@@ -297,6 +349,12 @@ bool remove_unconditional(const RawAddress& address) {
     return false;
   }
 
+  for (size_t app_id = 0; app_id < it->second.doing_direct_conn.size(); app_id++) {
+    if (it->second.doing_direct_conn.test(app_id)) {
+      direct_connect_timeout_remove(static_cast<tAPP_ID>(app_id), address);
+    }
+  }
+
   BTM_AcceptlistRemove(address);
   bgconn_dev.erase(it);
   return true;
@@ -315,17 +373,19 @@ bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
 
   bool accept_list_enabled = it->second.is_in_accept_list;
   auto num_of_targeted_announcements_before_remove =
-          it->second.doing_targeted_announcements_conn.size();
+          it->second.doing_targeted_announcements_conn.count();
 
-  bool removed_from_bg_conn = (it->second.doing_bg_conn.erase(app_id) > 0);
-  bool removed_from_ta = (it->second.doing_targeted_announcements_conn.erase(app_id) > 0);
+  bool removed_from_bg_conn = it->second.doing_bg_conn.test(app_id);
+  bool removed_from_ta = it->second.doing_targeted_announcements_conn.test(app_id);
+  it->second.doing_bg_conn.reset(app_id);
+  it->second.doing_targeted_announcements_conn.reset(app_id);
   if (!removed_from_bg_conn && !removed_from_ta) {
     log::warn("Failed to remove background connection app {} for address {}",
               static_cast<int>(app_id), address);
     return false;
   }
 
-  if (removed_from_ta && it->second.doing_targeted_announcements_conn.size() == 0) {
+  if (removed_from_ta && it->second.doing_targeted_announcements_conn.none()) {
     BTM_LogHistory(kBtmLogTag, address, "Ignore connection from");
   }
 
@@ -335,14 +395,14 @@ bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
     /* Check which method should be used now.*/
     if (!accept_list_enabled) {
       /* Accept list was not used */
-      if (!it->second.doing_targeted_announcements_conn.empty()) {
+      if (it->second.doing_targeted_announcements_conn.any()) {
         /* Keep using filtering */
         log::debug("Keep using target announcement filtering");
-      } else if (!it->second.doing_bg_conn.empty()) {
+      } else if (it->second.doing_bg_conn.any()) {
         if (!BTM_AcceptlistAdd(address)) {
           log::warn("Could not re add device to accept list");
         } else {
-          bgconn_dev[address].is_in_accept_list = true;
+          it->second.is_in_accept_list = true;
         }
       }
     }
@@ -380,9 +440,12 @@ void on_app_deregistered(uint8_t app_id) {
   auto end = bgconn_dev.end();
   /* update the BG conn device list */
   while (it != end) {
-    it->second.doing_bg_conn.erase(app_id);
+    it->second.doing_bg_conn.reset(app_id);
 
-    it->second.doing_direct_conn.erase(app_id);
+    if (it->second.doing_direct_conn.test(app_id)) {
+      it->second.doing_direct_conn.reset(app_id);
+      direct_connect_timeout_remove(app_id, it->first);
+    }
 
     if (is_anyone_connecting(it)) {
       it++;
@@ -397,8 +460,8 @@ void on_app_deregistered(uint8_t app_id) {
 static void remove_all_clients_with_pending_connections(const RawAddress& address) {
   log::debug("address={}", address);
   auto it = bgconn_dev.find(address);
-  while (it != bgconn_dev.end() && !it->second.doing_direct_conn.empty()) {
-    uint8_t app_id = it->second.doing_direct_conn.begin()->first;
+  while (it != bgconn_dev.end() && it->second.doing_direct_conn.any()) {
+    uint8_t app_id = first_app_id(it->second.doing_direct_conn);
     direct_connect_remove(app_id, address);
     it = bgconn_dev.find(address);
   }
@@ -419,21 +482,44 @@ void on_connection_timed_out_from_shim(const RawAddress& address) {
  * to true, as there is no need to wipe controller acceptlist in this case. */
 void reset(bool after_reset) {
   bgconn_dev.clear();
+  direct_connect_timeouts.clear();
+  if (direct_connect_timer != nullptr) {
+    alarm_free(direct_connect_timer);
+    direct_connect_timer = nullptr;
+  }
   if (!after_reset) {
     target_announcements_filtering_set(false);
     BTM_AcceptlistClear();
   }
 }
 
-void wl_direct_connect_timeout_cb(uint8_t app_id, const RawAddress& address) {
+static void wl_direct_connect_timeout_cb(uint8_t app_id, const RawAddress& address) {
   log::debug("app_id={}, address={}", static_cast<int>(app_id), address);
   on_connection_timed_out(app_id, address);
-
-  // TODO: this would free the timer, from within the timer callback, which is
-  // bad.
   direct_connect_remove(app_id, address, true);
 }
 
+/* Fires for the earliest direct connection timeout. Expires every attempt that
+ * is due by now, then re-arms the alarm for the next one. */
+static void direct_connect_timer_cb(void* /* data */) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  std::vector<std::pair<tAPP_ID, RawAddress>> expired;
+  for (auto it = direct_connect_timeouts.begin(); it != direct_connect_timeouts.end();) {
+    // The head is due even if the alarm fired slightly early
+    if (!expired.empty() && std::get<0>(*it) > now_ms) {
+      break;
+    }
+    expired.emplace_back(std::get<2>(*it), std::get<1>(*it));
+    it = direct_connect_timeouts.erase(it);
+  }
+
+  for (const auto& [app_id, address] : expired) {
+    wl_direct_connect_timeout_cb(app_id, address);
+  }
+
+  direct_connect_timer_rearm();
+}
+
 /** Add a device to the direct connection list. Returns true if device
  * added to the list, false otherwise */
 bool direct_connect_add(uint8_t app_id, const RawAddress& address) {
@@ -442,7 +528,7 @@ bool direct_connect_add(uint8_t app_id, const RawAddress& address) {
   auto it = bgconn_dev.find(address);
   if (it != bgconn_dev.end()) {
     // app already trying to connect to this particular device
-    if (it->second.doing_direct_conn.count(app_id)) {
+    if (it->second.doing_direct_conn.test(app_id)) {
       log::info("direct connect attempt from app_id=0x{:x} already in progress", app_id);
       return false;
     }
@@ -463,12 +549,8 @@ bool direct_connect_add(uint8_t app_id, const RawAddress& address) {
     bgconn_dev[address].is_in_accept_list = true;
   }
 
-  // Setup a timer
-  alarm_t* timeout = alarm_new("wl_conn_params_30s");
-  alarm_set_closure(FROM_HERE, timeout, DIRECT_CONNECT_TIMEOUT,
-                    base::BindOnce(&wl_direct_connect_timeout_cb, app_id, address));
-
-  bgconn_dev[address].doing_direct_conn.emplace(app_id, unique_alarm_ptr(timeout, &alarm_free));
+  bgconn_dev[address].doing_direct_conn.set(app_id);
+  direct_connect_timeout_add(app_id, address);
 
   return true;
 }
@@ -485,17 +567,16 @@ bool direct_connect_remove(uint8_t app_id, const RawAddress& address, bool conne
     return false;
   }
 
-  auto app_it = it->second.doing_direct_conn.find(app_id);
-  if (app_it == it->second.doing_direct_conn.end()) {
+  if (!it->second.doing_direct_conn.test(app_id)) {
     log::warn("Unable to find direct connection to remove peer:{}", address);
     return false;
   }
 
   /* Let see if the device was connected due to Target Announcements.*/
-  bool is_targeted_announcement_enabled = !it->second.doing_targeted_announcements_conn.empty();
+  bool is_targeted_announcement_enabled = it->second.doing_targeted_announcements_conn.any();
 
-  // this will free the alarm
-  it->second.doing_direct_conn.erase(app_it);
+  it->second.doing_direct_conn.reset(app_id);
+  direct_connect_timeout_remove(app_id, address);
 
   if (is_anyone_interested_to_use_accept_list(it)) {
     if (connection_timeout) {
@@ -534,29 +615,29 @@ void dump(int fd) {
     // TODO: confirm whether we need to replace this
     dprintf(fd, "\n\t * %s: ", ADDRESS_TO_LOGGABLE_CSTR(entry.first));
 
-    if (!entry.second.doing_direct_conn.empty()) {
+    if (entry.second.doing_direct_conn.any()) {
       dprintf(fd, "\n\t\tapps doing direct connect: ");
-      for (const auto& id : entry.second.doing_direct_conn) {
-        dprintf(fd, "%d, ", id.first);
+      for (const auto& id : to_app_id_set(entry.second.doing_direct_conn)) {
+        dprintf(fd, "%d, ", id);
       }
     }
 
-    if (!entry.second.doing_bg_conn.empty()) {
+    if (entry.second.doing_bg_conn.any()) {
       dprintf(fd, "\n\t\tapps doing background connect: ");
-      for (const auto& id : entry.second.doing_bg_conn) {
+      for (const auto& id : to_app_id_set(entry.second.doing_bg_conn)) {
         dprintf(fd, "%d, ", id);
       }
     }
-    if (!entry.second.doing_targeted_announcements_conn.empty()) {
+    if (entry.second.doing_targeted_announcements_conn.any()) {
       dprintf(fd, "\n\t\tapps doing cap announcement connect: ");
-      for (const auto& id : entry.second.doing_targeted_announcements_conn) {
+      for (const auto& id : to_app_id_set(entry.second.doing_targeted_announcements_conn)) {
         dprintf(fd, "%d, ", id);
       }
     }
     dprintf(fd, "\n\t\t is in the allow list: %s",
             entry.second.is_in_accept_list ? "true" : "false");
   }
-  dprintf(fd, "\n");
+  dprintf(fd, "\n\tpending direct connection timeouts: %zu\n", direct_connect_timeouts.size());
 }
 
 }  // namespace connection_manager
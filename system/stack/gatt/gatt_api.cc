@@ -508,8 +508,28 @@ tGATT_STATUS GATTS_HandleValueIndication(tCONN_ID conn_id, uint16_t attr_handle,
   return cmd_status;
 }
 
+/* Builds a Multiple Handle Value Notification from the values in [begin, end),
+ * which must fit in payload_size */
+static BT_HDR* gatt_build_multi_value_notif(uint16_t payload_size, const tGATT_VALUE* begin,
+                                            const tGATT_VALUE* end) {
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+
+  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
+  p_buf->offset = L2CAP_MIN_OFFSET;
+  p_buf->len = 1;
+  for (const tGATT_VALUE* notif = begin; notif != end; notif++) {
+    log::verbose("Adding handle: 0x{:04x}, val len {}", notif->handle, notif->len);
+    UINT16_TO_STREAM(p, notif->handle);
+    UINT16_TO_STREAM(p, notif->len);
+    ARRAY_TO_STREAM(p, notif->value, notif->len);
+    p_buf->len += 4 + notif->len;
+  }
+  return p_buf;
+}
+
 #if (GATT_UPPER_TESTER_MULT_VARIABLE_LENGTH_NOTIF == TRUE)
-static tGATT_STATUS GATTS_HandleMultipleValueNotification(
+static tGATT_STATUS gatts_upper_tester_multi_value_notification(
         tGATT_TCB* p_tcb, std::vector<tGATT_VALUE> gatt_notif_vector) {
   log::info("");
 
@@ -518,21 +538,9 @@ static tGATT_STATUS GATTS_HandleMultipleValueNotification(
 
   /* TODO Handle too big packet size here. Not needed now for testing. */
   /* Just build the message. */
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
-
-  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-  UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_buf->len = 1;
-  for (auto notif : gatt_notif_vector) {
-    log::info("Adding handle: 0x{:04x}, val len {}", notif.handle, notif.len);
-    UINT16_TO_STREAM(p, notif.handle);
-    p_buf->len += 2;
-    UINT16_TO_STREAM(p, notif.len);
-    p_buf->len += 2;
-    ARRAY_TO_STREAM(p, notif.value, notif.len);
-    p_buf->len += notif.len;
-  }
+  BT_HDR* p_buf = gatt_build_multi_value_notif(
+          payload_size, gatt_notif_vector.data(),
+          gatt_notif_vector.data() + gatt_notif_vector.size());
 
   log::info("Total len: {}", p_buf->len);
 
@@ -607,7 +615,7 @@ tGATT_STATUS GATTS_HandleValueNotification(tCONN_ID conn_id, uint16_t attr_handl
 
       notif.auth_req = GATT_AUTH_REQ_NONE;
 
-      return GATTS_HandleMultipleValueNotification(p_tcb, gatt_notif_vector);
+      return gatts_upper_tester_multi_value_notification(p_tcb, gatt_notif_vector);
     }
 
     log::error("PTS Mode: Invalid tcb_idx: {}, cached_tcb_idx: {}", tcb_idx, cached_tcb_idx);
@@ -636,6 +644,94 @@ tGATT_STATUS GATTS_HandleValueNotification(tCONN_ID conn_id, uint16_t attr_handl
   return cmd_sent;
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function sends several handle value notifications to a
+ *                  client, packed into Multiple Handle Value Notifications up
+ *                  to the payload size when the client supports them.
+ *
+ *                  Sending stops at the first PDU that congests the channel.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  values: handles and values to notify, in order.
+ *                  p_num_sent: set to the number of values sent, the first ones
+ *                  of |values|.
+ *
+ * Returns          GATT_SUCCESS if all were sent, GATT_CONGESTED if the channel
+ *                  is now congested, whether values are left or not; otherwise
+ *                  error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleMultipleValueNotification(tCONN_ID conn_id,
+                                                   const std::vector<tGATT_VALUE>& values,
+                                                   uint16_t* p_num_sent) {
+  tGATT_IF gatt_if = gatt_get_gatt_if(conn_id);
+  uint8_t tcb_idx = gatt_get_tcb_idx(conn_id);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+
+  *p_num_sent = 0;
+  if ((p_reg == NULL) || (p_tcb == NULL)) {
+    log::error("Unknown  conn_id: {}", conn_id);
+    return GATT_ILLEGAL_PARAMETER;
+  }
+
+  for (const auto& value : values) {
+    if (!GATT_HANDLE_IS_VALID(value.handle)) {
+      return GATT_ILLEGAL_PARAMETER;
+    }
+  }
+
+  bool multi_notif_supported = gatt_sr_is_cl_multi_variable_len_notif_supported(*p_tcb);
+  size_t first = 0;
+  while (first < values.size()) {
+    /* Each PDU picks its own bearer, so that a burst spreads over EATT */
+    uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
+    uint16_t payload_size = gatt_tcb_get_payload_size(*p_tcb, cid);
+
+    /* Opcode, then a handle and a length before each value */
+    size_t last = first;
+    size_t pdu_len = 1;
+    while (multi_notif_supported && last < values.size() &&
+           pdu_len + 4 + values[last].len <= payload_size) {
+      pdu_len += 4 + values[last].len;
+      last++;
+    }
+
+    BT_HDR* p_buf;
+    if (last - first >= 2) {
+      p_buf = gatt_build_multi_value_notif(payload_size, values.data() + first,
+                                           values.data() + last);
+    } else {
+      /* Alone or too long to share a PDU */
+      tGATT_SR_MSG gatt_sr_msg;
+      gatt_sr_msg.attr_value = values[first];
+      gatt_sr_msg.attr_value.auth_req = GATT_AUTH_REQ_NONE;
+      p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF, &gatt_sr_msg, payload_size);
+      last = first + 1;
+    }
+
+    if (p_buf == NULL) {
+      return GATT_NO_RESOURCES;
+    }
+
+    tGATT_STATUS cmd_sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
+    if (cmd_sent != GATT_SUCCESS && cmd_sent != GATT_CONGESTED) {
+      return cmd_sent;
+    }
+    first = last;
+    *p_num_sent = static_cast<uint16_t>(first);
+
+    /* The rest waits for the channel to drain */
+    if (cmd_sent == GATT_CONGESTED) {
+      return GATT_CONGESTED;
+    }
+  }
+  return GATT_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -1672,6 +1768,30 @@ bool GATT_GetConnectionInfor(tCONN_ID conn_id, tGATT_IF* p_gatt_if, RawAddress&
   return true;
 }
 
+/*******************************************************************************
+ *
+ * Function         GATT_GetPayloadSize
+ *
+ * Description      Get the ATT payload size of the bearer the application
+ *                  registered on conn_id sends its server messages on.
+ *
+ * Parameters        conn_id: connection id  (input)
+ *
+ * Returns          The payload size, 0 if conn_id is unknown
+ *
+ ******************************************************************************/
+uint16_t GATT_GetPayloadSize(tCONN_ID conn_id) {
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_get_gatt_if(conn_id));
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(gatt_get_tcb_idx(conn_id));
+  if (!p_tcb || !p_reg) {
+    log::warn("Unknown conn_id=0x{:x}", conn_id);
+    return 0;
+  }
+
+  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
+  return gatt_tcb_get_payload_size(*p_tcb, cid);
+}
+
 /*******************************************************************************
  *
  * Function         GATT_GetConnIdIfConnected
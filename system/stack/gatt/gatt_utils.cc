@@ -472,7 +472,7 @@ std::string gatt_tcb_get_holders_info_string(const tGATT_TCB* p_tcb) {
  *
  * Function     gatt_tcb_dump
  *
- * Description  Print gatt_cb.tcb[] into dumpsys
+ * Description  Print gatt_cb.tcb[] and the EATT bearers into dumpsys
  *
  * Returns      void
  *
@@ -504,6 +504,8 @@ void gatt_tcb_dump(int fd) {
 
   dprintf(fd, "TCB (GATT_MAX_PHY_CHANNEL: %d) in_use: %d\n%s\n", gatt_get_max_phy_channel(),
           in_use_cnt, stream.str().c_str());
+
+  EattExtension::GetInstance()->Dump(fd);
 }
 #undef DUMPSYS_TAG
 
@@ -30,5 +30,8 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa, tBTM_SEC_DEV_REC* p_dev_rec)
 
 void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& p_dev_rec);
 void btm_ble_resolving_list_remove_dev(tBTM_SEC_DEV_REC* p_dev_rec);
+void btm_ble_resolving_list_note_activity(const RawAddress& pseudo_addr);
+void btm_ble_resolving_list_rebalance();
+bool btm_ble_resolving_list_is_host_resolved(const RawAddress& pseudo_addr);
 
 uint64_t btm_get_next_private_address_interval_ms();
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "btm_ble_api.h"
 #include "gattdefs.h"
@@ -915,6 +916,29 @@ void GATTS_StopService(uint16_t service_handle);
 [[nodiscard]] tGATT_STATUS GATTS_HandleValueNotification(tCONN_ID conn_id, uint16_t attr_handle,
                                                          uint16_t val_len, uint8_t* p_val);
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function sends several handle value notifications to a
+ *                  client. They are packed into as few Multiple Handle Value
+ *                  Notifications as the MTU allows when the client supports
+ *                  them, and sent one by one otherwise. Sending stops at the
+ *                  first PDU that congests the channel.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  values: handles and values to notify, in order.
+ *                  p_num_sent: set to the number of values sent, the first ones
+ *                  of |values|.
+ *
+ * Returns          GATT_SUCCESS if all were sent, GATT_CONGESTED if the channel
+ *                  is now congested, whether values are left or not; otherwise
+ *                  error code.
+ *
+ ******************************************************************************/
+[[nodiscard]] tGATT_STATUS GATTS_HandleMultipleValueNotification(
+        tCONN_ID conn_id, const std::vector<tGATT_VALUE>& values, uint16_t* p_num_sent);
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -1234,6 +1258,20 @@ void GATT_StartIf(tGATT_IF gatt_if);
 [[nodiscard]] bool GATT_GetConnectionInfor(tCONN_ID conn_id, tGATT_IF* p_gatt_if,
                                            RawAddress& bd_addr, tBT_TRANSPORT* p_transport);
 
+/*******************************************************************************
+ *
+ * Function         GATT_GetPayloadSize
+ *
+ * Description      Get the ATT payload size of the bearer the application
+ *                  registered on conn_id sends its server messages on.
+ *
+ * Parameters        conn_id: connection id  (input)
+ *
+ * Returns          The payload size, 0 if conn_id is unknown
+ *
+ ******************************************************************************/
+[[nodiscard]] uint16_t GATT_GetPayloadSize(tCONN_ID conn_id);
+
 /*******************************************************************************
  *
  * Function         GATT_GetConnIdIfConnected
@@ -590,6 +590,57 @@ public:
                                         uint16_t max_int, uint16_t latency, uint16_t timeout,
                                         uint16_t min_ce_len, uint16_t max_ce_len) = 0;
 
+  /*******************************************************************************
+   **
+   ** Function         L2CA_SetBleConnDemand
+   **
+   ** Description      Sets the connection parameters needed by one user of an
+   **                  LE link. The link is updated to the tightest combination
+   **                  of all active demands.
+   **
+   ** Parameters:      bd_addr: Peer bluetooth device address
+   **                  demand: user of the link placing the demand
+   **                  min_int, max_int, latency, timeout, min_ce_len,
+   **                  max_ce_len: parameters needed by that user
+   **
+   ** Returns          true if the link is known, false otherwise
+   **
+   ******************************************************************************/
+  virtual bool L2CA_SetBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand,
+                                     uint16_t min_int, uint16_t max_int, uint16_t latency,
+                                     uint16_t timeout, uint16_t min_ce_len,
+                                     uint16_t max_ce_len) = 0;
+
+  /*******************************************************************************
+   **
+   ** Function         L2CA_ClearBleConnDemand
+   **
+   ** Description      Withdraws the demand of one user of an LE link. The link
+   **                  is relaxed to the combination of the remaining demands.
+   **
+   ** Parameters:      bd_addr: Peer bluetooth device address
+   **                  demand: user of the link withdrawing its demand
+   **
+   ** Returns          void
+   **
+   ******************************************************************************/
+  virtual void L2CA_ClearBleConnDemand(const RawAddress& rem_bda,
+                                       tL2CAP_BLE_CONN_DEMAND demand) = 0;
+
+  /*******************************************************************************
+   **
+   ** Function         L2CA_IsBleConnLatencySensitive
+   **
+   ** Description      Tells whether audio or HID currently place a demand on
+   **                  the LE link to the peer.
+   **
+   ** Parameters:      bd_addr: Peer bluetooth device address
+   **
+   ** Returns          true if a latency sensitive demand is active
+   **
+   ******************************************************************************/
+  virtual bool L2CA_IsBleConnLatencySensitive(const RawAddress& rem_bda) = 0;
+
   /*******************************************************************************
    **
    ** Function         L2CA_LockBleConnParamsForServiceDiscovery
@@ -755,6 +806,22 @@ public:
    ******************************************************************************/
   virtual uint16_t L2CA_FlushChannel(uint16_t cid, uint16_t num_to_flush) = 0;
 
+  /*******************************************************************************
+   **
+   ** Function         L2CA_GetTxQueueDepth
+   **
+   ** Description      Returns the number of buffers queued up for xmission for
+   **                  a particular CID. Unlike L2CA_FlushChannel with
+   **                  L2CAP_FLUSH_CHANS_GET, the channel state is not touched
+   **                  and no congestion callback is called.
+   **
+   ** Parameters:      lcid: Local channel id of L2CAP connection
+   **
+   ** Returns          Number of buffers queued for that CID
+   **
+   ******************************************************************************/
+  virtual uint16_t L2CA_GetTxQueueDepth(uint16_t lcid) = 0;
+
   /*******************************************************************************
    **
    ** Function         L2CA_SetTxPriority
@@ -65,6 +65,17 @@ enum tL2CAP_LATENCY : uint8_t {
   L2CAP_LATENCY_LOW = 1,
 };
 
+/* Users of an LE link that place demands on its connection parameters, see
+ * L2CA_SetBleConnDemand. The link runs with the tightest combination of the
+ * active demands. */
+enum tL2CAP_BLE_CONN_DEMAND : uint8_t {
+  L2CAP_BLE_CONN_DEMAND_AUDIO = 0,
+  L2CAP_BLE_CONN_DEMAND_HID = 1,
+  L2CAP_BLE_CONN_DEMAND_GATT = 2,
+  L2CAP_BLE_CONN_DEMAND_OTHER = 3,
+};
+#define L2CAP_BLE_CONN_DEMAND_MAX 4
+
 #define L2CAP_NO_IDLE_TIMEOUT 0xFFFF
 
 /* L2CA_FlushChannel num_to_flush definitions */
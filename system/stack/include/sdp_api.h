@@ -136,6 +136,22 @@ struct tSdpApi {
     [[nodiscard]] bool (*SDP_ServiceSearchAttributeRequest2)(
             const RawAddress&, tSDP_DISCOVERY_DB*,
             base::RepeatingCallback<tSDP_DISC_CMPL_CB> complete_callback);
+
+    /*******************************************************************************
+
+      Function         SDP_FreeDiscoveryDb
+
+      Description      This function releases the overflow memory of a
+                       growable discovery database. The records of the
+                       database are no longer valid afterwards.
+
+      Parameters:      p_db        - (input) address of an area of memory where
+                                             the discovery database is managed.
+
+      Returns          void
+
+     ******************************************************************************/
+    void (*SDP_FreeDiscoveryDb)(tSDP_DISCOVERY_DB*);
   } service;
 
   struct {
@@ -46,6 +46,19 @@
  ******************************************************************************/
 void SMP_Init(uint8_t init_security_mode);
 
+/*******************************************************************************
+ *
+ * Function         SMP_Free
+ *
+ * Description      This function releases the resources of the SMP unit.
+ *                  It waits for the main thread, so it must be called from
+ *                  another thread.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SMP_Free();
+
 /*******************************************************************************
  *
  * Function         SMP_Register
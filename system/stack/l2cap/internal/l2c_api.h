@@ -495,6 +495,18 @@ void L2CA_DeregisterLECoc(uint16_t psm);
  ******************************************************************************/
 [[nodiscard]] uint16_t L2CA_FlushChannel(uint16_t lcid, uint16_t num_to_flush);
 
+/*******************************************************************************
+ *
+ * Function     L2CA_GetTxQueueDepth
+ *
+ * Description  Returns the number of buffers queued up for xmission for a
+ *              particular CID, without touching the channel state.
+ *
+ * Returns      Number of buffers queued for that CID
+ *
+ ******************************************************************************/
+[[nodiscard]] uint16_t L2CA_GetTxQueueDepth(uint16_t lcid);
+
 /*******************************************************************************
  *
  * Function         L2CA_UseLatencyMode
@@ -682,6 +694,49 @@ typedef void(tL2CA_FIXED_CONGESTION_STATUS_CB)(const RawAddress&, bool);
                                             uint16_t max_int, uint16_t latency, uint16_t timeout,
                                             uint16_t min_ce_len, uint16_t max_ce_len);
 
+/*******************************************************************************
+ *
+ * Function         L2CA_SetBleConnDemand
+ *
+ * Description      Sets the connection parameters needed by one user of an LE
+ *                  link. The link is updated to the tightest combination of
+ *                  all active demands: the smallest intervals and latency, and
+ *                  the longest supervision timeout and connection events.
+ *
+ * Returns          true if the link is known, false otherwise
+ *
+ ******************************************************************************/
+[[nodiscard]] bool L2CA_SetBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand,
+                                         uint16_t min_int, uint16_t max_int, uint16_t latency,
+                                         uint16_t timeout, uint16_t min_ce_len,
+                                         uint16_t max_ce_len);
+
+/*******************************************************************************
+ *
+ * Function         L2CA_ClearBleConnDemand
+ *
+ * Description      Withdraws the demand of one user of an LE link. The link is
+ *                  relaxed to the combination of the remaining demands, at the
+ *                  end of the current decision window.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void L2CA_ClearBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand);
+
+/*******************************************************************************
+ *
+ * Function         L2CA_IsBleConnLatencySensitive
+ *
+ * Description      Tells whether audio or HID currently place a demand on the
+ *                  LE link to the peer, so that power management keeps the
+ *                  links to that peer responsive.
+ *
+ * Returns          true if a latency sensitive demand is active
+ *
+ ******************************************************************************/
+[[nodiscard]] bool L2CA_IsBleConnLatencySensitive(const RawAddress& rem_bda);
+
 /* When called with lock=true, LE connection parameters will be locked on
  * fastest value, and we won't accept request to change it from remote. When
  * called with lock=false, parameters are relaxed.
@@ -31,6 +31,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -1617,6 +1618,33 @@ uint16_t L2CA_FlushChannel(uint16_t lcid, uint16_t num_to_flush) {
   return num_left;
 }
 
+/*******************************************************************************
+ *
+ * Function         L2CA_GetTxQueueDepth
+ *
+ * Description      Count the buffers queued up for xmission for a CID, in the
+ *                  link queue and in the CCB xmit hold queue.
+ *
+ * Returns          Number of buffers queued for that CID
+ *
+ ******************************************************************************/
+uint16_t L2CA_GetTxQueueDepth(uint16_t lcid) {
+  tL2C_CCB* p_ccb = l2cu_find_ccb_by_cid(NULL, lcid);
+  if (!p_ccb || (p_ccb->p_lcb == NULL)) {
+    return 0;
+  }
+
+  uint16_t depth = 0;
+  for (const list_node_t* node = list_begin(p_ccb->p_lcb->link_xmit_data_q);
+       node != list_end(p_ccb->p_lcb->link_xmit_data_q); node = list_next(node)) {
+    const BT_HDR* p_buf = (const BT_HDR*)list_node(node);
+    if (p_buf->event == lcid) {
+      depth++;
+    }
+  }
+  return depth + fixed_queue_length(p_ccb->xmit_hold_q);
+}
+
 bool L2CA_IsLinkEstablished(const RawAddress& bd_addr, tBT_TRANSPORT transport) {
   return l2cu_find_lcb_by_bd_addr(bd_addr, transport) != nullptr;
 }
@@ -1743,6 +1771,32 @@ using namespace bluetooth;
 
 #define DUMPSYS_TAG "shim::legacy::l2cap"
 
+static const char* conn_decision_outcome_text(tL2C_BLE_CONN_DECISION_OUTCOME outcome) {
+  switch (outcome) {
+    case L2C_BLE_CONN_DECISION_SENT:
+      return "sent";
+    case L2C_BLE_CONN_DECISION_UNCHANGED:
+      return "unchanged";
+    case L2C_BLE_CONN_DECISION_DEFERRED:
+      return "deferred";
+  }
+  return "unknown";
+}
+
+static const char* conn_demand_text(size_t demand) {
+  switch (demand) {
+    case L2CAP_BLE_CONN_DEMAND_AUDIO:
+      return "audio";
+    case L2CAP_BLE_CONN_DEMAND_HID:
+      return "hid";
+    case L2CAP_BLE_CONN_DEMAND_GATT:
+      return "gatt";
+    case L2CAP_BLE_CONN_DEMAND_OTHER:
+      return "other";
+  }
+  return "unknown";
+}
+
 void L2CA_Dumpsys(int fd) {
   LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
   for (int i = 0; i < MAX_L2CAP_LINKS; i++) {
@@ -1764,6 +1818,29 @@ void L2CA_Dumpsys(int fd) {
     for (auto fixed_cid : lcb.suspended) {
       LOG_DUMPSYS(fd, "  pending removal fixed CID: 0x%04x", fixed_cid);
     }
+
+    if (lcb.is_transport_ble()) {
+      LOG_DUMPSYS(fd, "  conn params interval:%u latency:%u timeout:%u", lcb.cur_interval,
+                  lcb.cur_latency, lcb.cur_timeout);
+      for (size_t j = 0; j < L2CAP_BLE_CONN_DEMAND_MAX; j++) {
+        const tL2C_BLE_CONN_DEMAND_PARAMS& demand = lcb.conn_demand[j];
+        if (demand.active) {
+          LOG_DUMPSYS(fd, "  conn demand %s interval:%u-%u latency:%u timeout:%u",
+                      conn_demand_text(j), demand.min_interval, demand.max_interval,
+                      demand.latency, demand.timeout);
+        }
+      }
+      unsigned count = std::min<unsigned>(lcb.conn_decision_count,
+                                          L2C_BLE_CONN_DECISION_HISTORY_SIZE);
+      for (unsigned j = lcb.conn_decision_count - count; j < lcb.conn_decision_count; j++) {
+        const tL2C_BLE_CONN_DECISION& decision =
+                lcb.conn_decision_history[j % L2C_BLE_CONN_DECISION_HISTORY_SIZE];
+        LOG_DUMPSYS(fd, "  conn update %s at %llu ms: interval:%u-%u latency:%u timeout:%u",
+                    conn_decision_outcome_text(decision.outcome),
+                    (unsigned long long)decision.timestamp_ms, decision.min_interval,
+                    decision.max_interval, decision.latency, decision.timeout);
+      }
+    }
   }
 }
 #undef DUMPSYS_TAG
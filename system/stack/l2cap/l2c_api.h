@@ -83,6 +83,7 @@ public:
                                          uint16_t subrate_max, uint16_t max_latency,
                                          uint16_t cont_num, uint16_t timeout) override;
   [[nodiscard]] uint16_t L2CA_FlushChannel(uint16_t lcid, uint16_t num_to_flush) override;
+  [[nodiscard]] uint16_t L2CA_GetTxQueueDepth(uint16_t lcid) override;
   [[nodiscard]] bool L2CA_SetTxPriority(uint16_t cid, tL2CAP_CHNL_PRIORITY priority) override;
   [[nodiscard]] bool L2CA_SetChnlFlushability(uint16_t cid, bool is_flushable) override;
 
@@ -103,6 +104,12 @@ public:
   [[nodiscard]] bool L2CA_UpdateBleConnParams(const RawAddress& bd_addr, uint16_t min_int,
                                               uint16_t max_int, uint16_t latency, uint16_t timeout,
                                               uint16_t min_ce_len, uint16_t max_ce_len) override;
+  [[nodiscard]] bool L2CA_SetBleConnDemand(const RawAddress& bd_addr,
+                                           tL2CAP_BLE_CONN_DEMAND demand, uint16_t min_int,
+                                           uint16_t max_int, uint16_t latency, uint16_t timeout,
+                                           uint16_t min_ce_len, uint16_t max_ce_len) override;
+  void L2CA_ClearBleConnDemand(const RawAddress& bd_addr, tL2CAP_BLE_CONN_DEMAND demand) override;
+  [[nodiscard]] bool L2CA_IsBleConnLatencySensitive(const RawAddress& bd_addr) override;
   void L2CA_LockBleConnParamsForServiceDiscovery(const RawAddress& bd_addr, bool lock) override;
   void L2CA_LockBleConnParamsForProfileConnection(const RawAddress& bd_addr, bool lock) override;
   [[nodiscard]] tHCI_ROLE L2CA_GetBleConnRole(const RawAddress& bd_addr) override;
@@ -174,6 +174,9 @@ bool l2cble_conn_comp(uint16_t handle, tHCI_ROLE role, const RawAddress& bda,
   p_lcb->min_interval = p_lcb->max_interval = conn_interval;
   p_lcb->timeout = conn_timeout;
   p_lcb->latency = conn_latency;
+  p_lcb->cur_interval = conn_interval;
+  p_lcb->cur_timeout = conn_timeout;
+  p_lcb->cur_latency = conn_latency;
   p_lcb->conn_update_mask = L2C_BLE_NOT_DEFAULT_PARAM;
   p_lcb->conn_update_blocked_by_profile_connection = false;
   p_lcb->conn_update_blocked_by_service_discovery = false;
@@ -1466,12 +1469,9 @@ void L2CA_SetEcosystemBaseInterval(uint32_t base_interval) {
 
     for (int i = 0; i < MAX_L2CAP_LINKS; i++, p_lcb++) {
       if ((p_lcb->in_use) && p_lcb->transport == BT_TRANSPORT_LE) {
-        bool ret = L2CA_UpdateBleConnParams(p_lcb->remote_bd_addr, p_lcb->min_interval,
-                                            p_lcb->max_interval, p_lcb->latency, p_lcb->timeout,
-                                            p_lcb->min_ce_len, p_lcb->max_ce_len);
-        if (!ret) {
-          log::warn("Unable to update BLE connection parameters peer:{}", p_lcb->remote_bd_addr);
-        }
+        /* Resend the combined demands of the link, without adding one */
+        p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
+        l2cble_start_conn_update(p_lcb);
       }
     }
   }
@@ -27,6 +27,9 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
+#include "common/time_util.h"
 #include "hci/controller_interface.h"
 #include "hci/event_checkers.h"
 #include "hci/hci_interface.h"
@@ -48,50 +51,175 @@ using namespace bluetooth;
 void l2cble_start_conn_update(tL2C_LCB* p_lcb);
 static void l2cble_start_subrate_change(tL2C_LCB* p_lcb);
 
-/*******************************************************************************
- *
- *  Function        L2CA_UpdateBleConnParams
- *
- *  Description     Update BLE connection parameters.
- *
- *  Parameters:     BD Address of remote
- *
- *  Return value:   true if update started
- *
- ******************************************************************************/
-bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int, uint16_t max_int,
-                              uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
-                              uint16_t max_ce_len) {
+static tL2C_LCB* l2cble_find_conn_demand_lcb(const RawAddress& rem_bda) {
   /* See if we have a link control block for the remote device */
   tL2C_LCB* p_lcb = l2cu_find_lcb_by_bd_addr(rem_bda, BT_TRANSPORT_LE);
 
   /* If we do not have one, create one and accept the connection. */
   if (!p_lcb || !get_btm_client_interface().peer.BTM_IsAclConnectionUp(rem_bda, BT_TRANSPORT_LE)) {
     log::warn("- unknown BD_ADDR {}", rem_bda);
-    return false;
+    return nullptr;
   }
 
   if (p_lcb->transport != BT_TRANSPORT_LE) {
     log::warn("- BD_ADDR {} not LE", rem_bda);
-    return false;
+    return nullptr;
+  }
+  return p_lcb;
+}
+
+/* Combines the active demands on the link into its requested parameters.
+ * Returns false if no user of the link has a demand. */
+static bool l2cble_combine_conn_demands(tL2C_LCB* p_lcb) {
+  bool combined = false;
+  for (const tL2C_BLE_CONN_DEMAND_PARAMS& demand : p_lcb->conn_demand) {
+    if (!demand.active) {
+      continue;
+    }
+    if (!combined) {
+      p_lcb->min_interval = demand.min_interval;
+      p_lcb->max_interval = demand.max_interval;
+      p_lcb->latency = demand.latency;
+      p_lcb->timeout = demand.timeout;
+      p_lcb->min_ce_len = demand.min_ce_len;
+      p_lcb->max_ce_len = demand.max_ce_len;
+      combined = true;
+      continue;
+    }
+    p_lcb->min_interval = std::min(p_lcb->min_interval, demand.min_interval);
+    p_lcb->max_interval = std::min(p_lcb->max_interval, demand.max_interval);
+    p_lcb->latency = std::min(p_lcb->latency, demand.latency);
+    p_lcb->timeout = std::max(p_lcb->timeout, demand.timeout);
+    p_lcb->min_ce_len = std::max(p_lcb->min_ce_len, demand.min_ce_len);
+    p_lcb->max_ce_len = std::max(p_lcb->max_ce_len, demand.max_ce_len);
   }
+  return combined;
+}
 
-  log::verbose("BD_ADDR={}, min_int={}, max_int={}, min_ce_len={}, max_ce_len={}", rem_bda, min_int,
-               max_int, min_ce_len, max_ce_len);
+static void l2cble_apply_conn_demands(tL2C_LCB* p_lcb) {
+  if (!l2cble_combine_conn_demands(p_lcb)) {
+    log::verbose("{} no demand left, parameters unchanged", p_lcb->remote_bd_addr);
+    return;
+  }
 
-  p_lcb->min_interval = min_int;
-  p_lcb->max_interval = max_int;
-  p_lcb->latency = latency;
-  p_lcb->timeout = timeout;
+  log::verbose("{} combined min_int={}, max_int={}, latency={}, timeout={}",
+               p_lcb->remote_bd_addr, p_lcb->min_interval, p_lcb->max_interval, p_lcb->latency,
+               p_lcb->timeout);
   p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
-  p_lcb->min_ce_len = min_ce_len;
-  p_lcb->max_ce_len = max_ce_len;
-
   l2cble_start_conn_update(p_lcb);
+}
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_SetBleConnDemand
+ *
+ *  Description     Set the BLE connection parameters needed by one user of
+ *                  the link, and update the link to the combination of all
+ *                  active demands.
+ *
+ *  Parameters:     BD Address of remote, user of the link, parameters
+ *
+ *  Return value:   true if the link is known
+ *
+ ******************************************************************************/
+bool L2CA_SetBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand,
+                           uint16_t min_int, uint16_t max_int, uint16_t latency, uint16_t timeout,
+                           uint16_t min_ce_len, uint16_t max_ce_len) {
+  if (demand >= L2CAP_BLE_CONN_DEMAND_MAX) {
+    log::error("invalid demand {}", static_cast<int>(demand));
+    return false;
+  }
+
+  tL2C_LCB* p_lcb = l2cble_find_conn_demand_lcb(rem_bda);
+  if (!p_lcb) {
+    return false;
+  }
+
+  log::verbose("BD_ADDR={}, demand={}, min_int={}, max_int={}, min_ce_len={}, max_ce_len={}",
+               rem_bda, static_cast<int>(demand), min_int, max_int, min_ce_len, max_ce_len);
+
+  p_lcb->conn_demand[demand] = {
+          .active = true,
+          .min_interval = min_int,
+          .max_interval = max_int,
+          .latency = latency,
+          .timeout = timeout,
+          .min_ce_len = min_ce_len,
+          .max_ce_len = max_ce_len,
+  };
+  l2cble_apply_conn_demands(p_lcb);
 
   return true;
 }
 
+/*******************************************************************************
+ *
+ *  Function        L2CA_ClearBleConnDemand
+ *
+ *  Description     Withdraw the demand of one user of the link. The link is
+ *                  relaxed to the combination of the remaining demands.
+ *
+ *  Parameters:     BD Address of remote, user of the link
+ *
+ *  Return value:   none
+ *
+ ******************************************************************************/
+void L2CA_ClearBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand) {
+  if (demand >= L2CAP_BLE_CONN_DEMAND_MAX) {
+    log::error("invalid demand {}", static_cast<int>(demand));
+    return;
+  }
+
+  tL2C_LCB* p_lcb = l2cble_find_conn_demand_lcb(rem_bda);
+  if (!p_lcb || !p_lcb->conn_demand[demand].active) {
+    return;
+  }
+
+  log::verbose("BD_ADDR={}, demand={}", rem_bda, static_cast<int>(demand));
+  p_lcb->conn_demand[demand] = {};
+  l2cble_apply_conn_demands(p_lcb);
+}
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_IsBleConnLatencySensitive
+ *
+ *  Description     Tell whether audio or HID place a demand on the LE link to
+ *                  the peer.
+ *
+ *  Parameters:     BD Address of remote
+ *
+ *  Return value:   true if a latency sensitive demand is active
+ *
+ ******************************************************************************/
+bool L2CA_IsBleConnLatencySensitive(const RawAddress& rem_bda) {
+  tL2C_LCB* p_lcb = l2cu_find_lcb_by_bd_addr(rem_bda, BT_TRANSPORT_LE);
+  if (!p_lcb) {
+    return false;
+  }
+  return p_lcb->conn_demand[L2CAP_BLE_CONN_DEMAND_AUDIO].active ||
+         p_lcb->conn_demand[L2CAP_BLE_CONN_DEMAND_HID].active;
+}
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_UpdateBleConnParams
+ *
+ *  Description     Update BLE connection parameters for a user of the link
+ *                  that has no demand class of its own.
+ *
+ *  Parameters:     BD Address of remote
+ *
+ *  Return value:   true if update started
+ *
+ ******************************************************************************/
+bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int, uint16_t max_int,
+                              uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
+                              uint16_t max_ce_len) {
+  return L2CA_SetBleConnDemand(rem_bda, L2CAP_BLE_CONN_DEMAND_OTHER, min_int, max_int, latency,
+                               timeout, min_ce_len, max_ce_len);
+}
+
 static bool l2c_enable_update_ble_conn_params(tL2C_LCB* p_lcb, bool enable);
 
 /* When called with lock=true, LE connection parameters will be locked on
@@ -166,6 +294,62 @@ void L2CA_LockBleConnParamsForProfileConnection(const RawAddress& rem_bda, bool
   l2c_enable_update_ble_conn_params(p_lcb, !lock);
 }
 
+static void l2cble_record_conn_decision(tL2C_LCB* p_lcb, uint16_t min_int, uint16_t max_int,
+                                        uint16_t latency, uint16_t timeout,
+                                        tL2C_BLE_CONN_DECISION_OUTCOME outcome) {
+  tL2C_BLE_CONN_DECISION& decision =
+          p_lcb->conn_decision_history[p_lcb->conn_decision_count %
+                                       L2C_BLE_CONN_DECISION_HISTORY_SIZE];
+  decision = {
+          .timestamp_ms = bluetooth::common::time_get_os_boottime_ms(),
+          .min_interval = min_int,
+          .max_interval = max_int,
+          .latency = latency,
+          .timeout = timeout,
+          .outcome = outcome,
+  };
+  p_lcb->conn_decision_count++;
+}
+
+/* Returns true if the link already runs with parameters that satisfy the
+ * requested ones, so that an update would not change anything */
+static bool l2cble_conn_params_in_use(const tL2C_LCB* p_lcb) {
+  return p_lcb->cur_interval != 0 && p_lcb->cur_interval >= p_lcb->min_interval &&
+         p_lcb->cur_interval <= p_lcb->max_interval && p_lcb->cur_latency == p_lcb->latency &&
+         p_lcb->cur_timeout == p_lcb->timeout;
+}
+
+static void l2cble_conn_update_timer_timeout(void* data) {
+  tL2C_LCB* p_lcb = (tL2C_LCB*)data;
+  log::verbose("{} decision window ended", p_lcb->remote_bd_addr);
+  l2cble_start_conn_update(p_lcb);
+}
+
+/* Returns true if the pending update has to wait for the end of the current
+ * decision window. The window timer is armed in that case. Updates that
+ * tighten the parameters in use are never held back. */
+static bool l2cble_defer_conn_update(tL2C_LCB* p_lcb) {
+  /* Tighter parameters are needed now, only relaxing waits for the window */
+  if (p_lcb->cur_interval != 0 &&
+      (p_lcb->max_interval < p_lcb->cur_interval || p_lcb->latency < p_lcb->cur_latency)) {
+    return false;
+  }
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (p_lcb->last_conn_update_ms == 0 ||
+      now_ms - p_lcb->last_conn_update_ms >= L2CAP_BLE_CONN_UPDATE_WINDOW_MS) {
+    return false;
+  }
+
+  if (p_lcb->conn_update_timer == NULL) {
+    p_lcb->conn_update_timer = alarm_new("l2c_lcb.conn_update_timer");
+  }
+  alarm_set_on_mloop(p_lcb->conn_update_timer,
+                     p_lcb->last_conn_update_ms + L2CAP_BLE_CONN_UPDATE_WINDOW_MS - now_ms,
+                     l2cble_conn_update_timer_timeout, p_lcb);
+  return true;
+}
+
 static bool l2c_enable_update_ble_conn_params(tL2C_LCB* p_lcb, bool enable) {
   log::debug("{} enable {} current upd state 0x{:02x}", p_lcb->remote_bd_addr, enable,
              p_lcb->conn_update_mask);
@@ -190,6 +374,11 @@ static bool l2c_enable_update_ble_conn_params(tL2C_LCB* p_lcb, bool enable) {
  *  Description     Start the BLE connection parameter update process based on
  *                  status.
  *
+ *                  The locks for service discovery and profile connection
+ *                  win, otherwise the combined demands of the users of the
+ *                  link are used. Relaxing updates are sent at most once per
+ *                  link per decision window.
+ *
  *  Parameters:     lcb : l2cap link control block
  *
  *  Return value:   none
@@ -239,12 +428,36 @@ void l2cble_start_conn_update(tL2C_LCB* p_lcb) {
         l2cu_send_peer_ble_par_req(p_lcb, min_conn_int, max_conn_int, peripheral_latency,
                                    supervision_tout);
       }
+      /* Locking to fast parameters is never delayed, but it starts a new
+       * decision window so that relaxing them again is not immediate. */
+      p_lcb->last_conn_update_ms = bluetooth::common::time_get_os_boottime_ms();
+      l2cble_record_conn_decision(p_lcb, min_conn_int, max_conn_int, peripheral_latency,
+                                  supervision_tout, L2C_BLE_CONN_DECISION_SENT);
       p_lcb->conn_update_mask &= ~L2C_BLE_NOT_DEFAULT_PARAM;
       p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
     }
   } else {
     /* application allows to do update, if we were delaying one do it now */
     if (p_lcb->conn_update_mask & L2C_BLE_NEW_CONN_PARAM) {
+      if (l2cble_conn_params_in_use(p_lcb)) {
+        log::verbose("{} already uses requested parameters", p_lcb->remote_bd_addr);
+        l2cble_record_conn_decision(p_lcb, p_lcb->min_interval, p_lcb->max_interval,
+                                    p_lcb->latency, p_lcb->timeout,
+                                    L2C_BLE_CONN_DECISION_UNCHANGED);
+        p_lcb->conn_update_mask &= ~L2C_BLE_NEW_CONN_PARAM;
+        p_lcb->conn_update_mask |= L2C_BLE_NOT_DEFAULT_PARAM;
+        return;
+      }
+
+      if (l2cble_defer_conn_update(p_lcb)) {
+        log::verbose("{} update deferred to the end of the decision window",
+                     p_lcb->remote_bd_addr);
+        l2cble_record_conn_decision(p_lcb, p_lcb->min_interval, p_lcb->max_interval,
+                                    p_lcb->latency, p_lcb->timeout,
+                                    L2C_BLE_CONN_DECISION_DEFERRED);
+        return;
+      }
+
       /* if both side 4.1, or we are central device, send HCI command */
       if (p_lcb->IsLinkRoleCentral() ||
           (bluetooth::shim::GetController()->SupportsBleConnectionParametersRequest() &&
@@ -257,6 +470,9 @@ void l2cble_start_conn_update(tL2C_LCB* p_lcb) {
         l2cu_send_peer_ble_par_req(p_lcb, p_lcb->min_interval, p_lcb->max_interval, p_lcb->latency,
                                    p_lcb->timeout);
       }
+      p_lcb->last_conn_update_ms = bluetooth::common::time_get_os_boottime_ms();
+      l2cble_record_conn_decision(p_lcb, p_lcb->min_interval, p_lcb->max_interval, p_lcb->latency,
+                                  p_lcb->timeout, L2C_BLE_CONN_DECISION_SENT);
       p_lcb->conn_update_mask &= ~L2C_BLE_NEW_CONN_PARAM;
       p_lcb->conn_update_mask |= L2C_BLE_NOT_DEFAULT_PARAM;
     }
@@ -274,8 +490,8 @@ void l2cble_start_conn_update(tL2C_LCB* p_lcb) {
  * Returns          void
  *
  ******************************************************************************/
-void l2cble_process_conn_update_evt(uint16_t handle, uint8_t status, uint16_t /* interval */,
-                                    uint16_t /* latency */, uint16_t /* timeout */) {
+void l2cble_process_conn_update_evt(uint16_t handle, uint8_t status, uint16_t interval,
+                                    uint16_t latency, uint16_t timeout) {
   log::verbose("");
 
   /* See if we have a link control block for the remote device */
@@ -289,6 +505,10 @@ void l2cble_process_conn_update_evt(uint16_t handle, uint8_t status, uint16_t /*
 
   if (status != HCI_SUCCESS) {
     log::warn("Error status: {}", status);
+  } else {
+    p_lcb->cur_interval = interval;
+    p_lcb->cur_latency = latency;
+    p_lcb->cur_timeout = timeout;
   }
 
   l2cble_start_conn_update(p_lcb);
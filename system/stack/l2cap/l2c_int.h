@@ -66,6 +66,7 @@ constexpr uint16_t L2CAP_CREDIT_BASED_MIN_MPS = 64;
 #define L2CAP_WAIT_INFO_RSP_TIMEOUT_MS (3 * 1000)      /* 3 seconds */
 #define L2CAP_BLE_LINK_CONNECT_TIMEOUT_MS (30 * 1000)  /* 30 seconds */
 #define L2CAP_FCR_ACK_TIMEOUT_MS 200                   /* 200 milliseconds */
+#define L2CAP_BLE_CONN_UPDATE_WINDOW_MS (1 * 1000)     /* 1 second */
 
 /* Define the possible L2CAP channel states. The names of
  * the states may seem a bit strange, but they are taken from
@@ -392,6 +393,38 @@ enum tCONN_UPDATE_MASK : uint8_t {
   L2C_BLE_NOT_DEFAULT_PARAM = (1u << 3),
 };
 
+/* Outcome of an LE connection parameter update decision */
+enum tL2C_BLE_CONN_DECISION_OUTCOME : uint8_t {
+  /* update sent to the controller or to the peer */
+  L2C_BLE_CONN_DECISION_SENT,
+  /* link already uses matching parameters, nothing sent */
+  L2C_BLE_CONN_DECISION_UNCHANGED,
+  /* held back until the end of the current decision window */
+  L2C_BLE_CONN_DECISION_DEFERRED,
+};
+
+struct tL2C_BLE_CONN_DECISION {
+  uint64_t timestamp_ms;
+  uint16_t min_interval;
+  uint16_t max_interval;
+  uint16_t latency;
+  uint16_t timeout;
+  tL2C_BLE_CONN_DECISION_OUTCOME outcome;
+};
+
+#define L2C_BLE_CONN_DECISION_HISTORY_SIZE 8
+
+/* Connection parameters needed by one user of an LE link */
+struct tL2C_BLE_CONN_DEMAND_PARAMS {
+  bool active;
+  uint16_t min_interval;
+  uint16_t max_interval;
+  uint16_t latency;
+  uint16_t timeout;
+  uint16_t min_ce_len;
+  uint16_t max_ce_len;
+};
+
 /* Define a link control block. There is one link control block between
  * this device and any other device (i.e. BD ADDR).
  */
@@ -511,6 +544,9 @@ public:
   bool conn_update_blocked_by_service_discovery;
   bool conn_update_blocked_by_profile_connection;
 
+  /* demands of the users of the link, indexed by tL2CAP_BLE_CONN_DEMAND */
+  tL2C_BLE_CONN_DEMAND_PARAMS conn_demand[L2CAP_BLE_CONN_DEMAND_MAX];
+
   uint16_t min_interval; /* parameters as requested by peripheral */
   uint16_t max_interval;
   uint16_t latency;
@@ -518,6 +554,18 @@ public:
   uint16_t min_ce_len;
   uint16_t max_ce_len;
 
+  /* parameters currently in use on the link */
+  uint16_t cur_interval;
+  uint16_t cur_latency;
+  uint16_t cur_timeout;
+
+  /* At most one parameter update is sent per decision window. Requests
+   * arriving within the window only replace the pending parameters. */
+  alarm_t* conn_update_timer;
+  uint64_t last_conn_update_ms;
+  tL2C_BLE_CONN_DECISION conn_decision_history[L2C_BLE_CONN_DECISION_HISTORY_SIZE];
+  uint32_t conn_decision_count;
+
 #define L2C_BLE_SUBRATE_REQ_DISABLE 0x1  // disable subrate req
 #define L2C_BLE_NEW_SUBRATE_PARAM 0x2    // new subrate req parameter to be set
 #define L2C_BLE_SUBRATE_REQ_PENDING 0x4  // waiting for subrate to be completed
@@ -75,6 +75,7 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding, tBT_TR
     if (!p_lcb->in_use) {
       alarm_free(p_lcb->l2c_lcb_timer);
       alarm_free(p_lcb->info_resp_timer);
+      alarm_free(p_lcb->conn_update_timer);
       *p_lcb = {};
 
       p_lcb->remote_bd_addr = p_bd_addr;
@@ -163,6 +164,8 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   p_lcb->l2c_lcb_timer = NULL;
   alarm_free(p_lcb->info_resp_timer);
   p_lcb->info_resp_timer = NULL;
+  alarm_free(p_lcb->conn_update_timer);
+  p_lcb->conn_update_timer = NULL;
 
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) { /* Release all SCO links */
     get_btm_client_interface().sco.BTM_RemoveScoByBdaddr(p_lcb->remote_bd_addr);
@@ -126,6 +126,10 @@ void bluetooth::stack::l2cap::Impl::L2CA_DeregisterLECoc(uint16_t psm) {
   return ::L2CA_FlushChannel(lcid, num_to_flush);
 }
 
+[[nodiscard]] uint16_t bluetooth::stack::l2cap::Impl::L2CA_GetTxQueueDepth(uint16_t lcid) {
+  return ::L2CA_GetTxQueueDepth(lcid);
+}
+
 [[nodiscard]] bool bluetooth::stack::l2cap::Impl::L2CA_UseLatencyMode(const RawAddress& bd_addr,
                                                                       bool use_latency_mode) {
   return ::L2CA_UseLatencyMode(bd_addr, use_latency_mode);
@@ -194,6 +198,24 @@ void bluetooth::stack::l2cap::Impl::L2CA_DeregisterLECoc(uint16_t psm) {
                                     max_ce_len);
 }
 
+[[nodiscard]] bool bluetooth::stack::l2cap::Impl::L2CA_SetBleConnDemand(
+        const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand, uint16_t min_int,
+        uint16_t max_int, uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
+        uint16_t max_ce_len) {
+  return ::L2CA_SetBleConnDemand(rem_bda, demand, min_int, max_int, latency, timeout, min_ce_len,
+                                 max_ce_len);
+}
+
+void bluetooth::stack::l2cap::Impl::L2CA_ClearBleConnDemand(const RawAddress& rem_bda,
+                                                             tL2CAP_BLE_CONN_DEMAND demand) {
+  ::L2CA_ClearBleConnDemand(rem_bda, demand);
+}
+
+[[nodiscard]] bool bluetooth::stack::l2cap::Impl::L2CA_IsBleConnLatencySensitive(
+        const RawAddress& rem_bda) {
+  return ::L2CA_IsBleConnLatencySensitive(rem_bda);
+}
+
 void bluetooth::stack::l2cap::Impl::L2CA_LockBleConnParamsForServiceDiscovery(
         const RawAddress& rem_bda, bool lock) {
   ::L2CA_LockBleConnParamsForServiceDiscovery(rem_bda, lock);
@@ -41,6 +41,18 @@ bool SDP_InitDiscoveryDb(tSDP_DISCOVERY_DB* p_db, uint32_t len, uint16_t num_uui
                          const bluetooth::Uuid* p_uuid_list, uint16_t num_attr,
                          const uint16_t* p_attr_list);
 
+/*******************************************************************************
+ *
+ * Function         SDP_FreeDiscoveryDb
+ *
+ * Description      This function releases the overflow memory of a growable
+ *                  discovery database.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_FreeDiscoveryDb(tSDP_DISCOVERY_DB* p_db);
+
 /*******************************************************************************
  *
  * Function         SDP_CancelServiceSearch
@@ -35,6 +35,7 @@
 
 #include "internal_include/bt_target.h"
 #include "main/shim/dumpsys.h"
+#include "osi/include/allocator.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/bt_uuid16.h"
 #include "stack/include/sdpdefs.h"
@@ -110,6 +111,36 @@ bool SDP_InitDiscoveryDb(tSDP_DISCOVERY_DB* p_db, uint32_t len, uint16_t num_uui
   return true;
 }
 
+/*******************************************************************************
+ *
+ * Function         SDP_FreeDiscoveryDb
+ *
+ * Description      This function releases the overflow memory chained to a
+ *                  growable discovery database. The records of the database
+ *                  are no longer valid afterwards. It must be called before
+ *                  the memory of a growable database is reused or freed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_FreeDiscoveryDb(tSDP_DISCOVERY_DB* p_db) {
+  if (p_db == NULL) {
+    return;
+  }
+
+  while (p_db->p_chunks != NULL) {
+    tSDP_DISC_CHUNK* p_chunk = p_db->p_chunks;
+    p_db->p_chunks = p_chunk->p_next;
+    p_db->mem_size -= p_chunk->size;
+    osi_free(p_chunk);
+  }
+
+  p_db->p_first_rec = NULL;
+  p_db->p_free_mem = NULL;
+  p_db->mem_free = 0;
+  p_db->mem_grown = 0;
+}
+
 /*******************************************************************************
  *
  * Function         SDP_CancelServiceSearch
@@ -1071,6 +1102,7 @@ bluetooth::legacy::stack::sdp::tSdpApi api_ = {
                         .SDP_ServiceSearchRequest = ::SDP_ServiceSearchRequest,
                         .SDP_ServiceSearchAttributeRequest = ::SDP_ServiceSearchAttributeRequest,
                         .SDP_ServiceSearchAttributeRequest2 = ::SDP_ServiceSearchAttributeRequest2,
+                        .SDP_FreeDiscoveryDb = ::SDP_FreeDiscoveryDb,
                 },
         .db =
                 {
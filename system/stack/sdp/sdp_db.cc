@@ -28,7 +28,10 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <set>
+#include <vector>
 
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
@@ -39,25 +42,59 @@
 #include "stack/sdp/sdpint.h"
 
 using namespace bluetooth;
+using bluetooth::Uuid;
+
+static bool sdp_add_attribute_to_record(tSDP_RECORD* p_rec, uint16_t attr_id, uint8_t attr_type,
+                                        uint32_t attr_len, uint8_t* p_val);
+static bool sdp_delete_attribute_from_record(tSDP_RECORD* p_rec, uint16_t attr_id);
 
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         sdp_db_uuid_from_array
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Description      This function converts a BE UUID of 2, 4 or 16 bytes to its
+ *                  128-bit form.
  *
- * Returns          true if found, else false
+ * Returns          true if the length is valid, else false
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len, const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static bool sdp_db_uuid_from_array(const uint8_t* p_uuid, uint32_t uuid_len, Uuid* p_out) {
+  switch (uuid_len) {
+    case Uuid::kNumBytes16:
+      *p_out = Uuid::From16Bit((p_uuid[0] << 8) | p_uuid[1]);
+      return true;
+    case Uuid::kNumBytes32:
+      *p_out = Uuid::From32Bit(((uint32_t)p_uuid[0] << 24) | ((uint32_t)p_uuid[1] << 16) |
+                               ((uint32_t)p_uuid[2] << 8) | p_uuid[3]);
+      return true;
+    case Uuid::kNumBytes128:
+      *p_out = Uuid::From128BitBE(p_uuid);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         collect_uuids_in_seq
+ *
+ * Description      This function collects the UUIDs of a data element
+ *                  sequence, descending into nested sequences.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void collect_uuids_in_seq(uint8_t* p, uint32_t seq_len, int nest_level,
+                                 std::vector<Uuid>* p_uuids) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
+  Uuid uuid;
 
   /* A little safety check to avoid excessive recursion */
   if (nest_level > 3) {
-    return false;
+    return;
   }
 
   while (p < p_end) {
@@ -69,19 +106,117 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len, const uint8_t* p_uuid
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) {
-        return true;
+      if (sdp_db_uuid_from_array(p, len, &uuid)) {
+        p_uuids->push_back(uuid);
       }
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1)) {
-        return true;
-      }
+      collect_uuids_in_seq(p, len, nest_level + 1, p_uuids);
     }
     p = p + len;
   }
+}
 
-  /* If here, failed to match */
-  return false;
+/*******************************************************************************
+ *
+ * Function         sdp_db_is_server_record
+ *
+ * Description      This function checks whether a record belongs to the server
+ *                  database, as opposed to a standalone record.
+ *
+ * Returns          true if the record is part of the database
+ *
+ ******************************************************************************/
+static bool sdp_db_is_server_record(const tSDP_RECORD* p_rec) {
+  return p_rec >= &sdp_cb.server_db.record[0] &&
+         p_rec < &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_index_remove_record
+ *
+ * Description      This function removes a record handle from the UUID index
+ *                  and drops its cached attribute list length.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_index_remove_record(uint32_t handle) {
+  tSDP_DB_INDEX& index = sdp_cb.server_db.index;
+
+  auto it = index.handle_to_uuids.find(handle);
+  if (it != index.handle_to_uuids.end()) {
+    for (const Uuid& uuid : it->second) {
+      auto handles = index.uuid_to_handles.find(uuid);
+      if (handles == index.uuid_to_handles.end()) {
+        continue;
+      }
+      handles->second.erase(handle);
+      if (handles->second.empty()) {
+        index.uuid_to_handles.erase(handles);
+      }
+    }
+    index.handle_to_uuids.erase(it);
+  }
+  index.all_attr_list_len.erase(handle);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_index_record
+ *
+ * Description      This function (re)builds the index entries of a record
+ *                  after its attributes changed. Matching UUIDs follows the
+ *                  rules of the service search: UUID attributes and UUIDs
+ *                  nested in data element sequences.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_index_record(const tSDP_RECORD* p_rec) {
+  if (!sdp_db_is_server_record(p_rec)) {
+    return;
+  }
+
+  tSDP_DB_INDEX& index = sdp_cb.server_db.index;
+  sdp_db_index_remove_record(p_rec->record_handle);
+
+  std::vector<Uuid> uuids;
+  Uuid uuid;
+  const tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
+  for (uint16_t xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
+    if (p_attr->type == UUID_DESC_TYPE) {
+      if (sdp_db_uuid_from_array(p_attr->value_ptr, p_attr->len, &uuid)) {
+        uuids.push_back(uuid);
+      }
+    } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
+      collect_uuids_in_seq(p_attr->value_ptr, p_attr->len, 0, &uuids);
+    }
+  }
+
+  for (const Uuid& found : uuids) {
+    index.uuid_to_handles[found].insert(p_rec->record_handle);
+  }
+  index.handle_to_uuids[p_rec->record_handle] = std::move(uuids);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_index_positions
+ *
+ * Description      This function refreshes the handle to record position map
+ *                  after records were moved in the database.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_index_positions() {
+  tSDP_DB_INDEX& index = sdp_cb.server_db.index;
+
+  index.handle_to_index.clear();
+  for (uint16_t xx = 0; xx < sdp_cb.server_db.num_records; xx++) {
+    index.handle_to_index[sdp_cb.server_db.record[xx].record_handle] = xx;
+  }
 }
 
 /*******************************************************************************
@@ -96,46 +231,42 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len, const uint8_t* p_uuid
  *
  ******************************************************************************/
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec, const tSDP_UUID_SEQ* p_seq) {
-  uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+  const tSDP_DB_INDEX& index = sdp_cb.server_db.index;
+  /* Records are kept in ascending handle order, so the next record is the
+   * first matching one with a greater handle */
+  uint32_t prev_handle = p_rec ? p_rec->record_handle : 0;
+
+  if (p_seq->num_uids == 0) {
+    /* Every record matches an empty sequence */
+    uint16_t next = p_rec ? (uint16_t)(p_rec - &sdp_cb.server_db.record[0] + 1) : 0;
+    return next < sdp_cb.server_db.num_records ? &sdp_cb.server_db.record[next] : NULL;
+  }
 
-  /* If NULL, start at the beginning, else start at the first specified record
-   */
-  if (!p_rec) {
-    p_rec = &sdp_cb.server_db.record[0];
-  } else {
-    p_rec++;
-  }
-
-  /* Look through the records. The spec says that a match occurs if */
-  /* the record contains all the passed UUIDs in it.                */
-  for (; p_rec < p_end; p_rec++) {
-    for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len)) {
-            break;
-          }
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len, &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0)) {
-            break;
-          }
-        }
-      }
-      /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) {
-        break;
-      }
+  /* The spec says that a match occurs if the record contains all the passed
+   * UUIDs in it. Walk the smallest handle set and check the others. */
+  std::vector<const std::set<uint32_t>*> handle_sets;
+  handle_sets.reserve(p_seq->num_uids);
+  for (uint16_t yy = 0; yy < p_seq->num_uids; yy++) {
+    Uuid uuid;
+    if (!sdp_db_uuid_from_array(p_seq->uuid_entry[yy].value, p_seq->uuid_entry[yy].len, &uuid)) {
+      log::error("invalid length");
+      return NULL;
     }
-
-    /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) {
-      return p_rec;
+    auto it = index.uuid_to_handles.find(uuid);
+    if (it == index.uuid_to_handles.end()) {
+      return NULL;
+    }
+    handle_sets.push_back(&it->second);
+  }
+  std::sort(handle_sets.begin(), handle_sets.end(),
+            [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+  const std::set<uint32_t>& candidates = *handle_sets.front();
+  for (auto it = candidates.upper_bound(prev_handle); it != candidates.end(); ++it) {
+    bool all_found = std::all_of(handle_sets.begin() + 1, handle_sets.end(),
+                                 [&it](const auto* handles) { return handles->count(*it) != 0; });
+    if (all_found) {
+      return sdp_db_find_record(*it);
     }
   }
 
@@ -154,18 +285,56 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec, const tSDP_UU
  *
  ******************************************************************************/
 tSDP_RECORD* sdp_db_find_record(uint32_t handle) {
-  tSDP_RECORD* p_rec;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+  const tSDP_DB_INDEX& index = sdp_cb.server_db.index;
 
-  /* Look through the records for the caller's handle */
-  for (p_rec = &sdp_cb.server_db.record[0]; p_rec < p_end; p_rec++) {
-    if (p_rec->record_handle == handle) {
-      return p_rec;
-    }
+  auto it = index.handle_to_index.find(handle);
+  if (it == index.handle_to_index.end() || it->second >= sdp_cb.server_db.num_records) {
+    /* Record with that handle not found. */
+    return NULL;
   }
+  return &sdp_cb.server_db.record[it->second];
+}
 
-  /* Record with that handle not found. */
-  return NULL;
+/*******************************************************************************
+ *
+ * Function         sdp_db_get_all_attr_list_len
+ *
+ * Description      This function returns the cached length of the attribute
+ *                  list holding every attribute of a database record.
+ *
+ * Returns          true if a cached length is available, else false
+ *
+ ******************************************************************************/
+bool sdp_db_get_all_attr_list_len(const tSDP_RECORD* p_rec, uint16_t* p_len) {
+  if (!sdp_db_is_server_record(p_rec)) {
+    return false;
+  }
+
+  const tSDP_DB_INDEX& index = sdp_cb.server_db.index;
+  auto it = index.all_attr_list_len.find(p_rec->record_handle);
+  if (it == index.all_attr_list_len.end()) {
+    return false;
+  }
+  *p_len = it->second;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_set_all_attr_list_len
+ *
+ * Description      This function caches the length of the attribute list
+ *                  holding every attribute of a database record. The cache is
+ *                  invalidated whenever the record changes.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_db_set_all_attr_list_len(const tSDP_RECORD* p_rec, uint16_t len) {
+  if (!sdp_db_is_server_record(p_rec)) {
+    return;
+  }
+  sdp_cb.server_db.index.all_attr_list_len[p_rec->record_handle] = len;
 }
 
 /*******************************************************************************
@@ -263,9 +432,6 @@ static int sdp_compose_proto_list(uint8_t* p, uint16_t num_elem, tSDP_PROTOCOL_E
  ******************************************************************************/
 bool SDP_AddAttribute(uint32_t handle, uint16_t attr_id, uint8_t attr_type, uint32_t attr_len,
                       uint8_t* p_val) {
-  uint16_t zz;
-  tSDP_RECORD* p_rec = &sdp_cb.server_db.record[0];
-
   if (p_val == nullptr) {
     log::warn("Trying to add attribute with p_val == nullptr, skipped");
     return false;
@@ -307,19 +473,19 @@ bool SDP_AddAttribute(uint32_t handle, uint16_t attr_id, uint8_t attr_type, uint
   }
 
   /* Find the record in the database */
-  for (zz = 0; zz < sdp_cb.server_db.num_records; zz++, p_rec++) {
-    if (p_rec->record_handle == handle) {
-      // error out early, no need to look up
-      if (p_rec->free_pad_ptr >= SDP_MAX_PAD_LEN) {
-        log::error("the free pad for SDP record with handle {} is full, skip adding the attribute",
-                   handle);
-        return false;
-      }
+  tSDP_RECORD* p_rec = sdp_db_find_record(handle);
+  if (p_rec == NULL) {
+    return false;
+  }
 
-      return SDP_AddAttributeToRecord(p_rec, attr_id, attr_type, attr_len, p_val);
-    }
+  // error out early, no need to look up
+  if (p_rec->free_pad_ptr >= SDP_MAX_PAD_LEN) {
+    log::error("the free pad for SDP record with handle {} is full, skip adding the attribute",
+               handle);
+    return false;
   }
-  return false;
+
+  return SDP_AddAttributeToRecord(p_rec, attr_id, attr_type, attr_len, p_val);
 }
 
 /*******************************************************************************
@@ -352,6 +518,7 @@ uint32_t SDP_CreateRecord(void) {
     }
 
     p_db->record[p_db->num_records].record_handle = handle;
+    p_db->index.handle_to_index[handle] = p_db->num_records;
 
     p_db->num_records++;
     log::verbose("SDP_CreateRecord ok, num_records:{}", p_db->num_records);
@@ -390,6 +557,8 @@ bool SDP_DeleteRecord(uint32_t handle) {
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
 
+    sdp_cb.server_db.index = {};
+
     return true;
   } else {
     /* Find the record in the database */
@@ -407,6 +576,9 @@ bool SDP_DeleteRecord(uint32_t handle) {
 
         sdp_cb.server_db.num_records--;
 
+        sdp_db_index_remove_record(handle);
+        sdp_db_index_positions();
+
         log::verbose("SDP_DeleteRecord ok, num_records:{}", sdp_cb.server_db.num_records);
         /* if we're deleting the primary DI record, clear the */
         /* value in the control block */
@@ -437,6 +609,13 @@ bool SDP_DeleteRecord(uint32_t handle) {
  ******************************************************************************/
 bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id, uint8_t attr_type,
                               uint32_t attr_len, uint8_t* p_val) {
+  bool result = sdp_add_attribute_to_record(p_rec, attr_id, attr_type, attr_len, p_val);
+  sdp_db_index_record(p_rec);
+  return result;
+}
+
+static bool sdp_add_attribute_to_record(tSDP_RECORD* p_rec, uint16_t attr_id, uint8_t attr_type,
+                                        uint32_t attr_len, uint8_t* p_val) {
   uint16_t xx, yy;
   tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
 
@@ -444,7 +623,7 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id, uint8_t attr
   for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
     /* The attribute exists. replace it */
     if (p_attr->id == attr_id) {
-      SDP_DeleteAttributeFromRecord(p_rec, attr_id);
+      sdp_delete_attribute_from_record(p_rec, attr_id);
       break;
     }
     if (p_attr->id > attr_id) {
@@ -837,6 +1016,14 @@ bool SDP_AddServiceClassIdList(uint32_t handle, uint16_t num_services, uint16_t*
  ******************************************************************************/
 
 bool SDP_DeleteAttributeFromRecord(tSDP_RECORD* p_rec, uint16_t attr_id) {
+  bool result = sdp_delete_attribute_from_record(p_rec, attr_id);
+  if (result) {
+    sdp_db_index_record(p_rec);
+  }
+  return result;
+}
+
+static bool sdp_delete_attribute_from_record(tSDP_RECORD* p_rec, uint16_t attr_id) {
   tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
   uint8_t* pad_ptr;
   uint32_t len; /* Number of bytes in the entry */
@@ -27,6 +27,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "internal_include/bt_target.h"
@@ -191,53 +192,62 @@ static void sdp_snd_service_search_req(tCONN_CB* p_ccb, uint8_t cont_len, uint8_
  *
  * Function         sdp_copy_raw_data
  *
- * Description      copy the raw data
+ * Description      Append raw response data to the raw_data buffer of the
+ *                  DB, if the client provided one. Data that does not fit is
+ *                  dropped.
  *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_copy_raw_data(tSDP_DISCOVERY_DB* p_db, const uint8_t* p, uint32_t len) {
+  if (p_db == NULL || p_db->raw_data == NULL) {
+    return;
+  }
+
+  uint32_t cpy_len = p_db->raw_size - p_db->raw_used;
+  if (len < cpy_len) {
+    cpy_len = len;
+  }
+  memcpy(&p_db->raw_data[p_db->raw_used], p, cpy_len);
+  p_db->raw_used += cpy_len;
+}
+
+/*******************************************************************************
  *
- * Returns          bool
- *                          true if successful
- *                          false if not copied
+ * Function         sdp_db_reserve
+ *
+ * Description      This function makes sure the DB has at least len contiguous
+ *                  bytes available at p_free_mem. A growable DB chains a new
+ *                  overflow chunk when its current pool is exhausted; the rest
+ *                  of the exhausted pool is left unused.
+ *
+ * Returns          true if the space is available, false if the DB is full
  *
  ******************************************************************************/
-static bool sdp_copy_raw_data(tCONN_CB* p_ccb, bool offset) {
-  unsigned int cpy_len, rem_len;
-  uint32_t list_len;
-  uint8_t* p;
-  uint8_t* p_end;
-  uint8_t type;
+static bool sdp_db_reserve(tSDP_DISCOVERY_DB* p_db, uint32_t len) {
+  if (p_db->mem_free >= len) {
+    return true;
+  }
 
-  if (p_ccb->p_db && p_ccb->p_db->raw_data) {
-    cpy_len = p_ccb->p_db->raw_size - p_ccb->p_db->raw_used;
-    list_len = p_ccb->list_len;
-    p = &p_ccb->rsp_list[0];
-    p_end = &p_ccb->rsp_list[0] + list_len;
-
-    if (offset) {
-      cpy_len -= 1;
-      type = *p++;
-      uint8_t* old_p = p;
-      p = sdpu_get_len_from_type(p, p_end, type, &list_len);
-      if (p == NULL || (p + list_len) > p_end) {
-        log::warn("bad length");
-        return false;
-      }
-      if ((int)cpy_len < (p - old_p)) {
-        log::warn("no bytes left for data");
-        return false;
-      }
-      cpy_len -= (p - old_p);
-    }
-    if (list_len < cpy_len) {
-      cpy_len = list_len;
-    }
-    rem_len = SDP_MAX_LIST_BYTE_COUNT - (unsigned int)(p - &p_ccb->rsp_list[0]);
-    if (cpy_len > rem_len) {
-      log::warn("rem_len :{} less than cpy_len:{}", rem_len, cpy_len);
-      cpy_len = rem_len;
-    }
-    memcpy(&p_ccb->p_db->raw_data[p_ccb->p_db->raw_used], p, cpy_len);
-    p_ccb->p_db->raw_used += cpy_len;
+  if (p_db->chunk_size == 0) {
+    return false;
   }
+
+  const uint32_t size = std::max(p_db->chunk_size, len);
+  if (p_db->mem_grown + size > SDP_MAX_DISC_DB_GROWTH) {
+    log::warn("SDP - DB growth limit reached, grown:{} requested:{}", p_db->mem_grown, size);
+    return false;
+  }
+
+  tSDP_DISC_CHUNK* p_chunk = (tSDP_DISC_CHUNK*)osi_malloc(sizeof(tSDP_DISC_CHUNK) + size);
+  p_chunk->p_next = p_db->p_chunks;
+  p_chunk->size = size;
+
+  p_db->p_chunks = p_chunk;
+  p_db->mem_grown += size;
+  p_db->mem_size += size;
+  p_db->p_free_mem = (uint8_t*)(p_chunk + 1);
+  p_db->mem_free = size;
   return true;
 }
 
@@ -254,7 +264,7 @@ tSDP_DISC_REC* add_record(tSDP_DISCOVERY_DB* p_db, const RawAddress& bd_addr) {
   tSDP_DISC_REC* p_rec;
 
   /* See if there is enough space in the database */
-  if (p_db->mem_free < sizeof(tSDP_DISC_REC)) {
+  if (!sdp_db_reserve(p_db, sizeof(tSDP_DISC_REC))) {
     return NULL;
   }
 
@@ -333,7 +343,7 @@ static uint8_t* add_attr(uint8_t* p, uint8_t* p_end, tSDP_DISCOVERY_DB* p_db, tS
   total_len = (total_len + 3) & ~3;
 
   /* See if there is enough space in the database */
-  if (p_db->mem_free < total_len) {
+  if (!sdp_db_reserve(p_db, total_len)) {
     return NULL;
   }
 
@@ -573,6 +583,70 @@ static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end) {
   return p;
 }
 
+/*******************************************************************************
+ *
+ * Function         save_search_attr_lists
+ *
+ * Description      This function saves the attribute lists of a service search
+ *                  attribute response as soon as they are complete in the
+ *                  scratchpad, so that every continuation fragment is decoded
+ *                  when it arrives. Only the incomplete tail of the response
+ *                  is kept in the scratchpad.
+ *
+ * Returns          SDP_SUCCESS, or the status to disconnect with
+ *
+ ******************************************************************************/
+static tSDP_STATUS save_search_attr_lists(tCONN_CB* p_ccb) {
+  uint8_t* p = &p_ccb->rsp_list[0];
+  uint8_t* p_end = &p_ccb->rsp_list[p_ccb->list_len];
+  uint8_t type;
+  uint32_t len;
+
+  /* The contents is a sequence of attribute sequences, skip its header */
+  if (!p_ccb->rsp_seq_started) {
+    if (p == p_end) {
+      return tSDP_STATUS::SDP_SUCCESS;
+    }
+    type = *p++;
+    if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
+      return tSDP_STATUS::SDP_ILLEGAL_PARAMETER;
+    }
+    p = sdpu_get_len_from_type(p, p_end, type, &len);
+    if (p == NULL) {
+      /* Wait for the rest of the header */
+      return tSDP_STATUS::SDP_SUCCESS;
+    }
+    p_ccb->rsp_seq_started = true;
+    p_ccb->rsp_seq_left = len;
+  }
+
+  while (p < p_end) {
+    uint8_t* p_list = p;
+    type = *p_list++;
+    p_list = sdpu_get_len_from_type(p_list, p_end, type, &len);
+    if (p_list == NULL || (p_list + len) > p_end) {
+      /* Attribute list continues in the next fragment */
+      break;
+    }
+
+    const uint32_t list_size = (uint32_t)(p_list + len - p);
+    if (list_size > p_ccb->rsp_seq_left) {
+      return tSDP_STATUS::SDP_INVALID_CONT_STATE;
+    }
+
+    sdp_copy_raw_data(p_ccb->p_db, p, list_size);
+    p = save_attr_seq(p_ccb, p, p_list + len);
+    if (!p) {
+      return tSDP_STATUS::SDP_DB_FULL;
+    }
+    p_ccb->rsp_seq_left -= list_size;
+  }
+
+  p_ccb->list_len = (uint16_t)(p_end - p);
+  memmove(&p_ccb->rsp_list[0], p, p_ccb->list_len);
+  return tSDP_STATUS::SDP_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         process_service_search_attr_rsp
@@ -585,9 +659,7 @@ static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end) {
  ******************************************************************************/
 static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                             uint8_t* p_reply_end) {
-  uint8_t *p, *p_start, *p_end, *p_param_len;
-  uint8_t type;
-  uint32_t seq_len;
+  uint8_t *p_start, *p_param_len;
   uint16_t param_len, lists_byte_count = 0;
   bool cont_request_needed = false;
 
@@ -629,6 +701,13 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 
       cont_request_needed = true;
     }
+
+    /* Save what is complete now instead of reassembling the whole response */
+    tSDP_STATUS status = save_search_attr_lists(p_ccb);
+    if (status != tSDP_STATUS::SDP_SUCCESS) {
+      sdp_disconnect(p_ccb, status);
+      return;
+    }
   }
 
   /* If continuation request (or first time request) */
@@ -718,43 +797,19 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
   }
 
   /*******************************************************************/
-  /* We now have the full response, which is a sequence of sequences */
+  /* We now have the full response, all attribute lists must be saved */
   /*******************************************************************/
 
-  if (!sdp_copy_raw_data(p_ccb, true)) {
-    sdp_disconnect(p_ccb, tSDP_STATUS::SDP_ILLEGAL_PARAMETER);
-    return;
-  }
-
-  p = &p_ccb->rsp_list[0];
-
-  /* The contents is a sequence of attribute sequences */
-  type = *p++;
-
-  if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
-    sdp_disconnect(p_ccb, tSDP_STATUS::SDP_ILLEGAL_PARAMETER);
-    return;
-  }
-  p = sdpu_get_len_from_type(p, p + p_ccb->list_len, type, &seq_len);
-  if (p == NULL || (p + seq_len) > (p + p_ccb->list_len)) {
+  if (!p_ccb->rsp_seq_started) {
     sdp_disconnect(p_ccb, tSDP_STATUS::SDP_ILLEGAL_PARAMETER);
     return;
   }
-  p_end = &p_ccb->rsp_list[p_ccb->list_len];
 
-  if ((p + seq_len) != p_end) {
+  if (p_ccb->rsp_seq_left != 0 || p_ccb->list_len != 0) {
     sdp_disconnect(p_ccb, tSDP_STATUS::SDP_INVALID_CONT_STATE);
     return;
   }
 
-  while (p < p_end) {
-    p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
-    if (!p) {
-      sdp_disconnect(p_ccb, tSDP_STATUS::SDP_DB_FULL);
-      return;
-    }
-  }
-
   /* Since we got everything we need, disconnect the call */
   sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
   sdp_disconnect(p_ccb, tSDP_STATUS::SDP_SUCCESS);
@@ -813,10 +868,7 @@ static void process_service_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply, uint8_t*
       cont_request_needed = true;
     } else {
       log::warn("process_service_attr_rsp");
-      if (!sdp_copy_raw_data(p_ccb, false)) {
-        sdp_disconnect(p_ccb, tSDP_STATUS::SDP_ILLEGAL_PARAMETER);
-        return;
-      }
+      sdp_copy_raw_data(p_ccb->p_db, &p_ccb->rsp_list[0], p_ccb->list_len);
 
       /* Save the response in the database. Stop on any error */
       if (!save_attr_seq(p_ccb, &p_ccb->rsp_list[0], &p_ccb->rsp_list[p_ccb->list_len])) {
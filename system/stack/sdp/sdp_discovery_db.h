@@ -62,6 +62,13 @@ struct tSDP_DISC_REC {
 // Typedef alias used by profiles
 typedef tSDP_DISC_REC t_sdp_disc_rec;
 
+/* Overflow memory chained to a growable discovery DB once its initial pool is
+ * exhausted. The chunk payload directly follows this header. */
+struct tSDP_DISC_CHUNK {
+  struct tSDP_DISC_CHUNK* p_next; /* Previously allocated chunk   */
+  uint32_t size;                  /* Size of the chunk payload    */
+};
+
 struct tSDP_DISCOVERY_DB {
   uint32_t mem_size;                                  /* Memory size of the DB        */
   uint32_t mem_free;                                  /* Memory still available       */
@@ -74,6 +81,12 @@ struct tSDP_DISCOVERY_DB {
   uint8_t* raw_data; /* Received record from server. allocated/released by client  */
   uint32_t raw_size; /* size of raw_data */
   uint32_t raw_used; /* length of raw_data used */
+  /* A non zero chunk_size lets the DB grow past its initial pool instead of
+   * truncating the results. Overflow chunks must then be released with
+   * SDP_FreeDiscoveryDb() before the DB memory is reused or freed. */
+  uint32_t chunk_size;        /* Growth step, 0 for a fixed DB */
+  uint32_t mem_grown;         /* Bytes held in overflow chunks */
+  tSDP_DISC_CHUNK* p_chunks;  /* Most recent overflow chunk    */
 };
 
 /* This structure is used to add protocol lists and find protocol elements */
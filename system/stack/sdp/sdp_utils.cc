@@ -1304,6 +1304,14 @@ uint16_t sdpu_get_attrib_seq_len(const tSDP_RECORD* p_rec, const tSDP_ATTR_SEQ*
   bool is_range = false;
   uint16_t start_id = 0, end_id = 0;
 
+  /* Browsing peers request every attribute, the length of that list is cached
+   * per record until the record changes */
+  bool is_all_attributes = (attr_seq->num_attr == 1) && (attr_seq->attr_entry[0].start == 0) &&
+                           (attr_seq->attr_entry[0].end == 0xFFFF);
+  if (is_all_attributes && sdp_db_get_all_attr_list_len(p_rec, &len1)) {
+    return len1;
+  }
+
   for (xx = 0; xx < attr_seq->num_attr; xx++) {
     if (!is_range) {
       start_id = attr_seq->attr_entry[xx].start;
@@ -1326,6 +1334,10 @@ uint16_t sdpu_get_attrib_seq_len(const tSDP_RECORD* p_rec, const tSDP_ATTR_SEQ*
       is_range = false;
     }
   }
+
+  if (is_all_attributes) {
+    sdp_db_set_all_attr_list_len(p_rec, len1);
+  }
   return len1;
 }
 
@@ -28,7 +28,10 @@
 #include <base/strings/stringprintf.h>
 
 #include <cstdint>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "include/macros.h"
 #include "internal_include/bt_target.h"
@@ -107,11 +110,25 @@ struct tSDP_RECORD {
   uint8_t attr_pad[SDP_MAX_PAD_LEN];
 };
 
+/* Lookup tables over the SDP database records, kept in sync by the database
+ * maintenance API */
+struct tSDP_DB_INDEX {
+  /* Handles of the records containing a UUID, UUIDs normalized to 128 bits */
+  std::unordered_map<bluetooth::Uuid, std::set<uint32_t>> uuid_to_handles;
+  /* UUIDs contained in a record, used to update uuid_to_handles */
+  std::unordered_map<uint32_t, std::vector<bluetooth::Uuid>> handle_to_uuids;
+  /* Position of a record in tSDP_DB::record */
+  std::unordered_map<uint32_t, uint16_t> handle_to_index;
+  /* Length of the attribute list holding every attribute of a record */
+  std::unordered_map<uint32_t, uint16_t> all_attr_list_len;
+};
+
 /* Define the SDP database */
 struct tSDP_DB {
   uint32_t di_primary_handle; /* Device ID Primary record or NULL if nonexistent */
   uint16_t num_records;
   tSDP_RECORD record[SDP_MAX_RECORDS];
+  tSDP_DB_INDEX index;
 };
 
 /* Continuation information for the SDP server response */
@@ -203,6 +220,10 @@ struct tCONN_CB {
   tSDP_DISC_WAIT disc_state{SDP_DISC_WAIT_CONN};
   bool is_attr_search{false};
 
+  /* Service search attribute responses are saved fragment by fragment */
+  bool rsp_seq_started{false}; /* Header of the response sequence was seen */
+  uint32_t rsp_seq_left{0};    /* Bytes of the response sequence not saved */
+
   uint16_t cont_offset;     /* Continuation state data in the server response */
   tSDP_CONT_INFO cont_info;  // structure to hold continuation information for
                              //   the server response
@@ -298,6 +319,8 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec, const tSDP_UU
 tSDP_RECORD* sdp_db_find_record(uint32_t handle);
 const tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(const tSDP_RECORD* p_rec, uint16_t start_attr,
                                               uint16_t end_attr);
+bool sdp_db_get_all_attr_list_len(const tSDP_RECORD* p_rec, uint16_t* p_len);
+void sdp_db_set_all_attr_list_len(const tSDP_RECORD* p_rec, uint16_t len);
 
 /* Functions provided by sdp_server.cc
  */
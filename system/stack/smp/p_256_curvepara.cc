@@ -23,10 +23,11 @@
  ******************************************************************************/
 
 #include <cstring>
+#include <mutex>
 
 #include "p_256_ecc_pp.h"
 
-void p_256_init_curve() {
+static void p_256_init_curve_parameters() {
   elliptic_curve_t* ec = &curve_p256;
 
   ec->p[7] = 0xFFFFFFFF;
@@ -72,3 +73,9 @@ void p_256_init_curve() {
   ec->G.y[1] = 0xcbb64068;
   ec->G.y[0] = 0x37bf51f5;
 }
+
+// The parameters are written once only, as they are read from the SMP key worker thread too
+void p_256_init_curve() {
+  static std::once_flag curve_initialized;
+  std::call_once(curve_initialized, p_256_init_curve_parameters);
+}
@@ -26,13 +26,17 @@
 
 #include "smp_api.h"
 
+#include <base/functional/bind.h>
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <future>
+
 #include "smp_int.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/btm_sec_api_types.h"
 #include "stack/include/l2cap_interface.h"
+#include "stack/include/main_thread.h"
 #include "types/raw_address.h"
 
 using namespace bluetooth;
@@ -48,6 +52,32 @@ using namespace bluetooth;
  ******************************************************************************/
 void SMP_Init(uint8_t init_security_mode) { smp_cb.init(init_security_mode); }
 
+/*******************************************************************************
+ *
+ * Function         SMP_Free
+ *
+ * Description      This function releases the resources of the SMP unit.
+ *                  The key pair pool belongs to the main thread, it is stopped
+ *                  there unless the main thread is already gone.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SMP_Free() {
+  std::promise<void> stopped;
+  std::future<void> future = stopped.get_future();
+  if (do_in_main_thread(base::BindOnce(
+              [](std::promise<void> stopped) {
+                smp_sc_key_pool_stop();
+                stopped.set_value();
+              },
+              std::move(stopped))) != BT_STATUS_SUCCESS) {
+    smp_sc_key_pool_stop();
+    return;
+  }
+  future.wait();
+}
+
 /*******************************************************************************
  *
  * Function         SMP_Register
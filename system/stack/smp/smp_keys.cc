@@ -30,10 +30,14 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <memory>
 
+#include "common/message_loop_thread.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/controller_interface.h"
 #include "main/shim/entry.h"
+#include "osi/include/properties.h"
 #include "p_256_ecc_pp.h"
 #include "smp_int.h"
 #include "stack/btm/btm_ble_sec.h"
@@ -56,9 +60,20 @@ using namespace bluetooth;
 #define SMP_MAX_ENC_REPEAT 3
 #endif
 
+/* Number of precomputed Secure Connections key pairs kept ready for pairing */
+#ifndef SMP_SC_KEY_POOL_SIZE
+#define SMP_SC_KEY_POOL_SIZE 2
+#endif
+
+/* Number of pairings a precomputed key pair may be used for. The default of 1
+ * gives every pairing a fresh key pair. */
+#define SMP_SC_KEY_MAX_USES_PROPERTY "bluetooth.core.le.smp_sc_key_max_uses"
+
 static void smp_process_stk(tSMP_CB* p_cb, Octet16* p);
 static Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb);
 static void smp_process_private_key(tSMP_CB* p_cb);
+static void smp_local_public_key_ready(tSMP_CB* p_cb);
+static bool smp_sc_key_pool_take(tSMP_CB* p_cb);
 
 static void send_ble_rand(OnceCallback<void(uint64_t)> callback);
 
@@ -68,6 +83,25 @@ static void send_ble_rand(OnceCallback<void(uint64_t)> callback);
 // This needs to be cleared on a successfult pairing using the oob data
 static tSMP_LOC_OOB_DATA saved_local_oob_data = {};
 
+namespace {
+
+struct SmpScKeyPair {
+  BT_OCTET32 private_key;
+  tSMP_PUBLIC_KEY public_key;
+  int uses_left;
+};
+
+// Key pairs ready for the next pairings, only touched on the main thread
+std::deque<SmpScKeyPair> sc_key_pool;
+bool sc_key_pool_refilling = false;
+// Bumped on SMP init and cleanup so that key pairs still in flight from before are dropped
+uint32_t sc_key_pool_generation = 0;
+
+// Runs the scalar multiplications, started and stopped along with SMP
+bluetooth::common::MessageLoopThread sc_key_worker("bt_smp_key_worker");
+
+}  // namespace
+
 void smp_save_local_oob_data(tSMP_CB* p_cb) {
   saved_local_oob_data = p_cb->sc_oob_data.loc_oob_data;
 }
@@ -612,6 +646,16 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* /* p_data */) {
     log::warn("OOB Association Model with no saved data present");
   }
 
+  /* A key pair handed over Out of Band is generated inline, so that it never
+   * comes from, nor is shared through, the pool */
+  bool is_oob = p_cb->selected_association_model == SMP_MODEL_SEC_CONN_OOB ||
+                p_cb->state == SMP_STATE_CREATE_LOCAL_SEC_CONN_OOB_DATA;
+  if (!is_oob && smp_sc_key_pool_take(p_cb)) {
+    smp_local_public_key_ready(p_cb);
+    smp_sc_key_pool_refill();
+    return;
+  }
+
   send_ble_rand(BindOnce(
           [](tSMP_CB* p_cb, uint64_t rand) {
             memcpy(p_cb->private_key, (uint8_t*)&rand, sizeof(uint64_t));
@@ -626,6 +670,7 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* /* p_data */) {
                                           memcpy(&p_cb->private_key[24], (uint8_t*)&rand,
                                                  sizeof(uint64_t));
                                           smp_process_private_key(p_cb);
+                                          smp_sc_key_pool_refill();
                                         },
                                         p_cb));
                               },
@@ -715,6 +760,20 @@ void smp_process_private_key(tSMP_CB* p_cb) {
   memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
   memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
 
+  smp_local_public_key_ready(p_cb);
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_local_public_key_ready
+ *
+ * Description      This function notifies SM that the local private key /
+ *                  public key pair is available in the control block.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_local_public_key_ready(tSMP_CB* p_cb) {
   smp_debug_print_nbyte_little_endian(p_cb->private_key, "private", BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)", BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.y, "local public(y)", BT_OCTET32_LEN);
@@ -1044,3 +1103,154 @@ void smp_start_nonce_generation(tSMP_CB* p_cb) {
 static void send_ble_rand(OnceCallback<void(uint64_t)> callback) {
   bluetooth::shim::GetController()->LeRand(get_main_thread()->BindOnce(std::move(callback)));
 }
+
+/*******************************************************************************
+ *
+ * Function         smp_sc_key_pool_take
+ *
+ * Description      Copy a precomputed key pair into the control block, if one
+ *                  is ready.
+ *
+ * Returns          true if the control block now holds a local key pair
+ *
+ ******************************************************************************/
+static bool smp_sc_key_pool_take(tSMP_CB* p_cb) {
+  if (sc_key_pool.empty()) {
+    log::debug("No precomputed key pair ready");
+    return false;
+  }
+
+  SmpScKeyPair& key = sc_key_pool.front();
+  memcpy(p_cb->private_key, key.private_key, BT_OCTET32_LEN);
+  p_cb->loc_publ_key = key.public_key;
+  if (--key.uses_left <= 0) {
+    sc_key_pool.pop_front();
+  }
+  return true;
+}
+
+static void smp_sc_key_pool_add(uint32_t generation, std::unique_ptr<SmpScKeyPair> key) {
+  if (generation != sc_key_pool_generation) {
+    return;
+  }
+
+  sc_key_pool_refilling = false;
+  sc_key_pool.push_back(*key);
+  smp_sc_key_pool_refill();
+}
+
+static void smp_sc_key_pool_compute(uint32_t generation, Point base_point,
+                                    std::unique_ptr<SmpScKeyPair> key) {
+  Point public_key;
+  BT_OCTET32 private_key;
+
+  memcpy(private_key, key->private_key, BT_OCTET32_LEN);
+  ECC_PointMult(&public_key, &base_point, (uint32_t*)private_key);
+  memcpy(key->public_key.x, public_key.x, BT_OCTET32_LEN);
+  memcpy(key->public_key.y, public_key.y, BT_OCTET32_LEN);
+
+  do_in_main_thread(base::BindOnce(&smp_sc_key_pool_add, generation, std::move(key)));
+}
+
+static void smp_sc_key_pool_collect_rand(uint32_t generation, std::unique_ptr<SmpScKeyPair> key,
+                                         size_t offset, uint64_t rand) {
+  if (generation != sc_key_pool_generation) {
+    return;
+  }
+
+  memcpy(&key->private_key[offset], (uint8_t*)&rand, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  if (offset < BT_OCTET32_LEN) {
+    send_ble_rand(BindOnce(&smp_sc_key_pool_collect_rand, generation, std::move(key), offset));
+    return;
+  }
+
+  /* The scalar multiplication is the expensive part, keep it off the main
+   * thread. The base point is copied as ECC_PointMult() writes to it. */
+  if (!sc_key_worker.DoInThread(
+              FROM_HERE, base::BindOnce(&smp_sc_key_pool_compute, generation, curve_p256.G,
+                                        std::move(key)))) {
+    log::warn("Unable to compute key pair in the background");
+    sc_key_pool_refilling = false;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_sc_key_pool_refill
+ *
+ * Description      Start precomputing another Secure Connections key pair if
+ *                  the pool is not full. Key pairs are computed one at a time
+ *                  on a background thread.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_sc_key_pool_refill() {
+  if (sc_key_pool_refilling || sc_key_pool.size() >= SMP_SC_KEY_POOL_SIZE) {
+    return;
+  }
+
+  auto key = std::make_unique<SmpScKeyPair>();
+  key->uses_left = std::max(1, osi_property_get_int32(SMP_SC_KEY_MAX_USES_PROPERTY, 1));
+  sc_key_pool_refilling = true;
+  send_ble_rand(BindOnce(&smp_sc_key_pool_collect_rand, sc_key_pool_generation, std::move(key),
+                         size_t{0}));
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_sc_key_pool_reset
+ *
+ * Description      Drop all precomputed key pairs, including the ones still
+ *                  being computed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_sc_key_pool_reset() {
+  sc_key_pool.clear();
+  sc_key_pool_refilling = false;
+  sc_key_pool_generation++;
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_sc_key_pool_start
+ *
+ * Description      Start the thread computing key pairs with an empty pool.
+ *                  The P-256 curve parameters must be initialized before.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_sc_key_pool_start() {
+  smp_sc_key_pool_reset();
+  if (!sc_key_worker.IsRunning()) {
+    sc_key_worker.StartUp();
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_sc_key_pool_stop
+ *
+ * Description      Stop the thread computing key pairs and drop all
+ *                  precomputed key pairs, including the ones in flight.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_sc_key_pool_stop() {
+  sc_key_worker.ShutDown();
+  smp_sc_key_pool_reset();
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_sc_key_pool_size
+ *
+ * Returns          the number of precomputed key pairs ready for pairing
+ *
+ ******************************************************************************/
+size_t smp_sc_key_pool_size() { return sc_key_pool.size(); }
@@ -864,6 +864,7 @@ void tSMP_CB::init(uint8_t security_mode) {
   smp_l2cap_if_init();
   /* initialization of P-256 parameters */
   p_256_init_curve();
+  smp_sc_key_pool_start();
 
   /* Initialize failure case for certification */
   smp_cb.cert_failure =
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/time_util.h"
+#include "crypto_toolbox/crypto_toolbox.h"
+#include "hci/controller_interface_mock.h"
+#include "stack/btm/btm_ble_int.h"
+#include "stack/btm/btm_dev.h"
+#include "stack/btm/btm_int_types.h"
+#include "stack/btm/btm_sec_cb.h"
+#include "stack/include/bt_octets.h"
+#include "stack/include/btm_ble_privacy.h"
+#include "stack/include/hcidefs.h"
+#include "stack/include/main_thread.h"
+#include "stack/test/btm/btm_test_fixtures.h"
+#include "test/common/main_handler.h"
+#include "test/common/mock_functions.h"
+#include "test/mock/mock_main_shim_entry.h"
+#include "types/raw_address.h"
+
+extern tBTM_CB btm_cb;
+
+using ::testing::Return;
+
+namespace {
+
+const Octet16 kIrk1 = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                       0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+const Octet16 kIrk2 = {0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                       0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20};
+
+constexpr uint64_t kIdleMs = 60 * 1000;
+
+// Builds the resolvable private address of |irk| for the given random part
+RawAddress MakeRpa(const Octet16& irk, uint8_t prand1, uint8_t prand2) {
+  RawAddress rpa({static_cast<uint8_t>(0x40 | (prand1 & 0x3f)), prand2, 0x5a, 0x00, 0x00, 0x00});
+  Octet16 rand{};
+  rand[0] = rpa.address[2];
+  rand[1] = rpa.address[1];
+  rand[2] = rpa.address[0];
+  Octet16 hash = crypto_toolbox::aes_128(irk, rand);
+  rpa.address[5] = hash[0];
+  rpa.address[4] = hash[1];
+  rpa.address[3] = hash[2];
+  return rpa;
+}
+
+class StackBtmBlePrivacyTest : public BtmWithMocksTest {
+protected:
+  void SetUp() override {
+    BtmWithMocksTest::SetUp();
+    main_thread_start_up();
+    bluetooth::hci::testing::mock_controller_ = &controller_;
+    ON_CALL(controller_, SupportsBlePrivacy()).WillByDefault(Return(true));
+    ON_CALL(controller_, GetLeResolvingListSize()).WillByDefault(Return(2));
+    BTM_Sec_Init();
+    btm_cb.ble_ctr_cb.privacy_mode = BTM_PRIVACY_1_2;
+    btm_ble_resolving_list_init(0);
+    reset_mock_function_count_map();
+  }
+
+  void TearDown() override {
+    btm_cb.ble_ctr_cb.privacy_mode = BTM_PRIVACY_NONE;
+    BTM_Sec_Free();
+    bluetooth::hci::testing::mock_controller_ = nullptr;
+    main_thread_shut_down();
+    BtmWithMocksTest::TearDown();
+  }
+
+  tBTM_SEC_DEV_REC* AddBondedDevice(uint8_t id, const Octet16& irk) {
+    tBTM_SEC_DEV_REC* p_dev_rec = btm_sec_allocate_dev_rec();
+    p_dev_rec->bd_addr = RawAddress({0xc0, 0x11, 0x22, 0x33, 0x44, id});
+    p_dev_rec->ble_hci_handle = HCI_INVALID_HANDLE;
+    p_dev_rec->device_type = BT_DEVICE_TYPE_BLE;
+    p_dev_rec->ble.SetAddressType(BLE_ADDR_RANDOM);
+    p_dev_rec->sec_rec.ble_keys.key_type = BTM_LE_KEY_PID;
+    p_dev_rec->sec_rec.ble_keys.irk = irk;
+    return p_dev_rec;
+  }
+
+  bluetooth::hci::testing::MockControllerInterface controller_;
+};
+
+TEST_F(StackBtmBlePrivacyTest, resolved_rpa_is_cached) {
+  tBTM_SEC_DEV_REC* device_record1 = AddBondedDevice(1, kIrk2);
+  device_record1->sec_rec.ble_keys.key_type = 0;
+  tBTM_SEC_DEV_REC* device_record2 = AddBondedDevice(2, kIrk1);
+  const RawAddress rpa = MakeRpa(kIrk1, 0x01, 0x01);
+
+  ASSERT_EQ(device_record2, btm_ble_resolve_random_addr(rpa));
+
+  // A full pass would now stop at the first record, the cache still points to the second one
+  device_record1->sec_rec.ble_keys.irk = kIrk1;
+  device_record1->sec_rec.ble_keys.key_type = BTM_LE_KEY_PID;
+  ASSERT_EQ(device_record2, btm_ble_resolve_random_addr(rpa));
+
+  // A cached device that no longer matches is checked again against every record
+  device_record2->sec_rec.ble_keys.key_type = 0;
+  ASSERT_EQ(device_record1, btm_ble_resolve_random_addr(rpa));
+}
+
+TEST_F(StackBtmBlePrivacyTest, unresolved_rpa_is_cached_until_irk_changes) {
+  const RawAddress rpa = MakeRpa(kIrk1, 0x02, 0x02);
+  AddBondedDevice(1, kIrk2);
+
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+
+  // Without a new IRK being reported, the earlier miss is remembered
+  tBTM_SEC_DEV_REC* device_record2 = AddBondedDevice(2, kIrk1);
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+
+  btm_ble_rpa_cache_irk_changed();
+  ASSERT_EQ(device_record2, btm_ble_resolve_random_addr(rpa));
+}
+
+TEST_F(StackBtmBlePrivacyTest, loaded_devices_are_sent_in_one_update) {
+  // Two devices fill the controller list, the third one is resolved by the host
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(1, kIrk2));
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(2, kIrk2));
+  tBTM_SEC_DEV_REC* device_record3 = AddBondedDevice(3, kIrk1);
+  btm_ble_resolving_list_load_dev(*device_record3);
+  ASSERT_FALSE(device_record3->ble.in_controller_list & BTM_RESOLVING_LIST_BIT);
+  ASSERT_TRUE(btm_ble_resolving_list_is_host_resolved(device_record3->bd_addr));
+
+  sync_main_handler();
+  ASSERT_EQ(1, get_func_call_count("ACL_UpdateAddressResolution"));
+  ASSERT_EQ(0, get_func_call_count("ACL_AddToAddressResolution"));
+}
+
+TEST_F(StackBtmBlePrivacyTest, removal_is_sent_with_pending_additions) {
+  tBTM_SEC_DEV_REC* device_record1 = AddBondedDevice(1, kIrk2);
+  btm_ble_resolving_list_load_dev(*device_record1);
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(2, kIrk2));
+
+  // Removed before the additions went out, the controller never sees the device
+  btm_ble_resolving_list_remove_dev(device_record1);
+  ASSERT_FALSE(device_record1->ble.in_controller_list & BTM_RESOLVING_LIST_BIT);
+
+  sync_main_handler();
+  ASSERT_EQ(1, get_func_call_count("ACL_UpdateAddressResolution"));
+  ASSERT_EQ(0, get_func_call_count("ACL_RemoveFromAddressResolution"));
+}
+
+TEST_F(StackBtmBlePrivacyTest, host_activity_does_not_touch_controller_list) {
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(1, kIrk2));
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(2, kIrk2));
+  tBTM_SEC_DEV_REC* device_record3 = AddBondedDevice(3, kIrk1);
+  btm_ble_resolving_list_load_dev(*device_record3);
+  sync_main_handler();
+  reset_mock_function_count_map();
+
+  for (uint8_t i = 0; i < 10; i++) {
+    ASSERT_EQ(device_record3, btm_ble_resolve_random_addr(MakeRpa(kIrk1, 0x03, i)));
+  }
+  sync_main_handler();
+  ASSERT_EQ(0, get_func_call_count("ACL_UpdateAddressResolution"));
+  ASSERT_EQ(0, get_func_call_count("ACL_RemoveFromAddressResolution"));
+  ASSERT_FALSE(device_record3->ble.in_controller_list & BTM_RESOLVING_LIST_BIT);
+}
+
+TEST_F(StackBtmBlePrivacyTest, host_resolved_devices_are_tried_first) {
+  // The first device shares the IRK of the third one, a full pass would stop at it
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(1, kIrk1));
+  btm_ble_resolving_list_load_dev(*AddBondedDevice(2, kIrk2));
+  tBTM_SEC_DEV_REC* device_record3 = AddBondedDevice(3, kIrk1);
+  btm_ble_resolving_list_load_dev(*device_record3);
+  ASSERT_TRUE(btm_ble_resolving_list_is_host_resolved(device_record3->bd_addr));
+
+  ASSERT_EQ(device_record3, btm_ble_resolve_random_addr(MakeRpa(kIrk1, 0x04, 0x04)));
+}
+
+TEST_F(StackBtmBlePrivacyTest, rebalance_swaps_idle_entries) {
+  if (bluetooth::common::time_get_os_boottime_ms() < kIdleMs) {
+    GTEST_SKIP() << "Controller entries can not be idle long enough yet";
+  }
+
+  std::vector<tBTM_SEC_DEV_REC*> controller_records;
+  for (uint8_t id = 1; id <= 2; id++) {
+    controller_records.push_back(AddBondedDevice(id, kIrk2));
+    btm_ble_resolving_list_load_dev(*controller_records.back());
+  }
+  std::vector<tBTM_SEC_DEV_REC*> host_records;
+  for (uint8_t id = 3; id <= 5; id++) {
+    host_records.push_back(AddBondedDevice(id, kIrk1));
+    btm_ble_resolving_list_load_dev(*host_records.back());
+  }
+  sync_main_handler();
+  reset_mock_function_count_map();
+
+  // Without recent activity on the host, nothing is worth a swap
+  btm_ble_resolving_list_rebalance();
+  sync_main_handler();
+  ASSERT_EQ(0, get_func_call_count("ACL_UpdateAddressResolution"));
+
+  for (auto p_dev_rec : host_records) {
+    btm_ble_resolving_list_note_activity(p_dev_rec->bd_addr);
+  }
+  btm_ble_resolving_list_rebalance();
+
+  // The idle controller entries went to two of the active devices, in one update
+  sync_main_handler();
+  ASSERT_EQ(1, get_func_call_count("ACL_UpdateAddressResolution"));
+  for (auto p_dev_rec : controller_records) {
+    ASSERT_FALSE(p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT);
+    ASSERT_TRUE(btm_ble_resolving_list_is_host_resolved(p_dev_rec->bd_addr));
+  }
+
+  // Entries given to active devices are not idle, so they are not taken back
+  btm_ble_resolving_list_rebalance();
+  sync_main_handler();
+  ASSERT_EQ(1, get_func_call_count("ACL_UpdateAddressResolution"));
+}
+
+}  // namespace
@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include <future>
+#include <vector>
 
 #include "common/contextual_callback.h"
 #include "hci/address.h"
@@ -191,3 +192,37 @@ TEST_F(BtmDeviceInquiryTest, bta_dm_disc_device_discovery_single_result) {
 
   EXPECT_EQ(std::future_status::ready, one_result.wait_for(std::chrono::seconds(1)));
 }
+
+TEST_F(BtmDeviceInquiryTest, bta_dm_disc_device_discovery_duplicate_extended_result) {
+  std::vector<RawAddress> reported;
+  std::promise<void> sync_promise;
+  auto sync = sync_promise.get_future();
+  EXPECT_CALL(*inquiry_callback_ptr, btm_inq_results_cb(_, _, _))
+          .WillRepeatedly([&reported, &sync_promise](tBTM_INQ_RESULTS* p_inq, const uint8_t*,
+                                                     uint16_t) {
+            reported.push_back(p_inq->remote_bd_addr);
+            if (p_inq->remote_bd_addr == kRawAddress) {
+              sync_promise.set_value();
+            }
+          });
+
+  std::vector<bluetooth::hci::GapData> eir{};
+  bluetooth::hci::GapData name{};
+  name.data_type_ = bluetooth::hci::GapDataType::COMPLETE_LOCAL_NAME;
+  name.data_ = {'d', 'e', 'v', 'i', 'c', 'e'};
+  eir.push_back(name);
+
+  // The same response twice only gets reported once
+  for (int i = 0; i < 2; i++) {
+    hci_layer_.IncomingEvent(ExtendedInquiryResultBuilder::Create(
+            kAddress2, bluetooth::hci::PageScanRepetitionMode::R0,
+            bluetooth::hci::ClassOfDevice(), 0x2345, 0xc4, eir));
+  }
+  // Synchronize on a response for another device
+  hci_layer_.IncomingEvent(ExtendedInquiryResultBuilder::Create(
+          kAddress, bluetooth::hci::PageScanRepetitionMode::R0, bluetooth::hci::ClassOfDevice(),
+          0x1234, 0xc4, eir));
+
+  EXPECT_EQ(std::future_status::ready, sync.wait_for(std::chrono::seconds(1)));
+  EXPECT_EQ((std::vector<RawAddress>{kRawAddress2, kRawAddress}), reported);
+}
@@ -431,3 +431,59 @@ TEST_F(StackBtmSecWithInitFreeTest, btm_sec_temp_bond_auth_encryption_required)
   ASSERT_EQ(status, tBTM_STATUS::BTM_CMD_STARTED);
   ASSERT_EQ(device_record->sec_rec.classic_link, tSECURITY_STATE::ENCRYPTING);
 }
+
+TEST_F(StackBtmSecWithInitFreeTest, pending_requests_replayed_in_queue_order) {
+  const RawAddress bd_addr1 = RawAddress({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
+  const RawAddress bd_addr2 = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+  // Queue requests for two devices, interleaved
+  for (uint16_t psm : {1, 3, 5, 7}) {
+    tBTM_SEC_QUEUE_ENTRY entry{};
+    entry.bd_addr = (psm % 4 == 1) ? bd_addr1 : bd_addr2;
+    entry.psm = psm;
+    btm_sec_cb.QueuePendingRequest(entry);
+  }
+  ASSERT_EQ(2U, btm_sec_cb.sec_pending_q.size());
+  ASSERT_EQ(2U, btm_sec_cb.sec_pending_q[bd_addr1].size());
+
+  std::vector<tBTM_SEC_QUEUE_ENTRY> entries = btm_sec_cb.TakePendingRequests();
+  ASSERT_EQ(4U, entries.size());
+  ASSERT_EQ(1, entries[0].psm);
+  ASSERT_EQ(bd_addr1, entries[0].bd_addr);
+  ASSERT_EQ(3, entries[1].psm);
+  ASSERT_EQ(bd_addr2, entries[1].bd_addr);
+  ASSERT_EQ(5, entries[2].psm);
+  ASSERT_EQ(7, entries[3].psm);
+  ASSERT_TRUE(btm_sec_cb.sec_pending_q.empty());
+  ASSERT_TRUE(btm_sec_cb.TakePendingRequests().empty());
+}
+
+TEST_F(StackBtmSecWithInitFreeTest, busy_dev_rec_follow_classic_link_state) {
+  tBTM_SEC_DEV_REC* device_record1 = btm_sec_allocate_dev_rec();
+  device_record1->bd_addr = RawAddress({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
+  tBTM_SEC_DEV_REC* device_record2 = btm_sec_allocate_dev_rec();
+  device_record2->bd_addr = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+  ASSERT_EQ(nullptr, btm_sec_cb.FindDevRecBySecState(tSECURITY_STATE::AUTHENTICATING));
+
+  // The record that left IDLE first is found first
+  btm_sec_cb.SetClassicLinkState(device_record2, tSECURITY_STATE::AUTHENTICATING);
+  btm_sec_cb.SetClassicLinkState(device_record1, tSECURITY_STATE::AUTHENTICATING);
+  btm_sec_cb.SetClassicLinkState(device_record2, tSECURITY_STATE::AUTHENTICATING);
+  ASSERT_EQ(2U, btm_sec_cb.sec_busy_dev_rec.size());
+  ASSERT_EQ(device_record2, btm_sec_cb.FindDevRecBySecState(tSECURITY_STATE::AUTHENTICATING));
+  ASSERT_EQ(nullptr, btm_sec_cb.FindDevRecBySecState(tSECURITY_STATE::ENCRYPTING));
+
+  // Clearing the security flags makes the record idle
+  BTM_SecClearSecurityFlags(device_record2->bd_addr);
+  ASSERT_EQ(tSECURITY_STATE::IDLE, device_record2->sec_rec.classic_link);
+  ASSERT_EQ(1U, btm_sec_cb.sec_busy_dev_rec.size());
+  ASSERT_EQ(device_record1, btm_sec_cb.FindDevRecBySecState(tSECURITY_STATE::AUTHENTICATING));
+
+  // Removed records are dropped
+  btm_sec_cb.SetClassicLinkState(device_record1, tSECURITY_STATE::ENCRYPTING);
+  ASSERT_EQ(device_record1, btm_sec_cb.FindDevRecBySecState(tSECURITY_STATE::ENCRYPTING));
+  wipe_secrets_and_remove(device_record1);
+  ASSERT_TRUE(btm_sec_cb.sec_busy_dev_rec.empty());
+  ASSERT_EQ(nullptr, btm_sec_cb.FindDevRecBySecState(tSECURITY_STATE::ENCRYPTING));
+}
@@ -89,6 +89,8 @@ EattChannel* EattExtension::GetChannelAvailableForClientRequest(const RawAddress
   return pimpl_->GetChannelAvailableForClientRequest(bd_addr);
 }
 
+void EattExtension::Dump(int fd) { pimpl_->Dump(fd); }
+
 /* Start stop GATT indication timer per CID */
 void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr, uint16_t cid) {
   pimpl_->StartIndicationConfirmationTimer(bd_addr, cid);
@@ -49,6 +49,7 @@ public:
   MOCK_METHOD((bool), IsOutstandingMsgInSendQueue, (const RawAddress& bd_addr));
   MOCK_METHOD((EattChannel*), GetChannelWithQueuedDataToSend, (const RawAddress& bd_addr));
   MOCK_METHOD((EattChannel*), GetChannelAvailableForClientRequest, (const RawAddress& bd_addr));
+  MOCK_METHOD((void), Dump, (int fd));
   MOCK_METHOD((void), StartIndicationConfirmationTimer, (const RawAddress& bd_addr, uint16_t cid));
   MOCK_METHOD((void), StopIndicationConfirmationTimer, (const RawAddress& bd_addr, uint16_t cid));
 
@@ -20,6 +20,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <set>
 #include <vector>
 
 #include "bta/test/common/fake_osi.h"
@@ -657,6 +658,38 @@ TEST_F(EattTest, ChannelUnavailableWhileReconfiguring) {
   ASSERT_EQ(available_channel_for_indication, nullptr);
 }
 
+TEST_F(EattTest, ChannelsAssignedByLoad) {
+  ConnectDeviceEattSupported(/* num_of_accepted_connections = */ 3);
+
+  // Idle bearers are used in turn
+  std::set<uint16_t> used_cids;
+  for (size_t i = 0; i < connected_cids_.size(); i++) {
+    EattChannel* channel = eatt_instance_->GetChannelAvailableForClientRequest(test_address);
+    ASSERT_NE(channel, nullptr);
+    used_cids.insert(channel->cid_);
+  }
+  ASSERT_EQ(used_cids.size(), connected_cids_.size());
+
+  // Bearers with SDUs waiting in L2CAP are used last
+  ON_CALL(mock_stack_l2cap_interface_, L2CA_GetTxQueueDepth(_)).WillByDefault(Return(4));
+  ON_CALL(mock_stack_l2cap_interface_, L2CA_GetTxQueueDepth(connected_cids_[1]))
+          .WillByDefault(Return(0));
+  for (int i = 0; i < 3; i++) {
+    EattChannel* channel = eatt_instance_->GetChannelAvailableForIndication(test_address);
+    ASSERT_NE(channel, nullptr);
+    ASSERT_EQ(channel->cid_, connected_cids_[1]);
+  }
+
+  // Only bearers without an outstanding request take a new one
+  EattChannel* busy_channel =
+          eatt_instance_->FindEattChannelByCid(test_address, connected_cids_[1]);
+  busy_channel->cl_cmd_q_.push_back(tGATT_CMD_Q{});
+  EattChannel* channel = eatt_instance_->GetChannelAvailableForClientRequest(test_address);
+  ASSERT_NE(channel, nullptr);
+  ASSERT_NE(channel->cid_, connected_cids_[1]);
+  busy_channel->cl_cmd_q_.clear();
+}
+
 TEST_F(EattTest, DisconnectChannelOnIndicationConfirmationTimeout) {
   com::android::bluetooth::flags::provider_->gatt_disconnect_fix(true);
   ConnectDeviceEattSupported(1);
@@ -16,6 +16,7 @@
 
 #include <com_android_bluetooth_flags.h>
 #include <flag_macros.h>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <string.h>
 
@@ -23,6 +24,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/strings.h"
 #include "gd/os/rand.h"
@@ -32,6 +34,7 @@
 #include "stack/include/gatt_api.h"
 #include "stack/include/l2cap_types.h"
 #include "stack/sdp/internal/sdp_api.h"
+#include "test/mock/mock_stack_l2cap_interface.h"
 #include "test/mock/mock_stack_sdp_legacy_api.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
@@ -366,3 +369,158 @@ TEST_F(StackGattTest, attp_build_value_cmd_read_by_type_test_long_data) {
                                                                  offset_0, data_size, data);
   ASSERT_EQ(ret, nullptr);
 }
+
+namespace {
+
+const RawAddress kPeerAddress = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+
+/* Client Supported Features bit of Multiple Handle Value Notifications */
+constexpr uint8_t kClSuppFeatMultiNotif = 0x04;
+
+tGATT_VALUE make_value(uint16_t handle, uint16_t len) {
+  tGATT_VALUE value{};
+  value.handle = handle;
+  value.len = len;
+  memset(value.value, static_cast<uint8_t>(handle), len);
+  return value;
+}
+
+}  // namespace
+
+class StackGattNotificationTest : public StackGattTest {
+protected:
+  void SetUp() override {
+    StackGattTest::SetUp();
+    bluetooth::testing::stack::l2cap::set_interface(&mock_l2cap_);
+    gatt_init();
+
+    bluetooth::Uuid uuid = bluetooth::Uuid::From128BitBE(
+            bluetooth::os::GenerateRandom<bluetooth::Uuid::kNumBytes128>());
+    gatt_if_ = GATT_Register(uuid, "notification_test", &gatt_callbacks, false);
+    ASSERT_NE(gatt_if_, 0);
+
+    tcb_ = gatt_allocate_tcb_by_bdaddr(kPeerAddress, BT_TRANSPORT_LE);
+    ASSERT_NE(tcb_, nullptr);
+    tcb_->att_lcid = L2CAP_ATT_CID;
+    tcb_->payload_size = GATT_DEF_BLE_MTU_SIZE;
+    conn_id_ = gatt_create_conn_id(tcb_->tcb_idx, gatt_if_);
+
+    ON_CALL(mock_l2cap_, L2CA_SendFixedChnlData)
+            .WillByDefault([this](uint16_t /* cid */, const RawAddress& /* addr */,
+                                  BT_HDR* p_buf) {
+              uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
+              sent_pdus_.emplace_back(p, p + p_buf->len);
+              osi_free(p_buf);
+              return tL2CAP_DW_RESULT::SUCCESS;
+            });
+  }
+
+  void TearDown() override {
+    GATT_Deregister(gatt_if_);
+    gatt_free();
+    bluetooth::testing::stack::l2cap::reset_interface();
+    StackGattTest::TearDown();
+  }
+
+  ::testing::NiceMock<bluetooth::testing::stack::l2cap::Mock> mock_l2cap_;
+  tGATT_IF gatt_if_{0};
+  tGATT_TCB* tcb_{nullptr};
+  tCONN_ID conn_id_{0};
+  std::vector<std::vector<uint8_t>> sent_pdus_;
+};
+
+TEST_F(StackGattNotificationTest, multiple_value_notification_packs_values) {
+  tcb_->cl_supp_feat |= kClSuppFeatMultiNotif;
+  uint16_t num_sent = 0;
+
+  // Two values fill the 23 byte payload, the third goes out on its own
+  ASSERT_EQ(GATT_SUCCESS,
+            GATTS_HandleMultipleValueNotification(
+                    conn_id_, {make_value(0x10, 4), make_value(0x11, 4), make_value(0x12, 4)},
+                    &num_sent));
+  ASSERT_EQ(3, num_sent);
+  ASSERT_EQ(2u, sent_pdus_.size());
+
+  const std::vector<uint8_t> multi_pdu{
+          GATT_HANDLE_MULTI_VALUE_NOTIF, 0x10, 0x00, 0x04, 0x00, 0x10, 0x10, 0x10, 0x10,
+          0x11,                          0x00, 0x04, 0x00, 0x11, 0x11, 0x11, 0x11};
+  ASSERT_EQ(multi_pdu, sent_pdus_[0]);
+  const std::vector<uint8_t> single_pdu{GATT_HANDLE_VALUE_NOTIF, 0x12, 0x00, 0x12,
+                                        0x12, 0x12, 0x12};
+  ASSERT_EQ(single_pdu, sent_pdus_[1]);
+}
+
+TEST_F(StackGattNotificationTest, multiple_value_notification_long_value_sent_alone) {
+  tcb_->cl_supp_feat |= kClSuppFeatMultiNotif;
+  uint16_t num_sent = 0;
+
+  // The first value takes the whole payload, the next two still share a PDU
+  ASSERT_EQ(GATT_SUCCESS,
+            GATTS_HandleMultipleValueNotification(
+                    conn_id_, {make_value(0x10, 18), make_value(0x11, 4), make_value(0x12, 4)},
+                    &num_sent));
+  ASSERT_EQ(3, num_sent);
+  ASSERT_EQ(2u, sent_pdus_.size());
+  ASSERT_EQ(GATT_HANDLE_VALUE_NOTIF, sent_pdus_[0][0]);
+  ASSERT_EQ(21u, sent_pdus_[0].size());
+  ASSERT_EQ(GATT_HANDLE_MULTI_VALUE_NOTIF, sent_pdus_[1][0]);
+  ASSERT_EQ(17u, sent_pdus_[1].size());
+}
+
+TEST_F(StackGattNotificationTest, multiple_value_notification_not_supported_by_client) {
+  uint16_t num_sent = 0;
+
+  ASSERT_EQ(GATT_SUCCESS,
+            GATTS_HandleMultipleValueNotification(
+                    conn_id_, {make_value(0x10, 4), make_value(0x11, 4), make_value(0x12, 4)},
+                    &num_sent));
+  ASSERT_EQ(3, num_sent);
+  ASSERT_EQ(3u, sent_pdus_.size());
+  for (const auto& pdu : sent_pdus_) {
+    ASSERT_EQ(GATT_HANDLE_VALUE_NOTIF, pdu[0]);
+    ASSERT_EQ(7u, pdu.size());
+  }
+}
+
+TEST_F(StackGattNotificationTest, multiple_value_notification_stops_when_congested) {
+  tcb_->cl_supp_feat |= kClSuppFeatMultiNotif;
+  ON_CALL(mock_l2cap_, L2CA_SendFixedChnlData)
+          .WillByDefault([this](uint16_t /* cid */, const RawAddress& /* addr */,
+                                BT_HDR* p_buf) {
+            sent_pdus_.emplace_back();
+            osi_free(p_buf);
+            return tL2CAP_DW_RESULT::CONGESTED;
+          });
+  uint16_t num_sent = 0;
+
+  // The first PDU is accepted, the value left over waits for the channel to drain
+  ASSERT_EQ(GATT_CONGESTED,
+            GATTS_HandleMultipleValueNotification(
+                    conn_id_, {make_value(0x10, 4), make_value(0x11, 4), make_value(0x12, 4)},
+                    &num_sent));
+  ASSERT_EQ(2, num_sent);
+  ASSERT_EQ(1u, sent_pdus_.size());
+}
+
+TEST_F(StackGattNotificationTest, multiple_value_notification_send_failure) {
+  ON_CALL(mock_l2cap_, L2CA_SendFixedChnlData)
+          .WillByDefault([](uint16_t /* cid */, const RawAddress& /* addr */, BT_HDR* p_buf) {
+            osi_free(p_buf);
+            return tL2CAP_DW_RESULT::FAILED;
+          });
+  uint16_t num_sent = 0;
+
+  ASSERT_EQ(GATT_INTERNAL_ERROR,
+            GATTS_HandleMultipleValueNotification(conn_id_, {make_value(0x10, 4)}, &num_sent));
+  ASSERT_EQ(0, num_sent);
+}
+
+TEST_F(StackGattNotificationTest, multiple_value_notification_unknown_connection) {
+  uint16_t num_sent = 1;
+
+  ASSERT_EQ(GATT_ILLEGAL_PARAMETER,
+            GATTS_HandleMultipleValueNotification(gatt_create_conn_id(tcb_->tcb_idx + 1, gatt_if_),
+                                                  {make_value(0x10, 4)}, &num_sent));
+  ASSERT_EQ(0, num_sent);
+  ASSERT_TRUE(sent_pdus_.empty());
+}
@@ -84,7 +84,7 @@ class BleConnectionManager : public testing::Test {
     auto alarm_mock = AlarmMock::Get();
     ON_CALL(*alarm_mock, AlarmNew(_)).WillByDefault(testing::Invoke([](const char* name) {
       // We must return something from alarm_new in tests, if we just return
-      // null, unique_ptr will misbehave.
+      // null, the timeout alarm is considered not created.
       return (alarm_t*)new uint8_t[30];
     }));
     ON_CALL(*alarm_mock, AlarmFree(_)).WillByDefault(testing::Invoke([](alarm_t* alarm) {
@@ -182,9 +182,9 @@ TEST_F(BleConnectionManager, test_direct_connection_client) {
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 
   EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(_)).Times(1);
-  EXPECT_CALL(*AlarmMock::Get(), AlarmFree(_)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(1);
 
-  // Removal should lower the connection parameters, and free the alarm.
+  // Removal should lower the connection parameters, and cancel the alarm.
   // Even though we call AcceptlistRemove, it won't be executed over HCI until
   // acceptlist is in use, i.e. next connection attempt
   EXPECT_TRUE(direct_connect_remove(CLIENT1, address1));
@@ -211,7 +211,7 @@ TEST_F(BleConnectionManager, test_direct_connect_timeout) {
 
   EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(_)).Times(1);
   EXPECT_CALL(*localAcceptlistMock, OnConnectionTimedOut(CLIENT1, address1)).Times(1);
-  EXPECT_CALL(*AlarmMock::Get(), AlarmFree(_)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(1);
 
   // simulate timeout seconds passed, alarm executing
   alarm_callback(alarm_data);
@@ -219,6 +219,31 @@ TEST_F(BleConnectionManager, test_direct_connect_timeout) {
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 }
 
+/** Verify that all direct connection attempts share one alarm, armed for the
+ * earliest timeout */
+TEST_F(BleConnectionManager, test_direct_connect_shared_timeout_alarm) {
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1, true)).WillOnce(Return(true));
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address2, true)).WillOnce(Return(true));
+  EXPECT_CALL(*AlarmMock::Get(), AlarmNew(_)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmSetOnMloop(_, _, _, _)).Times(1);
+  EXPECT_TRUE(direct_connect_add(CLIENT1, address1));
+  EXPECT_TRUE(direct_connect_add(CLIENT2, address2));
+  Mock::VerifyAndClearExpectations(AlarmMock::Get());
+
+  // Removing the later attempt leaves the alarm untouched
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address2)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmSetOnMloop(_, _, _, _)).Times(0);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(0);
+  EXPECT_TRUE(direct_connect_remove(CLIENT2, address2));
+  Mock::VerifyAndClearExpectations(AlarmMock::Get());
+
+  // Removing the last attempt cancels it
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address1)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(1);
+  EXPECT_TRUE(direct_connect_remove(CLIENT1, address1));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+}
+
 /** Verify that we properly handle successfull direct connection */
 TEST_F(BleConnectionManager, test_direct_connection_success) {
   EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1, true)).WillOnce(Return(true));
@@ -231,7 +256,7 @@ TEST_F(BleConnectionManager, test_direct_connection_success) {
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 
   EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address1)).Times(1);
-  EXPECT_CALL(*AlarmMock::Get(), AlarmFree(_)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(1);
   // simulate event from lower layers - connections was established
   // successfully.
   on_connection_complete(address1);
@@ -273,7 +298,7 @@ TEST_F(BleConnectionManager, test_direct_and_background_connect) {
 
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 
-  EXPECT_CALL(*AlarmMock::Get(), AlarmFree(_)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(1);
   // not removing from acceptlist yet, as the background connection is still
   // pending.
   EXPECT_TRUE(direct_connect_remove(CLIENT1, address1));
@@ -367,7 +392,7 @@ TEST_F(BleConnectionManager, test_re_add_to_allow_list_after_timeout_with_multip
   EXPECT_CALL(*localAcceptlistMock, OnConnectionTimedOut(CLIENT2, address1)).Times(1);
   EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(_)).Times(0);
   EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1)).Times(1);
-  EXPECT_CALL(*AlarmMock::Get(), AlarmFree(_)).Times(1);
+  EXPECT_CALL(*AlarmMock::Get(), AlarmCancel(_)).Times(1);
   alarm_callback(alarm_data);
 
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
+#include "stack/include/bt_uuid16.h"
 #include "stack/include/sdp_api.h"
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdpint.h"
@@ -178,3 +181,54 @@ TEST_F(StackSdpDbTest, SDP_AddAttribute__three_attributes_replace_middle) {
 
   ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(record_handle));
 }
+
+TEST_F(StackSdpDbTest, sdp_db_service_search__uuid_index) {
+  uint16_t audio_sink = UUID_SERVCLASS_AUDIO_SINK;
+  uint16_t audio_source = UUID_SERVCLASS_AUDIO_SOURCE;
+
+  uint32_t sink_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  uint32_t source_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  ASSERT_NE((uint32_t)0, sink_handle);
+  ASSERT_NE((uint32_t)0, source_handle);
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(sink_handle, 1,
+                                                                           &audio_sink));
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(source_handle, 1,
+                                                                           &audio_source));
+
+  // Search for the 128-bit form of the source UUID
+  tSDP_UUID_SEQ uid_seq = {.num_uids = 1};
+  uid_seq.uuid_entry[0].len = bluetooth::Uuid::kNumBytes128;
+  memcpy(uid_seq.uuid_entry[0].value, bluetooth::Uuid::From16Bit(audio_source).To128BitBE().data(),
+         bluetooth::Uuid::kNumBytes128);
+
+  const tSDP_RECORD* p_rec = sdp_db_service_search(nullptr, &uid_seq);
+  ASSERT_TRUE(p_rec != nullptr);
+  ASSERT_EQ(source_handle, p_rec->record_handle);
+  ASSERT_TRUE(sdp_db_service_search(p_rec, &uid_seq) == nullptr);
+
+  // Replacing the attribute updates the index
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(source_handle, 1,
+                                                                           &audio_sink));
+  ASSERT_TRUE(sdp_db_service_search(nullptr, &uid_seq) == nullptr);
+
+  // Both records now match the sink UUID, in handle order
+  uid_seq.uuid_entry[0].len = bluetooth::Uuid::kNumBytes16;
+  uid_seq.uuid_entry[0].value[0] = (uint8_t)(audio_sink >> 8);
+  uid_seq.uuid_entry[0].value[1] = (uint8_t)audio_sink;
+  p_rec = sdp_db_service_search(nullptr, &uid_seq);
+  ASSERT_TRUE(p_rec != nullptr);
+  ASSERT_EQ(sink_handle, p_rec->record_handle);
+  p_rec = sdp_db_service_search(p_rec, &uid_seq);
+  ASSERT_TRUE(p_rec != nullptr);
+  ASSERT_EQ(source_handle, p_rec->record_handle);
+
+  // Deleted records are no longer found, the remaining one is still reachable by handle
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(sink_handle));
+  p_rec = sdp_db_service_search(nullptr, &uid_seq);
+  ASSERT_TRUE(p_rec != nullptr);
+  ASSERT_EQ(source_handle, p_rec->record_handle);
+  ASSERT_EQ(p_rec, sdp_db_find_record(source_handle));
+  ASSERT_TRUE(sdp_db_find_record(sink_handle) == nullptr);
+
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(source_handle));
+}
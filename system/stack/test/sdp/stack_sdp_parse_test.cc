@@ -21,6 +21,8 @@
 #include <stdlib.h>
 
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 #include "gd/os/rand.h"
 #include "osi/include/allocator.h"
@@ -243,3 +245,95 @@ TEST_F_WITH_FLAGS(StackSdpAsClientParseTest, sdp_disc_server_rsp_packets00b,
   ASSERT_NE(nullptr, p_sdp_rec);
   ASSERT_EQ(7U, sdp_get_num_attributes(*p_sdp_rec));
 }
+
+TEST_F_WITH_FLAGS(StackSdpAsClientParseTest, sdp_disc_server_rsp_packets00b__growable_db,
+                  REQUIRES_FLAGS_ENABLED(ACONFIG_FLAG(TEST_BT,
+                                                      stack_sdp_detect_nil_property_type))) {
+  // Leave almost no room in the initial pool so that the record and all its
+  // attributes end up in overflow chunks.
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->service.SDP_InitDiscoveryDb(
+          p_db_, sizeof(tSDP_DISCOVERY_DB) + 16, 1, p_uuid_list, 0, nullptr));
+  p_db_->chunk_size = 64;
+
+  parse_sdp_responses(bluetooth::testing::stack::sdp::packets00::rx_pkts,
+                      bluetooth::testing::stack::sdp::packets00::kNumRxPkts);
+
+  ASSERT_NE(nullptr, p_db_->p_chunks);
+  ASSERT_NE(nullptr, p_db_->p_chunks->p_next);
+  ASSERT_EQ(1U, sdp_get_num_records(*p_db_));
+
+  tSDP_DISC_REC* p_sdp_rec = p_db_->p_first_rec;
+  ASSERT_NE(nullptr, p_sdp_rec);
+  ASSERT_EQ(7U, sdp_get_num_attributes(*p_sdp_rec));
+  ASSERT_EQ(0x00010009U,
+            get_legacy_stack_sdp_api()
+                    ->record.SDP_FindAttributeInRec(p_sdp_rec, ATTR_ID_SERVICE_RECORD_HDL)
+                    ->attr_value.v.u32);
+
+  get_legacy_stack_sdp_api()->service.SDP_FreeDiscoveryDb(p_db_);
+  ASSERT_EQ(nullptr, p_db_->p_chunks);
+  ASSERT_EQ(nullptr, p_db_->p_first_rec);
+  ASSERT_EQ(0U, p_db_->mem_grown);
+}
+
+TEST_F(StackSdpAsClientParseTest, sdp_disc_server_rsp__search_attr_rsp_fragments) {
+  EXPECT_CALL(mock_stack_l2cap_interface_, L2CA_DataWrite(_, _))
+          .WillOnce(Invoke([](uint16_t /* cid */, BT_HDR* p_data) -> tL2CAP_DW_RESULT {
+            osi_free_and_reset((void**)&p_data);
+            return tL2CAP_DW_RESULT::SUCCESS;
+          }));
+  EXPECT_CALL(mock_stack_l2cap_interface_, L2CA_DisconnectReq(_)).Times(1);
+
+  // Two attribute lists holding a service record handle each, split across
+  // two responses in the middle of the first list.
+  const std::vector<uint8_t> attr_lists = {
+          0x35, 0x14,                                                  // sequence of 20 bytes
+          0x35, 0x08, 0x09, 0x00, 0x00, 0x0a, 0x00, 0x01, 0x00, 0x01,  // handle 0x00010001
+          0x35, 0x08, 0x09, 0x00, 0x00, 0x0a, 0x00, 0x01, 0x00, 0x02,  // handle 0x00010002
+  };
+  const size_t kSplit = 7;
+
+  auto send_rsp = [this](const uint8_t* lists, size_t len, uint8_t cont_len) {
+    std::vector<uint8_t> pdu = {
+            SDP_PDU_SERVICE_SEARCH_ATTR_RSP,
+            0x00,
+            0x01,  // transaction id
+            0x00,
+            (uint8_t)(2 + len + 1 + cont_len),  // parameter length
+            0x00,
+            (uint8_t)len,  // attribute lists byte count
+    };
+    pdu.insert(pdu.end(), lists, lists + len);
+    pdu.push_back(cont_len);
+    pdu.insert(pdu.end(), cont_len, 0x42);
+
+    BT_HDR* bt_hdr = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + pdu.size());
+    bt_hdr->event = 0;
+    bt_hdr->len = (uint16_t)pdu.size();
+    bt_hdr->offset = 0;
+    bt_hdr->layer_specific = 0;
+    memcpy(bt_hdr->data, pdu.data(), pdu.size());
+    sdp_disc_server_rsp(p_ccb_, bt_hdr);
+    osi_free(bt_hdr);
+  };
+
+  send_rsp(attr_lists.data(), kSplit, 1);
+
+  // The partial attribute list is kept back until the rest arrives.
+  ASSERT_TRUE(p_ccb_->rsp_seq_started);
+  ASSERT_EQ(kSplit - 2, p_ccb_->list_len);
+  ASSERT_EQ(0U, sdp_get_num_records(*p_db_));
+
+  send_rsp(attr_lists.data() + kSplit, attr_lists.size() - kSplit, 0);
+
+  ASSERT_EQ(2U, sdp_get_num_records(*p_db_));
+  tSDP_DISC_REC* p_sdp_rec = p_db_->p_first_rec;
+  ASSERT_EQ(0x00010001U,
+            get_legacy_stack_sdp_api()
+                    ->record.SDP_FindAttributeInRec(p_sdp_rec, ATTR_ID_SERVICE_RECORD_HDL)
+                    ->attr_value.v.u32);
+  ASSERT_EQ(0x00010002U, get_legacy_stack_sdp_api()
+                                 ->record.SDP_FindAttributeInRec(p_sdp_rec->p_next_rec,
+                                                                 ATTR_ID_SERVICE_RECORD_HDL)
+                                 ->attr_value.v.u32);
+}
@@ -30,12 +30,15 @@
 #include "stack/include/l2cdefs.h"
 #include "stack/l2cap/l2c_int.h"
 #include "test/mock/mock_main_shim_entry.h"
+#include "test/mock/mock_stack_acl.h"
+#include "test/mock/mock_stack_btm_interface.h"
 
 tBTM_CB btm_cb;
 extern tL2C_CB l2cb;
 
 void l2c_link_send_to_lower_br_edr(tL2C_LCB* p_lcb, BT_HDR* p_buf);
 void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf);
+void l2cble_start_conn_update(tL2C_LCB* p_lcb);
 
 using testing::Return;
 
@@ -43,6 +46,8 @@ namespace {
 constexpr uint16_t kAclBufferCountClassic = 123;
 constexpr uint16_t kAclBufferCountBle = 45;
 constexpr uint16_t kAclBufferSizeBle = 45;
+constexpr uint16_t kHciHandle = 0x0123;
+const RawAddress kRawAddress = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
 
 }  // namespace
 
@@ -299,3 +304,156 @@ TEST_F(StackL2capTest, bt_psm_text) {
     bluetooth::log::info("{} {} ", bt_psm_text(it.first), it.second);
   }
 }
+
+class StackL2capConnParamsTest : public StackL2capTest {
+protected:
+  struct ConnParams {
+    uint16_t min_interval;
+    uint16_t max_interval;
+    uint16_t latency;
+    uint16_t timeout;
+  };
+
+  void SetUp() override {
+    StackL2capTest::SetUp();
+    mock_btm_client_interface.peer.BTM_IsAclConnectionUp =
+            [](const RawAddress& /* remote_bda */, tBT_TRANSPORT /* transport */) { return true; };
+    test::mock::stack_acl::BTM_IsAclConnectionUp.body =
+            [](const RawAddress& /* remote_bda */, tBT_TRANSPORT /* transport */) { return true; };
+    test::mock::stack_acl::acl_ble_connection_parameters_request.body =
+            [this](uint16_t /* handle */, uint16_t min_interval, uint16_t max_interval,
+                   uint16_t latency, uint16_t timeout, uint16_t /* min_ce_len */,
+                   uint16_t /* max_ce_len */) {
+              sent_.push_back({min_interval, max_interval, latency, timeout});
+            };
+
+    lcb_ = &l2cb.lcb_pool[0];
+    lcb_->in_use = true;
+    lcb_->remote_bd_addr = kRawAddress;
+    lcb_->transport = BT_TRANSPORT_LE;
+    lcb_->SetLinkRoleAsCentral();
+    l2cu_set_lcb_handle(*lcb_, kHciHandle);
+  }
+
+  void TearDown() override {
+    alarm_free(lcb_->conn_update_timer);
+    lcb_->conn_update_timer = nullptr;
+    test::mock::stack_acl::acl_ble_connection_parameters_request = {};
+    test::mock::stack_acl::BTM_IsAclConnectionUp = {};
+    reset_mock_btm_client_interface();
+    StackL2capTest::TearDown();
+  }
+
+  void UpdateConnParams(ConnParams params) {
+    ASSERT_TRUE(L2CA_UpdateBleConnParams(kRawAddress, params.min_interval, params.max_interval,
+                                         params.latency, params.timeout, 0, 0));
+  }
+
+  // Answers the pending update with the given connection interval
+  void ConnUpdateComplete(uint16_t interval, ConnParams params) {
+    l2cble_process_conn_update_evt(kHciHandle, HCI_SUCCESS, interval, params.latency,
+                                   params.timeout);
+  }
+
+  // Runs the end of the decision window, as its timer would
+  void EndDecisionWindow() {
+    lcb_->last_conn_update_ms -= L2CAP_BLE_CONN_UPDATE_WINDOW_MS;
+    l2cble_start_conn_update(lcb_);
+  }
+
+  tL2C_BLE_CONN_DECISION_OUTCOME LastDecision() const {
+    return lcb_->conn_decision_history[(lcb_->conn_decision_count - 1) %
+                                       L2C_BLE_CONN_DECISION_HISTORY_SIZE]
+            .outcome;
+  }
+
+  tL2C_LCB* lcb_ = nullptr;
+  std::vector<ConnParams> sent_;
+};
+
+TEST_F(StackL2capConnParamsTest, updates_within_decision_window_are_coalesced) {
+  const ConnParams first = {24, 40, 0, 500};
+  const ConnParams second = {80, 100, 4, 600};
+  const ConnParams third = {160, 200, 4, 600};
+
+  UpdateConnParams(first);
+  ASSERT_EQ(1u, sent_.size());
+  ConnUpdateComplete(32, first);
+
+  // Both requests arrive within the window, only the latest one is kept
+  UpdateConnParams(second);
+  ASSERT_EQ(L2C_BLE_CONN_DECISION_DEFERRED, LastDecision());
+  UpdateConnParams(third);
+  ASSERT_EQ(1u, sent_.size());
+  ASSERT_NE(nullptr, lcb_->conn_update_timer);
+
+  EndDecisionWindow();
+  ASSERT_EQ(2u, sent_.size());
+  ASSERT_EQ(third.min_interval, sent_.back().min_interval);
+  ASSERT_EQ(third.max_interval, sent_.back().max_interval);
+  ASSERT_EQ(third.latency, sent_.back().latency);
+  ASSERT_EQ(third.timeout, sent_.back().timeout);
+  ASSERT_EQ(L2C_BLE_CONN_DECISION_SENT, LastDecision());
+}
+
+TEST_F(StackL2capConnParamsTest, update_matching_current_params_is_not_sent) {
+  const ConnParams params = {24, 40, 0, 500};
+
+  UpdateConnParams(params);
+  ASSERT_EQ(1u, sent_.size());
+  ConnUpdateComplete(32, params);
+
+  // The link already runs at an interval within the requested range
+  EndDecisionWindow();
+  UpdateConnParams(params);
+  ASSERT_EQ(1u, sent_.size());
+  ASSERT_EQ(L2C_BLE_CONN_DECISION_UNCHANGED, LastDecision());
+}
+
+TEST_F(StackL2capConnParamsTest, demands_are_combined_into_tightest_params) {
+  const ConnParams audio = {16, 16, 10, 100};
+  const ConnParams hid = {24, 40, 4, 300};
+
+  ASSERT_TRUE(L2CA_SetBleConnDemand(kRawAddress, L2CAP_BLE_CONN_DEMAND_AUDIO, audio.min_interval,
+                                    audio.max_interval, audio.latency, audio.timeout, 0, 0));
+  ASSERT_EQ(1u, sent_.size());
+  ConnUpdateComplete(16, audio);
+  ASSERT_TRUE(L2CA_IsBleConnLatencySensitive(kRawAddress));
+
+  // Tightening the latency is sent without waiting for the window
+  ASSERT_TRUE(L2CA_SetBleConnDemand(kRawAddress, L2CAP_BLE_CONN_DEMAND_HID, hid.min_interval,
+                                    hid.max_interval, hid.latency, hid.timeout, 0, 0));
+  ASSERT_EQ(2u, sent_.size());
+  ASSERT_EQ(audio.min_interval, sent_.back().min_interval);
+  ASSERT_EQ(audio.max_interval, sent_.back().max_interval);
+  ASSERT_EQ(hid.latency, sent_.back().latency);
+  ASSERT_EQ(hid.timeout, sent_.back().timeout);
+  ASSERT_EQ(L2C_BLE_CONN_DECISION_SENT, LastDecision());
+}
+
+TEST_F(StackL2capConnParamsTest, relaxing_after_cleared_demand_waits_for_window) {
+  const ConnParams audio = {16, 16, 0, 100};
+  const ConnParams gatt = {40, 80, 4, 500};
+
+  ASSERT_TRUE(L2CA_SetBleConnDemand(kRawAddress, L2CAP_BLE_CONN_DEMAND_GATT, gatt.min_interval,
+                                    gatt.max_interval, gatt.latency, gatt.timeout, 0, 0));
+  ConnUpdateComplete(60, gatt);
+  EndDecisionWindow();
+  ASSERT_TRUE(L2CA_SetBleConnDemand(kRawAddress, L2CAP_BLE_CONN_DEMAND_AUDIO, audio.min_interval,
+                                    audio.max_interval, audio.latency, audio.timeout, 0, 0));
+  ASSERT_EQ(2u, sent_.size());
+  ConnUpdateComplete(16, {16, 16, 0, 500});
+
+  // Only the GATT demand is left, relaxing to it waits for the window
+  L2CA_ClearBleConnDemand(kRawAddress, L2CAP_BLE_CONN_DEMAND_AUDIO);
+  ASSERT_FALSE(L2CA_IsBleConnLatencySensitive(kRawAddress));
+  ASSERT_EQ(2u, sent_.size());
+  ASSERT_EQ(L2C_BLE_CONN_DECISION_DEFERRED, LastDecision());
+
+  EndDecisionWindow();
+  ASSERT_EQ(3u, sent_.size());
+  ASSERT_EQ(gatt.min_interval, sent_.back().min_interval);
+  ASSERT_EQ(gatt.max_interval, sent_.back().max_interval);
+  ASSERT_EQ(gatt.latency, sent_.back().latency);
+  ASSERT_EQ(gatt.timeout, sent_.back().timeout);
+}
@@ -19,7 +19,12 @@
 #include <gtest/gtest.h>
 #include <stdarg.h>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <string>
+#include <thread>
 
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/include/packet_fragmenter.h"
@@ -31,6 +36,8 @@
 #include "stack/include/smp_status.h"
 #include "stack/smp/p_256_ecc_pp.h"
 #include "stack/smp/smp_int.h"
+#include "test/common/main_handler.h"
+#include "test/mock/mock_main_shim_entry.h"
 #include "test/mock/mock_stack_acl.h"
 #include "types/hci_role.h"
 #include "types/raw_address.h"
@@ -388,6 +395,101 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+class SmpScKeyPoolTest : public testing::Test {
+protected:
+  void SetUp() override {
+    main_thread_start_up();
+    bluetooth::hci::testing::mock_controller_ = &controller_;
+    // Hand out 1, 2, 3... so that the origin of a private key can be told
+    ON_CALL(controller_, LeRand).WillByDefault([this](bluetooth::hci::LeRandCallback cb) {
+      cb(++le_rand_count_);
+    });
+    p_256_init_curve();
+    smp_sc_key_pool_start();
+  }
+
+  void TearDown() override {
+    StopPool();
+    main_thread_shut_down();
+    bluetooth::hci::testing::mock_controller_ = nullptr;
+  }
+
+  template <typename T>
+  T RunOnMainThread(std::function<T()> function) {
+    std::promise<T> promise;
+    auto future = promise.get_future();
+    do_in_main_thread(base::BindOnce(
+            [](std::function<T()> function, std::promise<T> promise) {
+              promise.set_value(function());
+            },
+            function, std::move(promise)));
+    return future.get();
+  }
+
+  // The pool is only touched on the main thread, where a refill may still be going on
+  void StopPool() {
+    RunOnMainThread<bool>([]() {
+      smp_sc_key_pool_stop();
+      return true;
+    });
+  }
+
+  bool WaitForPoolSize(size_t size) {
+    for (int i = 0; i < 100; i++) {
+      if (RunOnMainThread<size_t>(smp_sc_key_pool_size) >= size) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  testing::NiceMock<bluetooth::hci::testing::MockControllerInterface> controller_;
+  std::atomic<uint64_t> le_rand_count_{0};
+};
+
+TEST_F(SmpScKeyPoolTest, no_le_rand_until_refill) {
+  ASSERT_EQ(0u, RunOnMainThread<size_t>(smp_sc_key_pool_size));
+  ASSERT_EQ(0u, le_rand_count_);
+}
+
+TEST_F(SmpScKeyPoolTest, precomputed_key_pair_used_for_pairing) {
+  do_in_main_thread(base::BindOnce(&smp_sc_key_pool_refill));
+  ASSERT_TRUE(WaitForPoolSize(1));
+
+  tSMP_CB cb{};
+  RunOnMainThread<bool>([&cb]() {
+    smp_create_private_key(&cb, nullptr);
+    return true;
+  });
+
+  // The first key pair of the pool was made from the first four LE_Rand results
+  for (uint64_t i = 0; i < BT_OCTET32_LEN / sizeof(uint64_t); i++) {
+    uint64_t rand;
+    memcpy(&rand, &cb.private_key[i * sizeof(uint64_t)], sizeof(uint64_t));
+    ASSERT_EQ(i + 1, rand);
+  }
+  ASSERT_TRUE(cb.flags & SMP_PAIR_FLAG_HAVE_LOCAL_PUBL_KEY);
+
+  // The public key computed in the background matches the private key
+  Point base_point = curve_p256.G;
+  Point public_key;
+  BT_OCTET32 private_key;
+  memcpy(private_key, cb.private_key, BT_OCTET32_LEN);
+  ECC_PointMult(&public_key, &base_point, (uint32_t*)private_key);
+  ASSERT_EQ(0, memcmp(cb.loc_publ_key.x, public_key.x, BT_OCTET32_LEN));
+  ASSERT_EQ(0, memcmp(cb.loc_publ_key.y, public_key.y, BT_OCTET32_LEN));
+  ASSERT_TRUE(ECC_ValidatePoint(public_key));
+}
+
+TEST_F(SmpScKeyPoolTest, stop_drops_key_pairs) {
+  do_in_main_thread(base::BindOnce(&smp_sc_key_pool_refill));
+  ASSERT_TRUE(WaitForPoolSize(1));
+
+  StopPool();
+  ASSERT_EQ(0u, RunOnMainThread<size_t>(smp_sc_key_pool_size));
+}
+
 TEST(SmpStatusText, smp_status_text) {
   std::vector<std::pair<tSMP_STATUS, std::string>> status = {
           std::make_pair(SMP_SUCCESS, "SMP_SUCCESS"),
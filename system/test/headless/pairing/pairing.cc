@@ -18,7 +18,13 @@
 
 #include "test/headless/pairing/pairing.h"
 
+#include <base/functional/bind.h>
+
+#include <utility>
+#include <vector>
+
 #include "btif/include/btif_api.h"
+#include "stack/include/main_thread.h"
 #include "test/headless/get_options.h"
 #include "test/headless/headless.h"
 #include "types/raw_address.h"
@@ -29,16 +35,28 @@ int bluetooth::test::headless::Pairing::Run() {
     options_.Usage();
     return -1;
   }
-  if (options_.device_.size() != 1) {
-    fprintf(stdout, "This test requires a single device specified");
+  if (options_.device_.empty()) {
+    fprintf(stdout, "This test requires at least a single device specified");
     options_.Usage();
     return -1;
   }
 
-  [[maybe_unused]] RawAddress raw_address = options_.device_.front();
+  // Several devices are bonded in turn as a single batch
+  std::vector<std::pair<RawAddress, tBT_TRANSPORT>> targets;
+  for (const RawAddress& raw_address : options_.device_) {
+    targets.emplace_back(raw_address, BT_TRANSPORT_BR_EDR);
+  }
 
-  return RunOnHeadlessStack<int>([raw_address]() {
-    btif_dm_create_bond(raw_address, BT_TRANSPORT_BR_EDR);
-    return BT_STATUS_SUCCESS;
+  return RunOnHeadlessStack<int>([targets]() {
+    if (targets.size() == 1) {
+      btif_dm_create_bond(targets.front().first, BT_TRANSPORT_BR_EDR);
+      return BT_STATUS_SUCCESS;
+    }
+    // The bond batch is owned by the main thread
+    return do_in_main_thread(base::BindOnce(
+            [](std::vector<std::pair<RawAddress, tBT_TRANSPORT>> targets) {
+              btif_dm_create_bond_batch(std::move(targets));
+            },
+            targets));
   });
 }
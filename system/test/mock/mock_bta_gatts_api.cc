@@ -52,6 +52,11 @@ void BTA_GATTS_HandleValueIndication(uint16_t /* conn_id */, uint16_t /* attr_id
                                      std::vector<uint8_t> /* value */, bool /* need_confirm */) {
   inc_func_call_count(__func__);
 }
+void BTA_GATTS_HandleMultipleValueNotification(tCONN_ID /* conn_id */,
+                                               std::vector<tGATT_VALUE> /* values */,
+                                               BTA_GATTS_MultipleValueNotificationCb /* cb */) {
+  inc_func_call_count(__func__);
+}
 void BTA_GATTS_Open(tGATT_IF /* server_if */, const RawAddress& /* remote_bda */,
                     tBLE_ADDR_TYPE /* addr_type */, bool /* is_direct */,
                     tBT_TRANSPORT /* transport */) {
@@ -22,6 +22,7 @@ class MockRasServer : public bluetooth::ras::RasServer {
   void HandleVendorSpecificReplyComplete(RawAddress /* address */, bool /* success */) override {}
   void PushProcedureData(RawAddress /* address */, uint16_t /* procedure_count */,
                          bool /* is_last */, std::vector<uint8_t> /* data */) override {}
+  void DebugDump(int /* fd */) override {}
   void SetVendorSpecificCharacteristic(
           const std::vector<bluetooth::ras::VendorSpecificCharacteristic>&
           /* vendor_specific_characteristics */) override {}
@@ -54,6 +54,8 @@ struct btif_config_get_paired_devices btif_config_get_paired_devices;
 struct btif_config_remove btif_config_remove;
 struct btif_config_remove_device btif_config_remove_device;
 struct btif_config_clear btif_config_clear;
+struct btif_config_begin_batched_save btif_config_begin_batched_save;
+struct btif_config_end_batched_save btif_config_end_batched_save;
 
 }  // namespace btif_config
 }  // namespace mock
@@ -124,5 +126,13 @@ bool btif_config_clear(void) {
   inc_func_call_count(__func__);
   return test::mock::btif_config::btif_config_clear();
 }
+void btif_config_begin_batched_save(void) {
+  inc_func_call_count(__func__);
+  test::mock::btif_config::btif_config_begin_batched_save();
+}
+void btif_config_end_batched_save(void) {
+  inc_func_call_count(__func__);
+  test::mock::btif_config::btif_config_end_batched_save();
+}
 
 // END mockcify generation
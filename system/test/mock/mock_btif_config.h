@@ -213,6 +213,22 @@ struct btif_config_clear {
   bool operator()(void) { return body(); }
 };
 extern struct btif_config_clear btif_config_clear;
+// Name: btif_config_begin_batched_save
+// Params: void
+// Returns: void
+struct btif_config_begin_batched_save {
+  std::function<void(void)> body{[](void) {}};
+  void operator()(void) { body(); }
+};
+extern struct btif_config_begin_batched_save btif_config_begin_batched_save;
+// Name: btif_config_end_batched_save
+// Params: void
+// Returns: void
+struct btif_config_end_batched_save {
+  std::function<void(void)> body{[](void) {}};
+  void operator()(void) { body(); }
+};
+extern struct btif_config_end_batched_save btif_config_end_batched_save;
 
 }  // namespace btif_config
 }  // namespace mock
@@ -16,10 +16,12 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:51
+ *   Functions generated:52
  */
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "bta/include/bta_api.h"
 #include "bta/include/bta_sec_api.h"
@@ -88,6 +90,10 @@ void btif_dm_create_bond(const RawAddress /* bd_addr */, int /* transport */) {
 void btif_dm_create_bond_le(const RawAddress /* bd_addr */, tBLE_ADDR_TYPE /* addr_type */) {
   inc_func_call_count(__func__);
 }
+void btif_dm_create_bond_batch(
+        std::vector<std::pair<RawAddress, tBT_TRANSPORT>> /* targets */) {
+  inc_func_call_count(__func__);
+}
 void btif_dm_create_bond_out_of_band(const RawAddress /* bd_addr */, int /* transport */,
                                      const bt_oob_data_t /* p192_data */,
                                      const bt_oob_data_t /* p256_data */) {
@@ -81,3 +81,5 @@ std::vector<std::string> bluetooth::shim::BtifConfigInterface::GetPersistentDevi
 }
 void bluetooth::shim::BtifConfigInterface::ConvertEncryptOrDecryptKeyIfNeeded() {}
 void bluetooth::shim::BtifConfigInterface::Clear() {}
+void bluetooth::shim::BtifConfigInterface::BeginBatchedSave() {}
+void bluetooth::shim::BtifConfigInterface::EndBatchedSave() {}
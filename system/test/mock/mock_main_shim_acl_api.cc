@@ -82,6 +82,11 @@ void bluetooth::shim::ACL_RemoveFromAddressResolution(
         const tBLE_BD_ADDR& /* legacy_address_with_type */) {
   inc_func_call_count(__func__);
 }
+void bluetooth::shim::ACL_UpdateAddressResolution(
+        const std::vector<std::pair<tBLE_BD_ADDR, Octet16>>& /* peers */,
+        const Octet16& /* local_irk */) {
+  inc_func_call_count(__func__);
+}
 void bluetooth::shim::ACL_ClearAddressResolution() { inc_func_call_count(__func__); }
 void bluetooth::shim::ACL_LeSetDefaultSubrate(uint16_t /* subrate_min */,
                                               uint16_t /* subrate_max */,
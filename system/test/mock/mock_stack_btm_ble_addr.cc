@@ -58,6 +58,7 @@ tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   inc_func_call_count(__func__);
   return test::mock::stack_btm_ble_addr::btm_ble_resolve_random_addr(random_bda);
 }
+void btm_ble_rpa_cache_irk_changed() { inc_func_call_count(__func__); }
 bool btm_identity_addr_to_random_pseudo(RawAddress* bd_addr, tBLE_ADDR_TYPE* p_addr_type,
                                         bool refresh) {
   inc_func_call_count(__func__);
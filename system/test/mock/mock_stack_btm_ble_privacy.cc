@@ -86,6 +86,14 @@ void btm_ble_resolving_list_remove_dev(tBTM_SEC_DEV_REC* p_dev_rec) {
   inc_func_call_count(__func__);
   test::mock::stack_btm_ble_privacy::btm_ble_resolving_list_remove_dev(p_dev_rec);
 }
+void btm_ble_resolving_list_note_activity(const RawAddress& /* pseudo_addr */) {
+  inc_func_call_count(__func__);
+}
+void btm_ble_resolving_list_rebalance() { inc_func_call_count(__func__); }
+bool btm_ble_resolving_list_is_host_resolved(const RawAddress& /* pseudo_addr */) {
+  inc_func_call_count(__func__);
+  return false;
+}
 void btm_ble_resolving_list_init(uint8_t max_irk_list_sz) {
   inc_func_call_count(__func__);
   test::mock::stack_btm_ble_privacy::btm_ble_resolving_list_init(max_irk_list_sz);
@@ -51,6 +51,7 @@ struct GATTS_AddService GATTS_AddService;
 struct GATTS_DeleteService GATTS_DeleteService;
 struct GATTS_HandleValueIndication GATTS_HandleValueIndication;
 struct GATTS_HandleValueNotification GATTS_HandleValueNotification;
+struct GATTS_HandleMultipleValueNotification GATTS_HandleMultipleValueNotification;
 struct GATTS_NVRegister GATTS_NVRegister;
 struct GATTS_SendRsp GATTS_SendRsp;
 struct GATTS_StopService GATTS_StopService;
@@ -60,6 +61,7 @@ struct GATT_Deregister GATT_Deregister;
 struct GATT_Disconnect GATT_Disconnect;
 struct GATT_GetConnIdIfConnected GATT_GetConnIdIfConnected;
 struct GATT_GetConnectionInfor GATT_GetConnectionInfor;
+struct GATT_GetPayloadSize GATT_GetPayloadSize;
 struct GATT_Register GATT_Register;
 struct GATT_SetIdleTimeout GATT_SetIdleTimeout;
 struct GATT_StartIf GATT_StartIf;
@@ -88,6 +90,7 @@ tGATT_STATUS GATTS_AddService::return_value = GATT_SUCCESS;
 bool GATTS_DeleteService::return_value = false;
 tGATT_STATUS GATTS_HandleValueIndication::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTS_HandleValueNotification::return_value = GATT_SUCCESS;
+tGATT_STATUS GATTS_HandleMultipleValueNotification::return_value = GATT_SUCCESS;
 bool GATTS_NVRegister::return_value = false;
 tGATT_STATUS GATTS_SendRsp::return_value = GATT_SUCCESS;
 bool GATT_CancelConnect::return_value = false;
@@ -95,6 +98,7 @@ bool GATT_Connect::return_value = false;
 tGATT_STATUS GATT_Disconnect::return_value = GATT_SUCCESS;
 bool GATT_GetConnIdIfConnected::return_value = false;
 bool GATT_GetConnectionInfor::return_value = false;
+uint16_t GATT_GetPayloadSize::return_value = 0;
 tGATT_IF GATT_Register::return_value = 0;
 // tGATT_HDL_LIST_ELEM gatt_add_an_item_to_list::return_value = { .svc_db = {},
 // .asgn_range = {}};
@@ -168,6 +172,13 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id, uint16_t attr_handl
   return test::mock::stack_gatt_api::GATTS_HandleValueNotification(conn_id, attr_handle, val_len,
                                                                    p_val);
 }
+tGATT_STATUS GATTS_HandleMultipleValueNotification(tCONN_ID conn_id,
+                                                   const std::vector<tGATT_VALUE>& values,
+                                                   uint16_t* p_num_sent) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTS_HandleMultipleValueNotification(conn_id, values,
+                                                                          p_num_sent);
+}
 bool GATTS_NVRegister(tGATT_APPL_INFO* p_cb_info) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTS_NVRegister(p_cb_info);
@@ -213,6 +224,10 @@ bool GATT_GetConnectionInfor(uint16_t conn_id, tGATT_IF* p_gatt_if, RawAddress&
   return test::mock::stack_gatt_api::GATT_GetConnectionInfor(conn_id, p_gatt_if, bd_addr,
                                                              p_transport);
 }
+uint16_t GATT_GetPayloadSize(uint16_t conn_id) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATT_GetPayloadSize(conn_id);
+}
 tGATT_IF GATT_Register(const Uuid& app_uuid128, const std::string& name, tGATT_CBACK* p_cb_info,
                        bool eatt_support) {
   inc_func_call_count(__func__);
@@ -231,6 +231,25 @@ struct GATTS_HandleValueNotification {
 };
 extern struct GATTS_HandleValueNotification GATTS_HandleValueNotification;
 
+// Name: GATTS_HandleMultipleValueNotification
+// Params: tCONN_ID conn_id, const std::vector<tGATT_VALUE>& values, uint16_t* p_num_sent
+// Return: tGATT_STATUS
+struct GATTS_HandleMultipleValueNotification {
+  static tGATT_STATUS return_value;
+  std::function<tGATT_STATUS(tCONN_ID conn_id, const std::vector<tGATT_VALUE>& values,
+                             uint16_t* p_num_sent)>
+          body{[](tCONN_ID /* conn_id */, const std::vector<tGATT_VALUE>& values,
+                  uint16_t* p_num_sent) {
+            *p_num_sent = return_value == GATT_SUCCESS ? static_cast<uint16_t>(values.size()) : 0;
+            return return_value;
+          }};
+  tGATT_STATUS operator()(tCONN_ID conn_id, const std::vector<tGATT_VALUE>& values,
+                          uint16_t* p_num_sent) {
+    return body(conn_id, values, p_num_sent);
+  }
+};
+extern struct GATTS_HandleMultipleValueNotification GATTS_HandleMultipleValueNotification;
+
 // Name: GATTS_NVRegister
 // Params: tGATT_APPL_INFO* p_cb_info
 // Return: bool
@@ -358,6 +377,17 @@ struct GATT_GetConnectionInfor {
 };
 extern struct GATT_GetConnectionInfor GATT_GetConnectionInfor;
 
+// Name: GATT_GetPayloadSize
+// Params: uint16_t conn_id
+// Return: uint16_t
+struct GATT_GetPayloadSize {
+  static uint16_t return_value;
+  std::function<uint16_t(uint16_t conn_id)> body{
+          [](uint16_t /* conn_id */) { return return_value; }};
+  uint16_t operator()(uint16_t conn_id) { return body(conn_id); }
+};
+extern struct GATT_GetPayloadSize GATT_GetPayloadSize;
+
 // Name: GATT_Register
 // Params: const Uuid& app_uuid128, std::string name, tGATT_CBACK* p_cb_info,
 // bool eatt_support Return: tGATT_IF
@@ -68,6 +68,7 @@ struct L2CA_DataWrite L2CA_DataWrite;
 struct L2CA_LECocDataWrite L2CA_LECocDataWrite;
 struct L2CA_SetChnlFlushability L2CA_SetChnlFlushability;
 struct L2CA_FlushChannel L2CA_FlushChannel;
+struct L2CA_GetTxQueueDepth L2CA_GetTxQueueDepth;
 struct L2CA_IsLinkEstablished L2CA_IsLinkEstablished;
 struct L2CA_SetMediaStreamChannel L2CA_SetMediaStreamChannel;
 struct L2CA_isMediaChannel L2CA_isMediaChannel;
@@ -232,6 +233,10 @@ uint16_t L2CA_FlushChannel(uint16_t lcid, uint16_t num_to_flush) {
   inc_func_call_count(__func__);
   return test::mock::stack_l2cap_api::L2CA_FlushChannel(lcid, num_to_flush);
 }
+uint16_t L2CA_GetTxQueueDepth(uint16_t lcid) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_api::L2CA_GetTxQueueDepth(lcid);
+}
 bool L2CA_IsLinkEstablished(const RawAddress& bd_addr, tBT_TRANSPORT transport) {
   inc_func_call_count(__func__);
   return test::mock::stack_l2cap_api::L2CA_IsLinkEstablished(bd_addr, transport);
@@ -418,6 +418,14 @@ struct L2CA_FlushChannel {
   uint16_t operator()(uint16_t lcid, uint16_t num_to_flush) { return body(lcid, num_to_flush); }
 };
 extern struct L2CA_FlushChannel L2CA_FlushChannel;
+// Name: L2CA_GetTxQueueDepth
+// Params: uint16_t lcid
+// Returns: uint16_t
+struct L2CA_GetTxQueueDepth {
+  std::function<uint16_t(uint16_t lcid)> body{[](uint16_t /* lcid */) { return 0; }};
+  uint16_t operator()(uint16_t lcid) { return body(lcid); }
+};
+extern struct L2CA_GetTxQueueDepth L2CA_GetTxQueueDepth;
 // Name: L2CA_IsLinkEstablished
 // Params: const RawAddress& bd_addr, tBT_TRANSPORT transport
 // Returns: bool
@@ -37,6 +37,9 @@ namespace stack_l2cap_ble {
 
 // Function state capture and return values, if needed
 struct L2CA_UpdateBleConnParams L2CA_UpdateBleConnParams;
+struct L2CA_SetBleConnDemand L2CA_SetBleConnDemand;
+struct L2CA_ClearBleConnDemand L2CA_ClearBleConnDemand;
+struct L2CA_IsBleConnLatencySensitive L2CA_IsBleConnLatencySensitive;
 struct L2CA_LockBleConnParamsForServiceDiscovery L2CA_LockBleConnParamsForServiceDiscovery;
 struct L2CA_LockBleConnParamsForProfileConnection L2CA_LockBleConnParamsForProfileConnection;
 struct L2CA_ConsolidateParams L2CA_ConsolidateParams;
@@ -75,6 +78,22 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int, uint1
   return test::mock::stack_l2cap_ble::L2CA_UpdateBleConnParams(rem_bda, min_int, max_int, latency,
                                                                timeout, min_ce_len, max_ce_len);
 }
+bool L2CA_SetBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand,
+                           uint16_t min_int, uint16_t max_int, uint16_t latency, uint16_t timeout,
+                           uint16_t min_ce_len, uint16_t max_ce_len) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_ble::L2CA_SetBleConnDemand(rem_bda, demand, min_int, max_int,
+                                                            latency, timeout, min_ce_len,
+                                                            max_ce_len);
+}
+void L2CA_ClearBleConnDemand(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand) {
+  inc_func_call_count(__func__);
+  test::mock::stack_l2cap_ble::L2CA_ClearBleConnDemand(rem_bda, demand);
+}
+bool L2CA_IsBleConnLatencySensitive(const RawAddress& rem_bda) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_ble::L2CA_IsBleConnLatencySensitive(rem_bda);
+}
 void L2CA_LockBleConnParamsForServiceDiscovery(const RawAddress& rem_bda, bool enable) {
   inc_func_call_count(__func__);
   return test::mock::stack_l2cap_ble::L2CA_LockBleConnParamsForServiceDiscovery(rem_bda, enable);
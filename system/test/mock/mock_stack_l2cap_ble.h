@@ -54,6 +54,46 @@ struct L2CA_UpdateBleConnParams {
   }
 };
 extern struct L2CA_UpdateBleConnParams L2CA_UpdateBleConnParams;
+// Name: L2CA_SetBleConnDemand
+// Params: const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand, uint16_t min_int,
+// uint16_t max_int, uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
+// uint16_t max_ce_len
+// Returns: bool
+struct L2CA_SetBleConnDemand {
+  std::function<bool(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand, uint16_t min_int,
+                     uint16_t max_int, uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
+                     uint16_t max_ce_len)>
+          body{[](const RawAddress& /* rem_bda */, tL2CAP_BLE_CONN_DEMAND /* demand */,
+                  uint16_t /* min_int */, uint16_t /* max_int */, uint16_t /* latency */,
+                  uint16_t /* timeout */, uint16_t /* min_ce_len */,
+                  uint16_t /* max_ce_len */) { return false; }};
+  bool operator()(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand, uint16_t min_int,
+                  uint16_t max_int, uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
+                  uint16_t max_ce_len) {
+    return body(rem_bda, demand, min_int, max_int, latency, timeout, min_ce_len, max_ce_len);
+  }
+};
+extern struct L2CA_SetBleConnDemand L2CA_SetBleConnDemand;
+// Name: L2CA_ClearBleConnDemand
+// Params: const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand
+// Returns: void
+struct L2CA_ClearBleConnDemand {
+  std::function<void(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand)> body{
+          [](const RawAddress& /* rem_bda */, tL2CAP_BLE_CONN_DEMAND /* demand */) {}};
+  void operator()(const RawAddress& rem_bda, tL2CAP_BLE_CONN_DEMAND demand) {
+    body(rem_bda, demand);
+  }
+};
+extern struct L2CA_ClearBleConnDemand L2CA_ClearBleConnDemand;
+// Name: L2CA_IsBleConnLatencySensitive
+// Params: const RawAddress& rem_bda
+// Returns: bool
+struct L2CA_IsBleConnLatencySensitive {
+  std::function<bool(const RawAddress& rem_bda)> body{
+          [](const RawAddress& /* rem_bda */) { return false; }};
+  bool operator()(const RawAddress& rem_bda) { return body(rem_bda); }
+};
+extern struct L2CA_IsBleConnLatencySensitive L2CA_IsBleConnLatencySensitive;
 // Name: L2CA_LockBleConnParamsForServiceDiscovery
 // Params: const RawAddress& rem_bda, bool enable
 // Returns: void
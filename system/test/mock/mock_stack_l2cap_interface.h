@@ -75,6 +75,7 @@ public:
               (const RawAddress& bd_addr, uint16_t subrate_min, uint16_t subrate_max,
                uint16_t max_latency, uint16_t cont_num, uint16_t timeout));
   MOCK_METHOD(uint16_t, L2CA_FlushChannel, (uint16_t lcid, uint16_t num_to_flush));
+  MOCK_METHOD(uint16_t, L2CA_GetTxQueueDepth, (uint16_t lcid));
   MOCK_METHOD(bool, L2CA_SetTxPriority, (uint16_t cid, tL2CAP_CHNL_PRIORITY priority));
   MOCK_METHOD(bool, L2CA_SetChnlFlushability, (uint16_t cid, bool is_flushable));
 
@@ -94,6 +95,13 @@ public:
   MOCK_METHOD(bool, L2CA_UpdateBleConnParams,
               (const RawAddress& bd_addr, uint16_t min_int, uint16_t max_int, uint16_t latency,
                uint16_t timeout, uint16_t min_ce_len, uint16_t max_ce_len));
+  MOCK_METHOD(bool, L2CA_SetBleConnDemand,
+              (const RawAddress& bd_addr, tL2CAP_BLE_CONN_DEMAND demand, uint16_t min_int,
+               uint16_t max_int, uint16_t latency, uint16_t timeout, uint16_t min_ce_len,
+               uint16_t max_ce_len));
+  MOCK_METHOD(void, L2CA_ClearBleConnDemand,
+              (const RawAddress& bd_addr, tL2CAP_BLE_CONN_DEMAND demand));
+  MOCK_METHOD(bool, L2CA_IsBleConnLatencySensitive, (const RawAddress& bd_addr));
   MOCK_METHOD(void, L2CA_LockBleConnParamsForServiceDiscovery,
               (const RawAddress& bd_addr, bool lock));
   MOCK_METHOD(void, L2CA_LockBleConnParamsForProfileConnection,
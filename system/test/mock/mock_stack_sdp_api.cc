@@ -43,6 +43,7 @@ struct SDP_FindProtocolListElemInRec SDP_FindProtocolListElemInRec;
 struct SDP_FindServiceUUIDInRec SDP_FindServiceUUIDInRec;
 struct SDP_FindServiceUUIDInRec_128bit SDP_FindServiceUUIDInRec_128bit;
 struct SDP_InitDiscoveryDb SDP_InitDiscoveryDb;
+struct SDP_FreeDiscoveryDb SDP_FreeDiscoveryDb;
 struct SDP_ServiceSearchAttributeRequest SDP_ServiceSearchAttributeRequest;
 struct SDP_ServiceSearchAttributeRequest2 SDP_ServiceSearchAttributeRequest2;
 struct SDP_ServiceSearchRequest SDP_ServiceSearchRequest;
@@ -90,6 +91,10 @@ bool SDP_InitDiscoveryDb(tSDP_DISCOVERY_DB* p_db, uint32_t len, uint16_t num_uui
   return test::mock::stack_sdp_api::SDP_InitDiscoveryDb(p_db, len, num_uuid, p_uuid_list, num_attr,
                                                         p_attr_list);
 }
+void SDP_FreeDiscoveryDb(tSDP_DISCOVERY_DB* p_db) {
+  inc_func_call_count(__func__);
+  test::mock::stack_sdp_api::SDP_FreeDiscoveryDb(p_db);
+}
 bool SDP_ServiceSearchAttributeRequest(const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db,
                                        tSDP_DISC_CMPL_CB* p_cb) {
   inc_func_call_count(__func__);
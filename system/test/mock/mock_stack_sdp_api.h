@@ -111,6 +111,14 @@ struct SDP_InitDiscoveryDb {
   }
 };
 extern struct SDP_InitDiscoveryDb SDP_InitDiscoveryDb;
+// Name: SDP_FreeDiscoveryDb
+// Params: tSDP_DISCOVERY_DB* p_db
+// Returns: void
+struct SDP_FreeDiscoveryDb {
+  std::function<void(tSDP_DISCOVERY_DB* p_db)> body{[](tSDP_DISCOVERY_DB* /* p_db */) {}};
+  void operator()(tSDP_DISCOVERY_DB* p_db) { body(p_db); }
+};
+extern struct SDP_FreeDiscoveryDb SDP_FreeDiscoveryDb;
 // Name: SDP_ServiceSearchAttributeRequest
 // Params: const RawAddress& p_bd_addr, tSDP_DISCOVERY_DB* p_db,
 // tSDP_DISC_CMPL_CB* p_cb Returns: bool
@@ -80,6 +80,13 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* /* p_rec */,
   inc_func_call_count(__func__);
   return nullptr;
 }
+bool sdp_db_get_all_attr_list_len(const tSDP_RECORD* /* p_rec */, uint16_t* /* p_len */) {
+  inc_func_call_count(__func__);
+  return false;
+}
+void sdp_db_set_all_attr_list_len(const tSDP_RECORD* /* p_rec */, uint16_t /* len */) {
+  inc_func_call_count(__func__);
+}
 uint32_t SDP_CreateRecord(void) {
   inc_func_call_count(__func__);
   return 0;
@@ -29,10 +29,13 @@ bluetooth::legacy::stack::sdp::tSdpApi api_ = {
                         .SDP_InitDiscoveryDb = [](tSDP_DISCOVERY_DB*, uint32_t, uint16_t,
                                                   const bluetooth::Uuid*, uint16_t,
                                                   const uint16_t*) -> bool { return false; },
-                        .SDP_CancelServiceSearch = nullptr,
+                        .SDP_CancelServiceSearch = [](const tSDP_DISCOVERY_DB*) -> bool {
+                          return false;
+                        },
                         .SDP_ServiceSearchRequest = nullptr,
                         .SDP_ServiceSearchAttributeRequest = nullptr,
                         .SDP_ServiceSearchAttributeRequest2 = nullptr,
+                        .SDP_FreeDiscoveryDb = [](tSDP_DISCOVERY_DB*) {},
                 },
         .db =
                 {